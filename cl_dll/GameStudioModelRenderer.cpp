@@ -47,6 +47,17 @@ CGameStudioModelRenderer::CGameStudioModelRenderer()
 {
 }
 
+/*
+====================
+StudioCreateWorker
+
+====================
+*/
+CStudioModelRenderer* CGameStudioModelRenderer::StudioCreateWorker()
+{
+	return new CGameStudioModelRenderer();
+}
+
 ////////////////////////////////////
 // Hooks to class implementation
 ////////////////////////////////////
@@ -73,6 +84,28 @@ int R_StudioDrawModel(int flags)
 	return static_cast<int>(g_StudioRenderer.StudioDrawModel(flags));
 }
 
+/*
+====================
+R_StudioQueueEntity
+
+====================
+*/
+void R_StudioQueueEntity(cl_entity_t* entity)
+{
+	g_StudioRenderer.StudioQueueEntity(entity);
+}
+
+/*
+====================
+R_StudioDrawOverlay
+
+====================
+*/
+void R_StudioDrawOverlay()
+{
+	g_StudioRenderer.StudioDrawAnimLODOverlay();
+}
+
 /*
 ====================
 R_StudioInit
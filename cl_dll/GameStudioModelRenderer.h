@@ -17,4 +17,6 @@ class CGameStudioModelRenderer : public CStudioModelRenderer
 {
 public:
 	CGameStudioModelRenderer();
+
+	CStudioModelRenderer* StudioCreateWorker() override;
 };
@@ -15,11 +15,15 @@
 #include <string.h>
 #include <memory.h>
 
+#include <algorithm>
+#include <mutex>
+
 #include "studio_util.h"
 #include "r_studioint.h"
 
 #include "StudioModelRenderer.h"
 #include "GameStudioModelRenderer.h"
+#include "job_system.h"
 
 extern cvar_t* tfc_newmodels;
 
@@ -36,6 +40,77 @@ int m_nPlayerGaitSequences[MAX_PLAYERS];
 // Global engine <-> studio model rendering code interface
 engine_studio_api_t IEngineStudio;
 
+// Entities not drawn for this many frames lose their bone cache entry
+#define BONECACHE_MAX_IDLE_FRAMES 256
+
+// Most entities queued for parallel bone setup in one frame
+#define BONESETUP_MAX_QUEUED 1024
+
+struct bone_cache_stats_t
+{
+	unsigned int hits;
+	unsigned int misses;
+	unsigned int transformHits;
+	unsigned int prepared;
+};
+
+static bone_cache_stats_t g_BoneCacheStats;
+
+static void StudioBoneCacheStats()
+{
+	const unsigned int total = g_BoneCacheStats.hits + g_BoneCacheStats.misses;
+
+	gEngfuncs.Con_Printf("Bone cache: %u setups, %u hits (%.1f%%), %u misses, %u transforms reused, %u set up in parallel\n",
+		total, g_BoneCacheStats.hits, total > 0 ? 100.0 * g_BoneCacheStats.hits / total : 0.0,
+		g_BoneCacheStats.misses, g_BoneCacheStats.transformHits, g_BoneCacheStats.prepared);
+
+	if (gEngfuncs.Cmd_Argc() > 1 && 0 == strcmp(gEngfuncs.Cmd_Argv(1), "reset"))
+	{
+		memset(&g_BoneCacheStats, 0, sizeof(g_BoneCacheStats));
+	}
+}
+
+// Decoded animations of every model, shared by all renderers
+static CStudioAnimCache g_StudioAnimCache;
+// Held while looking up animations, bones are set up on several threads during parallel bone setup
+static std::mutex g_StudioAnimCacheMutex;
+
+static void StudioAnimCacheStats()
+{
+	const auto& stats = g_StudioAnimCache.GetStats();
+	const unsigned int total = stats.hits + stats.misses;
+
+	gEngfuncs.Con_Printf("Animation cache: %d animations, %u KB of %u KB, %u lookups, %u hits (%.1f%%), %u bones decoded, %u evictions\n",
+		g_StudioAnimCache.GetEntryCount(), static_cast<unsigned int>(g_StudioAnimCache.GetBytes() / 1024),
+		static_cast<unsigned int>(g_StudioAnimCache.GetMaxBytes() / 1024),
+		total, stats.hits, total > 0 ? 100.0 * stats.hits / total : 0.0, stats.bonesDecoded, stats.evictions);
+
+	if (gEngfuncs.Cmd_Argc() > 1 && 0 == strcmp(gEngfuncs.Cmd_Argv(1), "reset"))
+	{
+		g_StudioAnimCache.ResetStats();
+	}
+}
+
+void StudioClearAnimCache()
+{
+	g_StudioAnimCache.Clear();
+}
+
+static void StudioSIMDStats()
+{
+	static const char* const modeNames[] = {"off", "SSE2", "SSE2, validating"};
+
+	const auto stats = GetStudioSIMDStats();
+
+	gEngfuncs.Con_Printf("Studio SIMD: %s, %u calls validated, %u values, %u mismatches, largest error %g\n",
+		modeNames[GetStudioSIMDMode()], stats.calls, stats.values, stats.mismatches, stats.maxError);
+
+	if (gEngfuncs.Cmd_Argc() > 1 && 0 == strcmp(gEngfuncs.Cmd_Argv(1), "reset"))
+	{
+		ResetStudioSIMDStats();
+	}
+}
+
 /////////////////////
 // Implementation of CStudioModelRenderer.h
 
@@ -51,6 +126,23 @@ void CStudioModelRenderer::Init()
 	m_pCvarHiModels = IEngineStudio.GetCvar("cl_himodels");
 	m_pCvarDeveloper = IEngineStudio.GetCvar("developer");
 	m_pCvarDrawEntities = IEngineStudio.GetCvar("r_drawentities");
+	m_pCvarBoneCache = CVAR_CREATE("r_bonecache", "1", 0);
+	m_pCvarAnimCache = CVAR_CREATE("r_animcache_kb", "8192", FCVAR_ARCHIVE);
+	m_pCvarParallelBones = CVAR_CREATE("r_parallelbones", "1", FCVAR_ARCHIVE);
+	m_pCvarSIMD = CVAR_CREATE("r_studio_simd", "1", FCVAR_ARCHIVE);
+	m_pCvarAnimLOD = CVAR_CREATE("r_animlod", "0", FCVAR_ARCHIVE);
+	m_pCvarAnimLODDist1 = CVAR_CREATE("r_animlod_dist1", "1024", FCVAR_ARCHIVE);
+	m_pCvarAnimLODDist2 = CVAR_CREATE("r_animlod_dist2", "2048", FCVAR_ARCHIVE);
+	m_pCvarAnimLODSize1 = CVAR_CREATE("r_animlod_size1", "64", FCVAR_ARCHIVE);
+	m_pCvarAnimLODSize2 = CVAR_CREATE("r_animlod_size2", "24", FCVAR_ARCHIVE);
+	m_pCvarAnimLODRate1 = CVAR_CREATE("r_animlod_rate1", "30", FCVAR_ARCHIVE);
+	m_pCvarAnimLODRate2 = CVAR_CREATE("r_animlod_rate2", "15", FCVAR_ARCHIVE);
+	m_pCvarAnimLODControllers = CVAR_CREATE("r_animlod_controllers", "1", FCVAR_ARCHIVE);
+	m_pCvarAnimLODDebug = CVAR_CREATE("r_animlod_debug", "0", 0);
+
+	gEngfuncs.pfnAddCommand("r_bonecache_stats", &StudioBoneCacheStats);
+	gEngfuncs.pfnAddCommand("r_animcache_stats", &StudioAnimCacheStats);
+	gEngfuncs.pfnAddCommand("r_studio_simd_stats", &StudioSIMDStats);
 
 	m_pChromeSprite = IEngineStudio.GetChromeSprite();
 
@@ -77,6 +169,19 @@ CStudioModelRenderer::CStudioModelRenderer()
 	m_pCvarHiModels = NULL;
 	m_pCvarDeveloper = NULL;
 	m_pCvarDrawEntities = NULL;
+	m_pCvarBoneCache = NULL;
+	m_pCvarAnimCache = NULL;
+	m_pCvarParallelBones = NULL;
+	m_pCvarSIMD = NULL;
+	m_pCvarAnimLOD = NULL;
+	m_pCvarAnimLODDist1 = NULL;
+	m_pCvarAnimLODDist2 = NULL;
+	m_pCvarAnimLODSize1 = NULL;
+	m_pCvarAnimLODSize2 = NULL;
+	m_pCvarAnimLODRate1 = NULL;
+	m_pCvarAnimLODRate2 = NULL;
+	m_pCvarAnimLODControllers = NULL;
+	m_pCvarAnimLODDebug = NULL;
 	m_pChromeSprite = NULL;
 	m_pStudioModelCount = NULL;
 	m_pModelsDrawn = NULL;
@@ -89,6 +194,12 @@ CStudioModelRenderer::CStudioModelRenderer()
 	m_pSubModel = NULL;
 	m_pPlayerInfo = NULL;
 	m_pRenderModel = NULL;
+	m_nBoneCacheSweepFrame = 0;
+	m_pBoneKeys = NULL;
+	m_nAnimCacheFrame = -1;
+	m_nBoneSetupFrame = -1;
+	m_nAnimLOD = ANIMLOD_FULL;
+	m_nAnimLODSweepFrame = 0;
 }
 
 /*
@@ -179,17 +290,71 @@ StudioCalcBoneQuaterion
 */
 void CStudioModelRenderer::StudioCalcBoneQuaterion(int frame, float s, mstudiobone_t* pbone, mstudioanim_t* panim, float* adj, float* q)
 {
-	int j, k;
 	vec4_t q1, q2;
 	Vector angle1, angle2;
+
+	StudioCalcBoneAngles(frame, pbone, panim, adj, angle1, angle2);
+
+	if (!VectorCompare(angle1, angle2))
+	{
+		AngleQuaternion(angle1, q1);
+		AngleQuaternion(angle2, q2);
+		QuaternionSlerp(q1, q2, s, q);
+	}
+	else
+	{
+		AngleQuaternion(angle1, q);
+	}
+}
+
+/*
+====================
+StudioNearestBlend
+
+====================
+*/
+int CStudioModelRenderer::StudioNearestBlend(mstudioseqdesc_t* pseqdesc)
+{
+	const float dadt = StudioEstimateInterpolant();
+
+	int blend = 0;
+
+	// Blends are laid out like StudioCalcPose slerps them, the first blending value picks from pairs, the second between the pairs
+	for (int i = 0; i < (pseqdesc->numblends == 4 ? 2 : 1); i++)
+	{
+		const float s = (m_pCurrentEntity->curstate.blending[i] * dadt + m_pCurrentEntity->latched.prevblending[i] * (1.0 - dadt)) / 255.0;
+
+		if (s >= 0.5)
+			blend += 1 << i;
+	}
+
+	return blend;
+}
+
+/*
+====================
+StudioCalcBoneAngles
+
+====================
+*/
+void CStudioModelRenderer::StudioCalcBoneAngles(int frame, mstudiobone_t* pbone, mstudioanim_t* panim, float* adj, float* angle1, float* angle2)
+{
+	int j, k;
 	mstudioanimvalue_t* panimvalue;
 
 	for (j = 0; j < 3; j++)
 	{
+		const studio_animkey_t* key;
+
 		if (panim->offset[j + 3] == 0)
 		{
 			angle2[j] = angle1[j] = pbone->value[j + 3]; // default;
 		}
+		else if (m_pBoneKeys && (key = m_pBoneKeys->GetKey(j + 3, frame)) != NULL)
+		{
+			angle1[j] = pbone->value[j + 3] + key->value * pbone->scale[j + 3];
+			angle2[j] = pbone->value[j + 3] + key->next * pbone->scale[j + 3];
+		}
 		else
 		{
 			panimvalue = (mstudioanimvalue_t*)((byte*)panim + panim->offset[j + 3]);
@@ -244,17 +409,6 @@ void CStudioModelRenderer::StudioCalcBoneQuaterion(int frame, float s, mstudiobo
 			angle2[j] += adj[pbone->bonecontroller[j + 3]];
 		}
 	}
-
-	if (!VectorCompare(angle1, angle2))
-	{
-		AngleQuaternion(angle1, q1);
-		AngleQuaternion(angle2, q2);
-		QuaternionSlerp(q1, q2, s, q);
-	}
-	else
-	{
-		AngleQuaternion(angle1, q);
-	}
 }
 
 /*
@@ -270,8 +424,17 @@ void CStudioModelRenderer::StudioCalcBonePosition(int frame, float s, mstudiobon
 
 	for (j = 0; j < 3; j++)
 	{
+		const studio_animkey_t* key;
+
 		pos[j] = pbone->value[j]; // default;
-		if (panim->offset[j] != 0)
+		if (panim->offset[j] != 0 && m_pBoneKeys && (key = m_pBoneKeys->GetKey(j, frame)) != NULL)
+		{
+			if (key->blendPosition)
+				pos[j] += (key->value * (1.0 - s) + s * key->next) * pbone->scale[j];
+			else
+				pos[j] += key->value * pbone->scale[j];
+		}
+		else if (panim->offset[j] != 0)
 		{
 			panimvalue = (mstudioanimvalue_t*)((byte*)panim + panim->offset[j]);
 			/*
@@ -344,6 +507,20 @@ void CStudioModelRenderer::StudioSlerpBones(vec4_t q1[], float pos1[][3], vec4_t
 
 	s1 = 1.0 - s;
 
+	if (GetStudioSIMDMode() != STUDIO_SIMD_OFF)
+	{
+		QuaternionSlerps(q1, q2, s, q1, m_pStudioHeader->numbones);
+
+		for (i = 0; i < m_pStudioHeader->numbones; i++)
+		{
+			pos1[i][0] = pos1[i][0] * s1 + pos2[i][0] * s;
+			pos1[i][1] = pos1[i][1] * s1 + pos2[i][1] * s;
+			pos1[i][2] = pos1[i][2] * s1 + pos2[i][2] * s;
+		}
+
+		return;
+	}
+
 	for (i = 0; i < m_pStudioHeader->numbones; i++)
 	{
 		QuaternionSlerp(q1[i], q2[i], s, q3);
@@ -625,17 +802,83 @@ void CStudioModelRenderer::StudioCalcRotations(float pos[][3], vec4_t* q, mstudi
 	// add in programtic controllers
 	pbone = (mstudiobone_t*)((byte*)m_pStudioHeader + m_pStudioHeader->boneindex);
 
-	StudioCalcBoneAdj(dadt, adj, m_pCurrentEntity->curstate.controller, m_pCurrentEntity->latched.prevcontroller, m_pCurrentEntity->mouth.mouthopen);
+	if (m_nAnimLOD == ANIMLOD_LOW && 0 == m_pCvarAnimLODControllers->value)
+	{
+		memset(adj, 0, sizeof(adj));
+	}
+	else
+	{
+		StudioCalcBoneAdj(dadt, adj, m_pCurrentEntity->curstate.controller, m_pCurrentEntity->latched.prevcontroller, m_pCurrentEntity->mouth.mouthopen);
+	}
+
+	StudioUpdateAnimCache();
+
+	const studio_bonekeys_t* boneKeys[MAXSTUDIOBONES];
+	bool haveBoneKeys = false;
+
+	{
+		std::lock_guard<std::mutex> lock(g_StudioAnimCacheMutex);
+
+		CStudioAnimCache::Entry* animEntry = g_StudioAnimCache.Find(panim, m_pStudioHeader->numbones, pseqdesc->numframes);
+
+		if (animEntry)
+		{
+			for (i = 0; i < m_pStudioHeader->numbones; i++)
+			{
+				boneKeys[i] = &g_StudioAnimCache.GetBone(animEntry, i);
+			}
+
+			haveBoneKeys = true;
+		}
+	}
+
+	if (GetStudioSIMDMode() != STUDIO_SIMD_OFF)
+	{
+		// Find the angles of every bone, then turn them into quaternions 4 bones at a time
+		float angle1[MAXSTUDIOBONES][3];
+		float angle2[MAXSTUDIOBONES][3];
+		vec4_t q2[MAXSTUDIOBONES];
+
+		for (i = 0; i < m_pStudioHeader->numbones; i++, pbone++, panim++)
+		{
+			m_pBoneKeys = haveBoneKeys ? boneKeys[i] : NULL;
+
+			StudioCalcBoneAngles(frame, pbone, panim, adj, angle1[i], angle2[i]);
+
+			StudioCalcBonePosition(frame, s, pbone, panim, adj, pos[i]);
+		}
+
+		AngleQuaternions(angle1, q, m_pStudioHeader->numbones);
+		AngleQuaternions(angle2, q2, m_pStudioHeader->numbones);
+		QuaternionSlerps(q, q2, s, q2, m_pStudioHeader->numbones);
 
-	for (i = 0; i < m_pStudioHeader->numbones; i++, pbone++, panim++)
+		for (i = 0; i < m_pStudioHeader->numbones; i++)
+		{
+			if (!VectorCompare(angle1[i], angle2[i]))
+			{
+				q[i][0] = q2[i][0];
+				q[i][1] = q2[i][1];
+				q[i][2] = q2[i][2];
+				q[i][3] = q2[i][3];
+			}
+		}
+	}
+	else
 	{
-		StudioCalcBoneQuaterion(frame, s, pbone, panim, adj, q[i]);
+		for (i = 0; i < m_pStudioHeader->numbones; i++, pbone++, panim++)
+		{
+			m_pBoneKeys = haveBoneKeys ? boneKeys[i] : NULL;
 
-		StudioCalcBonePosition(frame, s, pbone, panim, adj, pos[i]);
-		// if (0 && i == 0)
-		//	Con_DPrintf("%d %d %d %d\n", m_pCurrentEntity->curstate.sequence, frame, j, k );
+			StudioCalcBoneQuaterion(frame, s, pbone, panim, adj, q[i]);
+
+			StudioCalcBonePosition(frame, s, pbone, panim, adj, pos[i]);
+			// if (0 && i == 0)
+			//	Con_DPrintf("%d %d %d %d\n", m_pCurrentEntity->curstate.sequence, frame, j, k );
+		}
 	}
 
+	m_pBoneKeys = NULL;
+
 	if ((pseqdesc->motiontype & STUDIO_X) != 0)
 	{
 		pos[pseqdesc->motionbone][0] = 0.0;
@@ -665,6 +908,23 @@ void CStudioModelRenderer::StudioCalcRotations(float pos[][3], vec4_t* q, mstudi
 	}
 }
 
+/*
+====================
+StudioUpdateAnimCache
+
+====================
+*/
+void CStudioModelRenderer::StudioUpdateAnimCache()
+{
+	if (m_nAnimCacheFrame == m_nFrameCount)
+		return;
+
+	m_nAnimCacheFrame = m_nFrameCount;
+
+	const float kilobytes = m_pCvarAnimCache->value;
+	g_StudioAnimCache.SetMaxBytes(kilobytes > 0 ? static_cast<std::size_t>(kilobytes) * 1024 : 0);
+}
+
 /*
 ====================
 Studio_FxTransform
@@ -773,148 +1033,366 @@ float CStudioModelRenderer::StudioEstimateFrame(mstudioseqdesc_t* pseqdesc)
 
 /*
 ====================
-StudioSetupBones
+StudioBoneCacheKey
 
 ====================
 */
-void CStudioModelRenderer::StudioSetupBones()
+void CStudioModelRenderer::StudioBoneCacheKey(bone_cache_key_t& key, double f, bool merge, bool blendPrevSequence)
 {
-	int i;
-	double f;
-
-	mstudiobone_t* pbones;
-	mstudioseqdesc_t* pseqdesc;
-	mstudioanim_t* panim;
+	memset(&key, 0, sizeof(key));
+
+	key.model = m_pRenderModel;
+	key.merge = merge;
+	key.doInterp = m_fDoInterp;
+	key.sequence = m_pCurrentEntity->curstate.sequence;
+	key.frame = f;
+	key.dadt = StudioEstimateInterpolant();
+	memcpy(key.controller, m_pCurrentEntity->curstate.controller, sizeof(key.controller));
+	memcpy(key.prevcontroller, m_pCurrentEntity->latched.prevcontroller, sizeof(key.prevcontroller));
+	key.mouthopen = m_pCurrentEntity->mouth.mouthopen;
+
+	if (merge)
+		return;
 
-	static float pos[MAXSTUDIOBONES][3];
-	static vec4_t q[MAXSTUDIOBONES];
-	float bonematrix[3][4];
+	memcpy(key.blending, m_pCurrentEntity->curstate.blending, sizeof(key.blending));
+	memcpy(key.prevblending, m_pCurrentEntity->latched.prevblending, sizeof(key.prevblending));
 
-	static float pos2[MAXSTUDIOBONES][3];
-	static vec4_t q2[MAXSTUDIOBONES];
-	static float pos3[MAXSTUDIOBONES][3];
-	static vec4_t q3[MAXSTUDIOBONES];
-	static float pos4[MAXSTUDIOBONES][3];
-	static vec4_t q4[MAXSTUDIOBONES];
+	if (blendPrevSequence)
+	{
+		key.prevsequence = m_pCurrentEntity->latched.prevsequence;
+		key.prevframe = m_pCurrentEntity->latched.prevframe;
+		memcpy(key.prevseqblending, m_pCurrentEntity->latched.prevseqblending, sizeof(key.prevseqblending));
+		key.prevsequenceweight = 1.0 - (m_clTime - m_pCurrentEntity->latched.sequencetime) / 0.2;
+	}
 
-	if (m_pCurrentEntity->curstate.sequence >= m_pStudioHeader->numseq)
+	if (m_pPlayerInfo)
 	{
-		m_pCurrentEntity->curstate.sequence = 0;
+		key.gaitsequence = m_pPlayerInfo->gaitsequence;
+
+		if (0 != key.gaitsequence)
+			key.gaitframe = m_pPlayerInfo->gaitframe;
 	}
+}
 
-	pseqdesc = (mstudioseqdesc_t*)((byte*)m_pStudioHeader + m_pStudioHeader->seqindex) + m_pCurrentEntity->curstate.sequence;
+/*
+====================
+StudioCheckBoneCache
 
-	// always want new gait sequences to start on frame zero
-	/*	if ( m_pPlayerInfo )
+====================
+*/
+bool CStudioModelRenderer::StudioCheckBoneCache(const bone_cache_key_t& key, bone_cache_t*& cache)
+{
+	if (m_nFrameCount - m_nBoneCacheSweepFrame > BONECACHE_MAX_IDLE_FRAMES || m_nFrameCount < m_nBoneCacheSweepFrame)
 	{
-		int playerNum = m_pCurrentEntity->index - 1;
+		m_nBoneCacheSweepFrame = m_nFrameCount;
 
-		// new jump gaitsequence?  start from frame zero
-		if ( m_nPlayerGaitSequences[ playerNum ] != m_pPlayerInfo->gaitsequence )
+		for (auto it = m_BoneCache.begin(); it != m_BoneCache.end();)
 		{
-	//		m_pPlayerInfo->gaitframe = 0.0;
-			gEngfuncs.Con_Printf( "Setting gaitframe to 0\n" );
+			if (m_nFrameCount - it->second.lastFrame > BONECACHE_MAX_IDLE_FRAMES || m_nFrameCount < it->second.lastFrame)
+				it = m_BoneCache.erase(it);
+			else
+				++it;
 		}
-
-		m_nPlayerGaitSequences[ playerNum ] = m_pPlayerInfo->gaitsequence;
-//		gEngfuncs.Con_Printf( "index: %d     gaitsequence: %d\n",playerNum, m_pPlayerInfo->gaitsequence);
 	}
-*/
-	f = StudioEstimateFrame(pseqdesc);
 
-	if (m_pCurrentEntity->latched.prevframe > f)
+	cache = &m_BoneCache[{m_pCurrentEntity, key.model, key.merge}];
+	cache->lastFrame = m_nFrameCount;
+
+	if (cache->valid && cache->numbones == m_pStudioHeader->numbones && 0 == memcmp(&cache->key, &key, sizeof(key)))
 	{
-		//Con_DPrintf("%f %f\n", m_pCurrentEntity->prevframe, f );
+		++g_BoneCacheStats.hits;
+		return true;
 	}
 
-	panim = StudioGetAnim(m_pRenderModel, pseqdesc);
-	StudioCalcRotations(pos, q, pseqdesc, panim, f);
-
-	if (pseqdesc->numblends > 1)
-	{
-		float s;
-		float dadt;
+	++g_BoneCacheStats.misses;
+	return false;
+}
 
-		panim += m_pStudioHeader->numbones;
-		StudioCalcRotations(pos2, q2, pseqdesc, panim, f);
+/*
+====================
+StudioLoadBoneCache
 
-		dadt = StudioEstimateInterpolant();
-		s = (m_pCurrentEntity->curstate.blending[0] * dadt + m_pCurrentEntity->latched.prevblending[0] * (1.0 - dadt)) / 255.0;
+====================
+*/
+void CStudioModelRenderer::StudioLoadBoneCache(const bone_cache_t& cache, float pos[][3], vec4_t* q)
+{
+	memcpy(pos, cache.pos.data(), cache.numbones * sizeof(pos[0]));
+	memcpy(q, cache.q.data(), cache.numbones * sizeof(q[0]));
+}
 
-		StudioSlerpBones(q, pos, q2, pos2, s);
+/*
+====================
+StudioStoreBoneCache
 
-		if (pseqdesc->numblends == 4)
-		{
-			panim += m_pStudioHeader->numbones;
-			StudioCalcRotations(pos3, q3, pseqdesc, panim, f);
+====================
+*/
+void CStudioModelRenderer::StudioStoreBoneCache(bone_cache_t& cache, const bone_cache_key_t& key, float pos[][3], vec4_t* q)
+{
+	cache.key = key;
+	cache.valid = true;
+	cache.transformsValid = false;
+	cache.numbones = m_pStudioHeader->numbones;
 
-			panim += m_pStudioHeader->numbones;
-			StudioCalcRotations(pos4, q4, pseqdesc, panim, f);
+	cache.pos.assign(&pos[0][0], &pos[0][0] + cache.numbones * 3);
+	cache.q.assign(&q[0][0], &q[0][0] + cache.numbones * 4);
+}
 
-			s = (m_pCurrentEntity->curstate.blending[0] * dadt + m_pCurrentEntity->latched.prevblending[0] * (1.0 - dadt)) / 255.0;
-			StudioSlerpBones(q3, pos3, q4, pos4, s);
+/*
+====================
+StudioLoadBoneTransforms
 
-			s = (m_pCurrentEntity->curstate.blending[1] * dadt + m_pCurrentEntity->latched.prevblending[1] * (1.0 - dadt)) / 255.0;
-			StudioSlerpBones(q, pos, q3, pos3, s);
-		}
+====================
+*/
+bool CStudioModelRenderer::StudioLoadBoneTransforms(bone_cache_t& cache)
+{
+	// These add random or time based changes to the transforms
+	switch (m_pCurrentEntity->curstate.renderfx)
+	{
+	case kRenderFxDistort:
+	case kRenderFxHologram:
+	case kRenderFxExplode:
+		return false;
 	}
 
-	if (m_fDoInterp &&
-		0 != m_pCurrentEntity->latched.sequencetime &&
-		(m_pCurrentEntity->latched.sequencetime + 0.2 > m_clTime) &&
-		(m_pCurrentEntity->latched.prevsequence < m_pStudioHeader->numseq))
-	{
-		// blend from last sequence
-		static float pos1b[MAXSTUDIOBONES][3];
-		static vec4_t q1b[MAXSTUDIOBONES];
-		float s;
+	const bool hardware = 0 != IEngineStudio.IsHardware();
 
-		if (m_pCurrentEntity->latched.prevsequence >= m_pStudioHeader->numseq)
-		{
-			m_pCurrentEntity->latched.prevsequence = 0;
-		}
+	if (!cache.transformsValid || cache.hardware != hardware || cache.renderfx != m_pCurrentEntity->curstate.renderfx ||
+		0 != memcmp(cache.rotationmatrix, *m_protationmatrix, sizeof(cache.rotationmatrix)))
+		return false;
 
-		pseqdesc = (mstudioseqdesc_t*)((byte*)m_pStudioHeader + m_pStudioHeader->seqindex) + m_pCurrentEntity->latched.prevsequence;
-		panim = StudioGetAnim(m_pRenderModel, pseqdesc);
-		// clip prevframe
-		StudioCalcRotations(pos1b, q1b, pseqdesc, panim, m_pCurrentEntity->latched.prevframe);
+	// The software renderer's bone transforms include the view
+	if (!hardware && 0 != memcmp(cache.aliastransform, *m_paliastransform, sizeof(cache.aliastransform)))
+		return false;
 
-		if (pseqdesc->numblends > 1)
-		{
-			panim += m_pStudioHeader->numbones;
-			StudioCalcRotations(pos2, q2, pseqdesc, panim, m_pCurrentEntity->latched.prevframe);
+	memcpy(*m_pbonetransform, cache.bonetransform.data(), cache.numbones * sizeof((*m_pbonetransform)[0]));
+	memcpy(*m_plighttransform, cache.lighttransform.data(), cache.numbones * sizeof((*m_plighttransform)[0]));
 
-			s = (m_pCurrentEntity->latched.prevseqblending[0]) / 255.0;
-			StudioSlerpBones(q1b, pos1b, q2, pos2, s);
+	++g_BoneCacheStats.transformHits;
 
-			if (pseqdesc->numblends == 4)
-			{
-				panim += m_pStudioHeader->numbones;
-				StudioCalcRotations(pos3, q3, pseqdesc, panim, m_pCurrentEntity->latched.prevframe);
+	return true;
+}
 
-				panim += m_pStudioHeader->numbones;
-				StudioCalcRotations(pos4, q4, pseqdesc, panim, m_pCurrentEntity->latched.prevframe);
+/*
+====================
+StudioStoreBoneTransforms
 
-				s = (m_pCurrentEntity->latched.prevseqblending[0]) / 255.0;
-				StudioSlerpBones(q3, pos3, q4, pos4, s);
+====================
+*/
+void CStudioModelRenderer::StudioStoreBoneTransforms(bone_cache_t& cache)
+{
+	cache.transformsValid = true;
+	cache.hardware = 0 != IEngineStudio.IsHardware();
+	cache.renderfx = m_pCurrentEntity->curstate.renderfx;
+	memcpy(cache.rotationmatrix, *m_protationmatrix, sizeof(cache.rotationmatrix));
+	memcpy(cache.aliastransform, *m_paliastransform, sizeof(cache.aliastransform));
+
+	cache.bonetransform.assign(&(*m_pbonetransform)[0][0][0], &(*m_pbonetransform)[0][0][0] + cache.numbones * 12);
+	cache.lighttransform.assign(&(*m_plighttransform)[0][0][0], &(*m_plighttransform)[0][0][0] + cache.numbones * 12);
+}
 
-				s = (m_pCurrentEntity->latched.prevseqblending[1]) / 255.0;
-				StudioSlerpBones(q1b, pos1b, q3, pos3, s);
-			}
+/*
+====================
+StudioQueueEntity
+
+====================
+*/
+void CStudioModelRenderer::StudioQueueEntity(cl_entity_t* entity)
+{
+	if (!m_pCvarParallelBones || 0 == m_pCvarParallelBones->value || 0 == m_pCvarBoneCache->value)
+		return;
+
+	if (!entity->model || entity->model->type != mod_studio)
+		return;
+
+	if (m_BoneSetupQueue.size() < BONESETUP_MAX_QUEUED)
+	{
+		m_BoneSetupQueue.push_back(entity);
+	}
+}
+
+/*
+====================
+StudioSetupBonesParallel
+
+====================
+*/
+void CStudioModelRenderer::StudioSetupBonesParallel()
+{
+	m_nBoneSetupFrame = m_nFrameCount;
+
+	if (m_BoneSetupQueue.empty())
+		return;
+
+	// An entity is added once per client frame, but there can be several between two rendered frames
+	std::sort(m_BoneSetupQueue.begin(), m_BoneSetupQueue.end());
+	m_BoneSetupQueue.erase(std::unique(m_BoneSetupQueue.begin(), m_BoneSetupQueue.end()), m_BoneSetupQueue.end());
+
+	if (0 == m_pCvarParallelBones->value || 0 == m_pCvarBoneCache->value)
+	{
+		m_BoneSetupQueue.clear();
+		return;
+	}
+
+	// Everything that needs the engine is done here, on the render thread
+	m_BoneSetupJobs.resize(m_BoneSetupQueue.size());
+
+	std::size_t count = 0;
+
+	for (auto entity : m_BoneSetupQueue)
+	{
+		if (StudioCreatePrepareJob(entity, m_BoneSetupJobs[count]))
+		{
+			++count;
 		}
+	}
 
-		s = 1.0 - (m_clTime - m_pCurrentEntity->latched.sequencetime) / 0.2;
-		StudioSlerpBones(q, pos, q1b, pos1b, s);
+	m_BoneSetupQueue.clear();
+
+	if (0 == count)
+		return;
+
+	g_JobSystem.StartWorkers();
+
+	while (static_cast<int>(m_BoneSetupWorkers.size()) < g_JobSystem.GetThreadCount())
+	{
+		m_BoneSetupWorkers.emplace_back(StudioCreateWorker());
+	}
+
+	for (auto& worker : m_BoneSetupWorkers)
+	{
+		worker->m_clTime = m_clTime;
+		worker->m_clOldTime = m_clOldTime;
+		worker->m_nFrameCount = m_nFrameCount;
+		worker->m_fDoInterp = m_fDoInterp;
+		worker->m_fGaitEstimation = m_fGaitEstimation;
+		worker->m_pCvarHiModels = m_pCvarHiModels;
+		worker->m_pCvarDeveloper = m_pCvarDeveloper;
+		worker->m_pCvarDrawEntities = m_pCvarDrawEntities;
+		worker->m_pCvarBoneCache = m_pCvarBoneCache;
+		worker->m_pCvarAnimCache = m_pCvarAnimCache;
+		worker->m_pCvarParallelBones = m_pCvarParallelBones;
+		worker->m_pCvarSIMD = m_pCvarSIMD;
+		worker->m_pCvarAnimLODControllers = m_pCvarAnimLODControllers;
+		// Only the render thread resizes the animation cache
+		worker->m_nAnimCacheFrame = m_nFrameCount;
+	}
+
+	StudioUpdateAnimCache();
+	g_StudioAnimCache.SetEvictionPaused(true);
+
+	g_JobSystem.ParallelFor(static_cast<int>(count), [this](int index, int thread)
+		{ m_BoneSetupWorkers[thread]->StudioPrepareBones(m_BoneSetupJobs[index]); });
+
+	g_StudioAnimCache.SetEvictionPaused(false);
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (m_BoneSetupJobs[i].prepared)
+			++g_BoneCacheStats.prepared;
+	}
+}
+
+/*
+====================
+StudioCreatePrepareJob
+
+====================
+*/
+bool CStudioModelRenderer::StudioCreatePrepareJob(cl_entity_t* entity, bone_prepare_job_t& job)
+{
+	if (!entity->model || entity->model->type != mod_studio || entity->curstate.renderfx == kRenderFxDeadPlayer)
+		return false;
+
+	job.original = entity;
+	job.entity = *entity;
+	job.merge = false;
+	job.player = 0 != entity->player;
+	job.prepared = false;
+
+	if (job.player)
+	{
+		const int playerIndex = entity->index - 1;
+
+		if (playerIndex < 0 || playerIndex >= gEngfuncs.GetMaxClients())
+			return false;
+
+		job.playerState = *IEngineStudio.GetPlayerState(playerIndex);
+		job.playerInfo = *IEngineStudio.PlayerInfo(playerIndex);
+		job.model = IEngineStudio.SetupPlayerModel(playerIndex);
 	}
 	else
 	{
-		//Con_DPrintf("prevframe = %4.2f\n", f);
-		m_pCurrentEntity->latched.prevframe = f;
+		job.merge = entity->curstate.movetype == MOVETYPE_FOLLOW;
+		job.model = entity->model;
 	}
 
-	pbones = (mstudiobone_t*)((byte*)m_pStudioHeader + m_pStudioHeader->boneindex);
+	if (!job.model)
+		return false;
+
+	job.header = (studiohdr_t*)IEngineStudio.Mod_Extradata(job.model);
+
+	if (!job.header || job.header->numbones <= 0 || job.header->numbones > MAXSTUDIOBONES || job.header->numseq <= 0)
+		return false;
+
+	// Doesn't use the bone cache
+	if (!job.merge && StudioCalcAnimLOD(entity, job.header) != ANIMLOD_FULL)
+		return false;
+
+	// Sequence groups other than the first are loaded by the engine
+	const auto pseqdesc = (mstudioseqdesc_t*)((byte*)job.header + job.header->seqindex);
+
+	const int sequence = entity->curstate.sequence < job.header->numseq ? entity->curstate.sequence : 0;
+	const int prevsequence = entity->latched.prevsequence;
+	const int gaitsequence = job.player && job.playerState.gaitsequence < job.header->numseq ? job.playerState.gaitsequence : 0;
+
+	if (sequence < 0 || prevsequence < 0 || gaitsequence < 0)
+		return false;
+
+	if (0 != pseqdesc[sequence].seqgroup ||
+		(prevsequence < job.header->numseq && 0 != pseqdesc[prevsequence].seqgroup) ||
+		0 != pseqdesc[gaitsequence].seqgroup)
+		return false;
+
+	job.cache = &m_BoneCache[{entity, job.model, job.merge}];
+	job.cache->lastFrame = m_nFrameCount;
+
+	return true;
+}
+
+/*
+====================
+StudioPrepareBones
+
+====================
+*/
+void CStudioModelRenderer::StudioPrepareBones(bone_prepare_job_t& job)
+{
+	float pos[MAXSTUDIOBONES][3];
+	vec4_t q[MAXSTUDIOBONES];
+
+	m_pCurrentEntity = &job.entity;
+	m_pRenderModel = job.model;
+	m_pStudioHeader = job.header;
+	m_pPlayerInfo = NULL;
+
+	if (job.player)
+	{
+		m_nPlayerIndex = job.original->index - 1;
+		m_pPlayerInfo = &job.playerInfo;
+
+		StudioAnimatePlayer(&job.playerState);
+	}
+
+	if (m_pCurrentEntity->curstate.sequence >= m_pStudioHeader->numseq)
+	{
+		m_pCurrentEntity->curstate.sequence = 0;
+	}
+
+	mstudioseqdesc_t* pseqdesc = (mstudioseqdesc_t*)((byte*)m_pStudioHeader + m_pStudioHeader->seqindex) + m_pCurrentEntity->curstate.sequence;
+
+	const double f = StudioEstimateFrame(pseqdesc);
+	const bool blendPrevSequence = !job.merge && StudioShouldBlendPrevSequence();
 
-	// bounds checking
 	if (m_pPlayerInfo)
 	{
 		if (m_pPlayerInfo->gaitsequence >= m_pStudioHeader->numseq)
@@ -923,14 +1401,284 @@ void CStudioModelRenderer::StudioSetupBones()
 		}
 	}
 
-	// calc gait animation
-	if (m_pPlayerInfo && m_pPlayerInfo->gaitsequence != 0)
+	// Same key StudioSetupBones or StudioMergeBones is going to look for
+	bone_cache_key_t key;
+	StudioBoneCacheKey(key, f, job.merge, blendPrevSequence);
+
+	bone_cache_t& cache = *job.cache;
+
+	if (!cache.valid || cache.numbones != m_pStudioHeader->numbones || 0 != memcmp(&cache.key, &key, sizeof(key)))
 	{
-		if (m_pPlayerInfo->gaitsequence >= m_pStudioHeader->numseq)
+		if (job.merge)
 		{
-			m_pPlayerInfo->gaitsequence = 0;
+			StudioCalcRotations(pos, q, pseqdesc, StudioGetAnim(m_pRenderModel, pseqdesc), f);
 		}
+		else
+		{
+			StudioCalcPose(pseqdesc, f, blendPrevSequence, pos, q);
+		}
+
+		StudioStoreBoneCache(cache, key, pos, q);
+
+		job.prepared = true;
+	}
+
+	m_pCurrentEntity = NULL;
+	m_pPlayerInfo = NULL;
+}
+
+/*
+====================
+StudioCreateWorker
+
+====================
+*/
+CStudioModelRenderer* CStudioModelRenderer::StudioCreateWorker()
+{
+	return new CStudioModelRenderer();
+}
+
+/*
+====================
+StudioCalcAnimLOD
+
+====================
+*/
+int CStudioModelRenderer::StudioCalcAnimLOD(cl_entity_t* entity, studiohdr_t* header)
+{
+	if (0 == m_pCvarAnimLOD->value)
+		return ANIMLOD_FULL;
+
+	// Always close to the view
+	if (entity == gEngfuncs.GetViewModel() || entity == gEngfuncs.GetLocalPlayer())
+		return ANIMLOD_FULL;
+
+	const int sequence = entity->curstate.sequence >= 0 && entity->curstate.sequence < header->numseq ? entity->curstate.sequence : 0;
+	const auto pseqdesc = (mstudioseqdesc_t*)((byte*)header + header->seqindex) + sequence;
+
+	const float distance = (entity->origin - Vector(m_vRenderOrigin)).Length();
+
+	// Size of the sequence's bounding box on screen
+	const float fov = gHUD.m_iFOV > 0 ? gHUD.m_iFOV : 90;
+	const float viewWidth = 2 * distance * tan(fov * (M_PI / 360.0));
+	const float size = viewWidth > 1 ? (Vector(pseqdesc->bbmax) - Vector(pseqdesc->bbmin)).Length() * ScreenWidth / viewWidth : ScreenWidth;
+
+	if ((m_pCvarAnimLODDist2->value > 0 && distance >= m_pCvarAnimLODDist2->value) || size < m_pCvarAnimLODSize2->value)
+		return ANIMLOD_LOW;
+
+	if ((m_pCvarAnimLODDist1->value > 0 && distance >= m_pCvarAnimLODDist1->value) || size < m_pCvarAnimLODSize1->value)
+		return ANIMLOD_REDUCED;
+
+	return ANIMLOD_FULL;
+}
+
+/*
+====================
+StudioAnimLODPose
+
+====================
+*/
+void CStudioModelRenderer::StudioAnimLODPose(mstudioseqdesc_t* pseqdesc, double f, float pos[][3], vec4_t* q)
+{
+	if (m_nFrameCount - m_nAnimLODSweepFrame > BONECACHE_MAX_IDLE_FRAMES || m_nFrameCount < m_nAnimLODSweepFrame)
+	{
+		m_nAnimLODSweepFrame = m_nFrameCount;
+
+		for (auto it = m_AnimLOD.begin(); it != m_AnimLOD.end();)
+		{
+			if (m_nFrameCount - it->second.lastFrame > BONECACHE_MAX_IDLE_FRAMES || m_nFrameCount < it->second.lastFrame)
+				it = m_AnimLOD.erase(it);
+			else
+				++it;
+		}
+	}
+
+	anim_lod_t& lod = m_AnimLOD[m_pCurrentEntity];
+	lod.lastFrame = m_nFrameCount;
+
+	const int numbones = m_pStudioHeader->numbones;
+	const float rate = m_nAnimLOD == ANIMLOD_LOW ? m_pCvarAnimLODRate2->value : m_pCvarAnimLODRate1->value;
+	const double interval = 1.0 / V_max(1.0f, rate);
+	const double elapsed = m_clTime - lod.updateTime;
+
+	// Start over if the entity wasn't drawn at this level for a while, there is nothing to interpolate from
+	const bool reset = lod.model != m_pRenderModel || lod.numbones != numbones || elapsed < 0 || elapsed > interval * 2;
+
+	if (reset || elapsed >= interval)
+	{
+		StudioCalcPose(pseqdesc, f, false, pos, q);
+
+		if (reset)
+		{
+			lod.model = m_pRenderModel;
+			lod.numbones = numbones;
+			lod.prevPos.assign(pos[0], pos[0] + numbones * 3);
+			lod.prevQ.assign(q[0], q[0] + numbones * 4);
+		}
+		else
+		{
+			lod.prevPos.swap(lod.pos);
+			lod.prevQ.swap(lod.q);
+		}
+
+		lod.pos.assign(pos[0], pos[0] + numbones * 3);
+		lod.q.assign(q[0], q[0] + numbones * 4);
+		lod.updateTime = m_clTime;
+	}
+
+	// Drawn one pose behind, so there is always a pose to interpolate towards
+	memcpy(pos, lod.prevPos.data(), numbones * sizeof(pos[0]));
+	memcpy(q, lod.prevQ.data(), numbones * sizeof(q[0]));
+
+	StudioSlerpBones(q, pos, reinterpret_cast<vec4_t*>(lod.q.data()), reinterpret_cast<float(*)[3]>(lod.pos.data()), (m_clTime - lod.updateTime) / interval);
+}
+
+/*
+====================
+StudioDrawAnimLODOverlay
+
+====================
+*/
+void CStudioModelRenderer::StudioDrawAnimLODOverlay()
+{
+	if (m_pCvarAnimLODDebug && 0 != m_pCvarAnimLODDebug->value)
+	{
+		static const int colors[][3] = {{0, 255, 0}, {255, 255, 0}, {255, 64, 64}};
+
+		for (const auto& debug : m_AnimLODDebug)
+		{
+			char text[32];
+			snprintf(text, sizeof(text), "LOD %d (%.0f)", debug.level, debug.distance);
+
+			const auto& color = colors[debug.level];
+			gHUD.DrawHudString(static_cast<int>(debug.screen[0]), static_cast<int>(debug.screen[1]), ScreenWidth, text, color[0], color[1], color[2]);
+		}
+	}
+
+	m_AnimLODDebug.clear();
+}
+
+/*
+====================
+StudioShouldBlendPrevSequence
+
+====================
+*/
+bool CStudioModelRenderer::StudioShouldBlendPrevSequence()
+{
+	return m_fDoInterp &&
+		   0 != m_pCurrentEntity->latched.sequencetime &&
+		   (m_pCurrentEntity->latched.sequencetime + 0.2 > m_clTime) &&
+		   (m_pCurrentEntity->latched.prevsequence < m_pStudioHeader->numseq);
+}
+
+/*
+====================
+StudioCalcPose
+
+====================
+*/
+void CStudioModelRenderer::StudioCalcPose(mstudioseqdesc_t* pseqdesc, double f, bool blendPrevSequence, float pos[][3], vec4_t* q)
+{
+	int i;
+
+	mstudiobone_t* pbones;
+	mstudioanim_t* panim;
+
+	// Not static, bones of several entities can be set up at the same time
+	float pos2[MAXSTUDIOBONES][3];
+	vec4_t q2[MAXSTUDIOBONES];
+	float pos3[MAXSTUDIOBONES][3];
+	vec4_t q3[MAXSTUDIOBONES];
+	float pos4[MAXSTUDIOBONES][3];
+	vec4_t q4[MAXSTUDIOBONES];
+
+	panim = StudioGetAnim(m_pRenderModel, pseqdesc);
+
+	if (pseqdesc->numblends > 1 && m_nAnimLOD == ANIMLOD_LOW)
+	{
+		panim += StudioNearestBlend(pseqdesc) * m_pStudioHeader->numbones;
+		StudioCalcRotations(pos, q, pseqdesc, panim, f);
+	}
+	else
+	{
+		StudioCalcRotations(pos, q, pseqdesc, panim, f);
+	}
+
+	if (pseqdesc->numblends > 1 && m_nAnimLOD != ANIMLOD_LOW)
+	{
+		float s;
+		float dadt;
+
+		panim += m_pStudioHeader->numbones;
+		StudioCalcRotations(pos2, q2, pseqdesc, panim, f);
+
+		dadt = StudioEstimateInterpolant();
+		s = (m_pCurrentEntity->curstate.blending[0] * dadt + m_pCurrentEntity->latched.prevblending[0] * (1.0 - dadt)) / 255.0;
+
+		StudioSlerpBones(q, pos, q2, pos2, s);
 
+		if (pseqdesc->numblends == 4)
+		{
+			panim += m_pStudioHeader->numbones;
+			StudioCalcRotations(pos3, q3, pseqdesc, panim, f);
+
+			panim += m_pStudioHeader->numbones;
+			StudioCalcRotations(pos4, q4, pseqdesc, panim, f);
+
+			s = (m_pCurrentEntity->curstate.blending[0] * dadt + m_pCurrentEntity->latched.prevblending[0] * (1.0 - dadt)) / 255.0;
+			StudioSlerpBones(q3, pos3, q4, pos4, s);
+
+			s = (m_pCurrentEntity->curstate.blending[1] * dadt + m_pCurrentEntity->latched.prevblending[1] * (1.0 - dadt)) / 255.0;
+			StudioSlerpBones(q, pos, q3, pos3, s);
+		}
+	}
+
+	if (blendPrevSequence)
+	{
+		// blend from last sequence
+		float pos1b[MAXSTUDIOBONES][3];
+		vec4_t q1b[MAXSTUDIOBONES];
+		float s;
+
+		pseqdesc = (mstudioseqdesc_t*)((byte*)m_pStudioHeader + m_pStudioHeader->seqindex) + m_pCurrentEntity->latched.prevsequence;
+		panim = StudioGetAnim(m_pRenderModel, pseqdesc);
+		// clip prevframe
+		StudioCalcRotations(pos1b, q1b, pseqdesc, panim, m_pCurrentEntity->latched.prevframe);
+
+		if (pseqdesc->numblends > 1)
+		{
+			panim += m_pStudioHeader->numbones;
+			StudioCalcRotations(pos2, q2, pseqdesc, panim, m_pCurrentEntity->latched.prevframe);
+
+			s = (m_pCurrentEntity->latched.prevseqblending[0]) / 255.0;
+			StudioSlerpBones(q1b, pos1b, q2, pos2, s);
+
+			if (pseqdesc->numblends == 4)
+			{
+				panim += m_pStudioHeader->numbones;
+				StudioCalcRotations(pos3, q3, pseqdesc, panim, m_pCurrentEntity->latched.prevframe);
+
+				panim += m_pStudioHeader->numbones;
+				StudioCalcRotations(pos4, q4, pseqdesc, panim, m_pCurrentEntity->latched.prevframe);
+
+				s = (m_pCurrentEntity->latched.prevseqblending[0]) / 255.0;
+				StudioSlerpBones(q3, pos3, q4, pos4, s);
+
+				s = (m_pCurrentEntity->latched.prevseqblending[1]) / 255.0;
+				StudioSlerpBones(q1b, pos1b, q3, pos3, s);
+			}
+		}
+
+		s = 1.0 - (m_clTime - m_pCurrentEntity->latched.sequencetime) / 0.2;
+		StudioSlerpBones(q, pos, q1b, pos1b, s);
+	}
+
+	pbones = (mstudiobone_t*)((byte*)m_pStudioHeader + m_pStudioHeader->boneindex);
+
+	// calc gait animation
+	if (m_pPlayerInfo && m_pPlayerInfo->gaitsequence != 0 && m_nAnimLOD != ANIMLOD_LOW)
+	{
 		bool copy = true;
 
 		pseqdesc = (mstudioseqdesc_t*)((byte*)m_pStudioHeader + m_pStudioHeader->seqindex) + m_pPlayerInfo->gaitsequence;
@@ -960,22 +1708,153 @@ void CStudioModelRenderer::StudioSetupBones()
 			}
 		}
 	}
+}
+
+/*
+====================
+StudioSetupBones
+
+====================
+*/
+void CStudioModelRenderer::StudioSetupBones()
+{
+	int i;
+	double f;
+
+	mstudiobone_t* pbones;
+	mstudioseqdesc_t* pseqdesc;
+
+	static float pos[MAXSTUDIOBONES][3];
+	static vec4_t q[MAXSTUDIOBONES];
+	float bonematrices[MAXSTUDIOBONES][3][4];
+
+	if (m_pCurrentEntity->curstate.sequence >= m_pStudioHeader->numseq)
+	{
+		m_pCurrentEntity->curstate.sequence = 0;
+	}
+
+	pseqdesc = (mstudioseqdesc_t*)((byte*)m_pStudioHeader + m_pStudioHeader->seqindex) + m_pCurrentEntity->curstate.sequence;
+
+	// always want new gait sequences to start on frame zero
+	/*	if ( m_pPlayerInfo )
+	{
+		int playerNum = m_pCurrentEntity->index - 1;
+
+		// new jump gaitsequence?  start from frame zero
+		if ( m_nPlayerGaitSequences[ playerNum ] != m_pPlayerInfo->gaitsequence )
+		{
+	//		m_pPlayerInfo->gaitframe = 0.0;
+			gEngfuncs.Con_Printf( "Setting gaitframe to 0\n" );
+		}
+
+		m_nPlayerGaitSequences[ playerNum ] = m_pPlayerInfo->gaitsequence;
+//		gEngfuncs.Con_Printf( "index: %d     gaitsequence: %d\n",playerNum, m_pPlayerInfo->gaitsequence);
+	}
+*/
+	f = StudioEstimateFrame(pseqdesc);
+
+	if (m_pCurrentEntity->latched.prevframe > f)
+	{
+		//Con_DPrintf("%f %f\n", m_pCurrentEntity->prevframe, f );
+	}
+
+	m_nAnimLOD = StudioCalcAnimLOD(m_pCurrentEntity, m_pStudioHeader);
+
+	const bool blendPrevSequence = m_nAnimLOD == ANIMLOD_FULL && StudioShouldBlendPrevSequence();
+
+	// bounds checking
+	if (m_pPlayerInfo)
+	{
+		if (m_pPlayerInfo->gaitsequence >= m_pStudioHeader->numseq)
+		{
+			m_pPlayerInfo->gaitsequence = 0;
+		}
+	}
+
+	if (0 != m_pCvarAnimLODDebug->value)
+	{
+		Vector top = m_pCurrentEntity->origin;
+		top.z += pseqdesc->bbmax[2];
+
+		anim_lod_debug_t debug;
+		Vector screen;
+
+		if (0 == gEngfuncs.pTriAPI->WorldToScreen(top, screen))
+		{
+			debug.screen[0] = XPROJECT(screen[0]);
+			debug.screen[1] = YPROJECT(screen[1]);
+			debug.level = m_nAnimLOD;
+			debug.distance = (m_pCurrentEntity->origin - Vector(m_vRenderOrigin)).Length();
+
+			m_AnimLODDebug.push_back(debug);
+		}
+	}
+
+	bone_cache_key_t key;
+	bone_cache_t* cache = nullptr;
+	bool cached = false;
+
+	if (m_nAnimLOD != ANIMLOD_FULL)
+	{
+		// Changes every frame, and doesn't need caching as much
+		StudioAnimLODPose(pseqdesc, f, pos, q);
+	}
+	else
+	{
+		if (0 != m_pCvarBoneCache->value)
+		{
+			StudioBoneCacheKey(key, f, false, blendPrevSequence);
+
+			cached = StudioCheckBoneCache(key, cache);
+
+			if (cached)
+			{
+				StudioLoadBoneCache(*cache, pos, q);
+			}
+		}
+
+		if (!cached)
+		{
+			StudioCalcPose(pseqdesc, f, blendPrevSequence, pos, q);
+		}
+	}
+
+	m_nAnimLOD = ANIMLOD_FULL;
+
+	if (!blendPrevSequence)
+	{
+		//Con_DPrintf("prevframe = %4.2f\n", f);
+		m_pCurrentEntity->latched.prevframe = f;
+	}
+
+	pbones = (mstudiobone_t*)((byte*)m_pStudioHeader + m_pStudioHeader->boneindex);
+
+	if (cache)
+	{
+		if (!cached)
+		{
+			StudioStoreBoneCache(*cache, key, pos, q);
+		}
+		else if (StudioLoadBoneTransforms(*cache))
+		{
+			return;
+		}
+	}
+
+	// Bone matrices don't depend on each other, the transforms depend on the parent's
+	BoneMatrices(q, pos, bonematrices, m_pStudioHeader->numbones);
 
 	for (i = 0; i < m_pStudioHeader->numbones; i++)
 	{
 		const int parent = pbones[i].parent;
 
-		QuaternionMatrix(q[i], bonematrix);
-
-		bonematrix[0][3] = pos[i][0];
-		bonematrix[1][3] = pos[i][1];
-		bonematrix[2][3] = pos[i][2];
+		float(*bonematrix)[4] = bonematrices[i];
 
 		if (parent == -1)
 		{
 			if (0 != IEngineStudio.IsHardware())
 			{
-				ConcatTransforms((*m_protationmatrix), bonematrix, (*m_pbonetransform)[i]);
+				ConcatBoneTransforms((*m_protationmatrix), bonematrix, (*m_pbonetransform)[i]);
 
 				// MatrixCopy should be faster...
 				//ConcatTransforms ((*m_protationmatrix), bonematrix, (*m_plighttransform)[i]);
@@ -983,8 +1862,8 @@ void CStudioModelRenderer::StudioSetupBones()
 			}
 			else
 			{
-				ConcatTransforms((*m_paliastransform), bonematrix, (*m_pbonetransform)[i]);
-				ConcatTransforms((*m_protationmatrix), bonematrix, (*m_plighttransform)[i]);
+				ConcatBoneTransforms((*m_paliastransform), bonematrix, (*m_pbonetransform)[i]);
+				ConcatBoneTransforms((*m_protationmatrix), bonematrix, (*m_plighttransform)[i]);
 			}
 
 			// Apply client-side effects to the transformation matrix
@@ -992,12 +1871,16 @@ void CStudioModelRenderer::StudioSetupBones()
 		}
 		else if (parent >= 0 && parent < m_pStudioHeader->numbones)
 		{
-			ConcatTransforms((*m_pbonetransform)[parent], bonematrix, (*m_pbonetransform)[i]);
-			ConcatTransforms((*m_plighttransform)[parent], bonematrix, (*m_plighttransform)[i]);
+			ConcatBoneTransforms((*m_pbonetransform)[parent], bonematrix, (*m_pbonetransform)[i]);
+			ConcatBoneTransforms((*m_plighttransform)[parent], bonematrix, (*m_plighttransform)[i]);
 		}
 	}
-}
 
+	if (cache)
+	{
+		StudioStoreBoneTransforms(*cache);
+	}
+}
 
 /*
 ====================
@@ -1056,8 +1939,29 @@ void CStudioModelRenderer::StudioMergeBones(model_t* m_pSubModel)
 		//Con_DPrintf("%f %f\n", m_pCurrentEntity->prevframe, f );
 	}
 
-	panim = StudioGetAnim(m_pSubModel, pseqdesc);
-	StudioCalcRotations(pos, q, pseqdesc, panim, f);
+	bone_cache_key_t key;
+	bone_cache_t* cache = nullptr;
+
+	if (0 != m_pCvarBoneCache->value)
+	{
+		StudioBoneCacheKey(key, f, true, false);
+		key.model = m_pSubModel;
+	}
+
+	if (0 != m_pCvarBoneCache->value && StudioCheckBoneCache(key, cache))
+	{
+		StudioLoadBoneCache(*cache, pos, q);
+	}
+	else
+	{
+		panim = StudioGetAnim(m_pSubModel, pseqdesc);
+		StudioCalcRotations(pos, q, pseqdesc, panim, f);
+
+		if (cache)
+		{
+			StudioStoreBoneCache(*cache, key, pos, q);
+		}
+	}
 
 	pbones = (mstudiobone_t*)((byte*)m_pStudioHeader + m_pStudioHeader->boneindex);
 
@@ -1085,7 +1989,7 @@ void CStudioModelRenderer::StudioMergeBones(model_t* m_pSubModel)
 			{
 				if (0 != IEngineStudio.IsHardware())
 				{
-					ConcatTransforms((*m_protationmatrix), bonematrix, (*m_pbonetransform)[i]);
+					ConcatBoneTransforms((*m_protationmatrix), bonematrix, (*m_pbonetransform)[i]);
 
 					// MatrixCopy should be faster...
 					//ConcatTransforms ((*m_protationmatrix), bonematrix, (*m_plighttransform)[i]);
@@ -1093,8 +1997,8 @@ void CStudioModelRenderer::StudioMergeBones(model_t* m_pSubModel)
 				}
 				else
 				{
-					ConcatTransforms((*m_paliastransform), bonematrix, (*m_pbonetransform)[i]);
-					ConcatTransforms((*m_protationmatrix), bonematrix, (*m_plighttransform)[i]);
+					ConcatBoneTransforms((*m_paliastransform), bonematrix, (*m_pbonetransform)[i]);
+					ConcatBoneTransforms((*m_protationmatrix), bonematrix, (*m_plighttransform)[i]);
 				}
 
 				// Apply client-side effects to the transformation matrix
@@ -1102,8 +2006,8 @@ void CStudioModelRenderer::StudioMergeBones(model_t* m_pSubModel)
 			}
 			else
 			{
-				ConcatTransforms((*m_pbonetransform)[pbones[i].parent], bonematrix, (*m_pbonetransform)[i]);
-				ConcatTransforms((*m_plighttransform)[pbones[i].parent], bonematrix, (*m_plighttransform)[i]);
+				ConcatBoneTransforms((*m_pbonetransform)[pbones[i].parent], bonematrix, (*m_pbonetransform)[i]);
+				ConcatBoneTransforms((*m_plighttransform)[pbones[i].parent], bonematrix, (*m_plighttransform)[i]);
 			}
 		}
 	}
@@ -1126,6 +2030,12 @@ bool CStudioModelRenderer::StudioDrawModel(int flags)
 	IEngineStudio.GetViewInfo(m_vRenderOrigin, m_vUp, m_vRight, m_vNormal);
 	IEngineStudio.GetAliasScale(&m_fSoftwareXScale, &m_fSoftwareYScale);
 
+	if (m_nBoneSetupFrame != m_nFrameCount)
+	{
+		SetStudioSIMDMode(static_cast<int>(m_pCvarSIMD->value));
+		StudioSetupBonesParallel();
+	}
+
 	if (m_pCurrentEntity->curstate.renderfx == kRenderFxDeadPlayer)
 	{
 		entity_state_t deadplayer;
@@ -1397,6 +2307,35 @@ void CStudioModelRenderer::StudioProcessGait(entity_state_t* pplayer)
 
 
 
+/*
+====================
+StudioAnimatePlayer
+
+====================
+*/
+void CStudioModelRenderer::StudioAnimatePlayer(entity_state_t* pplayer)
+{
+	if (0 != pplayer->gaitsequence)
+	{
+		StudioProcessGait(pplayer);
+
+		m_pPlayerInfo->gaitsequence = pplayer->gaitsequence;
+	}
+	else
+	{
+		m_pCurrentEntity->curstate.controller[0] = 127;
+		m_pCurrentEntity->curstate.controller[1] = 127;
+		m_pCurrentEntity->curstate.controller[2] = 127;
+		m_pCurrentEntity->curstate.controller[3] = 127;
+		m_pCurrentEntity->latched.prevcontroller[0] = m_pCurrentEntity->curstate.controller[0];
+		m_pCurrentEntity->latched.prevcontroller[1] = m_pCurrentEntity->curstate.controller[1];
+		m_pCurrentEntity->latched.prevcontroller[2] = m_pCurrentEntity->curstate.controller[2];
+		m_pCurrentEntity->latched.prevcontroller[3] = m_pCurrentEntity->curstate.controller[3];
+
+		m_pPlayerInfo->gaitsequence = 0;
+	}
+}
+
 /*
 ====================
 StudioDrawPlayer
@@ -1413,6 +2352,12 @@ bool CStudioModelRenderer::StudioDrawPlayer(int flags, entity_state_t* pplayer)
 	IEngineStudio.GetViewInfo(m_vRenderOrigin, m_vUp, m_vRight, m_vNormal);
 	IEngineStudio.GetAliasScale(&m_fSoftwareXScale, &m_fSoftwareYScale);
 
+	if (m_nBoneSetupFrame != m_nFrameCount)
+	{
+		SetStudioSIMDMode(static_cast<int>(m_pCvarSIMD->value));
+		StudioSetupBonesParallel();
+	}
+
 	m_nPlayerIndex = pplayer->number - 1;
 
 	if (m_nPlayerIndex < 0 || m_nPlayerIndex >= gEngfuncs.GetMaxClients())
@@ -1429,37 +2374,15 @@ bool CStudioModelRenderer::StudioDrawPlayer(int flags, entity_state_t* pplayer)
 	IEngineStudio.StudioSetHeader(m_pStudioHeader);
 	IEngineStudio.SetRenderModel(m_pRenderModel);
 
-	if (0 != pplayer->gaitsequence)
-	{
-		Vector orig_angles;
-		m_pPlayerInfo = IEngineStudio.PlayerInfo(m_nPlayerIndex);
-
-		VectorCopy(m_pCurrentEntity->angles, orig_angles);
-
-		StudioProcessGait(pplayer);
+	Vector orig_angles;
+	VectorCopy(m_pCurrentEntity->angles, orig_angles);
 
-		m_pPlayerInfo->gaitsequence = pplayer->gaitsequence;
-		m_pPlayerInfo = NULL;
-
-		StudioSetUpTransform(false);
-		VectorCopy(orig_angles, m_pCurrentEntity->angles);
-	}
-	else
-	{
-		m_pCurrentEntity->curstate.controller[0] = 127;
-		m_pCurrentEntity->curstate.controller[1] = 127;
-		m_pCurrentEntity->curstate.controller[2] = 127;
-		m_pCurrentEntity->curstate.controller[3] = 127;
-		m_pCurrentEntity->latched.prevcontroller[0] = m_pCurrentEntity->curstate.controller[0];
-		m_pCurrentEntity->latched.prevcontroller[1] = m_pCurrentEntity->curstate.controller[1];
-		m_pCurrentEntity->latched.prevcontroller[2] = m_pCurrentEntity->curstate.controller[2];
-		m_pCurrentEntity->latched.prevcontroller[3] = m_pCurrentEntity->curstate.controller[3];
-
-		m_pPlayerInfo = IEngineStudio.PlayerInfo(m_nPlayerIndex);
-		m_pPlayerInfo->gaitsequence = 0;
+	m_pPlayerInfo = IEngineStudio.PlayerInfo(m_nPlayerIndex);
+	StudioAnimatePlayer(pplayer);
+	m_pPlayerInfo = NULL;
 
-		StudioSetUpTransform(false);
-	}
+	StudioSetUpTransform(false);
+	VectorCopy(orig_angles, m_pCurrentEntity->angles);
 
 	if ((flags & STUDIO_RENDER) != 0)
 	{
@@ -7,6 +7,140 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "studio_animcache.h"
+
+/**
+*	@brief Everything the local bone rotations and positions of an entity are computed from.
+*	Compared bit for bit, unused fields are zero.
+*/
+struct bone_cache_key_t
+{
+	model_t* model;
+	bool merge; // Set up by StudioMergeBones, which doesn't blend
+	bool doInterp;
+	int sequence;
+	double frame;
+	float dadt;
+	byte controller[4];
+	byte prevcontroller[4];
+	byte mouthopen;
+	byte blending[2];
+	byte prevblending[2];
+
+	// Blend from the previous sequence
+	int prevsequence;
+	float prevframe;
+	byte prevseqblending[2];
+	float prevsequenceweight;
+
+	// Player gait
+	int gaitsequence;
+	float gaitframe;
+};
+
+/**
+*	@brief Bones of an entity from the last time it was set up.
+*	The bone and light transforms are reused as well when the entity's transform hasn't changed either.
+*/
+struct bone_cache_t
+{
+	bone_cache_key_t key;
+	bool valid = false;
+	int lastFrame = 0;
+	int numbones = 0;
+
+	std::vector<float> pos; // numbones * 3
+	std::vector<float> q;	// numbones * 4
+
+	bool transformsValid = false;
+	bool hardware = false;
+	int renderfx = 0;
+	float rotationmatrix[3][4];
+	float aliastransform[3][4];
+	std::vector<float> bonetransform;  // numbones * 12
+	std::vector<float> lighttransform; // numbones * 12
+};
+
+/**
+*	@brief Bone cache slot of a model drawn for an entity.
+*	A player's weapon model is merged onto the player entity, so it needs a slot of its own.
+*/
+struct bone_cache_slot_t
+{
+	const cl_entity_t* entity;
+	const model_t* model;
+	bool merge;
+
+	bool operator==(const bone_cache_slot_t& other) const
+	{
+		return entity == other.entity && model == other.model && merge == other.merge;
+	}
+};
+
+struct bone_cache_slot_hash_t
+{
+	std::size_t operator()(const bone_cache_slot_t& slot) const
+	{
+		return std::hash<const void*>()(slot.entity) ^ (std::hash<const void*>()(slot.model) << 1) ^ static_cast<std::size_t>(slot.merge);
+	}
+};
+
+// Animation level of detail, see StudioCalcAnimLOD
+enum
+{
+	ANIMLOD_FULL = 0,
+	ANIMLOD_REDUCED, // Lower update rate, no blending from the previous sequence
+	ANIMLOD_LOW,	 // Lowest update rate, closest sequence blend only, no gait layer, optionally no controllers
+};
+
+/**
+*	@brief Pose of an entity drawn at a reduced animation level of detail.
+*	The pose is set up at a fixed rate, and drawn interpolated between the last two.
+*/
+struct anim_lod_t
+{
+	int lastFrame = 0;
+	model_t* model = nullptr;
+	int numbones = 0;
+	double updateTime = 0;
+
+	std::vector<float> pos;		// numbones * 3
+	std::vector<float> q;		// numbones * 4
+	std::vector<float> prevPos; // Pose before the last one
+	std::vector<float> prevQ;
+};
+
+struct anim_lod_debug_t
+{
+	float screen[2];
+	int level;
+	float distance;
+};
+
+/**
+*	@brief An entity whose bones are set up on the job system before drawing starts.
+*	Works on copies, bone setup changes the entity and player info the same way drawing it will.
+*/
+struct bone_prepare_job_t
+{
+	cl_entity_t* original;
+	cl_entity_t entity;
+	model_t* model;
+	studiohdr_t* header;
+	bool merge; // Drawn with StudioMergeBones
+
+	bool player;
+	entity_state_t playerState;
+	player_info_t playerInfo;
+
+	bone_cache_t* cache;
+	bool prepared; // Bones were set up, not already up to date
+};
+
 /*
 ====================
 CStudioModelRenderer
@@ -68,12 +202,60 @@ public:
 	// Get bone quaternions
 	virtual void StudioCalcBoneQuaterion(int frame, float s, mstudiobone_t* pbone, mstudioanim_t* panim, float* adj, float* q);
 
+	// Get the sequence blend closest to the entity's blending values
+	int StudioNearestBlend(mstudioseqdesc_t* pseqdesc);
+
+	// Get the bone angles StudioCalcBoneQuaterion interpolates between
+	void StudioCalcBoneAngles(int frame, mstudiobone_t* pbone, mstudioanim_t* panim, float* adj, float* angle1, float* angle2);
+
 	// Get bone positions
 	virtual void StudioCalcBonePosition(int frame, float s, mstudiobone_t* pbone, mstudioanim_t* panim, float* adj, float* pos);
 
 	// Compute rotations
 	virtual void StudioCalcRotations(float pos[][3], vec4_t* q, mstudioseqdesc_t* pseqdesc, mstudioanim_t* panim, float f);
 
+	// Whether the current entity is still blending out of its previous sequence
+	bool StudioShouldBlendPrevSequence();
+
+	// Compute rotations and positions of all bones, blended and with player gait, for the current entity
+	void StudioCalcPose(mstudioseqdesc_t* pseqdesc, double f, bool blendPrevSequence, float pos[][3], vec4_t* q);
+
+	// Animation cache
+	// Applies r_animcache_kb, once per frame
+	void StudioUpdateAnimCache();
+
+	// Bone cache
+	// Fills in the inputs the current entity's bones are computed from
+	void StudioBoneCacheKey(bone_cache_key_t& key, double f, bool merge, bool blendPrevSequence);
+	// Looks up the cache entry of the current entity, returns whether its bones were set up from the same key
+	bool StudioCheckBoneCache(const bone_cache_key_t& key, bone_cache_t*& cache);
+	// Copies cached bone rotations and positions, or stores new ones
+	void StudioLoadBoneCache(const bone_cache_t& cache, float pos[][3], vec4_t* q);
+	void StudioStoreBoneCache(bone_cache_t& cache, const bone_cache_key_t& key, float pos[][3], vec4_t* q);
+	// Reuses the cached bone and light transforms if the entity's transform is the same, returns whether it did
+	bool StudioLoadBoneTransforms(bone_cache_t& cache);
+	void StudioStoreBoneTransforms(bone_cache_t& cache);
+
+	// Parallel bone setup
+	// Remembers an entity the engine is going to draw, so its bones can be set up before drawing starts
+	void StudioQueueEntity(cl_entity_t* entity);
+	// Sets up the bones of all queued entities on the job system and stores them in the bone cache, from the first draw of a frame
+	void StudioSetupBonesParallel();
+	// Returns whether the job's bones can be set up without the engine, filling in the rest of it
+	bool StudioCreatePrepareJob(cl_entity_t* entity, bone_prepare_job_t& job);
+	// Sets up the bones of a job on a worker renderer
+	void StudioPrepareBones(bone_prepare_job_t& job);
+	// Creates a renderer to set up bones on a job system thread
+	virtual CStudioModelRenderer* StudioCreateWorker();
+
+	// Animation level of detail
+	// Returns the level of detail an entity is animated at
+	int StudioCalcAnimLOD(cl_entity_t* entity, studiohdr_t* header);
+	// Sets up the current entity's pose at a reduced rate, interpolating in between
+	void StudioAnimLODPose(mstudioseqdesc_t* pseqdesc, double f, float pos[][3], vec4_t* q);
+	// Draws the level of detail of the entities drawn last frame, from the HUD
+	void StudioDrawAnimLODOverlay();
+
 	// Send bones and verts to renderer
 	virtual void StudioRenderModel();
 
@@ -94,6 +276,9 @@ public:
 	// Process movement of player
 	virtual void StudioProcessGait(entity_state_t* pplayer);
 
+	// Set up gait or fixed controllers for player
+	virtual void StudioAnimatePlayer(entity_state_t* pplayer);
+
 public:
 	// Client clock
 	double m_clTime;
@@ -116,6 +301,28 @@ public:
 	cvar_t* m_pCvarDeveloper;
 	// Draw entities bone hit boxes, etc?
 	cvar_t* m_pCvarDrawEntities;
+	// Reuse bones of entities whose animation state hasn't changed?
+	cvar_t* m_pCvarBoneCache;
+	// Memory limit of decoded animations, 0 reads them directly
+	cvar_t* m_pCvarAnimCache;
+	// Set up bones of all entities on several threads before drawing?
+	cvar_t* m_pCvarParallelBones;
+	// Use SSE2 for bone quaternions and matrices? 2 also compares them with the scalar code
+	cvar_t* m_pCvarSIMD;
+	// Animate distant and small entities at a lower level of detail?
+	cvar_t* m_pCvarAnimLOD;
+	// Distances and sizes on screen, in pixels, of the reduced and low levels of detail
+	cvar_t* m_pCvarAnimLODDist1;
+	cvar_t* m_pCvarAnimLODDist2;
+	cvar_t* m_pCvarAnimLODSize1;
+	cvar_t* m_pCvarAnimLODSize2;
+	// Poses per second at the reduced and low levels of detail
+	cvar_t* m_pCvarAnimLODRate1;
+	cvar_t* m_pCvarAnimLODRate2;
+	// Apply bone controllers and mouth movement at the low level of detail?
+	cvar_t* m_pCvarAnimLODControllers;
+	// Show the level of detail of every entity?
+	cvar_t* m_pCvarAnimLODDebug;
 
 	// The entity which we are currently rendering.
 	cl_entity_t* m_pCurrentEntity;
@@ -156,6 +363,32 @@ public:
 	float m_rgCachedBoneTransform[MAXSTUDIOBONES][3][4];
 	float m_rgCachedLightTransform[MAXSTUDIOBONES][3][4];
 
+	// Bones of every entity and model drawn recently
+	std::unordered_map<bone_cache_slot_t, bone_cache_t, bone_cache_slot_hash_t> m_BoneCache;
+	// Frame the bone cache was last checked for entities that are no longer drawn
+	int m_nBoneCacheSweepFrame;
+
+	// Decoded animation of the bone StudioCalcRotations is computing, if cached
+	const studio_bonekeys_t* m_pBoneKeys;
+	// Frame the animation cache size was last updated
+	int m_nAnimCacheFrame;
+
+	// Entities added to the visible list since the last parallel bone setup
+	std::vector<cl_entity_t*> m_BoneSetupQueue;
+	std::vector<bone_prepare_job_t> m_BoneSetupJobs;
+	// Frame bones were last set up in parallel
+	int m_nBoneSetupFrame;
+	// One renderer per job system thread
+	std::vector<std::unique_ptr<CStudioModelRenderer>> m_BoneSetupWorkers;
+
+	// Animation level of detail of the entity being set up
+	int m_nAnimLOD;
+	// Poses of entities animated at a reduced level of detail
+	std::unordered_map<const cl_entity_t*, anim_lod_t> m_AnimLOD;
+	int m_nAnimLODSweepFrame;
+	// Entities drawn this frame, for r_animlod_debug
+	std::vector<anim_lod_debug_t> m_AnimLODDebug;
+
 	// Software renderer scale factors
 	float m_fSoftwareXScale, m_fSoftwareYScale;
 
@@ -133,8 +133,7 @@ bool HistoryResource::DrawAmmoHistory(float flTime)
 				int xpos = ScreenWidth - (rcPic.right - rcPic.left) - 4;
 				if (spr && 0 != *spr) // weapon isn't loaded yet so just don't draw the pic
 				{					  // the dll has to make sure it has sent info the weapons you need
-					SPR_Set(*spr, r, g, b);
-					SPR_DrawAdditive(0, xpos, ypos, &rcPic);
+					gHUD.m_SpriteBatch.DrawAdditive(*spr, r, g, b, 0, xpos, ypos, &rcPic);
 				}
 
 				// Draw the number
@@ -158,8 +157,7 @@ bool HistoryResource::DrawAmmoHistory(float flTime)
 
 				int ypos = ScreenHeight - (AMMO_PICKUP_PICK_HEIGHT + (AMMO_PICKUP_GAP * i));
 				int xpos = ScreenWidth - (weap->rcInactive.right - weap->rcInactive.left);
-				SPR_Set(weap->hInactive, r, g, b);
-				SPR_DrawAdditive(0, xpos, ypos, &weap->rcInactive);
+				gHUD.m_SpriteBatch.DrawAdditive(weap->hInactive, r, g, b, 0, xpos, ypos, &weap->rcInactive);
 			}
 			else if (rgAmmoHistory[i].type == HISTSLOT_ITEM)
 			{
@@ -177,8 +175,7 @@ bool HistoryResource::DrawAmmoHistory(float flTime)
 				int ypos = ScreenHeight - (AMMO_PICKUP_PICK_HEIGHT + (AMMO_PICKUP_GAP * i));
 				int xpos = ScreenWidth - (rect.right - rect.left) - 10;
 
-				SPR_Set(gHUD.GetSprite(rgAmmoHistory[i].iId), r, g, b);
-				SPR_DrawAdditive(0, xpos, ypos, &rect);
+				gHUD.m_SpriteBatch.DrawAdditive(gHUD.GetSprite(rgAmmoHistory[i].iId), r, g, b, 0, xpos, ypos, &rect);
 			}
 		}
 	}
@@ -1,3 +1,6 @@
+// The WCHAR overloads would make the function pointer types below ambiguous
+#define NOBASSOVERLOADS
+
 #include "BASS/bass.h"
 #include "BASS/basszxtune.h"
 
@@ -6,35 +9,352 @@
 #include "SDL2/SDL_messagebox.h"
 
 #include <string>
+#ifdef __linux__
 #include <dlfcn.h>
+#endif
 #include <filesystem>
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "bassmanager.h"
 
+// Songs opened ahead of time that are kept around until played
+#define BASS_MAX_PRELOADED 4
+
+// How often the music thread checks whether fading songs have gone quiet
+#define BASS_FADE_POLL_MS 100
+
 namespace BASSManager
 {
-	HSTREAM musicHnd;
+	/// @brief BASS entry points, resolved once in Initialize.
+	struct BASSFunctions
+	{
+		decltype(BASS_Init)* Init;
+		decltype(BASS_Free)* Free;
+		decltype(BASS_ErrorGetCode)* ErrorGetCode;
+		decltype(BASS_PluginLoad)* PluginLoad;
+		decltype(BASS_PluginFree)* PluginFree;
+		decltype(BASS_SetVolume)* SetVolume;
+		decltype(BASS_StreamCreateFile)* StreamCreateFile;
+		decltype(BASS_StreamFree)* StreamFree;
+		decltype(BASS_ChannelPlay)* ChannelPlay;
+		decltype(BASS_ChannelPause)* ChannelPause;
+		decltype(BASS_ChannelStop)* ChannelStop;
+		decltype(BASS_ChannelIsActive)* ChannelIsActive;
+		decltype(BASS_ChannelFlags)* ChannelFlags;
+		decltype(BASS_ChannelUpdate)* ChannelUpdate;
+		decltype(BASS_ChannelSetAttribute)* ChannelSetAttribute;
+		decltype(BASS_ChannelSlideAttribute)* ChannelSlideAttribute;
+		decltype(BASS_ChannelIsSliding)* ChannelIsSliding;
+	};
+
+	BASSFunctions bass;
+	bool initialized;
 
 	#ifdef __linux__
 	// dlopen handle
 	void* bassHnd;
-	void* zxHnd;
-
-	// * ideally we would have our function pointers here, but bassHnd needs to be set before we can create them.
 	#endif
 
+	enum class CommandType
+	{
+		Preload,
+		Play,
+		Crossfade,
+		Pause,
+		Stop,
+		Volume
+	};
+
+	struct Command
+	{
+		CommandType type;
+		std::filesystem::path path;
+		bool loop;
+		float value; // volume, or fade time in seconds
+	};
+
+	// Shared between the game and the music thread
+	std::mutex queueMutex;
+	std::condition_variable queueReady;
+	std::deque<Command> commands;
+	bool quit;
+	std::thread musicThread;
+
+	// Only used by the music thread
+	HSTREAM musicHnd;
+	std::vector<std::pair<std::filesystem::path, HSTREAM>> preloaded;
+	std::vector<HSTREAM> fading;
+
 	/// @brief Displays a BASS error code with the failed library path for path debugging.
-	/// @param errorFile 
+	/// @param errorFile
 	void ErrorDisplay(std::filesystem::path errorFile)
 	{
-		auto BASSError = reinterpret_cast<decltype(BASS_ErrorGetCode)*>(dlsym(bassHnd, "BASS_ErrorGetCode"));
-
 		char errBuf[384];
-		snprintf(errBuf, sizeof(errBuf), "BASS Error %d @ %s", BASSError(), errorFile.c_str());
+		snprintf(errBuf, sizeof(errBuf), "BASS Error %d @ %s", bass.ErrorGetCode ? bass.ErrorGetCode() : -1, errorFile.string().c_str());
 		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Fatal Error", errBuf, nullptr);
 	}
 
+	/// @brief Fills the function table, from the linked library on Windows and from the dlopen'ed one on Linux.
+	/// @return true if every function was found
+	bool ResolveFunctions()
+	{
+		#ifdef _WIN32
+		#define BASS_RESOLVE(name) bass.name = &BASS_##name
+		#else
+		#define BASS_RESOLVE(name) bass.name = reinterpret_cast<decltype(BASS_##name)*>(dlsym(bassHnd, "BASS_" #name))
+		#endif
+
+		BASS_RESOLVE(Init);
+		BASS_RESOLVE(Free);
+		BASS_RESOLVE(ErrorGetCode);
+		BASS_RESOLVE(PluginLoad);
+		BASS_RESOLVE(PluginFree);
+		BASS_RESOLVE(SetVolume);
+		BASS_RESOLVE(StreamCreateFile);
+		BASS_RESOLVE(StreamFree);
+		BASS_RESOLVE(ChannelPlay);
+		BASS_RESOLVE(ChannelPause);
+		BASS_RESOLVE(ChannelStop);
+		BASS_RESOLVE(ChannelIsActive);
+		BASS_RESOLVE(ChannelFlags);
+		BASS_RESOLVE(ChannelUpdate);
+		BASS_RESOLVE(ChannelSetAttribute);
+		BASS_RESOLVE(ChannelSlideAttribute);
+		BASS_RESOLVE(ChannelIsSliding);
+
+		#undef BASS_RESOLVE
+
+		return bass.Init && bass.Free && bass.ErrorGetCode && bass.PluginLoad && bass.PluginFree && bass.SetVolume &&
+			   bass.StreamCreateFile && bass.StreamFree && bass.ChannelPlay && bass.ChannelPause && bass.ChannelStop &&
+			   bass.ChannelIsActive && bass.ChannelFlags && bass.ChannelUpdate && bass.ChannelSetAttribute &&
+			   bass.ChannelSlideAttribute && bass.ChannelIsSliding;
+	}
+
+	/// @brief Opens a song and decodes enough of it to start playing right away. Music thread only.
+	/// @return the stream, or 0 if it could not be opened
+	HSTREAM OpenSong(const std::filesystem::path& musicPath)
+	{
+		// * This function works even with plugins.
+		DWORD flags = 0;
+
+		#ifdef _WIN32
+		flags |= BASS_UNICODE;
+		#endif
+
+		HSTREAM stream = bass.StreamCreateFile(FALSE, musicPath.c_str(), 0, 0, flags);
+
+		if (stream)
+		{
+			// fill the playback buffer now, instead of when the song starts
+			bass.ChannelUpdate(stream, 0);
+		}
+
+		return stream;
+	}
+
+	/// @brief Takes a preloaded song, or opens it if it wasn't. Music thread only.
+	HSTREAM TakeSong(const std::filesystem::path& musicPath)
+	{
+		auto it = std::find_if(preloaded.begin(), preloaded.end(), [&](const auto& song)
+			{ return song.first == musicPath; });
+
+		if (it != preloaded.end())
+		{
+			HSTREAM stream = it->second;
+			preloaded.erase(it);
+			return stream;
+		}
+
+		return OpenSong(musicPath);
+	}
+
+	/// @brief Starts a stream from the beginning. Music thread only.
+	void StartSong(HSTREAM stream, bool loop, float fadeTime)
+	{
+		bass.ChannelFlags(stream, loop ? BASS_SAMPLE_LOOP : 0, BASS_SAMPLE_LOOP);
+
+		if (fadeTime > 0)
+		{
+			bass.ChannelSetAttribute(stream, BASS_ATTRIB_VOL, 0);
+			bass.ChannelSlideAttribute(stream, BASS_ATTRIB_VOL, 1, static_cast<DWORD>(fadeTime * 1000));
+		}
+
+		bass.ChannelPlay(stream, TRUE);
+	}
+
+	/// @brief Runs a command on the music thread.
+	void RunCommand(const Command& command)
+	{
+		switch (command.type)
+		{
+		case CommandType::Preload:
+		{
+			auto it = std::find_if(preloaded.begin(), preloaded.end(), [&](const auto& song)
+				{ return song.first == command.path; });
+
+			if (it != preloaded.end())
+				break;
+
+			if (HSTREAM stream = OpenSong(command.path); stream)
+			{
+				if (preloaded.size() >= BASS_MAX_PRELOADED)
+				{
+					bass.StreamFree(preloaded.front().second);
+					preloaded.erase(preloaded.begin());
+				}
+
+				preloaded.emplace_back(command.path, stream);
+			}
+			break;
+		}
+
+		case CommandType::Play:
+			// keep playing the current song, it has to be stopped first
+			if (musicHnd && bass.ChannelIsActive(musicHnd) == BASS_ACTIVE_PLAYING)
+				break;
+
+			if (musicHnd)
+				bass.StreamFree(musicHnd);
+
+			musicHnd = TakeSong(command.path);
+
+			if (musicHnd)
+				StartSong(musicHnd, command.loop, 0);
+			break;
+
+		case CommandType::Crossfade:
+		{
+			HSTREAM next = TakeSong(command.path);
+
+			if (musicHnd)
+			{
+				if (command.value > 0 && bass.ChannelIsActive(musicHnd) == BASS_ACTIVE_PLAYING)
+				{
+					bass.ChannelSlideAttribute(musicHnd, BASS_ATTRIB_VOL, 0, static_cast<DWORD>(command.value * 1000));
+					fading.push_back(musicHnd);
+				}
+				else
+				{
+					bass.StreamFree(musicHnd);
+				}
+			}
+
+			musicHnd = next;
+
+			if (musicHnd)
+				StartSong(musicHnd, command.loop, command.value);
+			break;
+		}
+
+		case CommandType::Pause:
+			if (musicHnd)
+			{
+				switch (bass.ChannelIsActive(musicHnd))
+				{
+				case BASS_ACTIVE_PLAYING:
+					bass.ChannelPause(musicHnd);
+					break;
+				case BASS_ACTIVE_PAUSED:
+					// resume playback where it was paused, the loop flag is still set on the channel
+					bass.ChannelPlay(musicHnd, FALSE);
+					break;
+				}
+			}
+			break;
+
+		case CommandType::Stop:
+			if (musicHnd)
+			{
+				bass.ChannelStop(musicHnd);
+				bass.StreamFree(musicHnd);
+				musicHnd = 0;
+			}
+			break;
+
+		case CommandType::Volume:
+			bass.SetVolume(std::clamp<float>(command.value, 0, 1));
+			break;
+		}
+	}
+
+	/// @brief Frees songs that have finished fading out. Music thread only.
+	void FreeFadedSongs()
+	{
+		fading.erase(std::remove_if(fading.begin(), fading.end(), [](HSTREAM stream)
+						 {
+							 if (bass.ChannelIsSliding(stream, BASS_ATTRIB_VOL))
+								 return false;
+
+							 bass.StreamFree(stream);
+							 return true;
+						 }),
+			fading.end());
+	}
+
+	/// @brief Opens and plays songs as commands come in, so file access and decoding stay off the game thread.
+	void MusicThreadMain()
+	{
+		std::unique_lock<std::mutex> lock(queueMutex);
+
+		while (true)
+		{
+			const auto hasWork = []()
+			{ return quit || !commands.empty(); };
+
+			// while songs are fading out, wake up every now and then to free them
+			if (fading.empty())
+				queueReady.wait(lock, hasWork);
+			else
+				queueReady.wait_for(lock, std::chrono::milliseconds(BASS_FADE_POLL_MS), hasWork);
+
+			if (quit)
+				break;
+
+			while (!commands.empty())
+			{
+				Command command = std::move(commands.front());
+				commands.pop_front();
+
+				lock.unlock();
+				RunCommand(command);
+				lock.lock();
+			}
+
+			lock.unlock();
+			FreeFadedSongs();
+			lock.lock();
+		}
+	}
+
+	/// @brief Queues a command for the music thread.
+	void PostCommand(Command command)
+	{
+		if (!initialized)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			commands.push_back(std::move(command));
+		}
+
+		queueReady.notify_one();
+	}
+
+	/// @brief Starts the music thread once BASS is ready.
+	void StartMusicThread()
+	{
+		quit = false;
+		musicThread = std::thread(MusicThreadMain);
+		initialized = true;
+	}
+
 	#ifdef _WIN32
 	/// <summary>
 	/// A function to initialize the BASS library and plugins, prepare for use, and handle error checking.
@@ -44,8 +364,13 @@ namespace BASSManager
 	/// </summary>
 	bool Initialize(const char* gameDir)
 	{
+		if (initialized)
+			return true;
+
 		std::string pluginPath;
 
+		ResolveFunctions();
+
 		// Get window handle directly from SDL
 		SDL_SysWMinfo sysInfo;
 		SDL_VERSION(&sysInfo.version);
@@ -57,7 +382,7 @@ namespace BASSManager
 		if (win != nullptr && infoSuccess == SDL_TRUE)
 		{
 			// TODO: Find if I can use client audio settings as flags
-			if (!(bool)BASS_Init(-1, 44100, BASS_DEVICE_STEREO | BASS_DEVICE_16BITS, sysInfo.info.win.window, nullptr))
+			if (!(bool)bass.Init(-1, 44100, BASS_DEVICE_STEREO | BASS_DEVICE_16BITS, sysInfo.info.win.window, nullptr))
 			{
 				SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Fatal Error", "BASS not initialized.", nullptr);
 				return false;
@@ -66,8 +391,9 @@ namespace BASSManager
 			{
 				pluginPath = std::string(gameDir) + "/cl_dlls/basszxtune.dll";
 
-				if (BASS_PluginLoad(pluginPath.c_str(), 0) != 0)
+				if (bass.PluginLoad(pluginPath.c_str(), 0) != 0)
 				{
+					StartMusicThread();
 					return true;
 				}
 
@@ -85,6 +411,9 @@ namespace BASSManager
 	/// @return true on successful load, false otherwise
 	bool Initialize(const char* modDir)
 	{
+		if (initialized)
+			return true;
+
 		// library paths
 		std::filesystem::path fullDir = std::filesystem::current_path() / modDir;
 
@@ -98,12 +427,15 @@ namespace BASSManager
 		// set bass handle
 		bassHnd = dlopen(bassPath.c_str(), RTLD_NOW);
 
-		auto BASSInit = reinterpret_cast<decltype(BASS_Init)*>(dlsym(bassHnd, "BASS_Init"));
-		auto BASSPluginLoad = reinterpret_cast<decltype(BASS_PluginLoad)*>(dlsym(bassHnd, "BASS_PluginLoad"));
-		auto BASSStart = reinterpret_cast<decltype(BASS_IsStarted)*>(dlsym(bassHnd, "BASS_IsStarted"));
-		
+		if (!bassHnd || !ResolveFunctions())
+		{
+			ErrorDisplay(bassPath);
+			Shutdown();
+			return false;
+		}
+
 		// simplified initialization logic as Linux doesn't require window pointer.
-		if (!BASSInit(-1, 44100, BASS_DEVICE_STEREO | BASS_DEVICE_16BITS, nullptr, nullptr))
+		if (!bass.Init(-1, 44100, BASS_DEVICE_STEREO | BASS_DEVICE_16BITS, nullptr, nullptr))
 		{
 			ErrorDisplay(bassPath);
 			Shutdown();
@@ -111,12 +443,10 @@ namespace BASSManager
 		}
 		else
 		{
-			if(std::filesystem::exists(zxPath));
+			if (std::filesystem::exists(zxPath))
 			{
-				// zxHnd = dlopen(zxPath.c_str(), RTLD_NOW);
-
 				// todo: make this more modular and flexible again
-				HPLUGIN plugin = BASSPluginLoad(zxPath.c_str(), 0);
+				HPLUGIN plugin = bass.PluginLoad(zxPath.c_str(), 0);
 				if (!plugin)
 				{
 					ErrorDisplay(zxPath);
@@ -130,92 +460,94 @@ namespace BASSManager
 			// 	{
 			// 	}
 			// }
+			StartMusicThread();
 			return true;
 		}
 	}
 	#endif
 
 	/// <summary>
-	/// Releases BASS resources to prepare for shutdown.
+	/// Stops the music thread and releases BASS resources to prepare for shutdown.
 	/// </summary>
 	void Shutdown()
 	{
-		#ifdef __linux__
-		auto BASSFree = reinterpret_cast<decltype(BASS_Free)*>(dlsym(bassHnd, "BASS_Free"));
-		auto BASSPluginFree = reinterpret_cast<decltype(BASS_PluginFree)*>(dlsym(bassHnd, "BASS_PluginFree"));
+		if (musicThread.joinable())
+		{
+			{
+				std::lock_guard<std::mutex> lock(queueMutex);
+				quit = true;
+				commands.clear();
+			}
+
+			queueReady.notify_one();
+			musicThread.join();
+		}
+
+		initialized = false;
+
+		// BASS_Free releases any streams that are still open
+		musicHnd = 0;
+		preloaded.clear();
+		fading.clear();
 
-		BASSFree();
-		BASSPluginFree(0);
-		dlclose(bassHnd);
+		if (bass.Free)
+		{
+			bass.Free();
+			bass.PluginFree(0);
+		}
+
+		bass = {};
+
+		#ifdef __linux__
+		if (bassHnd)
+		{
+			dlclose(bassHnd);
+			bassHnd = nullptr;
+		}
 		#endif
 	}
 
+	/// @brief Opens a song ahead of time, such as while a map loads, so playing it later starts right away.
+	/// @param musicPath an std::path with the absolute path to the file
+	void Preload(std::filesystem::path musicPath)
+	{
+		PostCommand({CommandType::Preload, std::move(musicPath), false, 0});
+	}
+
 	/// @brief Play a song using the BASS instance, with proper state checking and plugin support.
+	/// Does nothing if a song is already playing.
 	/// @param musicPath an std::path with the absolute path to the file
 	/// @param loop true = loop, false = play once
 	void PlaySong(std::filesystem::path musicPath, bool loop)
 	{
-		#ifdef __linux__
-		// * This function works even with plugins.
-		auto BASSStreamCreate = reinterpret_cast<decltype(BASS_StreamCreateFile)*>(dlsym(bassHnd, "BASS_StreamCreateFile"));
-		auto BASSPlay = reinterpret_cast<decltype(BASS_ChannelPlay)*>(dlsym(bassHnd, "BASS_ChannelPlay"));
-		auto BASSProbeState = reinterpret_cast<decltype(BASS_ChannelIsActive)*>(dlsym(bassHnd, "BASS_ChannelIsActive"));
+		PostCommand({CommandType::Play, std::move(musicPath), loop, 0});
+	}
 
-		if(musicHnd)
-		{
-			switch(BASSProbeState(musicHnd))
-			{
-				case BASS_ACTIVE_PLAYING:
-					break;
-				default:
-					musicHnd = BASSStreamCreate(FALSE, musicPath.c_str(), 0, 0, 0);
-					BASSPlay(musicHnd, loop);
-					break;
-			}
-		}
-		#endif
+	/// @brief Fades the current song out while a new one fades in.
+	/// @param musicPath an std::path with the absolute path to the file
+	/// @param loop true = loop, false = play once
+	/// @param fadeTime fade duration in seconds, 0 switches immediately
+	void CrossfadeSong(std::filesystem::path musicPath, bool loop, float fadeTime)
+	{
+		PostCommand({CommandType::Crossfade, std::move(musicPath), loop, std::max(0.f, fadeTime)});
 	}
-	
+
 	/// @brief (Un)pauses BASS playback, with state checking
 	void PauseSong()
 	{
-		auto BASSProbeState = reinterpret_cast<decltype(BASS_ChannelIsActive)*>(dlsym(bassHnd, "BASS_ChannelIsActive"));
-		auto BASSPause = reinterpret_cast<decltype(BASS_ChannelPause)*>(dlsym(bassHnd, "BASS_ChannelPause"));
-		auto BASSPlay = reinterpret_cast<decltype(BASS_ChannelPlay)*>(dlsym(bassHnd, "BASS_ChannelPlay"));
-		auto BASSFlags = reinterpret_cast<decltype(BASS_ChannelFlags)*>(dlsym(bassHnd, "BASS_ChannelFlags"));
-
-		if(musicHnd)
-		{
-			switch(BASSProbeState(musicHnd))
-			{
-				case BASS_ACTIVE_PLAYING:
-					BASSPause(musicHnd);
-					break;
-				case BASS_ACTIVE_PAUSED:
-					// resume playback with same handle and loop flag
-					// looping bool is obtained through bass state to avoid weird clunky dependency injections
-					BASSPlay(musicHnd, BASSFlags(musicHnd, 0, 0) & BASS_SAMPLE_LOOP == 1 ? true : false);
-					break;
-			}
-		}
+		PostCommand({CommandType::Pause, {}, false, 0});
 	}
 
 	/// @brief Stops BASS playback, with state checking
 	void StopSong()
 	{
-		auto BASSProbeState = reinterpret_cast<decltype(BASS_ChannelIsActive)*>(dlsym(bassHnd, "BASS_ChannelIsActive"));
-		auto BASSStop = reinterpret_cast<decltype(BASS_ChannelStop)*>(dlsym(bassHnd, "BASS_ChannelStop"));
-		if(BASSProbeState(musicHnd) == BASS_ACTIVE_PLAYING && musicHnd)
-		{
-			BASSStop(musicHnd);
-		}
+		PostCommand({CommandType::Stop, {}, false, 0});
 	}
 
 	/// @brief Sets volume of the BASS instance
 	/// @param volume 0-1 float (clamped internally)
 	void SetVolume(float volume)
 	{
-		auto BASSSetVolume = reinterpret_cast<decltype(BASS_SetVolume)*>(dlsym(bassHnd, "BASS_SetVolume"));
-		BASSSetVolume(std::clamp<float>(volume, 0, 1));
+		PostCommand({CommandType::Volume, {}, false, volume});
 	}
 }
@@ -4,17 +4,22 @@
 
 #pragma once
 
+#include <filesystem>
+
 /// <summary>
 /// A namespace to serve as a wrapper/abstraction layer for the BASS API,
 ///	to prevent header conflicts, manage resources efficiently, and
 /// simplify ease-of-use when working with BASS.
+/// Songs are opened and played on a background thread, so none of these block the game thread.
 /// </summary>
 namespace BASSManager
 {
 bool Initialize(const char* gameDir);
 void Shutdown();
+void Preload(std::filesystem::path musicPath);
 void PlaySong(std::filesystem::path musicPath, bool loop);
+void CrossfadeSong(std::filesystem::path musicPath, bool loop, float fadeTime);
 void PauseSong();
 void StopSong();
 void SetVolume(float volume);
-};
\ No newline at end of file
+};
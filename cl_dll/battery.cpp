@@ -125,18 +125,16 @@ bool CHudBattery::Draw(float flTime)
 	if (0 == m_hSprite2)
 		m_hSprite2 = gHUD.GetSprite(gHUD.GetSpriteIndex("suit_full"));
 
-	SPR_Set(m_hSprite1, r, g, b);
-	SPR_DrawAdditive(0, x, y - iOffset, m_prc1);
+	gHUD.m_SpriteBatch.DrawAdditive(m_hSprite1, r, g, b, 0, x, y - iOffset, m_prc1);
 
 	if (rc.bottom > rc.top)
 	{
-		SPR_Set(m_hSprite2, r, g, b);
-		SPR_DrawAdditive(0, x, y - iOffset + (rc.top - m_prc2->top), &rc);
+		gHUD.m_SpriteBatch.DrawAdditive(m_hSprite2, r, g, b, 0, x, y - iOffset + (rc.top - m_prc2->top), &rc);
 	}
 
 	x += width;
 	y += (int)(gHUD.m_iFontHeight * 0.2f);
-	x = gHUD.DrawHudNumber(x, y, DHN_3DIGITS | DHN_DRAWZERO, m_iBat, r, g, b);
+	x = gHUD.DrawHudNumber(m_BatLayout, x, y, DHN_3DIGITS | DHN_DRAWZERO, m_iBat, r, g, b);
 
 	return true;
 }
@@ -37,6 +37,8 @@ struct DeathNoticeItem
 	float flDisplayTime;
 	float* KillerColor;
 	float* VictimColor;
+	int iKillerWidth; // ConsoleStringLen of the names, measured once
+	int iVictimWidth;
 };
 
 #define MAX_DEATHNOTICES 4
@@ -96,6 +98,9 @@ bool CHudDeathNotice::VidInit()
 {
 	m_HUD_d_skull = gHUD.GetSpriteIndex("d_skull");
 
+	// The console font may have changed
+	m_bDirty = true;
+
 	return true;
 }
 
@@ -113,6 +118,17 @@ bool CHudDeathNotice::Draw(float flTime)
 	gEngfuncs.pfnGetScreenInfo(&screenInfo);
 	gap = V_max(gap, screenInfo.iCharHeight);
 
+	if (m_bDirty)
+	{
+		for (int i = 0; i < MAX_DEATHNOTICES && rgDeathNoticeList[i].iId != 0; i++)
+		{
+			rgDeathNoticeList[i].iKillerWidth = ConsoleStringLen(rgDeathNoticeList[i].szKiller);
+			rgDeathNoticeList[i].iVictimWidth = ConsoleStringLen(rgDeathNoticeList[i].szVictim);
+		}
+
+		m_bDirty = false;
+	}
+
 	for (int i = 0; i < MAX_DEATHNOTICES; i++)
 	{
 		if (rgDeathNoticeList[i].iId == 0)
@@ -137,11 +153,11 @@ bool CHudDeathNotice::Draw(float flTime)
 			texty = y + 4;
 
 			int id = (rgDeathNoticeList[i].iId == -1) ? m_HUD_d_skull : rgDeathNoticeList[i].iId;
-			x = ScreenWidth - ConsoleStringLen(rgDeathNoticeList[i].szVictim) - (gHUD.GetSpriteRect(id).right - gHUD.GetSpriteRect(id).left) - 4;
+			x = ScreenWidth - rgDeathNoticeList[i].iVictimWidth - (gHUD.GetSpriteRect(id).right - gHUD.GetSpriteRect(id).left) - 4;
 
 			if (!rgDeathNoticeList[i].iSuicide)
 			{
-				x -= (5 + ConsoleStringLen(rgDeathNoticeList[i].szKiller));
+				x -= (5 + rgDeathNoticeList[i].iKillerWidth);
 
 				// Draw killers name
 				if (rgDeathNoticeList[i].KillerColor)
@@ -160,8 +176,7 @@ bool CHudDeathNotice::Draw(float flTime)
 			}
 
 			// Draw death weapon
-			SPR_Set(gHUD.GetSprite(id), r, g, b);
-			SPR_DrawAdditive(0, x, y, &gHUD.GetSpriteRect(id));
+			gHUD.m_SpriteBatch.DrawAdditive(gHUD.GetSprite(id), r, g, b, 0, x, y, &gHUD.GetSpriteRect(id));
 
 			x += (gHUD.GetSpriteRect(id).right - gHUD.GetSpriteRect(id).left);
 
@@ -267,6 +282,9 @@ bool CHudDeathNotice::MsgFunc_DeathMsg(const char* pszName, int iSize, void* pbu
 	DEATHNOTICE_DISPLAY_TIME = CVAR_GET_FLOAT("hud_deathnotice_time");
 	rgDeathNoticeList[i].flDisplayTime = gHUD.m_flTime + DEATHNOTICE_DISPLAY_TIME;
 
+	rgDeathNoticeList[i].iKillerWidth = ConsoleStringLen(rgDeathNoticeList[i].szKiller);
+	rgDeathNoticeList[i].iVictimWidth = ConsoleStringLen(rgDeathNoticeList[i].szVictim);
+
 	if (rgDeathNoticeList[i].iNonPlayerKill)
 	{
 		ConsolePrint(rgDeathNoticeList[i].szKiller);
@@ -2,6 +2,12 @@
 
 #include <memory.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 #include "hud.h"
 #include "cl_util.h"
 #include "const.h"
@@ -13,13 +19,27 @@
 #include "pmtrace.h"
 #include "pm_shared.h"
 #include "Exports.h"
+#include "com_model.h"
+#include "CFrustum.h"
 
 #include "particleman.h"
+#include "particle_effects.h"
 extern IParticleMan* g_pParticleMan;
 
 void Game_AddObjects();
+void R_StudioQueueEntity(cl_entity_t* entity);
 
 extern Vector v_origin;
+extern Vector v_render_angles;
+extern cvar_t* cl_tempentcull;
+extern cvar_t* cl_tempenttracebudget;
+
+// Degrees added to the field of view, and units added to the size of tempents, when frustum culling them
+#define TEMPENT_CULL_FOV_MARGIN 20.0f
+#define TEMPENT_CULL_RADIUS_MARGIN 16.0f
+
+// Where tents that skipped collision checks last traced from
+static std::unordered_map<TEMPENTITY*, Vector> g_TempEntTraceStarts;
 
 bool g_iAlive = true;
 
@@ -58,6 +78,8 @@ int DLLEXPORT HUD_AddEntity(int type, struct cl_entity_s* ent, const char* model
 			return 0; // don't draw the player we are following in eye
 	}
 
+	R_StudioQueueEntity(ent);
+
 	return 1;
 }
 
@@ -347,7 +369,7 @@ void DLLEXPORT HUD_StudioEvent(const struct mstudioevent_s* event, const struct
 			gEngfuncs.pEfxAPI->R_MuzzleFlash((float*)&entity->attachment[3], atoi(event->options));
 		break;
 	case 5002:
-		gEngfuncs.pEfxAPI->R_SparkEffect((float*)&entity->attachment[0], atoi(event->options), -100, 100);
+		ParticleEffects_Sparks(entity->attachment[0], atoi(event->options), -100, 100);
 		break;
 	// Client side sound
 	case 5004:
@@ -358,11 +380,119 @@ void DLLEXPORT HUD_StudioEvent(const struct mstudioevent_s* event, const struct
 	}
 }
 
+/*
+=================
+CL_AddVisibleTempEnts
+
+Frustum culls the tempents in batches and adds those that can be seen to the visible list.
+Tempents outside of the view are kept alive, only those the engine can't draw are killed.
+=================
+*/
+static void CL_AddVisibleTempEnts(const std::vector<TEMPENTITY*>& tempents, double client_time, int (*Callback_AddVisibleEntity)(cl_entity_t* pEntity), bool killUndrawn)
+{
+	static std::vector<float> x, y, z, radius;
+	static std::vector<std::uint8_t> visible;
+
+	const int count = static_cast<int>(tempents.size());
+
+	visible.assign(count, 1);
+
+	if (0 != cl_tempentcull->value && count > 0)
+	{
+		// The view is set up after tempents are updated, so this is last frame's view.
+		// Widen it enough that turning doesn't show tempents popping in at the edges.
+		const float aspect = ScreenHeight > 0 ? static_cast<float>(ScreenWidth) / ScreenHeight : 4.0f / 3.0f;
+		const float fov = gHUD.m_iFOV > 0 ? gHUD.m_iFOV : 90;
+		const float tanX = std::tan(fov * 0.5f * (M_PI / 180)) * std::max(1.0f, aspect * 0.75f);
+		const float tanY = tanX / aspect;
+		const float fovX = std::min(179.0f, static_cast<float>(2 * std::atan(tanX) * (180 / M_PI)) + TEMPENT_CULL_FOV_MARGIN);
+		const float fovY = std::min(179.0f, static_cast<float>(2 * std::atan(tanY) * (180 / M_PI)) + TEMPENT_CULL_FOV_MARGIN);
+
+		CFrustum frustum;
+		frustum.CalculateFrustum(v_origin, v_render_angles, fovX, fovY);
+
+		x.resize(count);
+		y.resize(count);
+		z.resize(count);
+		radius.resize(count);
+
+		for (int i = 0; i < count; ++i)
+		{
+			const cl_entity_t& entity = tempents[i]->entity;
+			const model_t* model = entity.model;
+
+			x[i] = entity.origin.x;
+			y[i] = entity.origin.y;
+			z[i] = entity.origin.z;
+
+			// Sprites don't always have a radius, so use the bounds too
+			float size = TEMPENT_CULL_RADIUS_MARGIN;
+
+			if (model)
+			{
+				size += std::max({model->radius, model->mins.Length(), model->maxs.Length()}) * std::max(1.0f, entity.curstate.scale);
+			}
+			else
+			{
+				// Can't tell how big it is, so it's never culled
+				size = 1e9f;
+			}
+
+			radius[i] = size;
+		}
+
+		frustum.SpheresInsideFrustum(x.data(), y.data(), z.data(), radius.data(), count, visible.data());
+	}
+
+	for (int i = 0; i < count; ++i)
+	{
+		if (0 == visible[i])
+			continue;
+
+		TEMPENTITY* pTemp = tempents[i];
+
+		if (0 == Callback_AddVisibleEntity(&pTemp->entity) && killUndrawn)
+		{
+			if ((pTemp->flags & FTENT_PERSIST) == 0)
+			{
+				pTemp->die = client_time;		// If we can't draw it this frame, just dump it.
+				pTemp->flags &= ~FTENT_FADEOUT; // Don't fade out, just die
+			}
+		}
+	}
+}
+
+/*
+=================
+CL_TempEntPlayerPrediction
+
+In order to have tents collide with players, we have to run the player prediction code so
+that the client has the player list. This is only done once per update, when the first
+COLLIDEALL tent traces.
+=================
+*/
+static void CL_TempEntPlayerPrediction(bool& playerPrediction)
+{
+	if (playerPrediction)
+		return;
+
+	gEngfuncs.pEventAPI->EV_SetUpPlayerPrediction(0, 1);
+
+	// Store off the old count
+	gEngfuncs.pEventAPI->EV_PushPMStates();
+
+	// Now add in all of the players.
+	gEngfuncs.pEventAPI->EV_SetSolidPlayers(-1);
+
+	playerPrediction = true;
+}
+
 /*
 =================
 CL_UpdateTEnts
 
-Simulation and cleanup of temporary entities
+Simulation and cleanup of temporary entities.
+Active tents are gathered into an array first, then each stage of the simulation runs over all of them before the next.
 =================
 */
 void DLLEXPORT HUD_TempEntUpdate(
@@ -377,9 +507,15 @@ void DLLEXPORT HUD_TempEntUpdate(
 	//	RecClTempEntUpdate(frametime, client_time, cl_gravity, ppTempEntFree, ppTempEntActive, Callback_AddVisibleEntity, Callback_TempEntPlaySound);
 
 	static int gTempEntFrame = 0;
-	int i;
+	static unsigned int traceFrame = 0;
+	static double lastClientTime = 0;
+	static std::vector<TEMPENTITY*> tempents;
+	static std::vector<TEMPENTITY*> linear;
+	static std::vector<TEMPENTITY*> visibleTempEnts;
+	int i, count;
 	TEMPENTITY *pTemp, *pnext, *pprev;
 	float freq, gravity, gravitySlow, life, fastFreq;
+	bool playerPrediction = false;
 
 	Vector vAngles;
 
@@ -388,27 +524,23 @@ void DLLEXPORT HUD_TempEntUpdate(
 	if (g_pParticleMan)
 		g_pParticleMan->SetVariables(cl_gravity, vAngles);
 
+	// Tents are freed by the engine when a new map starts, forget where they were
+	if (!*ppTempEntActive || client_time < lastClientTime)
+		g_TempEntTraceStarts.clear();
+
+	lastClientTime = client_time;
+
 	// Nothing to simulate
 	if (!*ppTempEntActive)
 		return;
 
-	// in order to have tents collide with players, we have to run the player prediction code so
-	// that the client has the player list. We run this code once when we detect any COLLIDEALL
-	// tent, then set this bool to true so the code doesn't get run again if there's more than
-	// one COLLIDEALL ent for this update. (often are).
-	gEngfuncs.pEventAPI->EV_SetUpPlayerPrediction(0, 1);
-
-	// Store off the old count
-	gEngfuncs.pEventAPI->EV_PushPMStates();
-
-	// Now add in all of the players.
-	gEngfuncs.pEventAPI->EV_SetSolidPlayers(-1);
-
 	// !!!BUGBUG	-- This needs to be time based
 	gTempEntFrame = (gTempEntFrame + 1) & 31;
 
 	pTemp = *ppTempEntActive;
 
+	visibleTempEnts.clear();
+
 	// !!! Don't simulate while paused....  This is sort of a hack, revisit.
 	if (frametime <= 0)
 	{
@@ -416,11 +548,12 @@ void DLLEXPORT HUD_TempEntUpdate(
 		{
 			if ((pTemp->flags & FTENT_NOMODEL) == 0)
 			{
-				Callback_AddVisibleEntity(&pTemp->entity);
+				visibleTempEnts.push_back(pTemp);
 			}
 			pTemp = pTemp->next;
 		}
-		goto finish;
+		CL_AddVisibleTempEnts(visibleTempEnts, client_time, Callback_AddVisibleEntity, false);
+		return;
 	}
 
 	pprev = NULL;
@@ -429,6 +562,9 @@ void DLLEXPORT HUD_TempEntUpdate(
 	gravity = -frametime * cl_gravity;
 	gravitySlow = gravity * 0.5;
 
+	// Free the tents that died and gather the others
+	tempents.clear();
+
 	while (pTemp)
 	{
 		bool active;
@@ -458,280 +594,383 @@ void DLLEXPORT HUD_TempEntUpdate(
 				*ppTempEntActive = pnext;
 			else
 				pprev->next = pnext;
+
+			if (!g_TempEntTraceStarts.empty())
+				g_TempEntTraceStarts.erase(pTemp);
 		}
 		else
 		{
 			pprev = pTemp;
+			tempents.push_back(pTemp);
+		}
+		pTemp = pnext;
+	}
+
+	count = static_cast<int>(tempents.size());
+
+	// Move them. Most tents move in a straight line, those are done together afterwards
+	linear.clear();
+
+	for (int j = 0; j < count; j++)
+	{
+		pTemp = tempents[j];
 
-			VectorCopy(pTemp->entity.origin, pTemp->entity.prevstate.origin);
+		VectorCopy(pTemp->entity.origin, pTemp->entity.prevstate.origin);
 
-			if ((pTemp->flags & FTENT_SPARKSHOWER) != 0)
+		if ((pTemp->flags & FTENT_SPARKSHOWER) != 0)
+		{
+			// Adjust speed if it's time
+			// Scale is next think time
+			if (client_time > pTemp->entity.baseline.scale)
 			{
-				// Adjust speed if it's time
-				// Scale is next think time
-				if (client_time > pTemp->entity.baseline.scale)
-				{
-					// Show Sparks
-					gEngfuncs.pEfxAPI->R_SparkEffect(pTemp->entity.origin, 8, -200, 200);
+				// Show Sparks
+				ParticleEffects_Sparks(pTemp->entity.origin, 8, -200, 200);
 
-					// Reduce life
-					pTemp->entity.baseline.framerate -= 0.1;
+				// Reduce life
+				pTemp->entity.baseline.framerate -= 0.1;
 
-					if (pTemp->entity.baseline.framerate <= 0.0)
-					{
-						pTemp->die = client_time;
-					}
-					else
-					{
-						// So it will die no matter what
-						pTemp->die = client_time + 0.5;
+				if (pTemp->entity.baseline.framerate <= 0.0)
+				{
+					pTemp->die = client_time;
+				}
+				else
+				{
+					// So it will die no matter what
+					pTemp->die = client_time + 0.5;
 
-						// Next think
-						pTemp->entity.baseline.scale = client_time + 0.1;
-					}
+					// Next think
+					pTemp->entity.baseline.scale = client_time + 0.1;
 				}
 			}
-			else if ((pTemp->flags & FTENT_PLYRATTACHMENT) != 0)
-			{
-				cl_entity_t* pClient;
+		}
+		else if ((pTemp->flags & FTENT_PLYRATTACHMENT) != 0)
+		{
+			cl_entity_t* pClient;
 
-				pClient = gEngfuncs.GetEntityByIndex(pTemp->clientIndex);
+			pClient = gEngfuncs.GetEntityByIndex(pTemp->clientIndex);
 
-				VectorAdd(pClient->origin, pTemp->tentOffset, pTemp->entity.origin);
-			}
-			else if ((pTemp->flags & FTENT_SINEWAVE) != 0)
-			{
-				pTemp->x += pTemp->entity.baseline.origin[0] * frametime;
-				pTemp->y += pTemp->entity.baseline.origin[1] * frametime;
+			VectorAdd(pClient->origin, pTemp->tentOffset, pTemp->entity.origin);
+		}
+		else if ((pTemp->flags & FTENT_SINEWAVE) != 0)
+		{
+			pTemp->x += pTemp->entity.baseline.origin[0] * frametime;
+			pTemp->y += pTemp->entity.baseline.origin[1] * frametime;
 
-				pTemp->entity.origin[0] = pTemp->x + sin(pTemp->entity.baseline.origin[2] + client_time * pTemp->entity.prevstate.frame) * (10 * pTemp->entity.curstate.framerate);
-				pTemp->entity.origin[1] = pTemp->y + sin(pTemp->entity.baseline.origin[2] + fastFreq + 0.7) * (8 * pTemp->entity.curstate.framerate);
-				pTemp->entity.origin[2] += pTemp->entity.baseline.origin[2] * frametime;
-			}
-			else if ((pTemp->flags & FTENT_SPIRAL) != 0)
-			{
-				float s, c;
-				s = sin(pTemp->entity.baseline.origin[2] + fastFreq);
-				c = cos(pTemp->entity.baseline.origin[2] + fastFreq);
+			pTemp->entity.origin[0] = pTemp->x + sin(pTemp->entity.baseline.origin[2] + client_time * pTemp->entity.prevstate.frame) * (10 * pTemp->entity.curstate.framerate);
+			pTemp->entity.origin[1] = pTemp->y + sin(pTemp->entity.baseline.origin[2] + fastFreq + 0.7) * (8 * pTemp->entity.curstate.framerate);
+			pTemp->entity.origin[2] += pTemp->entity.baseline.origin[2] * frametime;
+		}
+		else if ((pTemp->flags & FTENT_SPIRAL) != 0)
+		{
+			float s, c;
+			s = sin(pTemp->entity.baseline.origin[2] + fastFreq);
+			c = cos(pTemp->entity.baseline.origin[2] + fastFreq);
 
-				pTemp->entity.origin[0] += pTemp->entity.baseline.origin[0] * frametime + 8 * sin(client_time * 20 + (int)pTemp);
-				pTemp->entity.origin[1] += pTemp->entity.baseline.origin[1] * frametime + 4 * sin(client_time * 30 + (int)pTemp);
-				pTemp->entity.origin[2] += pTemp->entity.baseline.origin[2] * frametime;
-			}
+			pTemp->entity.origin[0] += pTemp->entity.baseline.origin[0] * frametime + 8 * sin(client_time * 20 + (int)pTemp);
+			pTemp->entity.origin[1] += pTemp->entity.baseline.origin[1] * frametime + 4 * sin(client_time * 30 + (int)pTemp);
+			pTemp->entity.origin[2] += pTemp->entity.baseline.origin[2] * frametime;
+		}
+		else
+		{
+			linear.push_back(pTemp);
+		}
+	}
 
-			else
-			{
-				for (i = 0; i < 3; i++)
-					pTemp->entity.origin[i] += pTemp->entity.baseline.origin[i] * frametime;
-			}
+	for (TEMPENTITY* pLinear : linear)
+	{
+		for (i = 0; i < 3; i++)
+			pLinear->entity.origin[i] += pLinear->entity.baseline.origin[i] * frametime;
+	}
+
+	// Animate them, sprites that finished playing are left out of everything after this
+	int animated = 0;
+
+	for (int j = 0; j < count; j++)
+	{
+		pTemp = tempents[j];
 
-			if ((pTemp->flags & FTENT_SPRANIMATE) != 0)
+		if ((pTemp->flags & FTENT_SPRANIMATE) != 0)
+		{
+			pTemp->entity.curstate.frame += frametime * pTemp->entity.curstate.framerate;
+			if (pTemp->entity.curstate.frame >= pTemp->frameMax)
 			{
-				pTemp->entity.curstate.frame += frametime * pTemp->entity.curstate.framerate;
-				if (pTemp->entity.curstate.frame >= pTemp->frameMax)
-				{
-					pTemp->entity.curstate.frame = pTemp->entity.curstate.frame - (int)(pTemp->entity.curstate.frame);
+				pTemp->entity.curstate.frame = pTemp->entity.curstate.frame - (int)(pTemp->entity.curstate.frame);
 
-					if ((pTemp->flags & FTENT_SPRANIMATELOOP) == 0)
-					{
-						// this animating sprite isn't set to loop, so destroy it.
-						pTemp->die = client_time;
-						pTemp = pnext;
-						continue;
-					}
+				if ((pTemp->flags & FTENT_SPRANIMATELOOP) == 0)
+				{
+					// this animating sprite isn't set to loop, so destroy it.
+					pTemp->die = client_time;
+					continue;
 				}
 			}
-			else if ((pTemp->flags & FTENT_SPRCYCLE) != 0)
+		}
+		else if ((pTemp->flags & FTENT_SPRCYCLE) != 0)
+		{
+			pTemp->entity.curstate.frame += frametime * 10;
+			if (pTemp->entity.curstate.frame >= pTemp->frameMax)
 			{
-				pTemp->entity.curstate.frame += frametime * 10;
-				if (pTemp->entity.curstate.frame >= pTemp->frameMax)
-				{
-					pTemp->entity.curstate.frame = pTemp->entity.curstate.frame - (int)(pTemp->entity.curstate.frame);
-				}
+				pTemp->entity.curstate.frame = pTemp->entity.curstate.frame - (int)(pTemp->entity.curstate.frame);
 			}
+		}
+
+		tempents[animated++] = pTemp;
+	}
+
+	count = animated;
+	tempents.resize(count);
+
 // Experiment
 #if 0
-			if ( pTemp->flags & FTENT_SCALE )
-				pTemp->entity.curstate.framerate += 20.0 * (frametime / pTemp->entity.curstate.framerate);
+	for (int j = 0; j < count; j++)
+	{
+		pTemp = tempents[j];
+
+		if ( pTemp->flags & FTENT_SCALE )
+			pTemp->entity.curstate.framerate += 20.0 * (frametime / pTemp->entity.curstate.framerate);
+	}
 #endif
 
-			if ((pTemp->flags & FTENT_ROTATE) != 0)
-			{
-				pTemp->entity.angles[0] += pTemp->entity.baseline.angles[0] * frametime;
-				pTemp->entity.angles[1] += pTemp->entity.baseline.angles[1] * frametime;
-				pTemp->entity.angles[2] += pTemp->entity.baseline.angles[2] * frametime;
+	for (int j = 0; j < count; j++)
+	{
+		pTemp = tempents[j];
 
-				VectorCopy(pTemp->entity.angles, pTemp->entity.latched.prevangles);
-			}
+		if ((pTemp->flags & FTENT_ROTATE) != 0)
+		{
+			pTemp->entity.angles[0] += pTemp->entity.baseline.angles[0] * frametime;
+			pTemp->entity.angles[1] += pTemp->entity.baseline.angles[1] * frametime;
+			pTemp->entity.angles[2] += pTemp->entity.baseline.angles[2] * frametime;
 
-			if ((pTemp->flags & (FTENT_COLLIDEALL | FTENT_COLLIDEWORLD)) != 0)
-			{
-				Vector traceNormal;
-				float traceFraction = 1;
+			VectorCopy(pTemp->entity.angles, pTemp->entity.latched.prevangles);
+		}
+	}
 
-				if ((pTemp->flags & FTENT_COLLIDEALL) != 0)
-				{
-					pmtrace_t pmtrace;
-					physent_t* pe;
+	// Collide them. When there are more than the budget allows, tents take turns tracing;
+	// those that skip a frame trace from where they last traced the next time they do
+	int colliding = 0;
 
-					gEngfuncs.pEventAPI->EV_SetTraceHull(2);
+	for (int j = 0; j < count; j++)
+	{
+		if ((tempents[j]->flags & (FTENT_COLLIDEALL | FTENT_COLLIDEWORLD)) != 0)
+			++colliding;
+	}
 
-					gEngfuncs.pEventAPI->EV_PlayerTrace(pTemp->entity.prevstate.origin, pTemp->entity.origin, PM_STUDIO_BOX, -1, &pmtrace);
+	const int traceBudget = std::max(0, static_cast<int>(cl_tempenttracebudget->value));
+	const int traceInterval = traceBudget > 0 ? std::max(1, (colliding + traceBudget - 1) / traceBudget) : 1;
+	int traces = 0;
+	unsigned int traceCounter = 0;
 
+	++traceFrame;
 
-					if (pmtrace.fraction != 1)
-					{
-						pe = gEngfuncs.pEventAPI->EV_GetPhysent(pmtrace.ent);
-
-						if (0 == pmtrace.ent || (pe->info != pTemp->clientIndex))
-						{
-							traceFraction = pmtrace.fraction;
-							VectorCopy(pmtrace.plane.normal, traceNormal);
-
-							if (pTemp->hitcallback)
-							{
-								(*pTemp->hitcallback)(pTemp, &pmtrace);
-							}
-						}
-					}
-				}
-				else if ((pTemp->flags & FTENT_COLLIDEWORLD) != 0)
-				{
-					pmtrace_t pmtrace;
+	for (int j = 0; j < count; j++)
+	{
+		pTemp = tempents[j];
+
+		if ((pTemp->flags & (FTENT_COLLIDEALL | FTENT_COLLIDEWORLD)) == 0)
+			continue;
+
+		bool trace = traceInterval == 1 || (traceCounter++ + traceFrame) % traceInterval == 0;
 
-					gEngfuncs.pEventAPI->EV_SetTraceHull(2);
+		// The turns may not divide evenly, never go over the budget
+		if (trace && traceBudget > 0 && traces >= traceBudget)
+			trace = false;
 
-					gEngfuncs.pEventAPI->EV_PlayerTrace(pTemp->entity.prevstate.origin, pTemp->entity.origin, PM_STUDIO_BOX | PM_WORLD_ONLY, -1, &pmtrace);
+		const auto traceStartIt = g_TempEntTraceStarts.find(pTemp);
+		const bool resumed = traceStartIt != g_TempEntTraceStarts.end();
+
+		if (!trace)
+		{
+			if (!resumed)
+				g_TempEntTraceStarts.emplace(pTemp, pTemp->entity.prevstate.origin);
+			continue;
+		}
+
+		Vector traceStart = pTemp->entity.prevstate.origin;
+
+		if (resumed)
+		{
+			traceStart = traceStartIt->second;
+			g_TempEntTraceStarts.erase(traceStartIt);
+		}
 
-					if (pmtrace.fraction != 1)
+		++traces;
+
+		Vector traceNormal;
+		float traceFraction = 1;
+
+		if ((pTemp->flags & FTENT_COLLIDEALL) != 0)
+		{
+			pmtrace_t pmtrace;
+			physent_t* pe;
+
+			CL_TempEntPlayerPrediction(playerPrediction);
+
+			gEngfuncs.pEventAPI->EV_SetTraceHull(2);
+
+			gEngfuncs.pEventAPI->EV_PlayerTrace(traceStart, pTemp->entity.origin, PM_STUDIO_BOX, -1, &pmtrace);
+
+
+			if (pmtrace.fraction != 1)
+			{
+				pe = gEngfuncs.pEventAPI->EV_GetPhysent(pmtrace.ent);
+
+				if (0 == pmtrace.ent || (pe->info != pTemp->clientIndex))
+				{
+					traceFraction = pmtrace.fraction;
+					VectorCopy(pmtrace.plane.normal, traceNormal);
+
+					if (pTemp->hitcallback)
 					{
-						traceFraction = pmtrace.fraction;
-						VectorCopy(pmtrace.plane.normal, traceNormal);
-
-						if ((pTemp->flags & FTENT_SPARKSHOWER) != 0)
-						{
-							// Chop spark speeds a bit more
-							//
-							VectorScale(pTemp->entity.baseline.origin, 0.6, pTemp->entity.baseline.origin);
-
-							if (Length(pTemp->entity.baseline.origin) < 10)
-							{
-								pTemp->entity.baseline.framerate = 0.0;
-							}
-						}
-
-						if (pTemp->hitcallback)
-						{
-							(*pTemp->hitcallback)(pTemp, &pmtrace);
-						}
+						(*pTemp->hitcallback)(pTemp, &pmtrace);
 					}
 				}
+			}
+		}
+		else if ((pTemp->flags & FTENT_COLLIDEWORLD) != 0)
+		{
+			pmtrace_t pmtrace;
+
+			gEngfuncs.pEventAPI->EV_SetTraceHull(2);
+
+			gEngfuncs.pEventAPI->EV_PlayerTrace(traceStart, pTemp->entity.origin, PM_STUDIO_BOX | PM_WORLD_ONLY, -1, &pmtrace);
 
-				if (traceFraction != 1) // Decent collision now, and damping works
+			if (pmtrace.fraction != 1)
+			{
+				traceFraction = pmtrace.fraction;
+				VectorCopy(pmtrace.plane.normal, traceNormal);
+
+				if ((pTemp->flags & FTENT_SPARKSHOWER) != 0)
 				{
-					float proj, damp;
+					// Chop spark speeds a bit more
+					//
+					VectorScale(pTemp->entity.baseline.origin, 0.6, pTemp->entity.baseline.origin);
 
-					// Place at contact point
-					VectorMA(pTemp->entity.prevstate.origin, traceFraction * frametime, pTemp->entity.baseline.origin, pTemp->entity.origin);
-					// Damp velocity
-					damp = pTemp->bounceFactor;
-					if ((pTemp->flags & (FTENT_GRAVITY | FTENT_SLOWGRAVITY)) != 0)
+					if (Length(pTemp->entity.baseline.origin) < 10)
 					{
-						damp *= 0.5;
-						if (traceNormal[2] > 0.9) // Hit floor?
-						{
-							if (pTemp->entity.baseline.origin[2] <= 0 && pTemp->entity.baseline.origin[2] >= gravity * 3)
-							{
-								damp = 0; // Stop
-								pTemp->flags &= ~(FTENT_ROTATE | FTENT_GRAVITY | FTENT_SLOWGRAVITY | FTENT_COLLIDEWORLD | FTENT_SMOKETRAIL);
-								pTemp->entity.angles[0] = 0;
-								pTemp->entity.angles[2] = 0;
-							}
-						}
+						pTemp->entity.baseline.framerate = 0.0;
 					}
+				}
 
-					if ((pTemp->hitSound) != 0)
-					{
-						Callback_TempEntPlaySound(pTemp, damp);
-					}
+				if (pTemp->hitcallback)
+				{
+					(*pTemp->hitcallback)(pTemp, &pmtrace);
+				}
+			}
+		}
 
-					if ((pTemp->flags & FTENT_COLLIDEKILL) != 0)
-					{
-						// die on impact
-						pTemp->flags &= ~FTENT_FADEOUT;
-						pTemp->die = client_time;
-					}
-					else
+		if (traceFraction != 1) // Decent collision now, and damping works
+		{
+			float proj, damp;
+
+			// Place at contact point
+			if (resumed)
+				pTemp->entity.origin = traceStart + (pTemp->entity.origin - traceStart) * traceFraction;
+			else
+				VectorMA(pTemp->entity.prevstate.origin, traceFraction * frametime, pTemp->entity.baseline.origin, pTemp->entity.origin);
+			// Damp velocity
+			damp = pTemp->bounceFactor;
+			if ((pTemp->flags & (FTENT_GRAVITY | FTENT_SLOWGRAVITY)) != 0)
+			{
+				damp *= 0.5;
+				if (traceNormal[2] > 0.9) // Hit floor?
+				{
+					if (pTemp->entity.baseline.origin[2] <= 0 && pTemp->entity.baseline.origin[2] >= gravity * 3)
 					{
-						// Reflect velocity
-						if (damp != 0)
-						{
-							proj = DotProduct(pTemp->entity.baseline.origin, traceNormal);
-							VectorMA(pTemp->entity.baseline.origin, -proj * 2, traceNormal, pTemp->entity.baseline.origin);
-							// Reflect rotation (fake)
-
-							pTemp->entity.angles[1] = -pTemp->entity.angles[1];
-						}
-
-						if (damp != 1)
-						{
-
-							VectorScale(pTemp->entity.baseline.origin, damp, pTemp->entity.baseline.origin);
-							VectorScale(pTemp->entity.angles, 0.9, pTemp->entity.angles);
-						}
+						damp = 0; // Stop
+						pTemp->flags &= ~(FTENT_ROTATE | FTENT_GRAVITY | FTENT_SLOWGRAVITY | FTENT_COLLIDEWORLD | FTENT_SMOKETRAIL);
+						pTemp->entity.angles[0] = 0;
+						pTemp->entity.angles[2] = 0;
 					}
 				}
 			}
 
-
-			if ((pTemp->flags & FTENT_FLICKER) != 0 && gTempEntFrame == pTemp->entity.curstate.effects)
+			if ((pTemp->hitSound) != 0)
 			{
-				dlight_t* dl = gEngfuncs.pEfxAPI->CL_AllocDlight(0);
-				VectorCopy(pTemp->entity.origin, dl->origin);
-				dl->radius = 60;
-				dl->color.r = 255;
-				dl->color.g = 120;
-				dl->color.b = 0;
-				dl->die = client_time + 0.01;
+				Callback_TempEntPlaySound(pTemp, damp);
 			}
 
-			if ((pTemp->flags & FTENT_SMOKETRAIL) != 0)
+			if ((pTemp->flags & FTENT_COLLIDEKILL) != 0)
 			{
-				gEngfuncs.pEfxAPI->R_RocketTrail(pTemp->entity.prevstate.origin, pTemp->entity.origin, 1);
+				// die on impact
+				pTemp->flags &= ~FTENT_FADEOUT;
+				pTemp->die = client_time;
 			}
+			else
+			{
+				// Reflect velocity
+				if (damp != 0)
+				{
+					proj = DotProduct(pTemp->entity.baseline.origin, traceNormal);
+					VectorMA(pTemp->entity.baseline.origin, -proj * 2, traceNormal, pTemp->entity.baseline.origin);
+					// Reflect rotation (fake)
 
-			if ((pTemp->flags & FTENT_GRAVITY) != 0)
-				pTemp->entity.baseline.origin[2] += gravity;
-			else if ((pTemp->flags & FTENT_SLOWGRAVITY) != 0)
-				pTemp->entity.baseline.origin[2] += gravitySlow;
+					pTemp->entity.angles[1] = -pTemp->entity.angles[1];
+				}
 
-			if ((pTemp->flags & FTENT_CLIENTCUSTOM) != 0)
-			{
-				if (pTemp->callback)
+				if (damp != 1)
 				{
-					(*pTemp->callback)(pTemp, frametime, client_time);
+
+					VectorScale(pTemp->entity.baseline.origin, damp, pTemp->entity.baseline.origin);
+					VectorScale(pTemp->entity.angles, 0.9, pTemp->entity.angles);
 				}
 			}
+		}
+	}
 
-			// Cull to PVS (not frustum cull, just PVS)
-			if ((pTemp->flags & FTENT_NOMODEL) == 0)
+	for (int j = 0; j < count; j++)
+	{
+		pTemp = tempents[j];
+
+		if ((pTemp->flags & FTENT_FLICKER) != 0 && gTempEntFrame == pTemp->entity.curstate.effects)
+		{
+			dlight_t* dl = gEngfuncs.pEfxAPI->CL_AllocDlight(0);
+			VectorCopy(pTemp->entity.origin, dl->origin);
+			dl->radius = 60;
+			dl->color.r = 255;
+			dl->color.g = 120;
+			dl->color.b = 0;
+			dl->die = client_time + 0.01;
+		}
+
+		if ((pTemp->flags & FTENT_SMOKETRAIL) != 0)
+		{
+			gEngfuncs.pEfxAPI->R_RocketTrail(pTemp->entity.prevstate.origin, pTemp->entity.origin, 1);
+		}
+	}
+
+	for (int j = 0; j < count; j++)
+	{
+		pTemp = tempents[j];
+
+		if ((pTemp->flags & FTENT_GRAVITY) != 0)
+			pTemp->entity.baseline.origin[2] += gravity;
+		else if ((pTemp->flags & FTENT_SLOWGRAVITY) != 0)
+			pTemp->entity.baseline.origin[2] += gravitySlow;
+	}
+
+	for (int j = 0; j < count; j++)
+	{
+		pTemp = tempents[j];
+
+		if ((pTemp->flags & FTENT_CLIENTCUSTOM) != 0)
+		{
+			if (pTemp->callback)
 			{
-				if (0 == Callback_AddVisibleEntity(&pTemp->entity))
-				{
-					if ((pTemp->flags & FTENT_PERSIST) == 0)
-					{
-						pTemp->die = client_time;		// If we can't draw it this frame, just dump it.
-						pTemp->flags &= ~FTENT_FADEOUT; // Don't fade out, just die
-					}
-				}
+				(*pTemp->callback)(pTemp, frametime, client_time);
 			}
 		}
-		pTemp = pnext;
+
+		// Frustum culled and added to the visible list once all of them have moved
+		if ((pTemp->flags & FTENT_NOMODEL) == 0)
+		{
+			visibleTempEnts.push_back(pTemp);
+		}
 	}
 
-finish:
+	CL_AddVisibleTempEnts(visibleTempEnts, client_time, Callback_AddVisibleEntity, true);
+
 	// Restore state info
-	gEngfuncs.pEventAPI->EV_PopPMStates();
+	if (playerPrediction)
+		gEngfuncs.pEventAPI->EV_PopPMStates();
 }
 
 /*
@@ -47,6 +47,9 @@ extern engine_studio_api_t IEngineStudio;
 static int tracerCount[MAX_PLAYERS];
 
 #include "pm_shared.h"
+#include "bullet_impacts.h"
+#include "impact_scheduler.h"
+#include "particle_effects.h"
 
 void V_PunchAxis(int axis, float punch);
 void VectorAngles(const float* forward, float* angles);
@@ -74,8 +77,6 @@ float EV_HLDM_PlayTextureSound(int idx, pmtrace_t* ptr, float* vecSrc, float* ve
 	float fattn = ATTN_NORM;
 	int entity;
 	char* pTextureName;
-	char texname[64];
-	char szbuffer[64];
 
 	entity = gEngfuncs.pEventAPI->EV_IndexFromTrace(ptr);
 
@@ -92,26 +93,8 @@ float EV_HLDM_PlayTextureSound(int idx, pmtrace_t* ptr, float* vecSrc, float* ve
 
 		if (pTextureName)
 		{
-			strcpy(texname, pTextureName);
-			pTextureName = texname;
-
-			// strip leading '-0' or '+0~' or '{' or '!'
-			if (*pTextureName == '-' || *pTextureName == '+')
-			{
-				pTextureName += 2;
-			}
-
-			if (*pTextureName == '{' || *pTextureName == '!' || *pTextureName == '~' || *pTextureName == ' ')
-			{
-				pTextureName++;
-			}
-
-			// '}}'
-			strcpy(szbuffer, pTextureName);
-			szbuffer[CBTEXTURENAMEMAX - 1] = 0;
-
 			// get texture type
-			chTextureType = PM_FindTextureType(szbuffer);
+			chTextureType = PM_FindTextureTypeCached(pTextureName);
 		}
 	}
 	else
@@ -245,14 +228,15 @@ char* EV_HLDM_DamageDecal(physent_t* pe)
 	return decalname;
 }
 
-void EV_HLDM_GunshotDecalTrace(pmtrace_t* pTrace, char* decalName)
+void EV_HLDM_GunshotDecalTrace(pmtrace_t* pTrace, char* decalName, bool playSound, bool local)
 {
 	int iRand;
 
-	gEngfuncs.pEfxAPI->R_BulletImpactParticles(pTrace->endpos);
+	if (ImpactScheduler_Allow(IMPACT_SPARKS, local))
+		ParticleEffects_BulletImpact(pTrace->endpos, pTrace->plane.normal);
 
 	iRand = gEngfuncs.pfnRandomLong(0, 0x7FFF);
-	if (iRand < (0x7fff / 2)) // not every bullet makes a sound.
+	if (playSound && iRand < (0x7fff / 2) && ImpactScheduler_Allow(IMPACT_SOUND, local)) // not every bullet makes a sound.
 	{
 		switch (iRand % 5)
 		{
@@ -275,15 +259,15 @@ void EV_HLDM_GunshotDecalTrace(pmtrace_t* pTrace, char* decalName)
 	}
 
 	// Only decal brush models such as the world etc.
-	if (decalName && '\0' != decalName[0] && r_decals->value > 0)
+	if (decalName && '\0' != decalName[0] && r_decals->value > 0 && ImpactScheduler_Allow(IMPACT_DECAL, local))
 	{
 		gEngfuncs.pEfxAPI->R_DecalShoot(
-			gEngfuncs.pEfxAPI->Draw_DecalIndex(gEngfuncs.pEfxAPI->Draw_DecalIndexFromName(decalName)),
+			ImpactScheduler_DecalIndex(decalName),
 			gEngfuncs.pEventAPI->EV_IndexFromTrace(pTrace), 0, pTrace->endpos, 0);
 	}
 }
 
-void EV_HLDM_DecalGunshot(pmtrace_t* pTrace, int iBulletType)
+void EV_HLDM_DecalGunshot(pmtrace_t* pTrace, int iBulletType, bool playSound, bool local)
 {
 	physent_t* pe;
 
@@ -301,7 +285,7 @@ void EV_HLDM_DecalGunshot(pmtrace_t* pTrace, int iBulletType)
 		case BULLET_PLAYER_357:
 		default:
 			// smoke and decal
-			EV_HLDM_GunshotDecalTrace(pTrace, EV_HLDM_DamageDecal(pe));
+			EV_HLDM_GunshotDecalTrace(pTrace, EV_HLDM_DamageDecal(pe), playSound, local);
 			break;
 		}
 	}
@@ -345,6 +329,24 @@ void EV_HLDM_CheckTracer(int idx, float* vecSrc, float* end, float* forward, flo
 }
 
 
+// Plays the impact sound and paints the decal for a pellet. Only the first pellet to hit a surface
+// makes a sound, and pellets landing on top of an earlier one share its decal.
+// Impacts close to a recent one from another shot make no decal or sparks, see impact_scheduler.h.
+static void EV_HLDM_BulletImpact(CBulletImpacts& impacts, int idx, pmtrace_t* ptr, float* vecSrc, float* vecEnd, int iBulletType, bool playTextureSound)
+{
+	physent_t* pe = gEngfuncs.pEventAPI->EV_GetPhysent(ptr->ent);
+
+	const bool firstOnSurface = impacts.AddImpact(gEngfuncs.pEventAPI->EV_IndexFromTrace(ptr), EV_HLDM_IsBSPModel(pe), ptr->plane.normal, ptr->plane.dist);
+
+	const bool local = EV_IsLocal(idx);
+
+	if (playTextureSound && firstOnSurface && ImpactScheduler_Allow(IMPACT_SOUND, local))
+		EV_HLDM_PlayTextureSound(idx, ptr, vecSrc, vecEnd, iBulletType);
+
+	if (impacts.AddDecal(ptr->endpos) && ImpactScheduler_AddImpact(ptr->endpos, local))
+		EV_HLDM_DecalGunshot(ptr, iBulletType, firstOnSurface, local);
+}
+
 /*
 ================
 FireBullets
@@ -357,6 +359,18 @@ void EV_HLDM_FireBullets(int idx, float* forward, float* right, float* up, int c
 	int i;
 	pmtrace_t tr;
 	int iShot;
+	CBulletImpacts impacts;
+
+	// Player positions don't change between pellets, so set up the trace state once for the whole shot.
+	gEngfuncs.pEventAPI->EV_SetUpPlayerPrediction(0, 1);
+
+	// Store off the old count
+	gEngfuncs.pEventAPI->EV_PushPMStates();
+
+	// Now add in all of the players.
+	gEngfuncs.pEventAPI->EV_SetSolidPlayers(idx - 1);
+
+	gEngfuncs.pEventAPI->EV_SetTraceHull(2);
 
 	for (iShot = 1; iShot <= cShots; iShot++)
 	{
@@ -389,15 +403,6 @@ void EV_HLDM_FireBullets(int idx, float* forward, float* right, float* up, int c
 			}
 		}
 
-		gEngfuncs.pEventAPI->EV_SetUpPlayerPrediction(0, 1);
-
-		// Store off the old count
-		gEngfuncs.pEventAPI->EV_PushPMStates();
-
-		// Now add in all of the players.
-		gEngfuncs.pEventAPI->EV_SetSolidPlayers(idx - 1);
-
-		gEngfuncs.pEventAPI->EV_SetTraceHull(2);
 		// JoshA: Changed from PM_STUDIO_BOX to PM_NORMAL in prediction code as otherwise if you hit an NPC or player's
 		// bounding box but not one of their hitboxes, the shot won't hit on the server but it will
 		// play a hit sound on the client and not make a decal (as if it hit the NPC/player).
@@ -418,32 +423,19 @@ void EV_HLDM_FireBullets(int idx, float* forward, float* right, float* up, int c
 			{
 			default:
 			case BULLET_PLAYER_9MM:
-
-				EV_HLDM_PlayTextureSound(idx, &tr, vecSrc, vecEnd, iBulletType);
-				EV_HLDM_DecalGunshot(&tr, iBulletType);
-
-				break;
 			case BULLET_PLAYER_MP5:
-
-				EV_HLDM_PlayTextureSound(idx, &tr, vecSrc, vecEnd, iBulletType);
-				EV_HLDM_DecalGunshot(&tr, iBulletType);
-				break;
-			case BULLET_PLAYER_BUCKSHOT:
-
-				EV_HLDM_DecalGunshot(&tr, iBulletType);
-
-				break;
 			case BULLET_PLAYER_357:
+				EV_HLDM_BulletImpact(impacts, idx, &tr, vecSrc, vecEnd, iBulletType, true);
+				break;
 
-				EV_HLDM_PlayTextureSound(idx, &tr, vecSrc, vecEnd, iBulletType);
-				EV_HLDM_DecalGunshot(&tr, iBulletType);
-
+			case BULLET_PLAYER_BUCKSHOT:
+				EV_HLDM_BulletImpact(impacts, idx, &tr, vecSrc, vecEnd, iBulletType, false);
 				break;
 			}
 		}
-
-		gEngfuncs.pEventAPI->EV_PopPMStates();
 	}
+
+	gEngfuncs.pEventAPI->EV_PopPMStates();
 }
 
 //======================
@@ -1051,7 +1043,7 @@ void EV_FireGauss(event_args_t* args)
 			else
 			{
 				// tunnel
-				EV_HLDM_DecalGunshot(&tr, BULLET_MONSTER_12MM);
+				EV_HLDM_DecalGunshot(&tr, BULLET_MONSTER_12MM, true, EV_IsLocal(idx));
 
 				gEngfuncs.pEfxAPI->R_TempSprite(tr.endpos, vec3_origin, 1.0, m_iGlow, kRenderGlow, kRenderFxNoDissipation, flDamage / 255.0, 6.0, FTENT_FADEOUT);
 
@@ -1108,7 +1100,7 @@ void EV_FireGauss(event_args_t* args)
 							//////////////////////////////////// WHAT TO DO HERE
 							// CSoundEnt::InsertSound ( bits_SOUND_COMBAT, pev->origin, NORMAL_EXPLOSION_VOLUME, 3.0 );
 
-							EV_HLDM_DecalGunshot(&beam_tr, BULLET_MONSTER_12MM);
+							EV_HLDM_DecalGunshot(&beam_tr, BULLET_MONSTER_12MM, true, EV_IsLocal(idx));
 
 							gEngfuncs.pEfxAPI->R_TempSprite(beam_tr.endpos, vec3_origin, 0.1, m_iGlow, kRenderGlow, kRenderFxNoDissipation, flDamage / 255.0, 6.0, FTENT_FADEOUT);
 
@@ -1288,7 +1280,7 @@ void EV_FireCrossbow2(event_args_t* args)
 
 			//Not underwater, do some sparks...
 			if (gEngfuncs.PM_PointContents(tr.endpos, NULL) != CONTENTS_WATER)
-				gEngfuncs.pEfxAPI->R_SparkShower(tr.endpos);
+				ParticleEffects_SparkShower(tr.endpos);
 
 			Vector vBoltAngles;
 			int iModelIndex = gEngfuncs.pEventAPI->EV_FindModelIndex("models/crossbow_bolt.mdl");
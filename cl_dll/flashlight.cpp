@@ -121,15 +121,13 @@ bool CHudFlashlight::Draw(float flTime)
 	x = ScreenWidth - m_iWidth - m_iWidth / 2;
 
 	// Draw the flashlight casing
-	SPR_Set(m_hSprite1, r, g, b);
-	SPR_DrawAdditive(0, x, y, m_prc1);
+	gHUD.m_SpriteBatch.DrawAdditive(m_hSprite1, r, g, b, 0, x, y, m_prc1);
 
 	if (m_fOn)
 	{ // draw the flashlight beam
 		x = ScreenWidth - m_iWidth / 2;
 
-		SPR_Set(m_hBeam, r, g, b);
-		SPR_DrawAdditive(0, x, y, m_prcBeam);
+		gHUD.m_SpriteBatch.DrawAdditive(m_hBeam, r, g, b, 0, x, y, m_prcBeam);
 	}
 
 	// draw the flashlight energy level
@@ -140,8 +138,7 @@ bool CHudFlashlight::Draw(float flTime)
 		rc = *m_prc2;
 		rc.left += iOffset;
 
-		SPR_Set(m_hSprite2, r, g, b);
-		SPR_DrawAdditive(0, x + iOffset, y, &rc);
+		gHUD.m_SpriteBatch.DrawAdditive(m_hSprite2, r, g, b, 0, x + iOffset, y, &rc);
 	}
 
 
@@ -92,6 +92,8 @@ bool CHudHealth::VidInit()
 
 	giDmgHeight = gHUD.GetSpriteRect(m_HUD_dmg_bio).right - gHUD.GetSpriteRect(m_HUD_dmg_bio).left;
 	giDmgWidth = gHUD.GetSpriteRect(m_HUD_dmg_bio).bottom - gHUD.GetSpriteRect(m_HUD_dmg_bio).top;
+
+	m_bDirty = true;
 	return true;
 }
 
@@ -108,6 +110,7 @@ bool CHudHealth::MsgFunc_Health(const char* pszName, int iSize, void* pbuf)
 	{
 		m_fFade = FADE_TIME;
 		m_iHealth = x;
+		m_bDirty = true;
 	}
 
 	return true;
@@ -210,14 +213,19 @@ bool CHudHealth::Draw(float flTime)
 		y = ScreenHeight - gHUD.m_iFontHeight - gHUD.m_iFontHeight / 2;
 		x = CrossWidth / 2;
 
-		SPR_Set(gHUD.GetSprite(m_HUD_cross), r, g, b);
-		SPR_DrawAdditive(0, x, y, &gHUD.GetSpriteRect(m_HUD_cross));
+		gHUD.m_SpriteBatch.DrawAdditive(gHUD.GetSprite(m_HUD_cross), r, g, b, 0, x, y, &gHUD.GetSpriteRect(m_HUD_cross));
 
 		x = CrossWidth + HealthWidth / 2;
 		y += (int)(gHUD.m_iFontHeight * 0.2f);
 
 		//Reserve space for 3 digits by default, but allow it to expand
-		x += gHUD.GetHudNumberWidth(m_iHealth, 3, DHN_DRAWZERO);
+		if (m_bDirty)
+		{
+			m_iHealthWidth = gHUD.GetHudNumberWidth(m_iHealth, 3, DHN_DRAWZERO);
+			m_bDirty = false;
+		}
+
+		x += m_iHealthWidth;
 
 		gHUD.DrawHudNumberReverse(x, y, m_iHealth, DHN_DRAWZERO, r, g, b);
 
@@ -313,11 +321,10 @@ bool CHudHealth::DrawPain(float flTime)
 		GetPainColor(r, g, b);
 		shade = a * V_max(m_fAttackFront, 0.5f);
 		ScaleColors(r, g, b, shade);
-		SPR_Set(m_hSprite, r, g, b);
 
 		x = ScreenWidth / 2 - SPR_Width(m_hSprite, 0) / 2;
 		y = ScreenHeight / 2 - SPR_Height(m_hSprite, 0) * 3;
-		SPR_DrawAdditive(0, x, y, NULL);
+		gHUD.m_SpriteBatch.DrawAdditive(m_hSprite, r, g, b, 0, x, y, NULL);
 		m_fAttackFront = V_max(0.0f, m_fAttackFront - fFade);
 	}
 	else
@@ -328,11 +335,10 @@ bool CHudHealth::DrawPain(float flTime)
 		GetPainColor(r, g, b);
 		shade = a * V_max(m_fAttackRight, 0.5f);
 		ScaleColors(r, g, b, shade);
-		SPR_Set(m_hSprite, r, g, b);
 
 		x = ScreenWidth / 2 + SPR_Width(m_hSprite, 1) * 2;
 		y = ScreenHeight / 2 - SPR_Height(m_hSprite, 1) / 2;
-		SPR_DrawAdditive(1, x, y, NULL);
+		gHUD.m_SpriteBatch.DrawAdditive(m_hSprite, r, g, b, 1, x, y, NULL);
 		m_fAttackRight = V_max(0.0f, m_fAttackRight - fFade);
 	}
 	else
@@ -343,11 +349,10 @@ bool CHudHealth::DrawPain(float flTime)
 		GetPainColor(r, g, b);
 		shade = a * V_max(m_fAttackRear, 0.5f);
 		ScaleColors(r, g, b, shade);
-		SPR_Set(m_hSprite, r, g, b);
 
 		x = ScreenWidth / 2 - SPR_Width(m_hSprite, 2) / 2;
 		y = ScreenHeight / 2 + SPR_Height(m_hSprite, 2) * 2;
-		SPR_DrawAdditive(2, x, y, NULL);
+		gHUD.m_SpriteBatch.DrawAdditive(m_hSprite, r, g, b, 2, x, y, NULL);
 		m_fAttackRear = V_max(0.0f, m_fAttackRear - fFade);
 	}
 	else
@@ -358,11 +363,10 @@ bool CHudHealth::DrawPain(float flTime)
 		GetPainColor(r, g, b);
 		shade = a * V_max(m_fAttackLeft, 0.5f);
 		ScaleColors(r, g, b, shade);
-		SPR_Set(m_hSprite, r, g, b);
 
 		x = ScreenWidth / 2 - SPR_Width(m_hSprite, 3) * 3;
 		y = ScreenHeight / 2 - SPR_Height(m_hSprite, 3) / 2;
-		SPR_DrawAdditive(3, x, y, NULL);
+		gHUD.m_SpriteBatch.DrawAdditive(m_hSprite, r, g, b, 3, x, y, NULL);
 
 		m_fAttackLeft = V_max(0.0f, m_fAttackLeft - fFade);
 	}
@@ -393,8 +397,7 @@ bool CHudHealth::DrawDamage(float flTime)
 		if ((m_bitsDamage & giDmgFlags[i]) != 0)
 		{
 			pdmg = &m_dmg[i];
-			SPR_Set(gHUD.GetSprite(m_HUD_dmg_bio + i), r, g, b);
-			SPR_DrawAdditive(0, pdmg->x, pdmg->y, &gHUD.GetSpriteRect(m_HUD_dmg_bio + i));
+			gHUD.m_SpriteBatch.DrawAdditive(gHUD.GetSprite(m_HUD_dmg_bio + i), r, g, b, 0, pdmg->x, pdmg->y, &gHUD.GetSpriteRect(m_HUD_dmg_bio + i));
 		}
 	}
 
@@ -65,6 +65,7 @@ private:
 
 	DAMAGE_IMAGE m_dmg[NUM_DMG_TYPES];
 	int m_bitsDamage;
+	int m_iHealthWidth; // width of m_iHealth as drawn, updated when dirty
 	bool DrawPain(float fTime);
 	bool DrawDamage(float fTime);
 	void CalcDamageDirection(Vector vecFrom);
@@ -29,6 +29,7 @@
 #include "cl_dll.h"
 #include "../com_weapons.h"
 #include "../demo.h"
+#include "../prediction_debug.h"
 
 extern int g_iUser1;
 
@@ -929,4 +930,13 @@ void DLLEXPORT HUD_PostRunCmd(struct local_state_s* from, struct local_state_s*
 	// All games can use FOV state
 	g_lastFOV = to->client.fov;
 	g_CurrentWeaponId = to->client.m_iId;
+
+	if (g_runfuncs)
+	{
+#if defined(CLIENT_WEAPONS)
+		PredictionDebug_Record(to, cmd, random_seed, cl_lw && 0 != cl_lw->value);
+#else
+		PredictionDebug_Record(to, cmd, random_seed, false);
+#endif
+	}
 }
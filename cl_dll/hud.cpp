@@ -29,6 +29,11 @@
 #include "demo.h"
 #include "demo_api.h"
 #include "vgui_ScorePanel.h"
+#include "com_model.h"
+#include "pm_shared.h"
+#include "prediction_debug.h"
+#include "impact_scheduler.h"
+#include "particle_effects.h"
 
 #include "bassmanager.h"
 
@@ -88,8 +93,11 @@ cvar_t* cl_rollangle = nullptr;
 cvar_t* cl_rollspeed = nullptr;
 cvar_t* cl_bobtilt = nullptr;
 cvar_t* r_decals = nullptr;
+cvar_t* cl_tempentcull = nullptr;
+cvar_t* cl_tempenttracebudget = nullptr;
 
 void ShutdownInput();
+void StudioClearAnimCache();
 
 //DECLARE_MESSAGE(m_Logo, Logo)
 int __MsgFunc_Logo(const char* pszName, int iSize, void* pbuf)
@@ -321,6 +329,10 @@ void CHud::Init()
 	// VGUI Menus
 	HOOK_MESSAGE(VGUIMenu);
 
+	PredictionDebug_Init();
+	ImpactScheduler_Init();
+	ParticleEffects_Init();
+
 	CVAR_CREATE("hud_classautokill", "1", FCVAR_ARCHIVE | FCVAR_USERINFO); // controls whether or not to suicide immediately on TF class switch
 	CVAR_CREATE("hud_takesshots", "0", FCVAR_ARCHIVE);					   // controls whether or not to automatically take screenshots at the end of a round
 
@@ -333,11 +345,14 @@ void CHud::Init()
 	default_fov = CVAR_CREATE("default_fov", "90", FCVAR_ARCHIVE);
 	m_pCvarStealMouse = CVAR_CREATE("hud_capturemouse", "1", FCVAR_ARCHIVE);
 	m_pCvarDraw = CVAR_CREATE("hud_draw", "1", FCVAR_ARCHIVE);
+	m_pCvarTimings = CVAR_CREATE("hud_timings", "0", 0);
 	cl_lw = gEngfuncs.pfnGetCvarPointer("cl_lw");
 	cl_rollangle = CVAR_CREATE("cl_rollangle", "2.0", FCVAR_ARCHIVE);
 	cl_rollspeed = CVAR_CREATE("cl_rollspeed", "200", FCVAR_ARCHIVE);
 	cl_bobtilt = CVAR_CREATE("cl_bobtilt", "0", FCVAR_ARCHIVE);
 	r_decals = gEngfuncs.pfnGetCvarPointer("r_decals");
+	cl_tempentcull = CVAR_CREATE("cl_tempentcull", "1", FCVAR_ARCHIVE);
+	cl_tempenttracebudget = CVAR_CREATE("cl_tempenttracebudget", "128", FCVAR_ARCHIVE);
 
 	m_pSpriteList = NULL;
 
@@ -528,6 +543,26 @@ void CHud::VidInit()
 	m_TextMessage.VidInit();
 	m_StatusIcons.VidInit();
 	GetClientVoiceMgr()->VidInit();
+
+	// Models of the previous map may have been freed
+	StudioClearAnimCache();
+
+	ImpactScheduler_Reset();
+	ParticleEffects_VidInit();
+
+	// Look up the world's texture types now instead of on the first footstep or impact on each texture
+	PM_ClearTextureTypeCache();
+
+	cl_entity_t* world = gEngfuncs.GetEntityByIndex(0);
+
+	if (world && world->model)
+	{
+		for (int i = 0; i < world->model->numtextures; i++)
+		{
+			if (world->model->textures[i])
+				PM_FindTextureTypeCached(world->model->textures[i]->name);
+		}
+	}
 }
 
 bool CHud::MsgFunc_Logo(const char* pszName, int iSize, void* pbuf)
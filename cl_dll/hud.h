@@ -29,6 +29,7 @@
 #include "common_types.h"
 #include "cl_dll.h"
 #include "ammo.h"
+#include "hud_sprite_batch.h"
 
 #define DHN_DRAWZERO 1
 #define DHN_2DIGITS 2
@@ -68,6 +69,7 @@ public:
 	POSITION m_pos;
 	int m_type;
 	int m_iFlags; // active, moving,
+	bool m_bDirty = true; // set when what the element shows has changed, so text and numbers are measured again on the next draw
 	virtual ~CHudBase() {}
 	virtual bool Init() { return false; }
 	virtual bool VidInit() { return false; }
@@ -77,6 +79,18 @@ public:
 	virtual void InitHUDData() {} // called every time a server is connected to
 };
 
+// Digits of a number as DrawHudNumber lays them out, in digit widths from the start of the number.
+// Passing the same layout each frame only lays the number out again when it or the flags change.
+struct HudNumberLayout
+{
+	int number = -1;
+	int flags = -1;
+	int count = 0;
+	int digits[3];
+	int offsets[3];
+	int width = 0;
+};
+
 struct HUDLIST
 {
 	CHudBase* p;
@@ -133,6 +147,9 @@ private:
 	WEAPON* m_pWeapon;
 	int m_HUD_bucket0;
 	int m_HUD_selection;
+	HudNumberLayout m_ClipLayout;
+	HudNumberLayout m_AmmoLayout;
+	HudNumberLayout m_Ammo2Layout;
 };
 
 //
@@ -224,6 +241,8 @@ protected:
 
 	char m_szStatusText[MAX_STATUSBAR_LINES][MAX_STATUSTEXT_LENGTH]; // a text string describing how the status bar is to be drawn
 	char m_szStatusBar[MAX_STATUSBAR_LINES][MAX_STATUSTEXT_LENGTH];	 // the constructed bar that is drawn
+	int m_iTextWidth[MAX_STATUSBAR_LINES];							 // size of each line, measured when dirty
+	int m_iTextHeight[MAX_STATUSBAR_LINES];
 	int m_iStatusValues[MAX_STATUSBAR_VALUES];						 // an array of values for use in the status bar
 
 	bool m_bReparseString; // set to true whenever the m_szStatusBar needs to be recalculated
@@ -337,6 +356,7 @@ private:
 	int m_iBatMax;
 	float m_fFade;
 	int m_iHeight; // width of the battery innards
+	HudNumberLayout m_BatLayout;
 };
 
 
@@ -494,6 +514,12 @@ private:
 	float m_flMouseSensitivity;
 	int m_iConcussionEffect;
 
+	cvar_t* m_pCvarTimings = nullptr;
+	std::vector<float> m_flDrawTimes; // average time each element's Draw took in milliseconds, in m_pHudList order
+	float m_flFlushTime = 0;
+
+	void DrawTimings();
+
 public:
 	HSPRITE m_hsprCursor;
 	float m_flTime;		  // the current client time
@@ -511,6 +537,7 @@ public:
 
 	int m_iFontHeight;
 	int DrawHudNumber(int x, int y, int iFlags, int iNumber, int r, int g, int b);
+	int DrawHudNumber(HudNumberLayout& layout, int x, int y, int iFlags, int iNumber, int r, int g, int b);
 	int DrawHudString(int x, int y, int iMaxX, const char* szString, int r, int g, int b);
 	int DrawHudStringReverse(int xpos, int ypos, int iMinX, const char* szString, int r, int g, int b);
 	int DrawHudNumberString(int xpos, int ypos, int iMinX, int iNumber, int r, int g, int b);
@@ -573,6 +600,8 @@ public:
 	CHudTextMessage m_TextMessage;
 	CHudStatusIcons m_StatusIcons;
 
+	CHudSpriteBatch m_SpriteBatch;
+
 	void Init();
 	void VidInit();
 	void Think();
@@ -15,6 +15,9 @@
 //
 // hud_redraw.cpp
 //
+#include <chrono>
+#include <typeinfo>
+
 #include "hud.h"
 #include "cl_util.h"
 
@@ -22,6 +25,9 @@
 
 #define MAX_LOGO_FRAMES 56
 
+// How much of the new time goes into the averages hud_timings shows
+#define HUD_TIMINGS_SMOOTHING 0.05f
+
 int grgLogoFrame[MAX_LOGO_FRAMES] =
 	{
 		1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 13, 13, 13, 13, 13, 12, 11, 10, 9, 8, 14, 15,
@@ -35,6 +41,8 @@ float HUD_GetFOV();
 
 extern float IN_GetMouseSensitivity();
 
+void R_StudioDrawOverlay();
+
 // Think
 void CHud::Think()
 {
@@ -140,10 +148,19 @@ bool CHud::Redraw(float flTime, bool intermission)
 	// draw all registered HUD elements
 	if (0 != m_pCvarDraw->value)
 	{
+		using Clock = std::chrono::high_resolution_clock;
+
+		const bool timings = 0 != m_pCvarTimings->value;
+		std::size_t element = 0;
+
 		HUDLIST* pList = m_pHudList;
 
+		m_SpriteBatch.Begin();
+
 		while (pList)
 		{
+			const auto start = timings ? Clock::now() : Clock::time_point{};
+
 			if (!intermission)
 			{
 				if ((pList->p->m_iFlags & HUD_ACTIVE) != 0 && (m_iHideHUDDisplay & HIDEHUD_ALL) == 0)
@@ -155,10 +172,34 @@ bool CHud::Redraw(float flTime, bool intermission)
 					pList->p->Draw(flTime);
 			}
 
+			if (timings)
+			{
+				if (element >= m_flDrawTimes.size())
+					m_flDrawTimes.resize(element + 1);
+
+				const float time = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+				m_flDrawTimes[element] += (time - m_flDrawTimes[element]) * HUD_TIMINGS_SMOOTHING;
+			}
+
+			++element;
 			pList = pList->pNext;
 		}
+
+		const auto flushStart = timings ? Clock::now() : Clock::time_point{};
+
+		m_SpriteBatch.Flush();
+
+		if (timings)
+		{
+			const float time = std::chrono::duration<float, std::milli>(Clock::now() - flushStart).count();
+			m_flFlushTime += (time - m_flFlushTime) * HUD_TIMINGS_SMOOTHING;
+
+			DrawTimings();
+		}
 	}
 
+	R_StudioDrawOverlay();
+
 	// are we in demo mode? do we need to draw the logo in the top corner?
 	if (0 != m_iLogo)
 	{
@@ -205,6 +246,34 @@ bool CHud::Redraw(float flTime, bool intermission)
 	return true;
 }
 
+// Shows how long each element took to draw, and how long drawing the batched sprites took
+void CHud::DrawTimings()
+{
+	char szLine[128];
+	int y = ScreenHeight / 4;
+
+	HUDLIST* pList = m_pHudList;
+
+	for (std::size_t i = 0; pList && i < m_flDrawTimes.size(); ++i, pList = pList->pNext)
+	{
+		// GCC prefixes class names with their length
+		const char* name = typeid(*pList->p).name();
+
+		while (*name >= '0' && *name <= '9')
+			++name;
+
+		if (0 == strncmp(name, "class ", 6))
+			name += 6;
+
+		sprintf(szLine, "%s: %.3f ms", name, m_flDrawTimes[i]);
+		DrawConsoleString(XRES(8), y, szLine);
+		y += m_scrinfo.iCharHeight;
+	}
+
+	sprintf(szLine, "sprites: %.3f ms, %d drawn, %d SPR_Set calls", m_flFlushTime, m_SpriteBatch.GetDrawCount(), m_SpriteBatch.GetSetCount());
+	DrawConsoleString(XRES(8), y, szLine);
+}
+
 void ScaleColors(int& r, int& g, int& b, int a)
 {
 	float x = (float)a / 255;
@@ -233,69 +302,88 @@ int CHud::DrawHudStringReverse(int xpos, int ypos, int iMinX, const char* szStri
 
 int CHud::DrawHudNumber(int x, int y, int iFlags, int iNumber, int r, int g, int b)
 {
-	int iWidth = GetSpriteRect(m_HUD_number_0).right - GetSpriteRect(m_HUD_number_0).left;
-	int k;
+	HudNumberLayout layout;
+	return DrawHudNumber(layout, x, y, iFlags, iNumber, r, g, b);
+}
+
+static void LayoutHudNumber(HudNumberLayout& layout, int iFlags, int iNumber)
+{
+	int position = 0;
+
+	layout.number = iNumber;
+	layout.flags = iFlags;
+	layout.count = 0;
+
+	const auto addDigit = [&](int digit)
+	{
+		layout.digits[layout.count] = digit;
+		layout.offsets[layout.count] = position;
+		++layout.count;
+	};
 
 	if (iNumber > 0)
 	{
 		// SPR_Draw 100's
 		if (iNumber >= 100)
 		{
-			k = iNumber / 100;
-			SPR_Set(GetSprite(m_HUD_number_0 + k), r, g, b);
-			SPR_DrawAdditive(0, x, y, &GetSpriteRect(m_HUD_number_0 + k));
-			x += iWidth;
+			addDigit(iNumber / 100);
+			++position;
 		}
 		else if ((iFlags & DHN_3DIGITS) != 0)
 		{
-			//SPR_DrawAdditive( 0, x, y, &rc );
-			x += iWidth;
+			++position;
 		}
 
 		// SPR_Draw 10's
 		if (iNumber >= 10)
 		{
-			k = (iNumber % 100) / 10;
-			SPR_Set(GetSprite(m_HUD_number_0 + k), r, g, b);
-			SPR_DrawAdditive(0, x, y, &GetSpriteRect(m_HUD_number_0 + k));
-			x += iWidth;
+			addDigit((iNumber % 100) / 10);
+			++position;
 		}
 		else if ((iFlags & (DHN_3DIGITS | DHN_2DIGITS)) != 0)
 		{
-			//SPR_DrawAdditive( 0, x, y, &rc );
-			x += iWidth;
+			++position;
 		}
 
 		// SPR_Draw ones
-		k = iNumber % 10;
-		SPR_Set(GetSprite(m_HUD_number_0 + k), r, g, b);
-		SPR_DrawAdditive(0, x, y, &GetSpriteRect(m_HUD_number_0 + k));
-		x += iWidth;
+		addDigit(iNumber % 10);
+		++position;
 	}
 	else if ((iFlags & DHN_DRAWZERO) != 0)
 	{
-		SPR_Set(GetSprite(m_HUD_number_0), r, g, b);
-
 		// SPR_Draw 100's
 		if ((iFlags & DHN_3DIGITS) != 0)
 		{
-			//SPR_DrawAdditive( 0, x, y, &rc );
-			x += iWidth;
+			++position;
 		}
 
 		if ((iFlags & (DHN_3DIGITS | DHN_2DIGITS)) != 0)
 		{
-			//SPR_DrawAdditive( 0, x, y, &rc );
-			x += iWidth;
+			++position;
 		}
 
 		// SPR_Draw ones
+		addDigit(0);
+		++position;
+	}
 
-		SPR_DrawAdditive(0, x, y, &GetSpriteRect(m_HUD_number_0));
-		x += iWidth;
+	layout.width = position;
+}
+
+int CHud::DrawHudNumber(HudNumberLayout& layout, int x, int y, int iFlags, int iNumber, int r, int g, int b)
+{
+	int iWidth = GetSpriteRect(m_HUD_number_0).right - GetSpriteRect(m_HUD_number_0).left;
+
+	if (layout.number != iNumber || layout.flags != iFlags)
+		LayoutHudNumber(layout, iFlags, iNumber);
+
+	for (int i = 0; i < layout.count; ++i)
+	{
+		const int k = m_HUD_number_0 + layout.digits[i];
+		m_SpriteBatch.DrawAdditive(GetSprite(k), r, g, b, 0, x + layout.offsets[i] * iWidth, y, &GetSpriteRect(k));
 	}
 
-	return x;
+	return x + layout.width * iWidth;
 }
 
 
@@ -360,8 +448,7 @@ int CHud::DrawHudNumberReverse(int x, int y, int number, int flags, int r, int g
 			//This has to happen *before* drawing because we're drawing in reverse
 			x -= digitWidth;
 
-			SPR_Set(GetSprite(digitSpriteIndex), r, g, b);
-			SPR_DrawAdditive(0, x, y, &GetSpriteRect(digitSpriteIndex));
+			m_SpriteBatch.DrawAdditive(GetSprite(digitSpriteIndex), r, g, b, 0, x, y, &GetSpriteRect(digitSpriteIndex));
 
 			remainder /= 10;
 		} while (remainder > 0);
@@ -0,0 +1,92 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+//
+// hud_sprite_batch.cpp
+//
+
+#include <algorithm>
+
+#include "hud.h"
+#include "cl_util.h"
+
+void CHudSpriteBatch::Begin()
+{
+	m_bBatching = true;
+	m_Draws.clear();
+}
+
+void CHudSpriteBatch::DrawAdditive(HSPRITE sprite, int r, int g, int b, int frame, int x, int y, const Rect* rect)
+{
+	if (!m_bBatching)
+	{
+		SPR_Set(sprite, r, g, b);
+		SPR_DrawAdditive(frame, x, y, rect);
+		return;
+	}
+
+	SpriteDraw draw;
+
+	draw.sprite = sprite;
+	draw.r = r;
+	draw.g = g;
+	draw.b = b;
+	draw.frame = frame;
+	draw.x = x;
+	draw.y = y;
+	draw.hasRect = rect != nullptr;
+
+	if (rect)
+		draw.rect = *rect;
+
+	m_Draws.push_back(draw);
+}
+
+void CHudSpriteBatch::Flush()
+{
+	m_bBatching = false;
+
+	// Stable so sprites of the same group are still drawn in the order the elements drew them
+	std::stable_sort(m_Draws.begin(), m_Draws.end(), [](const SpriteDraw& lhs, const SpriteDraw& rhs)
+		{
+			if (lhs.sprite != rhs.sprite)
+				return lhs.sprite < rhs.sprite;
+			if (lhs.r != rhs.r)
+				return lhs.r < rhs.r;
+			if (lhs.g != rhs.g)
+				return lhs.g < rhs.g;
+			return lhs.b < rhs.b;
+		});
+
+	const SpriteDraw* last = nullptr;
+
+	m_iLastSets = 0;
+
+	for (const auto& draw : m_Draws)
+	{
+		if (!last || last->sprite != draw.sprite || last->r != draw.r || last->g != draw.g || last->b != draw.b)
+		{
+			SPR_Set(draw.sprite, draw.r, draw.g, draw.b);
+			++m_iLastSets;
+		}
+
+		SPR_DrawAdditive(draw.frame, draw.x, draw.y, draw.hasRect ? &draw.rect : nullptr);
+
+		last = &draw;
+	}
+
+	m_iLastDraws = static_cast<int>(m_Draws.size());
+
+	m_Draws.clear();
+}
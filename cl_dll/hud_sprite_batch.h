@@ -0,0 +1,63 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+//
+// hud_sprite_batch.h
+//
+
+#pragma once
+
+#include <vector>
+
+/**
+*	@brief Collects the additive sprite draws of the HUD elements and draws them grouped by sprite and color,
+*	so SPR_Set is only called when one of those changes. Additive drawing gives the same result in any order.
+*	Outside of Begin and Flush sprites are drawn right away.
+*/
+class CHudSpriteBatch
+{
+public:
+	void Begin();
+
+	/**
+	*	@brief SPR_Set followed by SPR_DrawAdditive.
+	*	@param rect Part of the frame to draw, or null for all of it. Copied.
+	*/
+	void DrawAdditive(HSPRITE sprite, int r, int g, int b, int frame, int x, int y, const Rect* rect);
+
+	void Flush();
+
+	/**
+	*	@brief Sprites drawn and SPR_Set calls made by the last Flush.
+	*/
+	int GetDrawCount() const { return m_iLastDraws; }
+	int GetSetCount() const { return m_iLastSets; }
+
+private:
+	struct SpriteDraw
+	{
+		HSPRITE sprite;
+		int r, g, b;
+		int frame;
+		int x, y;
+		bool hasRect;
+		Rect rect;
+	};
+
+	bool m_bBatching = false;
+	std::vector<SpriteDraw> m_Draws;
+
+	int m_iLastDraws = 0;
+	int m_iLastSets = 0;
+};
@@ -0,0 +1,162 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+//
+// impact_scheduler.cpp
+//
+
+#include <string>
+#include <unordered_map>
+
+#include "hud.h"
+#include "cl_util.h"
+#include "r_efx.h"
+#include "impact_scheduler.h"
+
+// Impacts closer together in time than this are coalesced
+#define IMPACT_COALESCE_TIME 0.1
+
+// Number of recent impacts new ones are compared against
+#define IMPACT_HISTORY 64
+
+struct recent_impact_t
+{
+	Vector origin;
+	float time;
+};
+
+static recent_impact_t g_RecentImpacts[IMPACT_HISTORY];
+static int g_NextImpact = 0;
+
+static float g_flFrameTime = -1;
+static int g_EffectCounts[IMPACT_EFFECT_COUNT];
+
+// Totals since the last cl_impact_stats
+static int g_ImpactsAdded = 0;
+static int g_ImpactsCoalesced = 0;
+static int g_EffectsDropped[IMPACT_EFFECT_COUNT];
+
+static std::unordered_map<std::string, int> g_DecalIndices;
+
+static cvar_t* cl_impact_coalesce = nullptr;
+static cvar_t* cl_impact_limits[IMPACT_EFFECT_COUNT];
+
+static void ImpactScheduler_Stats()
+{
+	gEngfuncs.Con_Printf("Impacts: %d added, %d coalesced; dropped %d decals, %d sounds, %d sparks\n",
+		g_ImpactsAdded, g_ImpactsCoalesced, g_EffectsDropped[IMPACT_DECAL], g_EffectsDropped[IMPACT_SOUND], g_EffectsDropped[IMPACT_SPARKS]);
+
+	g_ImpactsAdded = 0;
+	g_ImpactsCoalesced = 0;
+	memset(g_EffectsDropped, 0, sizeof(g_EffectsDropped));
+}
+
+// Starts counting effects again on the first impact of a new frame
+static void ImpactScheduler_CheckFrame()
+{
+	const float time = gEngfuncs.GetClientTime();
+
+	if (time != g_flFrameTime)
+	{
+		g_flFrameTime = time;
+		memset(g_EffectCounts, 0, sizeof(g_EffectCounts));
+	}
+}
+
+void ImpactScheduler_Init()
+{
+	cl_impact_coalesce = CVAR_CREATE("cl_impact_coalesce", "8", FCVAR_ARCHIVE);
+	cl_impact_limits[IMPACT_DECAL] = CVAR_CREATE("cl_impact_decals", "8", FCVAR_ARCHIVE);
+	cl_impact_limits[IMPACT_SOUND] = CVAR_CREATE("cl_impact_sounds", "4", FCVAR_ARCHIVE);
+	cl_impact_limits[IMPACT_SPARKS] = CVAR_CREATE("cl_impact_sparks", "8", FCVAR_ARCHIVE);
+
+	gEngfuncs.pfnAddCommand("cl_impact_stats", &ImpactScheduler_Stats);
+}
+
+void ImpactScheduler_Reset()
+{
+	memset(g_RecentImpacts, 0, sizeof(g_RecentImpacts));
+	g_NextImpact = 0;
+	g_flFrameTime = -1;
+
+	// Decal indices are looked up again for the new map
+	g_DecalIndices.clear();
+}
+
+bool ImpactScheduler_AddImpact(const float* origin, bool local)
+{
+	const float time = gEngfuncs.GetClientTime();
+	const float radius = cl_impact_coalesce->value;
+
+	if (!local && radius > 0)
+	{
+		for (const auto& impact : g_RecentImpacts)
+		{
+			// Client time restarts on map changes, anything from the future is from the last map
+			if (impact.time > time || time - impact.time >= IMPACT_COALESCE_TIME)
+				continue;
+
+			if ((impact.origin - Vector(origin)).Length() < radius)
+			{
+				++g_ImpactsCoalesced;
+				return false;
+			}
+		}
+	}
+
+	auto& impact = g_RecentImpacts[g_NextImpact];
+	g_NextImpact = (g_NextImpact + 1) % IMPACT_HISTORY;
+
+	impact.origin = origin;
+	impact.time = time;
+
+	++g_ImpactsAdded;
+
+	return true;
+}
+
+bool ImpactScheduler_Allow(ImpactEffect effect, bool local)
+{
+	ImpactScheduler_CheckFrame();
+
+	const int limit = static_cast<int>(cl_impact_limits[effect]->value);
+
+	if (limit > 0)
+	{
+		// Everyone else shares three quarters, so the local player's effects always have room
+		const int available = local ? limit : V_max(1, limit * 3 / 4);
+
+		if (g_EffectCounts[effect] >= available)
+		{
+			++g_EffectsDropped[effect];
+			return false;
+		}
+	}
+
+	++g_EffectCounts[effect];
+
+	return true;
+}
+
+int ImpactScheduler_DecalIndex(const char* name)
+{
+	if (auto it = g_DecalIndices.find(name); it != g_DecalIndices.end())
+		return it->second;
+
+	const int index = gEngfuncs.pEfxAPI->Draw_DecalIndex(gEngfuncs.pEfxAPI->Draw_DecalIndexFromName(const_cast<char*>(name)));
+
+	g_DecalIndices.emplace(name, index);
+
+	return index;
+}
@@ -0,0 +1,59 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+//
+// impact_scheduler.h
+//
+
+#pragma once
+
+/**
+*	@file
+*
+*	Limits the effects bullet impacts make on the client.
+*	Impacts landing close to a recent impact make no decal or sparks, and decals, sounds and sparks are capped per frame.
+*	The local player's impacts are never dropped for being close to another, and can use the whole cap while others get part of it.
+*/
+
+enum ImpactEffect
+{
+	IMPACT_DECAL = 0,
+	IMPACT_SOUND,
+	IMPACT_SPARKS,
+	IMPACT_EFFECT_COUNT
+};
+
+void ImpactScheduler_Init();
+
+/**
+*	@brief Forgets recent impacts and cached decal indices.
+*/
+void ImpactScheduler_Reset();
+
+/**
+*	@brief Records an impact and returns whether it should make a decal and sparks.
+*	Texture sounds are only limited by ImpactScheduler_Allow.
+*	@param local Whether the local player caused the impact.
+*/
+bool ImpactScheduler_AddImpact(const float* origin, bool local);
+
+/**
+*	@brief Returns whether there is room for another effect of the given type this frame, and counts it if there is.
+*/
+bool ImpactScheduler_Allow(ImpactEffect effect, bool local);
+
+/**
+*	@brief Returns Draw_DecalIndex(Draw_DecalIndexFromName(name)), looked up once per name.
+*/
+int ImpactScheduler_DecalIndex(const char* name);
@@ -22,6 +22,7 @@
 
 #include "vgui_TeamFortressViewport.h"
 #include "filesystem_utils.h"
+#include "job_system.h"
 
 
 extern bool g_iAlive;
@@ -1022,6 +1023,8 @@ void DLLEXPORT HUD_Shutdown()
 
 	ShutdownInput();
 
+	g_JobSystem.Shutdown();
+
 	BASSManager::Shutdown();
 
 	FileSystem_FreeFileSystem();
@@ -0,0 +1,125 @@
+//
+// job_system.cpp
+//
+
+#include <algorithm>
+
+#include "job_system.h"
+
+CJobSystem::~CJobSystem()
+{
+	Shutdown();
+}
+
+void CJobSystem::SetWorkerCount(int count)
+{
+	if (count < 0)
+		count = 0;
+
+	if (count == static_cast<int>(m_Workers.size()))
+		return;
+
+	Shutdown();
+
+	m_Quit = false;
+
+	for (int i = 0; i < count; ++i)
+	{
+		m_Workers.emplace_back(&CJobSystem::WorkerMain, this, i + 1);
+	}
+}
+
+void CJobSystem::StartWorkers()
+{
+	const int threads = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, JOB_MAX_THREADS);
+
+	SetWorkerCount(threads - 1);
+}
+
+void CJobSystem::ParallelFor(int count, const std::function<void(int index, int thread)>& job)
+{
+	if (count <= 0)
+		return;
+
+	if (m_Workers.empty() || count == 1)
+	{
+		for (int i = 0; i < count; ++i)
+			job(i, 0);
+
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		m_pJob = &job;
+		m_Count = count;
+		m_NextIndex = 0;
+		m_BusyWorkers = static_cast<int>(m_Workers.size());
+		++m_Generation;
+	}
+
+	m_WorkReady.notify_all();
+
+	RunJobs(0);
+
+	// The job must stay alive until every worker has stopped looking at it
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_WorkDone.wait(lock, [this]()
+		{ return 0 == m_BusyWorkers; });
+
+	m_pJob = nullptr;
+}
+
+void CJobSystem::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Quit = true;
+	}
+
+	m_WorkReady.notify_all();
+
+	for (auto& worker : m_Workers)
+	{
+		worker.join();
+	}
+
+	m_Workers.clear();
+}
+
+void CJobSystem::WorkerMain(int thread)
+{
+	unsigned int generation = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WorkReady.wait(lock, [&]()
+				{ return m_Quit || generation != m_Generation; });
+
+			if (m_Quit)
+				return;
+
+			generation = m_Generation;
+		}
+
+		RunJobs(thread);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			--m_BusyWorkers;
+		}
+
+		m_WorkDone.notify_one();
+	}
+}
+
+void CJobSystem::RunJobs(int thread)
+{
+	for (int index = m_NextIndex++; index < m_Count; index = m_NextIndex++)
+	{
+		(*m_pJob)(index, thread);
+	}
+}
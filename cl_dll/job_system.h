@@ -0,0 +1,80 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Most threads StartWorkers uses, including the calling thread
+#define JOB_MAX_THREADS 4
+
+/**
+*	@brief Small pool of worker threads for splitting a loop across cores.
+*	Jobs must not call into the engine, it is not thread safe.
+*/
+class CJobSystem
+{
+public:
+	~CJobSystem();
+
+	/**
+	*	@brief Starts or stops worker threads so there are @p count of them. 0 runs jobs on the calling thread only.
+	*/
+	void SetWorkerCount(int count);
+
+	/**
+	*	@brief Starts a worker for every spare core, up to JOB_MAX_THREADS threads in total. Does nothing if they are already running.
+	*/
+	void StartWorkers();
+
+	/**
+	*	@brief Number of threads ParallelFor runs on, including the calling thread.
+	*/
+	int GetThreadCount() const { return static_cast<int>(m_Workers.size()) + 1; }
+
+	/**
+	*	@brief Calls job(index, thread) for every index below count, spread over all threads. Returns once they are all done.
+	*	@param thread Index of the thread running the job, below GetThreadCount. 0 is the calling thread.
+	*/
+	void ParallelFor(int count, const std::function<void(int index, int thread)>& job);
+
+	void Shutdown();
+
+private:
+	void WorkerMain(int thread);
+	void RunJobs(int thread);
+
+	std::vector<std::thread> m_Workers;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkReady;
+	std::condition_variable m_WorkDone;
+
+	const std::function<void(int, int)>* m_pJob = nullptr;
+	int m_Count = 0;
+	std::atomic<int> m_NextIndex{0};
+
+	// Incremented for every ParallelFor so workers know when there is new work
+	unsigned int m_Generation = 0;
+	int m_BusyWorkers = 0;
+	bool m_Quit = false;
+};
+
+inline CJobSystem g_JobSystem;
@@ -0,0 +1,201 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+//
+// particle_effects.cpp
+//
+
+#include "hud.h"
+#include "cl_util.h"
+#include "const.h"
+#include "r_efx.h"
+#include "particleman.h"
+#include "particle_effects.h"
+
+extern IParticleMan* g_pParticleMan;
+
+static int g_iSparkType = -1;
+static int g_iBouncingSparkType = -1;
+static int g_iSmokeType = -1;
+
+// Whether the types use a sprite loaded for the current map
+static bool g_bSparksLoaded = false;
+static bool g_bSmokeLoaded = false;
+
+static cvar_t* cl_particleeffects = nullptr;
+
+static model_s* ParticleEffects_LoadSprite(const char* name, int& frames)
+{
+	const HSPRITE hSprite = SPR_Load(name);
+
+	if (0 == hSprite)
+		return nullptr;
+
+	frames = SPR_Frames(hSprite);
+
+	return (model_s*)gEngfuncs.GetSpritePointer(hSprite);
+}
+
+// Registers the type the first time, replaces it after that so it uses the sprite loaded for this map.
+// A type whose sprite failed to load stays registered, but isn't used until it loads again.
+static bool ParticleEffects_SetType(int& index, const particle_type_t& type)
+{
+	if (!type.pTexture)
+		return false;
+
+	if (-1 == index)
+	{
+		index = g_pParticleMan->RegisterParticleType(type);
+		return -1 != index;
+	}
+
+	return g_pParticleMan->SetParticleType(index, type);
+}
+
+void ParticleEffects_Init()
+{
+	cl_particleeffects = CVAR_CREATE("cl_particleeffects", "0", FCVAR_ARCHIVE);
+}
+
+void ParticleEffects_VidInit()
+{
+	g_bSparksLoaded = false;
+	g_bSmokeLoaded = false;
+
+	if (!g_pParticleMan)
+		return;
+
+	int frames = 0;
+
+	particle_type_t spark;
+
+	spark.pTexture = ParticleEffects_LoadSprite("sprites/hotglow.spr", frames);
+	spark.iRendermode = kRenderTransAdd;
+	spark.iRenderFlags = LIGHT_NONE | CULL_FRUSTUM_POINT | CULL_PVS;
+	spark.flGravity = 1;
+	spark.flContractSpeed = 0.1;
+	spark.flFadeSpeed = 0;
+
+	g_bSparksLoaded = ParticleEffects_SetType(g_iSparkType, spark);
+
+	spark.iCollisionFlags = TRI_COLLIDEWORLD;
+	spark.flBounceFactor = 0.4;
+
+	g_bSparksLoaded = ParticleEffects_SetType(g_iBouncingSparkType, spark) && g_bSparksLoaded;
+
+	particle_type_t smoke;
+
+	smoke.pTexture = ParticleEffects_LoadSprite("sprites/steam1.spr", frames);
+	smoke.iRendermode = kRenderTransAlpha;
+	smoke.iRenderFlags = LIGHT_NONE | CULL_FRUSTUM_SPHERE | CULL_PVS;
+	smoke.iCollisionFlags = TRI_ANIMATEDIE;
+	smoke.iFramerate = 15;
+	smoke.iNumFrames = frames;
+	smoke.flGravity = -0.02;
+	smoke.flScaleSpeed = 0.6;
+	smoke.flFadeSpeed = 0;
+
+	g_bSmokeLoaded = ParticleEffects_SetType(g_iSmokeType, smoke);
+}
+
+static bool ParticleEffects_UseSparks()
+{
+	return g_bSparksLoaded && cl_particleeffects && 0 != cl_particleeffects->value;
+}
+
+static void ParticleEffects_EmitSparks(int type, const Vector& origin, const Vector& direction, int count, float speedMin, float speedMax, float spread, float life)
+{
+	particle_desc_t desc;
+
+	desc.vOrigin = origin;
+	desc.vColor = Vector(255, 160, 64);
+
+	for (int i = 0; i < count; ++i)
+	{
+		Vector dir = direction;
+
+		for (int j = 0; j < 3; ++j)
+		{
+			dir[j] += gEngfuncs.pfnRandomFloat(-spread, spread);
+		}
+
+		desc.vVelocity = dir.Normalize() * gEngfuncs.pfnRandomFloat(speedMin, speedMax);
+		desc.flSize = gEngfuncs.pfnRandomFloat(1.5, 3);
+		desc.flLife = life * gEngfuncs.pfnRandomFloat(0.5, 1);
+
+		g_pParticleMan->EmitParticle(type, desc);
+	}
+}
+
+void ParticleEffects_BulletImpact(const float* origin, const float* normal)
+{
+	if (!ParticleEffects_UseSparks() || !g_bSmokeLoaded)
+	{
+		gEngfuncs.pEfxAPI->R_BulletImpactParticles(const_cast<float*>(origin));
+		return;
+	}
+
+	const Vector vecNormal(normal[0], normal[1], normal[2]);
+	const Vector vecOrigin = Vector(origin[0], origin[1], origin[2]) + vecNormal;
+
+	ParticleEffects_EmitSparks(g_iSparkType, vecOrigin, vecNormal, gEngfuncs.pfnRandomLong(2, 4), 100, 250, 0.8, 0.3);
+
+	particle_desc_t smoke;
+
+	smoke.vOrigin = vecOrigin + vecNormal * 2;
+	smoke.vVelocity = vecNormal * gEngfuncs.pfnRandomFloat(10, 20);
+	smoke.vColor = Vector(96, 96, 96);
+	smoke.flSize = gEngfuncs.pfnRandomFloat(4, 6);
+	smoke.flBrightness = 128;
+
+	g_pParticleMan->EmitParticle(g_iSmokeType, smoke);
+}
+
+void ParticleEffects_Sparks(const float* origin, int count, int velocityMin, int velocityMax)
+{
+	if (!ParticleEffects_UseSparks())
+	{
+		gEngfuncs.pEfxAPI->R_SparkEffect(const_cast<float*>(origin), count, velocityMin, velocityMax);
+		return;
+	}
+
+	particle_desc_t desc;
+
+	desc.vOrigin = Vector(origin[0], origin[1], origin[2]);
+	desc.vColor = Vector(255, 160, 64);
+
+	for (int i = 0; i < count; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			desc.vVelocity[j] = gEngfuncs.pfnRandomFloat(velocityMin, velocityMax);
+		}
+
+		desc.flSize = gEngfuncs.pfnRandomFloat(1.5, 3);
+		desc.flLife = gEngfuncs.pfnRandomFloat(0.2, 0.5);
+
+		g_pParticleMan->EmitParticle(g_iSparkType, desc);
+	}
+}
+
+void ParticleEffects_SparkShower(const float* origin)
+{
+	if (!ParticleEffects_UseSparks())
+	{
+		gEngfuncs.pEfxAPI->R_SparkShower(const_cast<float*>(origin));
+		return;
+	}
+
+	ParticleEffects_EmitSparks(g_iBouncingSparkType, Vector(origin[0], origin[1], origin[2]), Vector(0, 0, 1), gEngfuncs.pfnRandomLong(12, 20), 100, 300, 1, 1.5);
+}
@@ -0,0 +1,48 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+//
+// particle_effects.h
+//
+
+#pragma once
+
+/**
+*	@file
+*
+*	Sparks and smoke made by the client, optionally drawn as particleman particle types instead of one engine temporary entity or particle each.
+*	The engine's effects are used unless cl_particleeffects is set, or if particleman isn't loaded.
+*/
+
+void ParticleEffects_Init();
+
+/**
+*	@brief Loads the sprites for the new map, registering the particle types the first time it's called.
+*/
+void ParticleEffects_VidInit();
+
+/**
+*	@brief Sparks and a puff of smoke off a surface hit by a bullet, or R_BulletImpactParticles.
+*/
+void ParticleEffects_BulletImpact(const float* origin, const float* normal);
+
+/**
+*	@brief Sparks flying off in random directions, or R_SparkEffect. Same arguments as R_SparkEffect.
+*/
+void ParticleEffects_Sparks(const float* origin, int count, int velocityMin, int velocityMax);
+
+/**
+*	@brief Burst of sparks bouncing off the world, or R_SparkShower.
+*/
+void ParticleEffects_SparkShower(const float* origin);
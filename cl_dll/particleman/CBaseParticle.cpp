@@ -160,7 +160,7 @@ void CBaseParticle::Draw()
 
 	if ((m_iRenderFlags & LIGHT_NONE) == 0)
 	{
-		gEngfuncs.pTriAPI->LightAtPoint(m_vOrigin, vColor);
+		vColor = g_cParticleRenderer.LightAtPoint(m_vOrigin);
 
 		intensity = (vColor.x + vColor.y + vColor.z) / 3.0;
 	}
@@ -199,8 +199,19 @@ void CBaseParticle::Draw()
 	resultColor.y = std::clamp(resultColor.y, 0.f, 255.f);
 	resultColor.z = std::clamp(resultColor.z, 0.f, 255.f);
 
-	Vector forward, right, up;
-	gEngfuncs.pfnAngleVectors(m_vAngles, forward, right, up);
+	Vector right, up;
+
+	if ((m_iRenderFlags & RENDER_FACEPLAYER) != 0 && (m_iRenderFlags & RENDER_FACEPLAYER_ROTATEZ) == 0)
+	{
+		//Same as the view, computed once per frame.
+		right = g_cParticleRenderer.GetRight();
+		up = g_cParticleRenderer.GetUp();
+	}
+	else
+	{
+		Vector forward;
+		gEngfuncs.pfnAngleVectors(m_vAngles, forward, right, up);
+	}
 
 	const float radius = m_flSize;
 	const Vector width = right * radius * m_flStretchX;
@@ -213,29 +224,9 @@ void CBaseParticle::Draw()
 	const Vector topLeft = lowLeft + height;
 	const Vector topRight = lowRight + height;
 
-	gEngfuncs.pTriAPI->SpriteTexture(m_pTexture, m_iFrame);
-	gEngfuncs.pTriAPI->RenderMode(m_iRendermode);
-	gEngfuncs.pTriAPI->CullFace(TRI_NONE);
-
-	gEngfuncs.pTriAPI->Begin(TRI_QUADS);
-	gEngfuncs.pTriAPI->Color4f(resultColor.x / 255, resultColor.y / 255, resultColor.z / 255, m_flBrightness / 255);
-
-	gEngfuncs.pTriAPI->TexCoord2f(0, 0);
-	gEngfuncs.pTriAPI->Vertex3fv(topLeft);
-
-	gEngfuncs.pTriAPI->TexCoord2f(0, 1);
-	gEngfuncs.pTriAPI->Vertex3fv(lowLeft);
-
-	gEngfuncs.pTriAPI->TexCoord2f(1, 1);
-	gEngfuncs.pTriAPI->Vertex3fv(lowRight);
-
-	gEngfuncs.pTriAPI->TexCoord2f(1, 0);
-	gEngfuncs.pTriAPI->Vertex3fv(topRight);
+	const float color[4] = {resultColor.x / 255, resultColor.y / 255, resultColor.z / 255, m_flBrightness / 255};
 
-	gEngfuncs.pTriAPI->End();
-
-	gEngfuncs.pTriAPI->RenderMode(kRenderNormal);
-	gEngfuncs.pTriAPI->CullFace(TRI_FRONT);
+	g_cParticleRenderer.AddQuad(m_pTexture, m_iFrame, m_iRendermode, color, topLeft, lowLeft, lowRight, topRight);
 }
 
 void CBaseParticle::Animate(float time)
@@ -370,14 +361,19 @@ void CBaseParticle::CheckCollision(float time)
 		return;
 	}
 
+	//Over the trace budget, m_vPrevOrigin is kept so the next check covers the whole path.
+	if (!g_cParticleCollision.ShouldCollide())
+	{
+		return;
+	}
+
 	pmtrace_t trace;
 
 	bool collided = false;
 
 	if ((m_iCollisionFlags & TRI_COLLIDEALL) != 0)
 	{
-		gEngfuncs.pEventAPI->EV_SetTraceHull(2);
-		gEngfuncs.pEventAPI->EV_PlayerTrace(m_vPrevOrigin, m_vOrigin, PM_STUDIO_BOX, -1, &trace);
+		g_cParticleCollision.Trace(m_vPrevOrigin, m_vOrigin, PM_STUDIO_BOX, trace);
 
 		if (trace.fraction != 1.0)
 		{
@@ -393,8 +389,7 @@ void CBaseParticle::CheckCollision(float time)
 	}
 	else if ((m_iCollisionFlags & TRI_COLLIDEWORLD) != 0)
 	{
-		gEngfuncs.pEventAPI->EV_SetTraceHull(2);
-		gEngfuncs.pEventAPI->EV_PlayerTrace(m_vPrevOrigin, m_vOrigin, PM_WORLD_ONLY | PM_STUDIO_BOX, -1, &trace);
+		g_cParticleCollision.Trace(m_vPrevOrigin, m_vOrigin, PM_WORLD_ONLY | PM_STUDIO_BOX, trace);
 
 		if (trace.fraction != 1.0)
 		{
@@ -416,7 +411,8 @@ void CBaseParticle::CheckCollision(float time)
 	{
 		const float frametime = time - g_flOldTime;
 
-		m_vOrigin = m_vPrevOrigin + m_vVelocity * (trace.fraction * frametime);
+		//The path may span several frames if collision checks were skipped.
+		m_vOrigin = m_vPrevOrigin + (m_vOrigin - m_vPrevOrigin) * trace.fraction;
 
 		float bounce;
 
@@ -457,6 +453,8 @@ void CBaseParticle::CheckCollision(float time)
 		}
 
 		Touch(trace.endpos, trace.plane.normal, trace.ent);
+
+		g_cParticleCollision.InvalidateHull();
 	}
 	else if ((m_iCollisionFlags & TRI_WATERTRACE) != 0)
 	{
@@ -492,6 +490,12 @@ void CBaseParticle::Force()
 }
 
 void CBaseParticle::Think(float time)
+{
+	Simulate(time);
+	CheckCollision(time);
+}
+
+void CBaseParticle::Simulate(float time)
 {
 	if ((m_iCollisionFlags & TRI_ANIMATEDIE) != 0)
 	{
@@ -507,5 +511,4 @@ void CBaseParticle::Think(float time)
 	Fade(time);
 	Spin(time);
 	CalculateVelocity(time);
-	CheckCollision(time);
 }
@@ -34,6 +34,8 @@ private:
 	int m_iCollisionFlags;
 	float m_flPlayerDistance; //Used for sorting the particles, DO NOT TOUCH.
 
+	bool m_bParallelThink = false;
+
 public:
 	void* operator new(size_t size)
 	{
@@ -56,7 +58,14 @@ public:
 	}
 
 	virtual void Think(float time);
+
+	//Everything Think does except collisions. Runs on a worker thread for particles that allow parallel thinking,
+	//followed by CheckCollision on the main thread.
+	virtual void Simulate(float time);
 	virtual bool CheckVisibility(void);
+
+	//Adds the particle to the current batch of g_cParticleRenderer.
+	//Overrides that draw with the triangle API directly must call g_cParticleRenderer.Flush() before and ResetState() after.
 	virtual void Draw(void);
 	virtual void Animate(float time);
 	virtual void AnimateAndDie(float time);
@@ -131,6 +140,18 @@ public:
 		m_iRenderFlags |= iFlag;
 	}
 
+	//Particles whose Think is the base one, or whose Simulate never calls into the engine or touches other particles,
+	//can allow Simulate to run on worker threads.
+	void SetParallelThink(bool bParallel)
+	{
+		m_bParallelThink = bParallel;
+	}
+
+	bool GetParallelThink(void)
+	{
+		return m_bParallelThink;
+	}
+
 	int GetRenderFlags(void)
 	{
 		return m_iRenderFlags;
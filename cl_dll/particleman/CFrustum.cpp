@@ -17,11 +17,23 @@
 #include "PlatformHeaders.h"
 #include <GL/gl.h>
 
+#include <cmath>
+
+#include <emmintrin.h>
+
 #include "hud.h"
 #include "cl_util.h"
 #include "triangleapi.h"
+#include "studio_simd.h"
 #include "CFrustum.h"
 
+//The Linux build disables SSE for the library, so the batch tests ask for it themselves.
+#ifdef __GNUC__
+#define FRUSTUM_SIMD_TARGET __attribute__((target("sse2")))
+#else
+#define FRUSTUM_SIMD_TARGET
+#endif
+
 //TODO: this function always operates on the frustum matrix that's part of this object, so there is no need to pass the address.
 void CFrustum::NormalizeFrustumPlane(float frustum[6][4], int side)
 {
@@ -158,3 +170,130 @@ bool CFrustum::PlaneInsideFrustum(float x, float y, float z, float size)
 
 	return true;
 }
+
+void CFrustum::CalculateFrustum(const Vector& origin, const Vector& angles, float fovX, float fovY)
+{
+	Vector forward, right, up;
+	gEngfuncs.pfnAngleVectors(angles, forward, right, up);
+
+	const float halfX = fovX * 0.5f * (M_PI / 180);
+	const float halfY = fovY * 0.5f * (M_PI / 180);
+
+	const Vector normals[6] =
+		{
+			forward * std::sin(halfX) - right * std::cos(halfX),
+			forward * std::sin(halfX) + right * std::cos(halfX),
+			forward * std::sin(halfY) + up * std::cos(halfY),
+			forward * std::sin(halfY) - up * std::cos(halfY),
+			vec3_origin,
+			forward};
+
+	for (int i = 0; i < 6; ++i)
+	{
+		g_flFrustum[i][0] = normals[i].x;
+		g_flFrustum[i][1] = normals[i].y;
+		g_flFrustum[i][2] = normals[i].z;
+		g_flFrustum[i][3] = -DotProduct(normals[i], origin);
+	}
+
+	//Everything is in front of the far plane.
+	g_flFrustum[BACK][3] = 1;
+}
+
+void CFrustum::PointsInsideFrustum(const float* x, const float* y, const float* z, int count, std::uint8_t* visible) const
+{
+	static const float radiusScale[6] = {0, 0, 0, 0, 0, 0};
+
+	CullSpheres(radiusScale, x, y, z, nullptr, count, visible);
+}
+
+void CFrustum::SpheresInsideFrustum(const float* x, const float* y, const float* z, const float* radius, int count, std::uint8_t* visible) const
+{
+	static const float radiusScale[6] = {-1, -1, -1, -1, -1, -1};
+
+	CullSpheres(radiusScale, x, y, z, radius, count, visible);
+}
+
+void CFrustum::PlanesInsideFrustum(const float* x, const float* y, const float* z, const float* size, int count, std::uint8_t* visible) const
+{
+	//The corner closest to the outside of a plane is size * (|a| + |b| + |c|) closer than the center.
+	float radiusScale[6];
+
+	for (int i = 0; i < 6; ++i)
+	{
+		radiusScale[i] = std::fabs(g_flFrustum[i][0]) + std::fabs(g_flFrustum[i][1]) + std::fabs(g_flFrustum[i][2]);
+	}
+
+	CullSpheres(radiusScale, x, y, z, size, count, visible);
+}
+
+FRUSTUM_SIMD_TARGET static int CullSpheresSSE2(const float planes[6][4], const float radiusScale[6],
+	const float* x, const float* y, const float* z, const float* radius, int count, std::uint8_t* visible)
+{
+	__m128 a[6], b[6], c[6], d[6], scale[6];
+
+	for (int i = 0; i < 6; ++i)
+	{
+		a[i] = _mm_set1_ps(planes[i][0]);
+		b[i] = _mm_set1_ps(planes[i][1]);
+		c[i] = _mm_set1_ps(planes[i][2]);
+		d[i] = _mm_set1_ps(planes[i][3]);
+		scale[i] = _mm_set1_ps(radiusScale[i]);
+	}
+
+	int index = 0;
+
+	for (; index + 4 <= count; index += 4)
+	{
+		const __m128 px = _mm_loadu_ps(x + index);
+		const __m128 py = _mm_loadu_ps(y + index);
+		const __m128 pz = _mm_loadu_ps(z + index);
+		const __m128 r = radius ? _mm_loadu_ps(radius + index) : _mm_setzero_ps();
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+		for (int i = 0; i < 6; ++i)
+		{
+			const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[i], px), _mm_mul_ps(b[i], py)), _mm_add_ps(_mm_mul_ps(c[i], pz), d[i]));
+			inside = _mm_and_ps(inside, _mm_cmpgt_ps(distance, _mm_mul_ps(r, scale[i])));
+		}
+
+		const int mask = _mm_movemask_ps(inside);
+
+		visible[index] = mask & 1;
+		visible[index + 1] = (mask >> 1) & 1;
+		visible[index + 2] = (mask >> 2) & 1;
+		visible[index + 3] = (mask >> 3) & 1;
+	}
+
+	return index;
+}
+
+void CFrustum::CullSpheres(const float radiusScale[6], const float* x, const float* y, const float* z, const float* radius, int count, std::uint8_t* visible) const
+{
+	static const bool simd = StudioSIMD_IsSupported();
+
+	int index = 0;
+
+	if (simd)
+	{
+		index = CullSpheresSSE2(g_flFrustum, radiusScale, x, y, z, radius, count, visible);
+	}
+
+	//Whatever doesn't fill a whole vector.
+	for (; index < count; ++index)
+	{
+		const float r = radius ? radius[index] : 0;
+
+		visible[index] = 1;
+
+		for (int i = 0; i < 6; ++i)
+		{
+			if (((g_flFrustum[i][0] * x[index]) + (g_flFrustum[i][1] * y[index]) + (g_flFrustum[i][2] * z[index]) + g_flFrustum[i][3]) <= r * radiusScale[i])
+			{
+				visible[index] = 0;
+				break;
+			}
+		}
+	}
+}
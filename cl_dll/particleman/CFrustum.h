@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 enum FrustumSide
 {
 	RIGHT = 0,
@@ -35,9 +37,33 @@ struct CFrustum
 
 	bool PlaneInsideFrustum(float x, float y, float z, float size);
 
+	/**
+	*	@brief Builds the frustum from a view instead of the current matrices, without a far plane.
+	*	@param fovX Horizontal field of view in degrees.
+	*	@param fovY Vertical field of view in degrees.
+	*/
+	void CalculateFrustum(const Vector& origin, const Vector& angles, float fovX, float fovY);
+
+	//Batch versions of the tests above, using SSE2 to test 4 objects at a time when the CPU supports it.
+	//Each sets visible[i] to 1 if object i is inside the frustum and 0 otherwise.
+
+	void PointsInsideFrustum(const float* x, const float* y, const float* z, int count, std::uint8_t* visible) const;
+
+	void SpheresInsideFrustum(const float* x, const float* y, const float* z, const float* radius, int count, std::uint8_t* visible) const;
+
+	/**
+	*	@brief Like PlaneInsideFrustum, every corner of each box must be inside.
+	*/
+	void PlanesInsideFrustum(const float* x, const float* y, const float* z, const float* size, int count, std::uint8_t* visible) const;
+
 private:
 	void NormalizeFrustumPlane(float frustum[6][4], int side);
 
+	/**
+	*	@brief Objects are inside if they are further in front of every plane than their radius times that plane's scale.
+	*/
+	void CullSpheres(const float radiusScale[6], const float* x, const float* y, const float* z, const float* radius, int count, std::uint8_t* visible) const;
+
 public:
 	float g_flFrustum[6][4];
 };
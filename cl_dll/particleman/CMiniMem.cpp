@@ -23,13 +23,88 @@
 #include "particleman_internal.h"
 #include "CMiniMem.h"
 
+static bool ApplyForceToParticle(CBaseParticle* effect, const ForceMember& force)
+{
+	if (!effect->m_bAffectedByForce)
+	{
+		return false;
+	}
+
+	const Vector& vOrigin = force.m_vOrigin;
+	const float radiusSquared = force.m_flRadius * force.m_flRadius;
+
+	const float size = effect->m_flSize / 5;
+
+	const Vector mins = effect->m_vOrigin - Vector{size, size, size};
+	const Vector maxs = effect->m_vOrigin + Vector{size, size, size};
+
+	//If the force origin lies outside the effect's bounding box, calculate the distance from the box.
+	float totalDistanceSquared = 0;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		float boundingValue;
+
+		if (vOrigin[i] < mins[i])
+		{
+			boundingValue = mins[i];
+		}
+		else if (vOrigin[i] > maxs[i])
+		{
+			boundingValue = maxs[i];
+		}
+		else
+		{
+			continue;
+		}
+
+		totalDistanceSquared += (vOrigin[i] - boundingValue) * (vOrigin[i] - boundingValue);
+	}
+
+	//Effect is further away from position than force radius, don't apply force.
+	if (totalDistanceSquared > radiusSquared)
+	{
+		return false;
+	}
+
+	const float strength = std::max(0.f, force.m_flStrength - (vOrigin - effect->m_vOrigin).Length() * (force.m_flStrength / (0.5f * radiusSquared)));
+
+	if (force.m_vDirection == g_vecZero)
+	{
+		const float acceleration = -(strength / effect->m_flMass);
+
+		const Vector direction = (vOrigin - effect->m_vOrigin).Normalize();
+		const Vector velocity = effect->m_vVelocity.Normalize();
+
+		effect->m_vVelocity = acceleration * (direction + velocity);
+	}
+	else
+	{
+		const float acceleration = strength / effect->m_flMass;
+
+		const Vector direction = force.m_vDirection.Normalize();
+		const Vector velocity = effect->m_vVelocity.Normalize();
+
+		effect->m_vVelocity = acceleration * (direction + velocity);
+	}
+
+	return true;
+}
+
 void* CMiniMem::Allocate(std::size_t sizeInBytes, std::size_t alignment)
 {
 	auto particle = reinterpret_cast<CBaseParticle*>(_pool.allocate(sizeInBytes, alignment));
 
 	if (nullptr != particle)
 	{
-		_particles.push_back(particle);
+		if (_processing)
+		{
+			_createdParticles.push_back(particle);
+		}
+		else
+		{
+			_particles.push_back(particle);
+		}
 	}
 
 	return particle;
@@ -42,7 +117,14 @@ void CMiniMem::Deallocate(void* memory, std::size_t sizeInBytes, std::size_t ali
 		return;
 	}
 
-	_particles.erase(std::find(_particles.begin(), _particles.end(), memory));
+	if (auto it = std::find(_particles.begin(), _particles.end(), memory); it != _particles.end())
+	{
+		_particles.erase(it);
+	}
+	else
+	{
+		_createdParticles.erase(std::find(_createdParticles.begin(), _createdParticles.end(), memory));
+	}
 
 	_pool.deallocate(memory, sizeInBytes, alignment);
 }
@@ -63,12 +145,73 @@ CMiniMem* CMiniMem::Instance()
 	return _instance;
 }
 
-void CMiniMem::ProcessAll()
+bool CMiniMem::AddParticle(int type, const particle_desc_t& desc)
+{
+	return _arrays.Add(type, desc, gEngfuncs.GetClientTime());
+}
+
+void CMiniMem::ProcessAll(const std::vector<ForceMember>& forces, bool parallel)
 {
 	const float time = gEngfuncs.GetClientTime();
+	const bool paused = IsGamePaused();
 
 	//Clear list of visible particles.
 	_visibleParticles = 0;
+	_drawList.clear();
+
+	_processing = true;
+
+	_arrays.Simulate(time, paused ? 0 : time - g_flOldTime, forces, parallel);
+
+	const std::size_t count = _particles.size();
+
+	_forcesApplied.assign(count, 0);
+
+	ParticleParallelFor(count, parallel, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				auto effect = _particles[i];
+
+				for (const auto& force : forces)
+				{
+					if (ApplyForceToParticle(effect, force))
+					{
+						++_forcesApplied[i];
+					}
+				}
+
+				if (!paused && effect->GetParallelThink())
+				{
+					effect->Simulate(time);
+				}
+			}
+		});
+
+	//Callbacks are made in list order, so particles they create are always added in the same order.
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		auto effect = _particles[i];
+
+		for (int force = 0; force < _forcesApplied[i]; ++force)
+		{
+			effect->Force();
+		}
+
+		if (!paused)
+		{
+			if (effect->GetParallelThink())
+			{
+				effect->CheckCollision(time);
+			}
+			else
+			{
+				effect->Think(time);
+			}
+		}
+	}
+
+	auto player = gEngfuncs.GetLocalPlayer();
 
 	//Divide the particle list in two: the list of visible particles and the list of invisible particles.
 	//Remove any particles that have died.
@@ -78,11 +221,6 @@ void CMiniMem::ProcessAll()
 	{
 		auto effect = _particles[i];
 
-		if (!IsGamePaused())
-		{
-			effect->Think(time);
-		}
-
 		if (0 != effect->m_flDieTime && time >= effect->m_flDieTime)
 		{
 			effect->Die();
@@ -95,7 +233,6 @@ void CMiniMem::ProcessAll()
 
 		if (effect->CheckVisibility())
 		{
-			auto player = gEngfuncs.GetLocalPlayer();
 			effect->SetPlayerDistance((player->origin - effect->m_vOrigin).LengthSquared());
 
 			++_visibleParticles;
@@ -116,93 +253,59 @@ void CMiniMem::ProcessAll()
 		++i;
 	}
 
-	std::sort(_particles.begin(), _particles.begin() + _visibleParticles, [](const auto& lhs, const auto& rhs)
-		{
-			//Particles are ordered farthest to nearest so they can be drawn in order.
-			const float lhsDistance = lhs->GetPlayerDistance();
-			const float rhsDistance = rhs->GetPlayerDistance();
-
-			return lhsDistance > rhsDistance;
-		});
-
 	for (std::size_t i = 0; i < _visibleParticles; ++i)
 	{
-		auto effect = _particles[i];
-		effect->Draw();
+		_drawList.push_back({_particles[i]->GetPlayerDistance(), -static_cast<int>(i + 1)});
 	}
 
-	g_flOldTime = time;
-}
-
-int CMiniMem::ApplyForce(Vector vOrigin, Vector vDirection, float flRadius, float flStrength)
-{
-	const float radiusSquared = flRadius * flRadius;
+	_arrays.Cull(time, player->origin, _drawList);
 
-	for (auto effect : _particles)
-	{
-		if (!effect->m_bAffectedByForce)
+	std::sort(_drawList.begin(), _drawList.end(), [](const auto& lhs, const auto& rhs)
 		{
-			continue;
-		}
-
-		const float size = effect->m_flSize / 5;
-
-		const Vector mins = effect->m_vOrigin - Vector{size, size, size};
-		const Vector maxs = effect->m_vOrigin + Vector{size, size, size};
-
-		//If the force origin lies outside the effect's bounding box, calculate the distance from the box.
-		float totalDistanceSquared = 0;
+			//Particles are ordered farthest to nearest so they can be drawn in order.
+			return lhs.flDistance > rhs.flDistance;
+		});
 
-		for (int i = 0; i < 3; ++i)
+	for (const auto& particle : _drawList)
+	{
+		if (particle.iIndex < 0)
 		{
-			float boundingValue;
-
-			if (vOrigin[i] < mins[i])
-			{
-				boundingValue = mins[i];
-			}
-			else if (vOrigin[i] > maxs[i])
-			{
-				boundingValue = maxs[i];
-			}
-			else
-			{
-				continue;
-			}
-
-			totalDistanceSquared += (vOrigin[i] - boundingValue) * (vOrigin[i] - boundingValue);
+			_particles[-(particle.iIndex + 1)]->Draw();
 		}
-
-		//Effect is further away from position than force radius, don't apply force.
-		if (totalDistanceSquared > radiusSquared)
+		else
 		{
-			continue;
+			_arrays.Draw(particle.iIndex, time);
 		}
+	}
 
-		const float strength = std::max(0.f, flStrength - (vOrigin - effect->m_vOrigin).Length() * (flStrength / (0.5f * radiusSquared)));
+	_processing = false;
 
-		if (vDirection == g_vecZero)
-		{
-			const float acceleration = -(strength / effect->m_flMass);
+	_particles.insert(_particles.end(), _createdParticles.begin(), _createdParticles.end());
+	_createdParticles.clear();
 
-			const Vector direction = (vOrigin - effect->m_vOrigin).Normalize();
-			const Vector velocity = effect->m_vVelocity.Normalize();
+	g_flOldTime = time;
+}
 
-			effect->m_vVelocity = acceleration * (direction + velocity);
-		}
-		else
-		{
-			const float acceleration = strength / effect->m_flMass;
+int CMiniMem::ApplyForce(Vector vOrigin, Vector vDirection, float flRadius, float flStrength)
+{
+	ForceMember force;
 
-			const Vector direction = vDirection.Normalize();
-			const Vector velocity = effect->m_vVelocity.Normalize();
+	force.m_vOrigin = vOrigin;
+	force.m_vDirection = vDirection;
+	force.m_flRadius = flRadius;
+	force.m_flStrength = flStrength;
+	force.m_flDieTime = 0;
 
-			effect->m_vVelocity = acceleration * (direction + velocity);
+	for (auto effect : _particles)
+	{
+		if (ApplyForceToParticle(effect, force))
+		{
+			effect->Force();
 		}
-
-		effect->Force();
 	}
 
+	_arrays.ApplyForce(force, 0, _arrays.GetCount());
+
 	return 1;
 }
 
@@ -222,4 +325,10 @@ void CMiniMem::Reset()
 	//Wipe away previously allocated memory so maps with loads of particles don't eat up memory forever.
 	_pool.release();
 	_particles.shrink_to_fit();
+
+	_arrays.Clear();
+	_drawList.clear();
+	_drawList.shrink_to_fit();
+	_forcesApplied.clear();
+	_forcesApplied.shrink_to_fit();
 }
@@ -4,7 +4,10 @@
 #include <memory_resource>
 #include <vector>
 
+#include "CParticleArrays.h"
+
 class CBaseParticle;
+struct ForceMember;
 
 #define TRIANGLE_FPS 30
 
@@ -21,6 +24,18 @@ private:
 	std::vector<CBaseParticle*> _particles;
 	std::size_t _visibleParticles = 0;
 
+	//Particles created while processing, added to the list in creation order once it's done.
+	bool _processing = false;
+	std::vector<CBaseParticle*> _createdParticles;
+
+	//Number of forces applied to each particle this frame.
+	std::vector<int> _forcesApplied;
+
+	CParticleArrays _arrays;
+
+	//Visible particles of both kinds, sorted farthest to nearest.
+	std::vector<particle_draw_t> _drawList;
+
 protected:
 	// private constructor and destructor.
 	CMiniMem() = default;
@@ -31,7 +46,12 @@ public:
 
 	void Deallocate(void* memory, std::size_t sizeInBytes, std::size_t alignment = alignof(std::max_align_t));
 
-	void ProcessAll(); //Processes all
+	/**
+	*	@brief Applies forces to, thinks, culls and draws all particles.
+	*	Particle math is done in chunks on the job system's threads if @p parallel is set,
+	*	callbacks and everything that needs the engine are done on this thread in list order.
+	*/
+	void ProcessAll(const std::vector<ForceMember>& forces, bool parallel);
 
 	void Reset(); //clears memory, setting all particles to not used.
 
@@ -39,8 +59,14 @@ public:
 
 	int ApplyForce(Vector vOrigin, Vector vDirection, float flRadius, float flStrength);
 
+	int AddParticleType(const particle_type_t& type) { return _arrays.AddType(type); }
+	bool SetParticleType(int type, const particle_type_t& desc) { return _arrays.SetType(type, desc); }
+
+	bool AddParticle(int type, const particle_desc_t& desc);
+
 	static CMiniMem* Instance();
 
-	std::size_t GetTotalParticles() { return _particles.size(); }
-	std::size_t GetDrawnParticles() { return _visibleParticles; }
+	std::size_t GetTotalParticles() { return _particles.size() + _arrays.GetCount(); }
+	std::size_t GetArrayParticles() { return _arrays.GetCount(); }
+	std::size_t GetDrawnParticles() { return _drawList.size(); }
 };
@@ -0,0 +1,617 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#include "hud.h"
+#include "cl_util.h"
+
+#undef clamp
+
+#include <algorithm>
+
+#include "event_api.h"
+#include "triangleapi.h"
+
+#include "particleman.h"
+#include "particleman_internal.h"
+#include "CParticleArrays.h"
+
+#include "pm_defs.h"
+#include "pmtrace.h"
+
+int CParticleArrays::AddType(const particle_type_t& type)
+{
+	if (m_Types.size() >= MaxParticleTypes)
+	{
+		return -1;
+	}
+
+	m_Types.push_back(type);
+
+	return static_cast<int>(m_Types.size() - 1);
+}
+
+bool CParticleArrays::SetType(int type, const particle_type_t& desc)
+{
+	if (type < 0 || static_cast<std::size_t>(type) >= m_Types.size())
+	{
+		return false;
+	}
+
+	m_Types[type] = desc;
+
+	return true;
+}
+
+bool CParticleArrays::Add(int type, const particle_desc_t& desc, float time)
+{
+	if (type < 0 || static_cast<std::size_t>(type) >= m_Types.size() || m_Type.size() >= MaxArrayParticles)
+	{
+		return false;
+	}
+
+	if (m_bSimulating)
+	{
+		m_Pending.push_back({type, desc, time});
+		return true;
+	}
+
+	const auto& particleType = m_Types[type];
+
+	float dieTime = desc.flLife > 0 ? time + desc.flLife : 0;
+
+	//Animating once and then dying is the same as dying once the last frame has been shown.
+	if ((particleType.iCollisionFlags & TRI_ANIMATEDIE) != 0 && 0 != particleType.iFramerate && 0 != particleType.iNumFrames)
+	{
+		const float animationEnd = time + static_cast<float>(particleType.iNumFrames) / particleType.iFramerate;
+
+		dieTime = 0 != dieTime ? std::min(dieTime, animationEnd) : animationEnd;
+	}
+
+	//Expanding overrides contracting, like CBaseParticle::Expand called after CBaseParticle::Contract.
+	float sizeSpeed = 0;
+
+	if (0 != particleType.flScaleSpeed)
+	{
+		sizeSpeed = particleType.flScaleSpeed * 30.0;
+	}
+	else if (0 != particleType.flContractSpeed)
+	{
+		sizeSpeed = -particleType.flContractSpeed * 30.0;
+	}
+
+	float fadeSpeed = 0;
+
+	if (particleType.flFadeSpeed >= -0.5)
+	{
+		if (0 != particleType.flFadeSpeed)
+		{
+			fadeSpeed = particleType.flFadeSpeed * 30.0;
+		}
+		else if (0 != dieTime)
+		{
+			fadeSpeed = desc.flBrightness / (dieTime - time);
+		}
+	}
+
+	const float values[FIELD_COUNT] =
+		{
+			desc.vOrigin.x, desc.vOrigin.y, desc.vOrigin.z,
+			desc.vOrigin.x, desc.vOrigin.y, desc.vOrigin.z,
+			desc.vVelocity.x, desc.vVelocity.y, desc.vVelocity.z,
+			desc.vColor.x, desc.vColor.y, desc.vColor.z,
+			desc.flSize, desc.flSize, sizeSpeed,
+			desc.flBrightness, desc.flBrightness, fadeSpeed,
+			particleType.flGravity,
+			time,
+			dieTime,
+			time};
+
+	for (int field = 0; field < FIELD_COUNT; ++field)
+	{
+		m_Fields[field].push_back(values[field]);
+	}
+
+	std::uint8_t state = STATE_IN_PVS;
+
+	if ((particleType.iCollisionFlags & (TRI_SPIRAL | TRI_WATERTRACE | TRI_COLLIDEALL | TRI_COLLIDEWORLD)) != 0)
+	{
+		state |= STATE_COLLIDES;
+	}
+
+	m_Type.push_back(static_cast<std::uint16_t>(type));
+	m_State.push_back(state);
+
+	return true;
+}
+
+void CParticleArrays::Simulate(float time, float frametime, const std::vector<ForceMember>& forces, bool parallel)
+{
+	const std::size_t count = m_Type.size();
+
+	if (0 == count)
+	{
+		return;
+	}
+
+	ParticleParallelFor(count, parallel, [&](std::size_t begin, std::size_t end)
+		{ SimulateRange(begin, end, time, frametime, forces); });
+
+	//Traces and contents checks call the engine, and collisions may add particles.
+	m_bSimulating = true;
+
+	std::uint8_t* const state = m_State.data();
+
+	if (frametime > 0)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			if ((state[i] & (STATE_COLLIDES | STATE_DEAD)) == STATE_COLLIDES)
+			{
+				Collide(static_cast<int>(i), time, frametime);
+			}
+		}
+	}
+
+	m_bSimulating = false;
+
+	//Walk backwards so particles moved into the place of removed ones have already been checked.
+	for (std::size_t i = count; i-- > 0;)
+	{
+		if ((state[i] & STATE_DEAD) != 0)
+		{
+			Remove(i);
+		}
+	}
+
+	for (const auto& pending : m_Pending)
+	{
+		Add(pending.type, pending.desc, pending.time);
+	}
+
+	m_Pending.clear();
+}
+
+void CParticleArrays::SimulateRange(std::size_t begin, std::size_t end, float time, float frametime, const std::vector<ForceMember>& forces)
+{
+	for (const auto& force : forces)
+	{
+		ApplyForce(force, begin, end);
+	}
+
+	float* const originX = m_Fields[ORIGIN_X].data();
+	float* const originY = m_Fields[ORIGIN_Y].data();
+	float* const originZ = m_Fields[ORIGIN_Z].data();
+	std::uint8_t* const state = m_State.data();
+
+	if (frametime > 0)
+	{
+		const float* const velocityX = m_Fields[VELOCITY_X].data();
+		const float* const velocityY = m_Fields[VELOCITY_Y].data();
+		float* const velocityZ = m_Fields[VELOCITY_Z].data();
+		const float* const gravity = m_Fields[GRAVITY].data();
+
+		const float gravityScale = -frametime * g_flGravity;
+
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			originX[i] += velocityX[i] * frametime;
+			originY[i] += velocityY[i] * frametime;
+			originZ[i] += velocityZ[i] * frametime;
+
+			velocityZ[i] += gravityScale * gravity[i];
+		}
+	}
+
+	float* const size = m_Fields[SIZE].data();
+	const float* const startSize = m_Fields[START_SIZE].data();
+	const float* const sizeSpeed = m_Fields[SIZE_SPEED].data();
+	float* const brightness = m_Fields[BRIGHTNESS].data();
+	const float* const startBrightness = m_Fields[START_BRIGHTNESS].data();
+	const float* const fadeSpeed = m_Fields[FADE_SPEED].data();
+	const float* const timeCreated = m_Fields[TIME_CREATED].data();
+	const float* const dieTime = m_Fields[DIE_TIME].data();
+
+	for (std::size_t i = begin; i < end; ++i)
+	{
+		const float age = time - timeCreated[i];
+
+		size[i] = startSize[i] + sizeSpeed[i] * age;
+		brightness[i] = startBrightness[i] - fadeSpeed[i] * age;
+
+		const bool dead = (0 != dieTime[i] && time >= dieTime[i]) || (0 != sizeSpeed[i] && size[i] < 0.0001) || (0 != fadeSpeed[i] && brightness[i] < 1);
+
+		state[i] |= dead ? STATE_DEAD : 0;
+	}
+}
+
+void CParticleArrays::Collide(int index, float time, float frametime)
+{
+	const auto& type = m_Types[m_Type[index]];
+	const int collisionFlags = type.iCollisionFlags;
+
+	auto& state = m_State[index];
+
+	Vector origin{m_Fields[ORIGIN_X][index], m_Fields[ORIGIN_Y][index], m_Fields[ORIGIN_Z][index]};
+	Vector prevOrigin{m_Fields[PREV_ORIGIN_X][index], m_Fields[PREV_ORIGIN_Y][index], m_Fields[PREV_ORIGIN_Z][index]};
+	Vector velocity{m_Fields[VELOCITY_X][index], m_Fields[VELOCITY_Y][index], m_Fields[VELOCITY_Z][index]};
+
+	if ((collisionFlags & TRI_SPIRAL) != 0)
+	{
+		//Particles are moved around in the arrays, so use the creation time to give each one its own phase.
+		const float phase = m_Fields[TIME_CREATED][index] * 1000.0;
+
+		origin.x += sin(time * 5.0 + phase) * 2;
+		origin.y += sin(time * 7.5 + phase);
+	}
+
+	//Over the trace budget, the previous origin is kept so the next check covers the whole path.
+	const bool checked = (collisionFlags & (TRI_WATERTRACE | TRI_COLLIDEALL | TRI_COLLIDEWORLD)) != 0 && g_cParticleCollision.ShouldCollide();
+
+	if (checked)
+	{
+		pmtrace_t trace;
+
+		bool collided = false;
+
+		if ((collisionFlags & TRI_COLLIDEALL) != 0)
+		{
+			g_cParticleCollision.Trace(prevOrigin, origin, PM_STUDIO_BOX, trace);
+
+			//Collided with something other than world, ignore.
+			if (trace.fraction != 1.0 && 0 == trace.ent)
+			{
+				collided = true;
+			}
+		}
+		else if ((collisionFlags & TRI_COLLIDEWORLD) != 0)
+		{
+			g_cParticleCollision.Trace(prevOrigin, origin, PM_WORLD_ONLY | PM_STUDIO_BOX, trace);
+
+			if (trace.fraction != 1.0)
+			{
+				velocity = velocity * 0.6;
+
+				if (velocity.Length() < 10)
+				{
+					state &= ~STATE_COLLIDES;
+					velocity = g_vecZero;
+					origin = trace.endpos;
+				}
+
+				collided = true;
+			}
+		}
+
+		if (collided)
+		{
+			//The path may span several frames if collision checks were skipped.
+			origin = prevOrigin + (origin - prevOrigin) * trace.fraction;
+
+			float bounce = 1;
+
+			if (trace.plane.normal.z <= 0.9 || velocity.z > 0 || (velocity.z < -frametime * g_flGravity * m_Fields[GRAVITY][index] * 3.0))
+			{
+				if ((collisionFlags & TRI_COLLIDEKILL) != 0)
+				{
+					state |= STATE_DEAD;
+				}
+				else
+				{
+					bounce = type.flBounceFactor * 0.5;
+
+					if (bounce != 0)
+					{
+						const float dot = DotProduct(trace.plane.normal, velocity) * -2;
+						velocity = velocity + trace.plane.normal * dot;
+					}
+				}
+			}
+			else
+			{
+				//Particle fell on an (almost) flat surface and has no velocity to bounce back up; disable collisions from now on.
+				bounce = 0;
+				velocity = g_vecZero;
+				state &= ~STATE_COLLIDES;
+			}
+
+			if ((state & STATE_DEAD) == 0 && bounce != 1)
+			{
+				velocity = velocity * bounce;
+			}
+		}
+		else if ((collisionFlags & TRI_WATERTRACE) != 0)
+		{
+			if ((state & STATE_IN_WATER) == 0 && gEngfuncs.PM_PointContents(origin, nullptr) == CONTENTS_WATER)
+			{
+				state |= STATE_IN_WATER;
+
+				if ((collisionFlags & TRI_COLLIDEKILL) != 0)
+				{
+					state |= STATE_DEAD;
+				}
+			}
+		}
+	}
+
+	m_Fields[ORIGIN_X][index] = origin.x;
+	m_Fields[ORIGIN_Y][index] = origin.y;
+	m_Fields[ORIGIN_Z][index] = origin.z;
+
+	if (checked)
+	{
+		m_Fields[PREV_ORIGIN_X][index] = origin.x;
+		m_Fields[PREV_ORIGIN_Y][index] = origin.y;
+		m_Fields[PREV_ORIGIN_Z][index] = origin.z;
+	}
+
+	m_Fields[VELOCITY_X][index] = velocity.x;
+	m_Fields[VELOCITY_Y][index] = velocity.y;
+	m_Fields[VELOCITY_Z][index] = velocity.z;
+}
+
+void CParticleArrays::Cull(float time, const Vector& viewOrigin, std::vector<particle_draw_t>& visible)
+{
+	const std::size_t count = m_Type.size();
+
+	const float* const originX = m_Fields[ORIGIN_X].data();
+	const float* const originY = m_Fields[ORIGIN_Y].data();
+	const float* const originZ = m_Fields[ORIGIN_Z].data();
+	const float* const size = m_Fields[SIZE].data();
+	float* const nextPVSCheck = m_Fields[NEXT_PVS_CHECK].data();
+
+	m_CullRadius.resize(count);
+	m_Visible.resize(count);
+
+	bool planes = false;
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const float radius = size[i] / 5.0;
+
+		if (time >= nextPVSCheck[i])
+		{
+			const Vector origin{originX[i], originY[i], originZ[i]};
+			const Vector radiusVector{radius, radius, radius};
+			Vector mins = origin - radiusVector;
+			Vector maxs = origin + radiusVector;
+
+			if (gEngfuncs.pTriAPI->BoxInPVS(mins, maxs) != 0)
+			{
+				m_State[i] |= STATE_IN_PVS;
+			}
+			else
+			{
+				m_State[i] &= ~STATE_IN_PVS;
+			}
+
+			nextPVSCheck[i] = time + 0.1;
+		}
+
+		const int renderFlags = m_Types[m_Type[i]].iRenderFlags;
+
+		//Points are spheres without a radius.
+		m_CullRadius[i] = (renderFlags & CULL_FRUSTUM_SPHERE) != 0 ? radius : 0;
+
+		if ((renderFlags & (CULL_FRUSTUM_SPHERE | CULL_FRUSTUM_PLANE)) == CULL_FRUSTUM_PLANE)
+		{
+			planes = true;
+		}
+	}
+
+	g_cFrustum.SpheresInsideFrustum(originX, originY, originZ, m_CullRadius.data(), static_cast<int>(count), m_Visible.data());
+
+	//Only test boxes when some type needs it.
+	if (planes)
+	{
+		m_PlaneVisible.resize(count);
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			m_CullRadius[i] = size[i] / 5.0;
+		}
+
+		g_cFrustum.PlanesInsideFrustum(originX, originY, originZ, m_CullRadius.data(), static_cast<int>(count), m_PlaneVisible.data());
+	}
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const int renderFlags = m_Types[m_Type[i]].iRenderFlags;
+
+		if ((renderFlags & CULL_FRUSTUM_SPHERE) != 0 || ((renderFlags & CULL_FRUSTUM_PLANE) == 0 && (renderFlags & CULL_FRUSTUM_POINT) != 0))
+		{
+			if (0 == m_Visible[i])
+			{
+				continue;
+			}
+		}
+		else if ((renderFlags & CULL_FRUSTUM_PLANE) != 0)
+		{
+			if (0 == m_PlaneVisible[i])
+			{
+				continue;
+			}
+		}
+
+		if ((m_State[i] & STATE_IN_PVS) == 0 && (renderFlags & CULL_PVS) != 0)
+		{
+			continue;
+		}
+
+		visible.push_back({(viewOrigin - Vector{originX[i], originY[i], originZ[i]}).LengthSquared(), static_cast<int>(i)});
+	}
+}
+
+void CParticleArrays::Draw(int index, float time)
+{
+	const auto& type = m_Types[m_Type[index]];
+
+	const Vector origin{m_Fields[ORIGIN_X][index], m_Fields[ORIGIN_Y][index], m_Fields[ORIGIN_Z][index]};
+	const Vector color{m_Fields[COLOR_R][index], m_Fields[COLOR_G][index], m_Fields[COLOR_B][index]};
+
+	//Same lighting as CBaseParticle::Draw.
+	Vector resultColor;
+
+	if ((type.iRenderFlags & LIGHT_NONE) != 0)
+	{
+		resultColor = color;
+	}
+	else
+	{
+		const Vector vColor = g_cParticleRenderer.LightAtPoint(origin);
+
+		if ((type.iRenderFlags & LIGHT_COLOR) != 0)
+		{
+			resultColor.x = vColor.x / (color.x * 255);
+			resultColor.y = vColor.y / (color.y * 255);
+			resultColor.z = vColor.z / (color.z * 255);
+		}
+		else if ((type.iRenderFlags & LIGHT_INTENSITY) != 0)
+		{
+			const float intensity = (vColor.x + vColor.y + vColor.z) / 3.0;
+
+			resultColor.x = intensity / (color.x * 255);
+			resultColor.y = intensity / (color.y * 255);
+			resultColor.z = intensity / (color.z * 255);
+		}
+	}
+
+	resultColor.x = std::clamp(resultColor.x, 0.f, 255.f);
+	resultColor.y = std::clamp(resultColor.y, 0.f, 255.f);
+	resultColor.z = std::clamp(resultColor.z, 0.f, 255.f);
+
+	int frame = 0;
+
+	if (0 != type.iFramerate && 0 != type.iNumFrames)
+	{
+		frame = static_cast<int>(type.iFramerate * (time - m_Fields[TIME_CREATED][index]));
+
+		if ((type.iCollisionFlags & TRI_ANIMATEDIE) != 0)
+		{
+			frame = std::min(frame, type.iNumFrames - 1);
+		}
+		else
+		{
+			frame %= type.iNumFrames;
+		}
+	}
+
+	const float radius = m_Fields[SIZE][index];
+	const Vector width = g_cParticleRenderer.GetRight() * radius;
+	const Vector height = g_cParticleRenderer.GetUp() * radius;
+
+	const Vector lowLeft = origin - (width * 0.5) - (height * 0.5);
+
+	const Vector lowRight = lowLeft + width;
+	const Vector topLeft = lowLeft + height;
+	const Vector topRight = lowRight + height;
+
+	const float quadColor[4] = {resultColor.x / 255, resultColor.y / 255, resultColor.z / 255, m_Fields[BRIGHTNESS][index] / 255};
+
+	g_cParticleRenderer.AddQuad(type.pTexture, frame, type.iRendermode, quadColor, topLeft, lowLeft, lowRight, topRight);
+}
+
+void CParticleArrays::ApplyForce(const ForceMember& force, std::size_t begin, std::size_t end)
+{
+	const Vector& vOrigin = force.m_vOrigin;
+	const float flStrength = force.m_flStrength;
+	const float radiusSquared = force.m_flRadius * force.m_flRadius;
+
+	for (std::size_t i = begin; i < end; ++i)
+	{
+		const auto& type = m_Types[m_Type[i]];
+
+		if (!type.bAffectedByForce)
+		{
+			continue;
+		}
+
+		const Vector origin{m_Fields[ORIGIN_X][i], m_Fields[ORIGIN_Y][i], m_Fields[ORIGIN_Z][i]};
+		const float size = m_Fields[SIZE][i] / 5;
+
+		//Same as CMiniMem::ApplyForce, distance from the force origin to the particle's bounding box.
+		float totalDistanceSquared = 0;
+
+		for (int j = 0; j < 3; ++j)
+		{
+			const float boundingValue = std::clamp(vOrigin[j], origin[j] - size, origin[j] + size);
+
+			totalDistanceSquared += (vOrigin[j] - boundingValue) * (vOrigin[j] - boundingValue);
+		}
+
+		if (totalDistanceSquared > radiusSquared)
+		{
+			continue;
+		}
+
+		const float strength = std::max(0.f, flStrength - (vOrigin - origin).Length() * (flStrength / (0.5f * radiusSquared)));
+
+		const Vector velocity = Vector{m_Fields[VELOCITY_X][i], m_Fields[VELOCITY_Y][i], m_Fields[VELOCITY_Z][i]}.Normalize();
+
+		Vector newVelocity;
+
+		if (force.m_vDirection == g_vecZero)
+		{
+			newVelocity = -(strength / type.flMass) * ((vOrigin - origin).Normalize() + velocity);
+		}
+		else
+		{
+			newVelocity = (strength / type.flMass) * (force.m_vDirection.Normalize() + velocity);
+		}
+
+		m_Fields[VELOCITY_X][i] = newVelocity.x;
+		m_Fields[VELOCITY_Y][i] = newVelocity.y;
+		m_Fields[VELOCITY_Z][i] = newVelocity.z;
+	}
+}
+
+void CParticleArrays::Clear()
+{
+	for (auto& field : m_Fields)
+	{
+		field.clear();
+		field.shrink_to_fit();
+	}
+
+	m_Type.clear();
+	m_Type.shrink_to_fit();
+	m_State.clear();
+	m_State.shrink_to_fit();
+
+	m_Pending.clear();
+}
+
+void CParticleArrays::Remove(std::size_t index)
+{
+	const std::size_t last = m_Type.size() - 1;
+
+	if (index != last)
+	{
+		for (auto& field : m_Fields)
+		{
+			field[index] = field[last];
+		}
+
+		m_Type[index] = m_Type[last];
+		m_State[index] = m_State[last];
+	}
+
+	for (auto& field : m_Fields)
+	{
+		field.pop_back();
+	}
+
+	m_Type.pop_back();
+	m_State.pop_back();
+}
@@ -0,0 +1,190 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct model_s;
+struct ForceMember;
+
+/**
+*	@brief Behavior shared by every particle of a type.
+*	Uses the same flags and units as the CBaseParticle members of the same name.
+*	Particles of a type always face the viewer.
+*/
+struct particle_type_t
+{
+	model_s* pTexture = nullptr;
+	int iRendermode = 0;
+
+	int iRenderFlags = 0;	 //CULL_* and LIGHT_* flags
+	int iCollisionFlags = 0; //TRI_COLLIDEWORLD, TRI_COLLIDEALL, TRI_COLLIDEKILL, TRI_SPIRAL and TRI_ANIMATEDIE
+
+	int iFramerate = 0;
+	int iNumFrames = 0;
+
+	float flGravity = 0;	   //how effected by gravity particles are
+	float flScaleSpeed = 0;	   //speed at which particles expand
+	float flContractSpeed = 0; //speed at which particles contract
+	float flFadeSpeed = -1;	   //speed at which particles fade, 0 fades until the particle dies, -1 doesn't fade
+	float flBounceFactor = 1;
+	float flMass = 1;
+
+	bool bAffectedByForce = false;
+};
+
+/**
+*	@brief Initial state of a particle.
+*/
+struct particle_desc_t
+{
+	Vector vOrigin;
+	Vector vVelocity;
+	Vector vColor{255, 255, 255};
+	float flSize = 10;
+	float flBrightness = 255;
+	float flLife = 0; //seconds until the particle is removed, 0 lives until it fades, shrinks or collides away
+};
+
+/**
+*	@brief Visible particle, in the order particles are drawn in.
+*	Indices of CBaseParticle particles are stored as -(index + 1).
+*/
+struct particle_draw_t
+{
+	float flDistance;
+	int iIndex;
+};
+
+/**
+*	@brief Particles stored as one array per member, so simulating them runs through contiguous memory instead of one object per particle.
+*	Behavior is described by the particle's type, there are no callbacks.
+*/
+class CParticleArrays
+{
+public:
+	/**
+	*	@brief Adds a type and returns its index, or -1 if there are too many types.
+	*/
+	int AddType(const particle_type_t& type);
+
+	/**
+	*	@brief Replaces a type. Particles of the type already alive use the new behavior from now on,
+	*	except for collision flags, which are only read when a particle is added.
+	*	Returns false if the type is invalid.
+	*/
+	bool SetType(int type, const particle_type_t& desc);
+
+	/**
+	*	@brief Adds a particle. Returns false if the type is invalid or the maximum number of particles has been reached.
+	*	Particles added while simulating are added in order once the simulation is done.
+	*/
+	bool Add(int type, const particle_desc_t& desc, float time);
+
+	/**
+	*	@brief Applies forces, ages, moves and collides particles, and removes those that died.
+	*	Everything but collisions is done in chunks on the job system's threads if @p parallel is set.
+	*	@param frametime Time since the last frame, 0 if the game is paused.
+	*/
+	void Simulate(float time, float frametime, const std::vector<ForceMember>& forces, bool parallel);
+
+	/**
+	*	@brief Adds visible particles to @p visible, with their distance to @p viewOrigin.
+	*/
+	void Cull(float time, const Vector& viewOrigin, std::vector<particle_draw_t>& visible);
+
+	/**
+	*	@brief Adds a particle facing the viewer to the current batch of g_cParticleRenderer.
+	*/
+	void Draw(int index, float time);
+
+	void ApplyForce(const ForceMember& force, std::size_t begin, std::size_t end);
+
+	/**
+	*	@brief Removes all particles. Types are kept.
+	*/
+	void Clear();
+
+	std::size_t GetCount() const { return m_Type.size(); }
+
+private:
+	enum Field
+	{
+		ORIGIN_X = 0,
+		ORIGIN_Y,
+		ORIGIN_Z,
+		PREV_ORIGIN_X,
+		PREV_ORIGIN_Y,
+		PREV_ORIGIN_Z,
+		VELOCITY_X,
+		VELOCITY_Y,
+		VELOCITY_Z,
+		COLOR_R,
+		COLOR_G,
+		COLOR_B,
+		SIZE,
+		START_SIZE,
+		SIZE_SPEED,
+		BRIGHTNESS,
+		START_BRIGHTNESS,
+		FADE_SPEED,
+		GRAVITY,
+		TIME_CREATED,
+		DIE_TIME,
+		NEXT_PVS_CHECK,
+		FIELD_COUNT
+	};
+
+	enum StateFlags : std::uint8_t
+	{
+		STATE_IN_PVS = 1 << 0,
+		STATE_COLLIDES = 1 << 1, //Moves or collides in a way that can't be done for all particles at once
+		STATE_IN_WATER = 1 << 2,
+		STATE_DEAD = 1 << 3,
+	};
+
+	struct PendingParticle
+	{
+		int type;
+		particle_desc_t desc;
+		float time;
+	};
+
+	/**
+	*	@brief Part of Simulate that doesn't need the engine.
+	*/
+	void SimulateRange(std::size_t begin, std::size_t end, float time, float frametime, const std::vector<ForceMember>& forces);
+
+	void Collide(int index, float time, float frametime);
+
+	void Remove(std::size_t index);
+
+	std::vector<particle_type_t> m_Types;
+
+	std::vector<float> m_Fields[FIELD_COUNT];
+	std::vector<std::uint16_t> m_Type;
+	std::vector<std::uint8_t> m_State;
+
+	bool m_bSimulating = false;
+	std::vector<PendingParticle> m_Pending;
+
+	//Scratch space for Cull.
+	std::vector<float> m_CullRadius;
+	std::vector<std::uint8_t> m_Visible;
+	std::vector<std::uint8_t> m_PlaneVisible;
+};
@@ -0,0 +1,321 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#include "hud.h"
+#include "cl_util.h"
+
+#undef clamp
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include "event_api.h"
+
+#include "particleman.h"
+#include "particleman_internal.h"
+#include "CParticleCollision.h"
+
+#include "pm_defs.h"
+#include "pmtrace.h"
+
+bool CParticleCollision::TraceKey::operator==(const TraceKey& other) const
+{
+	return 0 == memcmp(this, &other, sizeof(*this));
+}
+
+std::size_t CParticleCollision::TraceKeyHash::operator()(const TraceKey& key) const
+{
+	std::size_t hash = static_cast<std::size_t>(key.traceFlags);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		hash = hash * 31 + static_cast<std::size_t>(key.start[i]);
+		hash = hash * 31 + static_cast<std::size_t>(key.end[i]);
+	}
+
+	return hash;
+}
+
+void CParticleCollision::BeginFrame(const Vector& viewOrigin, int mode, float cellSize, int budget)
+{
+	//Traces a particle needed when it did check, to estimate how many all of them would have needed.
+	const int checked = m_Stats.iParticles - m_Stats.iSkipped;
+	const float tracesPerParticle = checked > 0 ? static_cast<float>(m_Stats.iTraces) / checked : 1;
+	const float wanted = m_Stats.iParticles * tracesPerParticle;
+
+	m_iInterval = budget > 0 ? std::max(1, static_cast<int>(std::ceil(wanted / budget))) : 1;
+
+	m_LastStats = m_Stats;
+	m_Stats = {};
+	m_Stats.iInterval = m_iInterval;
+
+	m_iMode = std::clamp(mode, static_cast<int>(PARTICLE_COLLISION_TRACE), static_cast<int>(PARTICLE_COLLISION_HEIGHTFIELD));
+	m_flCellSize = std::max(1.f, cellSize);
+	m_iBudget = std::max(0, budget);
+
+	++m_iFrame;
+	m_iCollideCounter = 0;
+
+	m_bHullSet = false;
+	m_Cache.clear();
+
+	if (m_iMode == PARTICLE_COLLISION_HEIGHTFIELD)
+	{
+		SampleHeightfield(viewOrigin);
+	}
+	else
+	{
+		m_bHeightfieldValid = false;
+	}
+}
+
+void CParticleCollision::Reset()
+{
+	m_bHeightfieldValid = false;
+	m_Cache.clear();
+}
+
+bool CParticleCollision::ShouldCollide()
+{
+	++m_Stats.iParticles;
+
+	bool collide = true;
+
+	if (m_iInterval > 1)
+	{
+		//Spread the particles over the frames so they all get a turn.
+		collide = (m_iCollideCounter++ + m_iFrame) % m_iInterval == 0;
+	}
+
+	//The estimate may be off, never go over the budget.
+	if (collide && m_iBudget > 0 && m_Stats.iTraces >= m_iBudget)
+	{
+		collide = false;
+	}
+
+	if (!collide)
+	{
+		++m_Stats.iSkipped;
+	}
+
+	return collide;
+}
+
+void CParticleCollision::Trace(const Vector& start, const Vector& end, int traceFlags, pmtrace_s& trace)
+{
+	++m_Stats.iRequests;
+
+	memset(&trace, 0, sizeof(trace));
+	trace.fraction = 1;
+	trace.endpos = end;
+	trace.ent = -1;
+
+	if (m_iMode == PARTICLE_COLLISION_HEIGHTFIELD && (traceFlags & PM_WORLD_ONLY) != 0 && HeightfieldTrace(start, end, trace))
+	{
+		++m_Stats.iHeightfieldHits;
+		return;
+	}
+
+	if (m_iMode == PARTICLE_COLLISION_TRACE)
+	{
+		EngineTrace(start, end, traceFlags, trace);
+		++m_Stats.iTraces;
+		return;
+	}
+
+	TraceKey key;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		key.start[i] = static_cast<int>(std::floor(start[i] / m_flCellSize));
+		key.end[i] = static_cast<int>(std::floor(end[i] / m_flCellSize));
+	}
+
+	key.traceFlags = traceFlags;
+
+	if (auto it = m_Cache.find(key); it != m_Cache.end())
+	{
+		++m_Stats.iCacheHits;
+
+		const auto& cached = it->second;
+
+		if (cached.bHit)
+		{
+			//Clip this segment against the plane the cached trace hit.
+			const float startDistance = DotProduct(cached.vNormal, start) - cached.flDist;
+			const float endDistance = DotProduct(cached.vNormal, end) - cached.flDist;
+
+			if (startDistance >= 0 && endDistance < 0)
+			{
+				trace.fraction = startDistance / (startDistance - endDistance);
+				trace.endpos = start + (end - start) * trace.fraction;
+				trace.plane.normal = cached.vNormal;
+				trace.plane.dist = cached.flDist;
+				trace.ent = cached.iEnt;
+			}
+		}
+
+		return;
+	}
+
+	EngineTrace(start, end, traceFlags, trace);
+	++m_Stats.iTraces;
+
+	//Traces starting in solid don't tell anything about nearby segments.
+	if (0 == trace.allsolid && 0 == trace.startsolid)
+	{
+		CachedTrace cached;
+
+		cached.bHit = trace.fraction != 1.0;
+		cached.vNormal = trace.plane.normal;
+		cached.flDist = DotProduct(trace.plane.normal, trace.endpos);
+		cached.iEnt = trace.ent;
+
+		m_Cache.emplace(key, cached);
+	}
+}
+
+void CParticleCollision::EngineTrace(const Vector& start, const Vector& end, int traceFlags, pmtrace_s& trace)
+{
+	if (!m_bHullSet)
+	{
+		gEngfuncs.pEventAPI->EV_SetTraceHull(2);
+		m_bHullSet = true;
+	}
+
+	Vector traceStart = start;
+	Vector traceEnd = end;
+
+	gEngfuncs.pEventAPI->EV_PlayerTrace(traceStart, traceEnd, traceFlags, -1, &trace);
+}
+
+bool CParticleCollision::HeightfieldTrace(const Vector& start, const Vector& end, pmtrace_s& trace)
+{
+	if (!m_bHeightfieldValid)
+	{
+		return false;
+	}
+
+	//Only falling particles, anything moving sideways could go through walls.
+	const float drop = start.z - end.z;
+
+	if (drop <= 0 || (end - start).Make2D().Length() > drop)
+	{
+		return false;
+	}
+
+	const int x = static_cast<int>(std::floor(end.x / HeightfieldCellSize)) - m_iHeightfieldOrigin[0];
+	const int y = static_cast<int>(std::floor(end.y / HeightfieldCellSize)) - m_iHeightfieldOrigin[1];
+
+	if (x < 0 || x >= HeightfieldSize || y < 0 || y >= HeightfieldSize)
+	{
+		return false;
+	}
+
+	const auto& cell = m_Heightfield[y][x];
+
+	//Particles below the sampled floor are under an overhang or on another floor.
+	if (cell.state != HeightfieldCell::VALID || start.z < cell.flHeight)
+	{
+		return false;
+	}
+
+	if (end.z < cell.flHeight)
+	{
+		trace.fraction = (start.z - cell.flHeight) / drop;
+		trace.endpos = start + (end - start) * trace.fraction;
+		trace.plane.normal = cell.vNormal;
+		trace.plane.dist = DotProduct(cell.vNormal, trace.endpos);
+		trace.ent = 0;
+	}
+
+	return true;
+}
+
+void CParticleCollision::SampleHeightfield(const Vector& viewOrigin)
+{
+	const int originX = static_cast<int>(std::floor(viewOrigin.x / HeightfieldCellSize)) - HeightfieldSize / 2;
+	const int originY = static_cast<int>(std::floor(viewOrigin.y / HeightfieldCellSize)) - HeightfieldSize / 2;
+
+	//Start over once the view has moved a quarter of the field away, or to another floor.
+	if (!m_bHeightfieldValid || std::abs(originX - m_iHeightfieldOrigin[0]) > HeightfieldSize / 4 || std::abs(originY - m_iHeightfieldOrigin[1]) > HeightfieldSize / 4 || std::fabs(viewOrigin.z - m_flHeightfieldZ) > 128)
+	{
+		m_bHeightfieldValid = true;
+		m_iHeightfieldOrigin[0] = originX;
+		m_iHeightfieldOrigin[1] = originY;
+		m_flHeightfieldZ = viewOrigin.z;
+		m_iNextSample = 0;
+
+		for (auto& row : m_Heightfield)
+		{
+			for (auto& cell : row)
+			{
+				cell.state = HeightfieldCell::UNKNOWN;
+			}
+		}
+	}
+
+	//Cells nearest to the center are sampled first.
+	static const auto order = []()
+	{
+		std::array<int, HeightfieldSize * HeightfieldSize> cells;
+
+		for (int i = 0; i < HeightfieldSize * HeightfieldSize; ++i)
+		{
+			cells[i] = i;
+		}
+
+		const auto distance = [](int cell)
+		{
+			const int x = cell % HeightfieldSize - HeightfieldSize / 2;
+			const int y = cell / HeightfieldSize - HeightfieldSize / 2;
+			return x * x + y * y;
+		};
+
+		std::stable_sort(cells.begin(), cells.end(), [&](int lhs, int rhs)
+			{ return distance(lhs) < distance(rhs); });
+
+		return cells;
+	}();
+
+	for (int samples = 0; samples < HeightfieldSamplesPerFrame && m_iNextSample < HeightfieldSize * HeightfieldSize; ++samples)
+	{
+		const int index = order[m_iNextSample++];
+		const int x = index % HeightfieldSize;
+		const int y = index / HeightfieldSize;
+
+		const Vector start{(m_iHeightfieldOrigin[0] + x + 0.5f) * HeightfieldCellSize, (m_iHeightfieldOrigin[1] + y + 0.5f) * HeightfieldCellSize, m_flHeightfieldZ + 16};
+		const Vector end{start.x, start.y, start.z - 4096};
+
+		pmtrace_t trace;
+		EngineTrace(start, end, PM_WORLD_ONLY | PM_STUDIO_BOX, trace);
+		++m_Stats.iHeightfieldSamples;
+
+		auto& cell = m_Heightfield[y][x];
+
+		if (0 != trace.allsolid || 0 != trace.startsolid || trace.fraction == 1.0)
+		{
+			cell.state = HeightfieldCell::INVALID;
+		}
+		else
+		{
+			cell.state = HeightfieldCell::VALID;
+			cell.flHeight = trace.endpos.z;
+			cell.vNormal = trace.plane.normal;
+		}
+	}
+}
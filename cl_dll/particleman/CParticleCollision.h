@@ -0,0 +1,147 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+struct pmtrace_s;
+
+enum ParticleCollisionMode
+{
+	PARTICLE_COLLISION_TRACE = 0,	//Every collision check traces
+	PARTICLE_COLLISION_CACHE,		//Traces of nearby segments are shared within a frame
+	PARTICLE_COLLISION_HEIGHTFIELD, //Falling particles near the view collide with sampled floor heights, others use the cache
+};
+
+struct particle_collision_stats_t
+{
+	int iParticles; //Particles that wanted to check for collisions
+	int iRequests;
+	int iTraces;
+	int iCacheHits;
+	int iHeightfieldHits;
+	int iHeightfieldSamples;
+	int iSkipped;
+	int iInterval;
+};
+
+/**
+*	@brief Point hull traces for particle collisions, with a per-frame budget.
+*	Cached traces are stored as the plane that was hit, which segments sharing the cache entry are then clipped against.
+*/
+class CParticleCollision
+{
+public:
+	/**
+	*	@brief Starts a frame, clearing the trace cache and sampling part of the heightfield.
+	*	@param budget Most traces to do per frame, 0 for no limit.
+	*/
+	void BeginFrame(const Vector& viewOrigin, int mode, float cellSize, int budget);
+
+	/**
+	*	@brief Forgets the heightfield, for when a new map is loaded.
+	*/
+	void Reset();
+
+	/**
+	*	@brief Whether the next particle should check for collisions this frame.
+	*	When the last frame needed more traces than the budget allows, particles take turns colliding;
+	*	those that skip a frame should keep their previous origin so the next check covers the whole path.
+	*/
+	bool ShouldCollide();
+
+	/**
+	*	@brief Traces a point from @p start to @p end, like EV_PlayerTrace with hull 2.
+	*/
+	void Trace(const Vector& start, const Vector& end, int traceFlags, pmtrace_s& trace);
+
+	/**
+	*	@brief Call after anything that may have changed the trace hull, such as a Touch callback.
+	*/
+	void InvalidateHull() { m_bHullSet = false; }
+
+	const particle_collision_stats_t& GetStats() const { return m_LastStats; }
+
+private:
+	struct TraceKey
+	{
+		int start[3];
+		int end[3];
+		int traceFlags;
+
+		bool operator==(const TraceKey& other) const;
+	};
+
+	struct TraceKeyHash
+	{
+		std::size_t operator()(const TraceKey& key) const;
+	};
+
+	struct CachedTrace
+	{
+		bool bHit;
+		Vector vNormal;
+		float flDist;
+		int iEnt;
+	};
+
+	struct HeightfieldCell
+	{
+		enum State : std::uint8_t
+		{
+			UNKNOWN = 0,
+			VALID,
+			INVALID, //Sample started in solid or hit nothing
+		};
+
+		State state;
+		float flHeight;
+		Vector vNormal;
+	};
+
+	static constexpr int HeightfieldSize = 32;
+	static constexpr float HeightfieldCellSize = 64;
+	static constexpr int HeightfieldSamplesPerFrame = 32;
+
+	void EngineTrace(const Vector& start, const Vector& end, int traceFlags, pmtrace_s& trace);
+
+	bool HeightfieldTrace(const Vector& start, const Vector& end, pmtrace_s& trace);
+
+	void SampleHeightfield(const Vector& viewOrigin);
+
+	int m_iMode = PARTICLE_COLLISION_TRACE;
+	float m_flCellSize = 16;
+	int m_iBudget = 0;
+
+	bool m_bHullSet = false;
+
+	unsigned int m_iFrame = 0;
+	unsigned int m_iCollideCounter = 0;
+	int m_iInterval = 1;
+
+	std::unordered_map<TraceKey, CachedTrace, TraceKeyHash> m_Cache;
+
+	HeightfieldCell m_Heightfield[HeightfieldSize][HeightfieldSize]{};
+	int m_iHeightfieldOrigin[2]{};
+	bool m_bHeightfieldValid = false;
+	float m_flHeightfieldZ = 0;
+	int m_iNextSample = 0;
+
+	particle_collision_stats_t m_Stats{};
+	particle_collision_stats_t m_LastStats{};
+};
@@ -0,0 +1,170 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#include "hud.h"
+#include "cl_util.h"
+
+#undef clamp
+
+#include <algorithm>
+#include <cmath>
+
+#include "triangleapi.h"
+
+#include "particleman.h"
+#include "particleman_internal.h"
+#include "CParticleRenderer.h"
+
+void CParticleRenderer::BeginFrame(const Vector& viewAngles, float lightCellSize)
+{
+	Vector forward;
+	gEngfuncs.pfnAngleVectors(viewAngles, forward, m_vRight, m_vUp);
+
+	m_flLightCellSize = std::max(0.f, lightCellSize);
+	m_LightCache.clear();
+
+	m_pTexture = nullptr;
+	m_Quads.clear();
+	m_bStateChanged = false;
+
+	m_Stats = {};
+}
+
+void CParticleRenderer::EndFrame()
+{
+	Flush();
+
+	if (m_bStateChanged)
+	{
+		gEngfuncs.pTriAPI->RenderMode(kRenderNormal);
+		gEngfuncs.pTriAPI->CullFace(TRI_FRONT);
+		m_Stats.iTriAPICalls += 2;
+
+		m_bStateChanged = false;
+	}
+
+	m_LastStats = m_Stats;
+}
+
+Vector CParticleRenderer::LightAtPoint(const Vector& origin)
+{
+	Vector color;
+
+	if (m_flLightCellSize <= 0)
+	{
+		Vector point = origin;
+		gEngfuncs.pTriAPI->LightAtPoint(point, color);
+		++m_Stats.iTriAPICalls;
+		++m_Stats.iLightSamples;
+		return color;
+	}
+
+	//21 bits per axis covers any map at cell sizes of 1 unit or more.
+	std::uint64_t key = 0;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		const auto cell = static_cast<std::int64_t>(std::floor(origin[i] / m_flLightCellSize));
+		key = (key << 21) | (static_cast<std::uint64_t>(cell) & ((1 << 21) - 1));
+	}
+
+	if (auto it = m_LightCache.find(key); it != m_LightCache.end())
+	{
+		return it->second;
+	}
+
+	//Sample at the particle instead of the cell center, which may be inside a wall.
+	Vector point = origin;
+	gEngfuncs.pTriAPI->LightAtPoint(point, color);
+	++m_Stats.iTriAPICalls;
+	++m_Stats.iLightSamples;
+
+	m_LightCache.emplace(key, color);
+
+	return color;
+}
+
+void CParticleRenderer::AddQuad(model_s* texture, int frame, int rendermode, const float color[4],
+	const Vector& topLeft, const Vector& lowLeft, const Vector& lowRight, const Vector& topRight)
+{
+	if (!m_Quads.empty() && (texture != m_pTexture || frame != m_iFrame || rendermode != m_iRendermode))
+	{
+		Flush();
+	}
+
+	m_pTexture = texture;
+	m_iFrame = frame;
+	m_iRendermode = rendermode;
+
+	m_Quads.push_back({{color[0], color[1], color[2], color[3]}, {topLeft, lowLeft, lowRight, topRight}});
+
+	++m_Stats.iQuads;
+}
+
+void CParticleRenderer::Flush()
+{
+	if (m_Quads.empty())
+	{
+		return;
+	}
+
+	static const float texCoords[4][2] = {{0, 0}, {0, 1}, {1, 1}, {1, 0}};
+
+	auto triAPI = gEngfuncs.pTriAPI;
+
+	triAPI->SpriteTexture(m_pTexture, m_iFrame);
+	triAPI->RenderMode(m_iRendermode);
+
+	int calls = 2;
+
+	//Anything drawing directly in between resets this.
+	if (!m_bStateChanged)
+	{
+		triAPI->CullFace(TRI_NONE);
+		++calls;
+	}
+
+	triAPI->Begin(TRI_QUADS);
+	++calls;
+
+	const float* lastColor = nullptr;
+
+	for (auto& quad : m_Quads)
+	{
+		if (!lastColor || 0 != memcmp(lastColor, quad.color, sizeof(quad.color)))
+		{
+			triAPI->Color4f(quad.color[0], quad.color[1], quad.color[2], quad.color[3]);
+			lastColor = quad.color;
+			++calls;
+		}
+
+		for (int i = 0; i < 4; ++i)
+		{
+			triAPI->TexCoord2f(texCoords[i][0], texCoords[i][1]);
+			triAPI->Vertex3fv(quad.vertices[i]);
+		}
+
+		calls += 8;
+	}
+
+	triAPI->End();
+	++calls;
+
+	m_Stats.iTriAPICalls += calls;
+	++m_Stats.iBatches;
+
+	m_Quads.clear();
+	m_bStateChanged = true;
+}
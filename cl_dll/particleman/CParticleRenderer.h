@@ -0,0 +1,104 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct model_s;
+
+struct particle_render_stats_t
+{
+	int iQuads;
+	int iBatches;
+	int iTriAPICalls;
+	int iLightSamples;
+};
+
+/**
+*	@brief Draws particle quads in batches.
+*	Consecutive quads with the same texture, frame and render mode are drawn between a single Begin and End,
+*	so sorting order is kept while state changes are only made when needed.
+*/
+class CParticleRenderer
+{
+public:
+	/**
+	*	@brief Starts a frame. Computes the billboard basis from the view angles and clears the lighting cache.
+	*	@param lightCellSize Size of the cells lighting is sampled once for, 0 samples lighting for every particle.
+	*/
+	void BeginFrame(const Vector& viewAngles, float lightCellSize);
+
+	/**
+	*	@brief Draws the last batch and restores the render state.
+	*/
+	void EndFrame();
+
+	const Vector& GetRight() const { return m_vRight; }
+	const Vector& GetUp() const { return m_vUp; }
+
+	/**
+	*	@brief Returns the lighting at a point, shared by every point in the same cell this frame.
+	*/
+	Vector LightAtPoint(const Vector& origin);
+
+	/**
+	*	@brief Adds a quad to the current batch, drawing the batch first if it uses a different texture, frame or render mode.
+	*	@param color Color and alpha, 0 to 1.
+	*/
+	void AddQuad(model_s* texture, int frame, int rendermode, const float color[4],
+		const Vector& topLeft, const Vector& lowLeft, const Vector& lowRight, const Vector& topRight);
+
+	/**
+	*	@brief Draws the current batch. Call before drawing anything with the triangle API directly,
+	*	and ResetState after doing so.
+	*/
+	void Flush();
+
+	/**
+	*	@brief Notes that the render state was changed outside of the renderer.
+	*/
+	void ResetState() { m_bStateChanged = false; }
+
+	/**
+	*	@brief Statistics of the last frame.
+	*/
+	const particle_render_stats_t& GetStats() const { return m_LastStats; }
+
+private:
+	struct Quad
+	{
+		float color[4];
+		Vector vertices[4];
+	};
+
+	Vector m_vRight;
+	Vector m_vUp;
+
+	float m_flLightCellSize = 0;
+	std::unordered_map<std::uint64_t, Vector> m_LightCache;
+
+	model_s* m_pTexture = nullptr;
+	int m_iFrame = 0;
+	int m_iRendermode = 0;
+	std::vector<Quad> m_Quads;
+
+	bool m_bStateChanged = false;
+
+	particle_render_stats_t m_Stats{};
+	particle_render_stats_t m_LastStats{};
+};
@@ -26,6 +26,11 @@
 static bool g_iRenderMode = true;
 
 static cvar_t* cl_pmanstats = nullptr;
+static cvar_t* cl_pmanlightcell = nullptr;
+static cvar_t* cl_pmanparallel = nullptr;
+static cvar_t* cl_pmancollision = nullptr;
+static cvar_t* cl_pmantracecell = nullptr;
+static cvar_t* cl_pmantracebudget = nullptr;
 
 static std::vector<ForceMember> g_pForceList;
 
@@ -65,6 +70,11 @@ void IParticleMan_Active::SetUp(cl_enginefunc_t* pEnginefuncs)
 	//std::memcpy(&gEngfuncs, pEnginefuncs, sizeof(gEngfuncs));
 
 	cl_pmanstats = gEngfuncs.pfnRegisterVariable("cl_pmanstats", "0", 0);
+	cl_pmanlightcell = gEngfuncs.pfnRegisterVariable("cl_pmanlightcell", "32", FCVAR_ARCHIVE);
+	cl_pmanparallel = gEngfuncs.pfnRegisterVariable("cl_pmanparallel", "1", FCVAR_ARCHIVE);
+	cl_pmancollision = gEngfuncs.pfnRegisterVariable("cl_pmancollision", "1", FCVAR_ARCHIVE);
+	cl_pmantracecell = gEngfuncs.pfnRegisterVariable("cl_pmantracecell", "16", FCVAR_ARCHIVE);
+	cl_pmantracebudget = gEngfuncs.pfnRegisterVariable("cl_pmantracebudget", "256", FCVAR_ARCHIVE);
 }
 
 CBaseParticle* IParticleMan_Active::CreateParticle(Vector org, Vector normal, model_s* sprite, float size, float brightness, const char* classname)
@@ -72,16 +82,35 @@ CBaseParticle* IParticleMan_Active::CreateParticle(Vector org, Vector normal, mo
 	auto particle = new CBaseParticle();
 
 	particle->InitializeSprite(org, normal, sprite, size, brightness);
+
+	//Plain particles only do the base Think.
+	particle->SetParallelThink(true);
 	strncpy(particle->m_szClassname, classname, sizeof(particle->m_szClassname) - 1);
 	particle->m_szClassname[sizeof(particle->m_szClassname) - 1] = '\0';
 
 	return particle;
 }
 
+int IParticleMan_Active::RegisterParticleType(const particle_type_t& type)
+{
+	return CMiniMem::Instance()->AddParticleType(type);
+}
+
+bool IParticleMan_Active::SetParticleType(int type, const particle_type_t& desc)
+{
+	return CMiniMem::Instance()->SetParticleType(type, desc);
+}
+
+bool IParticleMan_Active::EmitParticle(int type, const particle_desc_t& desc)
+{
+	return CMiniMem::Instance()->AddParticle(type, desc);
+}
+
 void IParticleMan_Active::ResetParticles()
 {
 	CMiniMem::Instance()->Reset();
 	g_pForceList.clear();
+	g_cParticleCollision.Reset();
 }
 
 void IParticleMan_Active::SetVariables(float flGravity, Vector vViewAngles)
@@ -120,19 +149,35 @@ void IParticleMan_Active::Update()
 
 	auto memory = CMiniMem::Instance();
 
-	for (const auto& member : g_pForceList)
-	{
-		memory->ApplyForce(member.m_vOrigin, member.m_vDirection, member.m_flRadius, member.m_flStrength);
-	}
-
 	g_cFrustum.CalculateFrustum();
 
-	memory->ProcessAll();
+	g_cParticleCollision.BeginFrame(gEngfuncs.GetLocalPlayer()->origin,
+		nullptr != cl_pmancollision ? static_cast<int>(cl_pmancollision->value) : PARTICLE_COLLISION_TRACE,
+		nullptr != cl_pmantracecell ? cl_pmantracecell->value : 0,
+		nullptr != cl_pmantracebudget ? static_cast<int>(cl_pmantracebudget->value) : 0);
+
+	g_cParticleRenderer.BeginFrame(g_vViewAngles, nullptr != cl_pmanlightcell ? cl_pmanlightcell->value : 0);
+
+	memory->ProcessAll(g_pForceList, nullptr != cl_pmanparallel && 0 != cl_pmanparallel->value);
+
+	g_cParticleRenderer.EndFrame();
 
 	if (nullptr != cl_pmanstats && cl_pmanstats->value == 1)
 	{
 		//TODO: engine doesn't support printing size_t, use local printf
 		gEngfuncs.Con_NPrintf(15, "Number of Particles: %d", static_cast<int>(CMiniMem::Instance()->GetTotalParticles()));
 		gEngfuncs.Con_NPrintf(16, "Particles Drawn: %d", static_cast<int>(CMiniMem::Instance()->GetDrawnParticles()));
+		gEngfuncs.Con_NPrintf(17, "Particles Without Callbacks: %d", static_cast<int>(CMiniMem::Instance()->GetArrayParticles()));
+
+		const auto& renderStats = g_cParticleRenderer.GetStats();
+
+		gEngfuncs.Con_NPrintf(18, "Particle Batches: %d (%d quads)", renderStats.iBatches, renderStats.iQuads);
+		gEngfuncs.Con_NPrintf(19, "Particle TriAPI Calls: %d (%d light samples)", renderStats.iTriAPICalls, renderStats.iLightSamples);
+
+		const auto& collisionStats = g_cParticleCollision.GetStats();
+
+		gEngfuncs.Con_NPrintf(20, "Particle Collisions: %d checks, %d skipped, every %d frames", collisionStats.iParticles - collisionStats.iSkipped, collisionStats.iSkipped, collisionStats.iInterval);
+		gEngfuncs.Con_NPrintf(21, "Particle Traces: %d of %d (%d cached, %d heightfield, %d heightfield samples)", collisionStats.iTraces, collisionStats.iRequests,
+			collisionStats.iCacheHits, collisionStats.iHeightfieldHits, collisionStats.iHeightfieldSamples);
 	}
 }
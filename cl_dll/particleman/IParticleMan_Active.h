@@ -31,4 +31,8 @@ public:
 	CBaseParticle* CreateParticle(Vector org, Vector normal, model_s* sprite, float size, float brightness, const char* classname) override;
 
 	void SetRender(int iRender) override;
+
+	int RegisterParticleType(const particle_type_t& type) override;
+	bool SetParticleType(int type, const particle_type_t& desc) override;
+	bool EmitParticle(int type, const particle_desc_t& desc) override;
 };
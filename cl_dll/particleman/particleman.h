@@ -23,6 +23,17 @@ public:
 	virtual CBaseParticle* CreateParticle(Vector org, Vector normal, model_s* sprite, float size, float brightness, const char* classname) = 0;
 
 	virtual void SetRender(int iRender) = 0;
+
+	//Particles that only need the built-in behavior are much cheaper as a particle type.
+	//Register the type once, then emit as many particles of it as needed. Returns -1 if there are too many types.
+	virtual int RegisterParticleType(const particle_type_t& type) = 0;
+
+	//Replaces the behavior of a registered type, for example to use a sprite reloaded after a map change.
+	//Returns false if the type is invalid.
+	virtual bool SetParticleType(int type, const particle_type_t& desc) = 0;
+
+	//Returns false if the type is invalid or there are too many particles.
+	virtual bool EmitParticle(int type, const particle_desc_t& desc) = 0;
 };
 
 extern IParticleMan* g_pParticleMan;
@@ -27,11 +27,21 @@
 #include <algorithm>
 #include <cstddef>
 
+#include "job_system.h"
 #include "CFrustum.h"
+#include "CParticleCollision.h"
+#include "CParticleRenderer.h"
 
 constexpr std::size_t MaxForceElements = 128;
+constexpr std::size_t MaxArrayParticles = 1 << 16;
+constexpr std::size_t MaxParticleTypes = 1 << 16;
+
+//Number of particles simulated by one job.
+constexpr std::size_t ParticleChunkSize = 256;
 
 inline CFrustum g_cFrustum;
+inline CParticleRenderer g_cParticleRenderer;
+inline CParticleCollision g_cParticleCollision;
 inline float g_flGravity;
 inline float g_flOldTime;
 inline Vector g_vViewAngles;
@@ -49,3 +59,31 @@ struct ForceMember
 	float m_flStrength;
 	float m_flDieTime;
 };
+
+/**
+*	@brief Calls function(begin, end) for chunks of @p count particles, spread over the job system's threads if @p parallel is set.
+*	The function must not call into the engine.
+*/
+template <typename Function>
+void ParticleParallelFor(std::size_t count, bool parallel, const Function& function)
+{
+	const std::size_t chunks = (count + ParticleChunkSize - 1) / ParticleChunkSize;
+
+	if (!parallel || chunks <= 1)
+	{
+		if (count > 0)
+		{
+			function(std::size_t{0}, count);
+		}
+
+		return;
+	}
+
+	g_JobSystem.StartWorkers();
+
+	g_JobSystem.ParallelFor(static_cast<int>(chunks), [&](int chunk, int thread)
+		{
+			const std::size_t begin = chunk * ParticleChunkSize;
+			function(begin, std::min(begin + ParticleChunkSize, count));
+		});
+}
@@ -0,0 +1,204 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+//
+// prediction_debug.cpp
+//
+
+#include "hud.h"
+#include "cl_util.h"
+#include "parsemsg.h"
+#include "entity_state.h"
+#include "usercmd.h"
+#include "prediction_check.h"
+#include "prediction_debug.h"
+
+// Commands are checked well within this many commands after being predicted
+#define PREDICTION_HISTORY 256
+
+struct predicted_command_t
+{
+	unsigned int seed;
+	unsigned int sequence; // 0 if unused or already checked
+	int msec;
+	int buttons;
+	int weaponselect;
+	PredictionState state;
+	unsigned short hashes[PRED_FIELD_COUNT];
+};
+
+static predicted_command_t g_PredictedCommands[PREDICTION_HISTORY];
+static unsigned int g_PredictionSequence = 0;
+
+// Commands predicted before the correction for a divergence arrives diverge as well, only the first is printed
+static unsigned int g_SuppressUntil = 0;
+
+static int g_CommandsChecked = 0;
+static int g_CommandsDiverged = 0;
+
+static cvar_t* cl_prediction_debug = nullptr;
+
+void PredictionDebug_Record(const local_state_s* to, const usercmd_s* cmd, unsigned int random_seed, bool weaponsPredicted)
+{
+	if (!cl_prediction_debug || 0 == cl_prediction_debug->value)
+		return;
+
+	predicted_command_t& command = g_PredictedCommands[++g_PredictionSequence % PREDICTION_HISTORY];
+
+	memset(&command, 0, sizeof(command));
+
+	command.seed = random_seed;
+	command.sequence = g_PredictionSequence;
+	command.msec = cmd->msec;
+	command.buttons = cmd->buttons;
+	command.weaponselect = cmd->weaponselect;
+
+	PredictionState& state = command.state;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		state.Origin[i] = to->client.origin[i];
+		state.Velocity[i] = to->client.velocity[i];
+	}
+
+	state.Flags = to->client.flags & PREDICTION_FLAGS;
+	state.NextAttack = to->client.m_flNextAttack;
+
+	const int id = to->client.m_iId;
+
+	if (weaponsPredicted && id > 0 && id < MAX_WEAPONS)
+	{
+		const weapon_data_t& weapon = to->weapondata[id];
+
+		state.WeaponId = id;
+		state.Clip = weapon.m_iClip;
+		state.InReload = weapon.m_fInReload;
+		state.NextPrimaryAttack = weapon.m_flNextPrimaryAttack;
+		state.NextSecondaryAttack = weapon.m_flNextSecondaryAttack;
+		state.WeaponIdle = weapon.m_flTimeWeaponIdle;
+	}
+
+	PredictionState_Hash(state, command.hashes);
+}
+
+static void PredictionDebug_PrintValue(const PredictionState& state, int field, char* buffer, int size)
+{
+	switch (field)
+	{
+	case PRED_ORIGIN:
+		snprintf(buffer, size, "%.3f %.3f %.3f", state.Origin[0], state.Origin[1], state.Origin[2]);
+		break;
+	case PRED_VELOCITY:
+		snprintf(buffer, size, "%.3f %.3f %.3f", state.Velocity[0], state.Velocity[1], state.Velocity[2]);
+		break;
+	case PRED_FLAGS:
+		snprintf(buffer, size, "%X", state.Flags);
+		break;
+	case PRED_NEXTATTACK:
+		snprintf(buffer, size, "%.3f", state.NextAttack);
+		break;
+	case PRED_WEAPONID:
+		snprintf(buffer, size, "%d", state.WeaponId);
+		break;
+	case PRED_CLIP:
+		snprintf(buffer, size, "%d", state.Clip);
+		break;
+	case PRED_INRELOAD:
+		snprintf(buffer, size, "%d", state.InReload);
+		break;
+	case PRED_NEXTPRIMARYATTACK:
+		snprintf(buffer, size, "%.3f", state.NextPrimaryAttack);
+		break;
+	case PRED_NEXTSECONDARYATTACK:
+		snprintf(buffer, size, "%.3f", state.NextSecondaryAttack);
+		break;
+	case PRED_WEAPONIDLE:
+		snprintf(buffer, size, "%.3f", state.WeaponIdle);
+		break;
+	default:
+		buffer[0] = '\0';
+		break;
+	}
+}
+
+static int __MsgFunc_PredHash(const char* pszName, int iSize, void* pbuf)
+{
+	BEGIN_READ(pbuf, iSize);
+
+	const unsigned int seed = static_cast<unsigned int>(READ_LONG());
+
+	unsigned short hashes[PRED_FIELD_COUNT];
+
+	for (int i = 0; i < PRED_FIELD_COUNT; ++i)
+		hashes[i] = static_cast<unsigned short>(READ_SHORT());
+
+	if (!cl_prediction_debug || 0 == cl_prediction_debug->value)
+		return 1;
+
+	// Newest first, the command was most likely predicted recently
+	predicted_command_t* command = nullptr;
+
+	for (unsigned int i = 0; i < PREDICTION_HISTORY && i < g_PredictionSequence; ++i)
+	{
+		predicted_command_t& candidate = g_PredictedCommands[(g_PredictionSequence - i) % PREDICTION_HISTORY];
+
+		if (0 != candidate.sequence && candidate.seed == seed)
+		{
+			command = &candidate;
+			break;
+		}
+	}
+
+	// Not predicted, predicted too long ago or already checked
+	if (!command)
+		return 1;
+
+	++g_CommandsChecked;
+
+	int field;
+
+	for (field = 0; field < PRED_FIELD_COUNT; ++field)
+	{
+		if (command->hashes[field] != hashes[field])
+			break;
+	}
+
+	if (field < PRED_FIELD_COUNT)
+	{
+		++g_CommandsDiverged;
+
+		if (command->sequence > g_SuppressUntil)
+		{
+			g_SuppressUntil = g_PredictionSequence;
+
+			char value[128];
+			PredictionDebug_PrintValue(command->state, field, value, sizeof(value));
+
+			gEngfuncs.Con_Printf("Prediction diverged at command %u (seed %u, msec %d, buttons %X, weaponselect %d): %s, predicted %s (%d of %d commands diverged)\n",
+				command->sequence, command->seed, command->msec, command->buttons, command->weaponselect,
+				PredictionField_Name(field), value, g_CommandsDiverged, g_CommandsChecked);
+		}
+	}
+
+	command->sequence = 0;
+
+	return 1;
+}
+
+void PredictionDebug_Init()
+{
+	cl_prediction_debug = CVAR_CREATE("cl_prediction_debug", "0", 0);
+
+	HOOK_MESSAGE(PredHash);
+}
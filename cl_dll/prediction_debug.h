@@ -0,0 +1,36 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+//
+// prediction_debug.h
+//
+
+#pragma once
+
+/**
+*	@file
+*
+*	Checks the client's prediction against the hashes the server sends with sv_prediction_debug enabled.
+*	With cl_prediction_debug enabled the first field that differs is printed along with the command that caused it.
+*/
+
+struct local_state_s;
+struct usercmd_s;
+
+void PredictionDebug_Init();
+
+/**
+*	@brief Remembers the predicted state of a command the first time it is predicted.
+*/
+void PredictionDebug_Record(const local_state_s* to, const usercmd_s* cmd, unsigned int random_seed, bool weaponsPredicted);
@@ -52,6 +52,9 @@ bool CHudStatusBar::VidInit()
 {
 	// Load sprites here
 
+	// The console font may have changed
+	m_bDirty = true;
+
 	return true;
 }
 
@@ -182,6 +185,16 @@ bool CHudStatusBar::Draw(float fTime)
 			ParseStatusString(i);
 		}
 		m_bReparseString = false;
+		m_bDirty = true;
+	}
+
+	if (m_bDirty)
+	{
+		for (int i = 0; i < MAX_STATUSBAR_LINES; i++)
+		{
+			GetConsoleStringSize(m_szStatusBar[i], &m_iTextWidth[i], &m_iTextHeight[i]);
+		}
+		m_bDirty = false;
 	}
 
 	int Y_START = ScreenHeight - 52;
@@ -189,8 +202,8 @@ bool CHudStatusBar::Draw(float fTime)
 	// Draw the status bar lines
 	for (int i = 0; i < MAX_STATUSBAR_LINES; i++)
 	{
-		int TextHeight, TextWidth;
-		GetConsoleStringSize(m_szStatusBar[i], &TextWidth, &TextHeight);
+		const int TextHeight = m_iTextHeight[i];
+		const int TextWidth = m_iTextWidth[i];
 
 		int x = 8;
 		int y = Y_START - (4 + TextHeight * i); // draw along bottom of screen
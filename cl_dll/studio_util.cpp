@@ -6,11 +6,14 @@
 //=============================================================================
 
 #include <memory.h>
+#include <mutex>
 #include "hud.h"
 #include "cl_util.h"
 #include "const.h"
 #include "com_model.h"
 #include "studio_util.h"
+#include "studio.h"
+#include "studio_simd.h"
 
 // angles index are not the same as ROLL, PITCH, YAW
 
@@ -137,3 +140,236 @@ void MatrixCopy(float in[3][4], float out[3][4])
 {
 	memcpy(out, in, sizeof(float) * 3 * 4);
 }
+
+static int g_StudioSIMDMode = STUDIO_SIMD_OFF;
+static studio_simd_stats_t g_StudioSIMDStats;
+// Bones are set up on several threads
+static std::mutex g_StudioSIMDStatsMutex;
+
+/*
+====================
+SetStudioSIMDMode
+
+====================
+*/
+void SetStudioSIMDMode(int mode)
+{
+	static const bool supported = StudioSIMD_IsSupported();
+
+	if (!supported || mode < STUDIO_SIMD_OFF || mode > STUDIO_SIMD_VALIDATE)
+		mode = STUDIO_SIMD_OFF;
+
+	g_StudioSIMDMode = mode;
+}
+
+/*
+====================
+GetStudioSIMDMode
+
+====================
+*/
+int GetStudioSIMDMode()
+{
+	return g_StudioSIMDMode;
+}
+
+/*
+====================
+GetStudioSIMDStats
+
+====================
+*/
+studio_simd_stats_t GetStudioSIMDStats()
+{
+	std::lock_guard<std::mutex> lock(g_StudioSIMDStatsMutex);
+	return g_StudioSIMDStats;
+}
+
+/*
+====================
+ResetStudioSIMDStats
+
+====================
+*/
+void ResetStudioSIMDStats()
+{
+	std::lock_guard<std::mutex> lock(g_StudioSIMDStatsMutex);
+	g_StudioSIMDStats = {};
+}
+
+/*
+====================
+ValidateStudioSIMD
+
+====================
+*/
+static void ValidateStudioSIMD(const float* values, const float* reference, int count)
+{
+	const float error = StudioSIMD_MaxError(values, reference, count);
+
+	std::lock_guard<std::mutex> lock(g_StudioSIMDStatsMutex);
+
+	++g_StudioSIMDStats.calls;
+	g_StudioSIMDStats.values += count;
+
+	if (error > STUDIO_SIMD_TOLERANCE)
+		++g_StudioSIMDStats.mismatches;
+
+	if (error > g_StudioSIMDStats.maxError)
+		g_StudioSIMDStats.maxError = error;
+}
+
+/*
+====================
+AngleQuaternions
+
+====================
+*/
+void AngleQuaternions(const float (*angles)[3], vec4_t* quaternions, int count)
+{
+	if (g_StudioSIMDMode == STUDIO_SIMD_OFF)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			AngleQuaternion(const_cast<float*>(angles[i]), quaternions[i]);
+		}
+
+		return;
+	}
+
+	StudioSIMD_AngleQuaternions(angles, quaternions, count);
+
+	if (g_StudioSIMDMode == STUDIO_SIMD_VALIDATE)
+	{
+		vec4_t reference[MAXSTUDIOBONES];
+
+		for (int i = 0; i < count; i += MAXSTUDIOBONES)
+		{
+			const int batch = V_min(count - i, MAXSTUDIOBONES);
+
+			for (int j = 0; j < batch; j++)
+			{
+				AngleQuaternion(const_cast<float*>(angles[i + j]), reference[j]);
+			}
+
+			ValidateStudioSIMD(quaternions[i], reference[0], batch * 4);
+		}
+	}
+}
+
+/*
+====================
+QuaternionSlerps
+
+====================
+*/
+void QuaternionSlerps(const vec4_t* p, const vec4_t* q, float t, vec4_t* qt, int count)
+{
+	if (g_StudioSIMDMode == STUDIO_SIMD_OFF)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			vec4_t p1, q1;
+			memcpy(p1, p[i], sizeof(p1));
+			memcpy(q1, q[i], sizeof(q1));
+			QuaternionSlerp(p1, q1, t, qt[i]);
+		}
+
+		return;
+	}
+
+	if (g_StudioSIMDMode != STUDIO_SIMD_VALIDATE)
+	{
+		StudioSIMD_QuaternionSlerps(p, q, t, qt, count);
+		return;
+	}
+
+	// qt may be one of the inputs
+	for (int i = 0; i < count; i += MAXSTUDIOBONES)
+	{
+		const int batch = V_min(count - i, MAXSTUDIOBONES);
+
+		vec4_t reference[MAXSTUDIOBONES];
+
+		for (int j = 0; j < batch; j++)
+		{
+			vec4_t p1, q1;
+			memcpy(p1, p[i + j], sizeof(p1));
+			memcpy(q1, q[i + j], sizeof(q1));
+			QuaternionSlerp(p1, q1, t, reference[j]);
+		}
+
+		StudioSIMD_QuaternionSlerps(p + i, q + i, t, qt + i, batch);
+
+		ValidateStudioSIMD(qt[i], reference[0], batch * 4);
+	}
+}
+
+/*
+====================
+BoneMatrices
+
+====================
+*/
+void BoneMatrices(const vec4_t* quaternions, const float (*pos)[3], float (*matrices)[3][4], int count)
+{
+	if (g_StudioSIMDMode == STUDIO_SIMD_OFF)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			QuaternionMatrix(const_cast<float*>(quaternions[i]), matrices[i]);
+
+			matrices[i][0][3] = pos[i][0];
+			matrices[i][1][3] = pos[i][1];
+			matrices[i][2][3] = pos[i][2];
+		}
+
+		return;
+	}
+
+	StudioSIMD_BoneMatrices(quaternions, pos, matrices, count);
+
+	if (g_StudioSIMDMode == STUDIO_SIMD_VALIDATE)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			float reference[3][4];
+
+			QuaternionMatrix(const_cast<float*>(quaternions[i]), reference);
+
+			reference[0][3] = pos[i][0];
+			reference[1][3] = pos[i][1];
+			reference[2][3] = pos[i][2];
+
+			ValidateStudioSIMD(matrices[i][0], reference[0], 12);
+		}
+	}
+}
+
+/*
+====================
+ConcatBoneTransforms
+
+====================
+*/
+void ConcatBoneTransforms(float in1[3][4], float in2[3][4], float out[3][4])
+{
+	if (g_StudioSIMDMode == STUDIO_SIMD_OFF)
+	{
+		ConcatTransforms(in1, in2, out);
+		return;
+	}
+
+	if (g_StudioSIMDMode != STUDIO_SIMD_VALIDATE)
+	{
+		StudioSIMD_ConcatTransforms(in1, in2, out);
+		return;
+	}
+
+	float reference[3][4];
+	ConcatTransforms(in1, in2, reference);
+
+	StudioSIMD_ConcatTransforms(in1, in2, out);
+
+	ValidateStudioSIMD(out[0], reference[0], 12);
+}
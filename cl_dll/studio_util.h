@@ -28,3 +28,29 @@ void	MatrixCopy( float in[3][4], float out[3][4] );
 void	QuaternionMatrix( vec4_t quaternion, float (*matrix)[4] );
 void	QuaternionSlerp( vec4_t p, vec4_t q, float t, vec4_t qt );
 void	AngleQuaternion( float *angles, vec4_t quaternion );
+
+// Batched versions of the above for setting up bones, using the SSE2 kernels in studio_simd.h when enabled
+enum
+{
+	STUDIO_SIMD_OFF = 0,
+	STUDIO_SIMD_ON,
+	STUDIO_SIMD_VALIDATE	// Also run the functions above and compare the results
+};
+
+struct studio_simd_stats_t
+{
+	unsigned int calls;
+	unsigned int values;
+	unsigned int mismatches;
+	float maxError;
+};
+
+void	SetStudioSIMDMode( int mode );
+int		GetStudioSIMDMode();
+studio_simd_stats_t GetStudioSIMDStats();
+void	ResetStudioSIMDStats();
+
+void	AngleQuaternions( const float (*angles)[3], vec4_t* quaternions, int count );
+void	QuaternionSlerps( const vec4_t* p, const vec4_t* q, float t, vec4_t* qt, int count );
+void	BoneMatrices( const vec4_t* quaternions, const float (*pos)[3], float (*matrices)[3][4], int count );
+void	ConcatBoneTransforms( float in1[3][4], float in2[3][4], float out[3][4] );
@@ -55,13 +55,12 @@ bool CHudTrain::Draw(float fTime)
 		int r, g, b, x, y;
 
 		UnpackRGB(r, g, b, RGB_YELLOWISH);
-		SPR_Set(m_hSprite, r, g, b);
 
 		// This should show up to the right and part way up the armor number
 		y = ScreenHeight - SPR_Height(m_hSprite, 0) - gHUD.m_iFontHeight;
 		x = ScreenWidth / 3 + SPR_Width(m_hSprite, 0) / 4;
 
-		SPR_DrawAdditive(m_iPos - 1, x, y, NULL);
+		gHUD.m_SpriteBatch.DrawAdditive(m_hSprite, r, g, b, m_iPos - 1, x, y, NULL);
 	}
 
 	return true;
@@ -17,6 +17,8 @@
 //=============================================================================
 
 
+#include <algorithm>
+
 #include <VGUI_LineBorder.h>
 
 #include "hud.h"
@@ -248,6 +250,15 @@ void ScorePanel::Initialize()
 	m_iNumTeams = 0;
 	memset(g_PlayerExtraInfo, 0, sizeof g_PlayerExtraInfo);
 	memset(g_TeamInfo, 0, sizeof g_TeamInfo);
+
+	// Everyone has no score yet, so slot order is sorted
+	for (int i = 0; i < MAX_PLAYERS_HUD - 1; i++)
+	{
+		m_iPlayerOrder[i] = i + 1;
+	}
+
+	m_bUpdatePending = false;
+	memset(m_bRowFilled, 0, sizeof m_bRowFilled);
 }
 
 bool HACK_GetPlayerUniqueID(int iPlayer, char playerID[16])
@@ -290,6 +301,8 @@ void ScorePanel::Update()
 	else
 		SortTeams();
 
+	m_bUpdatePending = false;
+
 	// set scrollbar range
 	m_PlayerList.SetScrollRange(m_iRows);
 
@@ -306,9 +319,60 @@ void ScorePanel::Update()
 }
 
 //-----------------------------------------------------------------------------
-// Purpose: Sort all the teams
+// Purpose: Scores or teams changed. Scoreboard data often arrives as a burst of
+//			messages, so the grid is updated once when the viewport is next painted.
 //-----------------------------------------------------------------------------
-void ScorePanel::SortTeams()
+void ScorePanel::DeferUpdate()
+{
+	m_bUpdatePending = true;
+
+	// The team menu shows the team scores while the scoreboard is closed
+	if (!isVisible() && gHUD.m_Teamplay)
+		UpdateTeamScores();
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Whether a player is listed above another one: most frags first, then
+//			fewest deaths, then lowest slot
+//-----------------------------------------------------------------------------
+bool ScorePanel::PlayerRanksAbove(int iPlayer, int iOther)
+{
+	const extra_player_info_t& player = g_PlayerExtraInfo[iPlayer];
+	const extra_player_info_t& other = g_PlayerExtraInfo[iOther];
+
+	if (player.frags != other.frags)
+		return player.frags > other.frags;
+
+	if (player.deaths != other.deaths)
+		return player.deaths < other.deaths;
+
+	return iPlayer < iOther;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Moves a player whose score changed to its new place in the sorted order
+//-----------------------------------------------------------------------------
+void ScorePanel::PlayerScoreChanged(int iPlayer)
+{
+	if (iPlayer < 1 || iPlayer >= MAX_PLAYERS_HUD)
+		return;
+
+	int* begin = m_iPlayerOrder;
+	int* end = m_iPlayerOrder + MAX_PLAYERS_HUD - 1;
+
+	// take the player out, then insert it again where it belongs among the others
+	int* current = std::find(begin, end, iPlayer);
+	std::copy(current + 1, end, current);
+
+	int* place = std::lower_bound(begin, end - 1, iPlayer, PlayerRanksAbove);
+	std::copy_backward(place, end - 1, end);
+	*place = iPlayer;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Recalculate the team scores, pings and packetloss from their players
+//-----------------------------------------------------------------------------
+void ScorePanel::UpdateTeamScores()
 {
 	// clear out team scores
 	int i;
@@ -359,14 +423,26 @@ void ScorePanel::SortTeams()
 	// find team ping/packetloss averages
 	for (i = 1; i <= m_iNumTeams; i++)
 	{
-		g_TeamInfo[i].already_drawn = false;
-
 		if (g_TeamInfo[i].players > 0)
 		{
 			g_TeamInfo[i].ping /= g_TeamInfo[i].players;	   // use the average ping of all the players in the team as the teams ping
 			g_TeamInfo[i].packetloss /= g_TeamInfo[i].players; // use the average ping of all the players in the team as the teams ping
 		}
 	}
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Sort all the teams
+//-----------------------------------------------------------------------------
+void ScorePanel::SortTeams()
+{
+	UpdateTeamScores();
+
+	int i;
+	for (i = 1; i <= m_iNumTeams; i++)
+	{
+		g_TeamInfo[i].already_drawn = false;
+	}
 
 	// Draw the teams
 	while (true)
@@ -417,35 +493,19 @@ void ScorePanel::SortPlayers(int iTeam, char* team)
 	bool bCreatedTeam = false;
 
 	// draw the players, in order,  and restricted to team if set
-	while (true)
+	// m_iPlayerOrder is kept sorted as scores arrive, so this takes a single pass
+	for (int i = 0; i < MAX_PLAYERS_HUD - 1; i++)
 	{
-		// Find the top ranking player
-		int highest_frags = -99999;
-		int lowest_deaths = 99999;
-		int best_player;
-		best_player = 0;
+		const int best_player = m_iPlayerOrder[i];
 
-		for (int i = 1; i < MAX_PLAYERS_HUD; i++)
-		{
-			if (m_bHasBeenSorted[i] == false && g_PlayerInfoList[i].name && g_PlayerExtraInfo[i].frags >= highest_frags)
-			{
-				cl_entity_t* ent = gEngfuncs.GetEntityByIndex(i);
+		if (m_bHasBeenSorted[best_player] || !g_PlayerInfoList[best_player].name)
+			continue;
 
-				if (ent && !(team && stricmp(g_PlayerExtraInfo[i].teamname, team)))
-				{
-					extra_player_info_t* pl_info = &g_PlayerExtraInfo[i];
-					if (pl_info->frags > highest_frags || pl_info->deaths < lowest_deaths)
-					{
-						best_player = i;
-						lowest_deaths = pl_info->deaths;
-						highest_frags = pl_info->frags;
-					}
-				}
-			}
-		}
+		if (team && 0 != stricmp(g_PlayerExtraInfo[best_player].teamname, team))
+			continue;
 
-		if (0 == best_player)
-			break;
+		if (!gEngfuncs.GetEntityByIndex(best_player))
+			continue;
 
 		// If we haven't created the Team yet, do it first
 		if (!bCreatedTeam && 0 != iTeam)
@@ -527,7 +587,57 @@ void ScorePanel::RebuildTeams()
 	}
 
 	// Update the scoreboard
-	Update();
+	DeferUpdate();
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Gets what a grid row should show, to tell whether it has to be filled again
+//-----------------------------------------------------------------------------
+void ScorePanel::GetRowState(int row, RowState& state)
+{
+	memset(&state, 0, sizeof(state));
+
+	if (row >= m_iRows)
+	{
+		state.iIsATeam = -1;
+		return;
+	}
+
+	state.iIsATeam = m_iIsATeam[row];
+	state.iSortedRow = m_iSortedRows[row];
+
+	if (m_iIsATeam[row] == TEAM_YES)
+	{
+		const team_info_t& team_info = g_TeamInfo[m_iSortedRows[row]];
+
+		state.iTeamNumber = team_info.teamnumber;
+		state.iFrags = team_info.frags;
+		state.iDeaths = team_info.deaths;
+		state.iPing = team_info.ping;
+		state.iPlayers = team_info.players;
+	}
+	else if (m_iIsATeam[row] == TEAM_NO)
+	{
+		const int iPlayer = m_iSortedRows[row];
+		const hud_player_info_t& pl_info = g_PlayerInfoList[iPlayer];
+		const extra_player_info_t& extra_info = g_PlayerExtraInfo[iPlayer];
+
+		state.iTeamNumber = extra_info.teamnumber;
+		state.iFrags = extra_info.frags;
+		state.iDeaths = extra_info.deaths;
+		state.iPing = pl_info.ping;
+		state.iPlayerClass = extra_info.playerclass;
+		state.iLocalTeam = g_iTeamNumber;
+
+		// only looked at for the class column, when it shows this player's class
+		if (g_iTeamNumber != 0 && EV_TFC_IsAllyTeam(g_iTeamNumber, extra_info.teamnumber) && extra_info.playerclass == 0)
+			state.iValidClasses = gViewPort->GetValidClasses(extra_info.teamnumber);
+		state.bThisPlayer = 0 != pl_info.thisplayer;
+		state.bKiller = iPlayer == m_iLastKilledBy && 0 != m_fLastKillTime && m_fLastKillTime > gHUD.m_flTime;
+
+		if (pl_info.name)
+			strncpy(state.szName, pl_info.name, sizeof(state.szName) - 1);
+	}
 }
 
 
@@ -554,9 +664,24 @@ void ScorePanel::FillGrid()
 	}
 
 	bool bNextRowIsGap = false;
+	bool bLayoutChanged = false;
 	int row;
 	for (row = 0; row < NUM_ROWS; row++)
 	{
+		RowState state;
+		GetRowState(row, state);
+
+		// Only fill rows showing something different, the killer's highlight fades so that row is always filled
+		if (m_bRowFilled[row] && !state.bKiller && 0 == memcmp(&state, &m_RowStates[row], sizeof(state)))
+			continue;
+
+		// Row heights depend on what kind of row it is
+		if (!m_bRowFilled[row] || state.iIsATeam != m_RowStates[row].iIsATeam)
+			bLayoutChanged = true;
+
+		m_RowStates[row] = state;
+		m_bRowFilled[row] = true;
+
 		CGrid* pGridRow = &m_PlayerGrids[row];
 		pGridRow->SetRowUnderline(0, false, 0, 0, 0, 0, 0);
 
@@ -839,6 +964,9 @@ void ScorePanel::FillGrid()
 		}
 	}
 
+	if (!bLayoutChanged)
+		return;
+
 	for (row = 0; row < NUM_ROWS; row++)
 	{
 		CGrid* pGridRow = &m_PlayerGrids[row];
@@ -874,6 +1002,7 @@ void ScorePanel::DeathMsg(int killer, int victim)
 void ScorePanel::Open()
 {
 	RebuildTeams();
+	Update();
 	setVisible(true);
 	m_HitTestPanel.setVisible(true);
 }
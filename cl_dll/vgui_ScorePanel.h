@@ -261,6 +261,31 @@ private:
 	CommandButton* m_pCloseButton;
 	CLabelHeader* GetPlayerEntry(int x, int y) { return &m_PlayerEntries[x][y]; }
 
+	// What a grid row showed when it was last filled, FillGrid only fills rows again when this changes.
+	struct RowState
+	{
+		int iIsATeam; // -1 for hidden rows
+		int iSortedRow;
+		int iTeamNumber;
+		int iFrags;
+		int iDeaths;
+		int iPing;
+		int iPlayers;
+		int iPlayerClass;
+		int iValidClasses;
+		int iLocalTeam;
+		bool bThisPlayer;
+		bool bKiller;
+		char szName[MAX_PLAYER_NAME_LENGTH];
+	};
+
+	RowState m_RowStates[NUM_ROWS];
+	bool m_bRowFilled[NUM_ROWS];
+
+	void GetRowState(int row, RowState& state);
+
+	static bool PlayerRanksAbove(int iPlayer, int iOther);
+
 public:
 	int m_iNumTeams;
 	int m_iPlayerNum;
@@ -270,6 +295,8 @@ public:
 	int m_iSortedRows[NUM_ROWS];
 	int m_iIsATeam[NUM_ROWS];
 	bool m_bHasBeenSorted[MAX_PLAYERS_HUD];
+	int m_iPlayerOrder[MAX_PLAYERS_HUD - 1]; // All player slots, kept sorted by score as ScoreInfo messages arrive
+	bool m_bUpdatePending;
 	int m_iLastKilledBy;
 	int m_fLastKillTime;
 
@@ -278,7 +305,11 @@ public:
 	ScorePanel(int x, int y, int wide, int tall);
 
 	void Update();
+	void DeferUpdate();
+
+	void PlayerScoreChanged(int iPlayer);
 
+	void UpdateTeamScores();
 	void SortTeams();
 	void SortPlayers(int iTeam, char* team);
 	void RebuildTeams();
@@ -1645,7 +1645,7 @@ void TeamFortressViewport::UpdateOnPlayerInfo()
 	if (m_pClassMenu)
 		m_pClassMenu->Update();
 	if (m_pScoreBoard)
-		m_pScoreBoard->Update();
+		m_pScoreBoard->DeferUpdate();
 }
 
 void TeamFortressViewport::UpdateCursorState()
@@ -1741,7 +1741,8 @@ void TeamFortressViewport::paintBackground()
 	}
 
 	// Update the Scoreboard, if it's visible
-	if (m_pScoreBoard->isVisible() && (m_flScoreBoardLastUpdated < gHUD.m_flTime))
+	// Changes are picked up right away, pings are refreshed every half second
+	if (m_pScoreBoard->isVisible() && (m_pScoreBoard->m_bUpdatePending || m_flScoreBoardLastUpdated < gHUD.m_flTime))
 	{
 		m_pScoreBoard->Update();
 		m_flScoreBoardLastUpdated = gHUD.m_flTime + 0.5;
@@ -2049,6 +2050,9 @@ bool TeamFortressViewport::MsgFunc_ScoreInfo(const char* pszName, int iSize, voi
 		if (g_PlayerExtraInfo[cl].teamnumber < 0)
 			g_PlayerExtraInfo[cl].teamnumber = 0;
 
+		if (m_pScoreBoard)
+			m_pScoreBoard->PlayerScoreChanged(cl);
+
 		UpdateOnPlayerInfo();
 	}
 
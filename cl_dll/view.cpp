@@ -67,6 +67,7 @@ extern cvar_t* cl_bobtilt;
 #define CAM_MODE_FOCUS 2
 
 Vector v_origin, v_angles, v_cl_angles, v_sim_org, v_lastAngles;
+Vector v_render_angles; // angles the view is drawn with, v_angles doesn't have the third person camera applied
 float v_frametime, v_lastDistance;
 float v_cameraRelaxAngle = 5.0f;
 float v_cameraFocusAngle = 35.0f;
@@ -460,6 +461,7 @@ void V_CalcIntermissionRefdef(struct ref_params_s* pparams)
 	v_cl_angles = pparams->cl_viewangles;
 	v_origin = pparams->vieworg;
 	v_angles = pparams->viewangles;
+	v_render_angles = pparams->viewangles;
 }
 
 #define ORIGIN_BACKUP 64
@@ -844,6 +846,7 @@ void V_CalcNormalRefdef(struct ref_params_s* pparams)
 	lasttime = pparams->time;
 
 	v_origin = pparams->vieworg;
+	v_render_angles = pparams->viewangles;
 }
 
 void V_SmoothInterpolateAngles(float* startAngle, float* endAngle, float* finalAngle, float degreesPerSec)
@@ -1623,6 +1626,8 @@ void V_CalcSpectatorRefdef(struct ref_params_s* pparams)
 	VectorCopy(v_cl_angles, pparams->cl_viewangles);
 	VectorCopy(v_angles, pparams->viewangles)
 		VectorCopy(v_origin, pparams->vieworg);
+
+	v_render_angles = v_angles;
 }
 
 
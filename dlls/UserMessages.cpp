@@ -18,6 +18,7 @@
 #include "cbase.h"
 #include "shake.h"
 #include "UserMessages.h"
+#include "prediction_check.h"
 
 void LinkUserMessages()
 {
@@ -65,4 +66,6 @@ void LinkUserMessages()
 	gmsgStatusValue = REG_USER_MSG("StatusValue", 3);
 
 	gmsgWeapons = REG_USER_MSG("Weapons", 8);
+
+	gmsgPredHash = REG_USER_MSG("PredHash", 4 + PRED_FIELD_COUNT * 2);
 }
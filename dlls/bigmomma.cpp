@@ -24,6 +24,7 @@
 #include "decals.h"
 #include "weapons.h"
 #include "game.h"
+#include "stringpool.h"
 
 #define SF_INFOBM_RUN 0x0001
 #define SF_INFOBM_WAIT 0x0002
@@ -78,17 +79,17 @@ bool CInfoBM::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "reachtarget"))
 	{
-		pev->message = ALLOC_STRING(pkvd->szValue);
+		pev->message = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "reachsequence"))
 	{
-		pev->netname = ALLOC_STRING(pkvd->szValue);
+		pev->netname = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "presequence"))
 	{
-		m_preSequence = ALLOC_STRING(pkvd->szValue);
+		m_preSequence = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
@@ -25,6 +25,7 @@
 #include "cbase.h"
 #include "saverestore.h"
 #include "doors.h"
+#include "stringpool.h"
 
 #define SF_BUTTON_DONTMOVE 1
 #define SF_ROTBUTTON_NOTSOLID 1
@@ -66,7 +67,7 @@ bool CEnvGlobal::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "globalstate")) // State name
 	{
-		m_globalstate = ALLOC_STRING(pkvd->szValue);
+		m_globalstate = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "triggermode"))
@@ -162,7 +163,7 @@ bool CMultiSource::KeyValue(KeyValueData* pkvd)
 		return true;
 	else if (FStrEq(pkvd->szKeyName, "globalstate"))
 	{
-		m_globalstate = ALLOC_STRING(pkvd->szValue);
+		m_globalstate = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
@@ -400,7 +401,7 @@ bool CBaseButton::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "changetarget"))
 	{
-		m_strChangeTarget = ALLOC_STRING(pkvd->szValue);
+		m_strChangeTarget = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "locked_sound"))
@@ -22,6 +22,9 @@
 #include "gamerules.h"
 #include "game.h"
 #include "pm_shared.h"
+#include "pm_replay.h"
+#include "entitypool.h"
+#include "stringpool.h"
 
 void EntvarsKeyvalue(entvars_t* pev, KeyValueData* pkvd);
 
@@ -29,6 +32,13 @@ void OnFreeEntPrivateData(edict_s* pEdict);
 
 extern Vector VecBModelOrigin(entvars_t* pevBModel);
 
+static void ServerPM_Move(playermove_s* ppmove, qboolean server)
+{
+	PMReplay_BeginMove(ppmove);
+	PM_Move(ppmove, server);
+	PMReplay_EndMove(ppmove);
+}
+
 static DLL_FUNCTIONS gFunctionTable =
 	{
 		GameDLLInit,			   //pfnGameInit
@@ -74,7 +84,7 @@ static DLL_FUNCTIONS gFunctionTable =
 
 		Sys_Error, //pfnSys_Error				Called when engine has encountered an error
 
-		PM_Move,			//pfnPM_Move
+		ServerPM_Move,		//pfnPM_Move
 		PM_Init,			//pfnPM_Init				Server version of player movement initialization
 		PM_FindTextureType, //pfnPM_FindTextureType
 
@@ -269,7 +279,7 @@ void DispatchSave(edict_t* pent, SAVERESTOREDATA* pSaveData)
 		if (pTable->pent != pent)
 			ALERT(at_error, "ENTITY TABLE OR INDEX IS WRONG!!!!\n");
 
-		if ((pEntity->ObjectCaps() & FCAP_DONT_SAVE) != 0)
+		if ((pEntity->ObjectCaps() & FCAP_DONT_SAVE) != 0 || EntityPool_IsDormant(pEntity))
 			return;
 
 		// These don't use ltime & nextthink as times really, but we'll fudge around it.
@@ -296,6 +306,8 @@ void OnFreeEntPrivateData(edict_s* pEdict)
 	{
 		auto entity = reinterpret_cast<CBaseEntity*>(pEdict->pvPrivateData);
 
+		EntityPool_OnFree(entity);
+
 		delete entity;
 
 		//Zero this out so the engine doesn't try to free it again.
@@ -799,14 +811,25 @@ CBaseEntity* CBaseEntity::Create(const char* szName, const Vector& vecOrigin, co
 {
 	edict_t* pent;
 	CBaseEntity* pEntity;
+	CEntityPool* pool = CEntityPool::Find(szName);
 
-	pent = CREATE_NAMED_ENTITY(MAKE_STRING(szName));
-	if (FNullEnt(pent))
+	if (pool && (pEntity = pool->Acquire()) != NULL)
 	{
-		ALERT(at_console, "NULL Ent in Create!\n");
-		return NULL;
+		pEntity->pev->classname = StringPool_Alloc(szName);
+	}
+	else
+	{
+		pent = CREATE_NAMED_ENTITY(StringPool_Alloc(szName));
+		if (FNullEnt(pent))
+		{
+			ALERT(at_console, "NULL Ent in Create!\n");
+			return NULL;
+		}
+		pEntity = Instance(pent);
+
+		if (pool)
+			pool->Track(pEntity);
 	}
-	pEntity = Instance(pent);
 	pEntity->pev->owner = pentOwner;
 	pEntity->pev->origin = vecOrigin;
 	pEntity->pev->angles = vecAngles;
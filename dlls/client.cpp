@@ -46,7 +46,12 @@
 #include "netadr.h"
 #include "pm_shared.h"
 #include "pm_defs.h"
+#include "pm_replay.h"
 #include "UserMessages.h"
+#include "entitypool.h"
+#include "effectbudget.h"
+#include "stringpool.h"
+#include "prediction_check.h"
 
 DLL_GLOBAL unsigned int g_ulFrameCount;
 
@@ -529,7 +534,7 @@ void ClientCommand(edict_t* pEntity)
 	{
 		if (0 != g_psv_cheats->value)
 		{
-			int iszItem = ALLOC_STRING(CMD_ARGV(1)); // Make a copy of the classname
+			int iszItem = StringPool_Alloc(CMD_ARGV(1)); // Make a copy of the classname
 			player->GiveNamedItem(STRING(iszItem));
 		}
 	}
@@ -701,6 +706,75 @@ void ServerDeactivate()
 
 	// Peform any shutdown operations here...
 	//
+	EntityPool_Clear();
+	EffectBudget_Clear();
+	PMReplay_StopRecording();
+	PM_ClearTextureTypeCache();
+}
+
+/**
+*	@brief sv_pmrecord <file> [player index]: records a player's moves for the pmreplay tool. sv_pmrecord stop ends the recording.
+*/
+void PMRecordCommand()
+{
+	if (CMD_ARGC() < 2)
+	{
+		g_engfuncs.pfnServerPrint(PMReplay_IsRecording() ? "Recording player movement\n" : "Not recording player movement\n");
+		g_engfuncs.pfnServerPrint("Usage: sv_pmrecord <file> [player index] | stop\n");
+		return;
+	}
+
+	if (0 == strcmp(CMD_ARGV(1), "stop"))
+	{
+		PMReplay_StopRecording();
+		return;
+	}
+
+	const int playerIndex = CMD_ARGC() >= 3 ? atoi(CMD_ARGV(2)) : 1;
+
+	if (playerIndex < 1 || playerIndex > gpGlobals->maxClients)
+	{
+		g_engfuncs.pfnServerPrint(UTIL_VarArgs("Invalid player index %d\n", playerIndex));
+		return;
+	}
+
+	char gameDir[512];
+	GET_GAME_DIR(gameDir);
+
+	// Relative to the game directory so the file ends up next to the maps the tool loads
+	const char* filename = UTIL_VarArgs("%s/%s", gameDir, CMD_ARGV(1));
+
+	if (!PMReplay_StartRecording(filename, STRING(gpGlobals->mapname), playerIndex))
+	{
+		g_engfuncs.pfnServerPrint(UTIL_VarArgs("Couldn't open %s for writing\n", filename));
+		return;
+	}
+
+	g_engfuncs.pfnServerPrint(UTIL_VarArgs("Recording the moves of player %d to %s\n", playerIndex, filename));
+}
+
+/**
+*	@brief sv_pmtrace_stats [reset]: prints how many engine traces the player movement memo saved.
+*/
+void PMTraceStatsCommand()
+{
+	if (CMD_ARGC() >= 2 && 0 == strcmp(CMD_ARGV(1), "reset"))
+	{
+		PM_ResetTraceStats();
+		return;
+	}
+
+	const pm_tracestats_t& stats = PM_GetTraceStats();
+
+	const auto print = [](const char* name, unsigned int calls, unsigned int hits)
+	{
+		g_engfuncs.pfnServerPrint(UTIL_VarArgs("%-10s %10u calls %10u from memo (%.1f%%)\n",
+			name, calls, hits, calls > 0 ? 100.0 * hits / calls : 0.0));
+	};
+
+	print("traces", stats.traces, stats.traceHits);
+	print("contents", stats.contents, stats.contentsHits);
+	print("positions", stats.tests, stats.testHits);
 }
 
 void ServerActivate(edict_t* pEdictList, int edictCount, int clientMax)
@@ -1939,6 +2013,47 @@ void CmdStart(const edict_t* player, const struct usercmd_s* cmd, unsigned int r
 	pl->random_seed = random_seed;
 }
 
+/**
+*	@brief Sends hashes of the state the player ended up in after running a usercmd, for the client to check its prediction against.
+*	Must match the state HUD_PostRunCmd predicts on the client.
+*/
+static void SendPredictionHashes(CBasePlayer* pl)
+{
+	PredictionState state{};
+
+	for (int i = 0; i < 3; ++i)
+	{
+		state.Origin[i] = pl->pev->origin[i];
+		state.Velocity[i] = pl->pev->velocity[i];
+	}
+
+	state.Flags = pl->pev->flags & PREDICTION_FLAGS;
+	state.NextAttack = pl->m_flNextAttack;
+
+#if defined(CLIENT_WEAPONS)
+	CBasePlayerWeapon* gun = pl->m_pActiveItem ? pl->m_pActiveItem->GetWeaponPtr() : nullptr;
+
+	if (gun && gun->UseDecrement())
+	{
+		state.WeaponId = gun->m_iId;
+		state.Clip = gun->m_iClip;
+		state.InReload = static_cast<int>(gun->m_fInReload);
+		state.NextPrimaryAttack = gun->m_flNextPrimaryAttack;
+		state.NextSecondaryAttack = gun->m_flNextSecondaryAttack;
+		state.WeaponIdle = gun->m_flTimeWeaponIdle;
+	}
+#endif
+
+	unsigned short hashes[PRED_FIELD_COUNT];
+	PredictionState_Hash(state, hashes);
+
+	MESSAGE_BEGIN(MSG_ONE_UNRELIABLE, gmsgPredHash, nullptr, pl->pev);
+	WRITE_LONG(static_cast<int>(pl->random_seed));
+	for (int i = 0; i < PRED_FIELD_COUNT; ++i)
+		WRITE_SHORT(hashes[i]);
+	MESSAGE_END();
+}
+
 /*
 =================
 CmdEnd
@@ -1957,6 +2072,11 @@ void CmdEnd(const edict_t* player)
 	{
 		UTIL_UnsetGroupTrace();
 	}
+
+	if (0 != sv_prediction_debug.value && (pl->pev->flags & FL_FAKECLIENT) == 0)
+	{
+		SendPredictionHashes(pl);
+	}
 }
 
 /*
@@ -20,6 +20,8 @@
 
 */
 
+#include <vector>
+
 #include "extdll.h"
 #include "util.h"
 #include "cbase.h"
@@ -29,6 +31,9 @@
 #include "animation.h"
 #include "weapons.h"
 #include "func_break.h"
+#include "bullet_impacts.h"
+#include "entitypool.h"
+#include "effectbudget.h"
 
 extern Vector VecBModelOrigin(entvars_t* pevBModel);
 
@@ -36,6 +41,7 @@ extern Vector VecBModelOrigin(entvars_t* pevBModel);
 #define HUMAN_GIB_COUNT 6
 #define ALIEN_GIB_COUNT 4
 
+LINK_ENTITY_TO_POOL(gib, CGib);
 
 // HACKHACK -- The gib velocity equations don't work
 void CGib::LimitVelocity()
@@ -61,7 +67,7 @@ void CGib::SpawnStickyGibs(entvars_t* pevVictim, Vector vecOrigin, int cGibs)
 
 	for (i = 0; i < cGibs; i++)
 	{
-		CGib* pGib = GetClassPtr((CGib*)NULL);
+		CGib* pGib = GetPooledClassPtr<CGib>("gib");
 
 		pGib->Spawn("models/stickygib.mdl");
 		pGib->pev->body = RANDOM_LONG(0, 2);
@@ -115,12 +121,13 @@ void CGib::SpawnStickyGibs(entvars_t* pevVictim, Vector vecOrigin, int cGibs)
 			pGib->SetThink(NULL);
 		}
 		pGib->LimitVelocity();
+		EffectBudget_AddGib(pGib);
 	}
 }
 
 void CGib::SpawnHeadGib(entvars_t* pevVictim)
 {
-	CGib* pGib = GetClassPtr((CGib*)NULL);
+	CGib* pGib = GetPooledClassPtr<CGib>("gib");
 
 	if (g_Language == LANGUAGE_GERMAN)
 	{
@@ -174,6 +181,7 @@ void CGib::SpawnHeadGib(entvars_t* pevVictim)
 		}
 	}
 	pGib->LimitVelocity();
+	EffectBudget_AddGib(pGib);
 }
 
 void CGib::SpawnRandomGibs(entvars_t* pevVictim, int cGibs, bool human)
@@ -182,7 +190,7 @@ void CGib::SpawnRandomGibs(entvars_t* pevVictim, int cGibs, bool human)
 
 	for (cSplat = 0; cSplat < cGibs; cSplat++)
 	{
-		CGib* pGib = GetClassPtr((CGib*)NULL);
+		CGib* pGib = GetPooledClassPtr<CGib>("gib");
 
 		if (g_Language == LANGUAGE_GERMAN)
 		{
@@ -245,6 +253,7 @@ void CGib::SpawnRandomGibs(entvars_t* pevVictim, int cGibs, bool human)
 			UTIL_SetSize(pGib->pev, Vector(0, 0, 0), Vector(0, 0, 0));
 		}
 		pGib->LimitVelocity();
+		EffectBudget_AddGib(pGib);
 	}
 }
 
@@ -1025,21 +1034,99 @@ float CBaseMonster::DamageForce(float damage)
 	return force;
 }
 
+//=========================================================
+// Radius damage batching
 //
-// RadiusDamage - this entity is exploding, or otherwise needs to inflict damage upon entities within a certain range.
-//
-// only damage ents that can clearly be seen by the explosion!
+// Explosions issued while a batch is open are queued and
+// applied in issue order when the outermost batch ends.
+// Explosions triggered while a batch is being applied (chain
+// reactions from grenades, satchels, tripmines, ...) are
+// applied immediately, exactly like unbatched explosions, so
+// the order in which damage is dealt never changes.
+//=========================================================
+struct RadiusDamageInfo
+{
+	Vector vecSrc;
+	entvars_t* pevInflictor;
+	entvars_t* pevAttacker;
+	float flDamage;
+	float flRadius;
+	int iClassIgnore;
+	int bitsDamageType;
+};
+
+class CRadiusDamageBatch
+{
+public:
+	void Begin();
+	void End();
 
+	void Queue(const RadiusDamageInfo& info);
 
-void RadiusDamage(Vector vecSrc, entvars_t* pevInflictor, entvars_t* pevAttacker, float flDamage, float flRadius, int iClassIgnore, int bitsDamageType)
+private:
+	void Apply(const RadiusDamageInfo& info);
+
+	int m_iDepth = 0;
+	int m_iApplying = 0;
+	std::vector<RadiusDamageInfo> m_Queue;
+};
+
+static CRadiusDamageBatch g_RadiusDamageBatch;
+
+void CRadiusDamageBatch::Begin()
+{
+	++m_iDepth;
+}
+
+void CRadiusDamageBatch::End()
+{
+	if (m_iDepth <= 0)
+		return;
+
+	// Batches opened while the queue is being applied had nothing queued, their explosions were applied immediately.
+	if (--m_iDepth > 0 || 0 != m_iApplying)
+		return;
+
+	++m_iApplying;
+
+	// Explosions triggered from here on are applied immediately, so the queue can't grow while it's being walked.
+	for (std::size_t i = 0; i < m_Queue.size(); ++i)
+	{
+		Apply(m_Queue[i]);
+	}
+
+	--m_iApplying;
+
+	m_Queue.clear();
+}
+
+void CRadiusDamageBatch::Queue(const RadiusDamageInfo& info)
+{
+	if (m_iDepth > 0 && 0 == m_iApplying)
+	{
+		m_Queue.push_back(info);
+		return;
+	}
+
+	++m_iApplying;
+	Apply(info);
+	--m_iApplying;
+}
+
+void CRadiusDamageBatch::Apply(const RadiusDamageInfo& info)
 {
 	CBaseEntity* pEntity = NULL;
 	TraceResult tr;
 	float flAdjustedDamage, falloff;
 	Vector vecSpot;
 
-	if (0 != flRadius)
-		falloff = flDamage / flRadius;
+	Vector vecSrc = info.vecSrc;
+	entvars_t* pevInflictor = info.pevInflictor;
+	entvars_t* pevAttacker = info.pevAttacker;
+	const float flDamage = info.flDamage;
+
+	if (0 != info.flRadius)
+		falloff = flDamage / info.flRadius;
 	else
 		falloff = 1.0;
 
@@ -1051,12 +1138,12 @@ void RadiusDamage(Vector vecSrc, entvars_t* pevInflictor, entvars_t* pevAttacker
 		pevAttacker = pevInflictor;
 
 	// iterate on all entities in the vicinity.
-	while ((pEntity = UTIL_FindEntityInSphere(pEntity, vecSrc, flRadius)) != NULL)
+	while ((pEntity = UTIL_FindEntityInSphere(pEntity, vecSrc, info.flRadius)) != NULL)
 	{
 		if (pEntity->pev->takedamage != DAMAGE_NO)
 		{
 			// UNDONE: this should check a damage mask, not an ignore
-			if (iClassIgnore != CLASS_NONE && pEntity->Classify() == iClassIgnore)
+			if (info.iClassIgnore != CLASS_NONE && pEntity->Classify() == info.iClassIgnore)
 			{ // houndeyes don't hurt other houndeyes with their attack
 				continue;
 			}
@@ -1093,18 +1180,40 @@ void RadiusDamage(Vector vecSrc, entvars_t* pevInflictor, entvars_t* pevAttacker
 				if (tr.flFraction != 1.0)
 				{
 					ClearMultiDamage();
-					pEntity->TraceAttack(pevInflictor, flAdjustedDamage, (tr.vecEndPos - vecSrc).Normalize(), &tr, bitsDamageType);
+					pEntity->TraceAttack(pevInflictor, flAdjustedDamage, (tr.vecEndPos - vecSrc).Normalize(), &tr, info.bitsDamageType);
 					ApplyMultiDamage(pevInflictor, pevAttacker);
 				}
 				else
 				{
-					pEntity->TakeDamage(pevInflictor, pevAttacker, flAdjustedDamage, bitsDamageType);
+					pEntity->TakeDamage(pevInflictor, pevAttacker, flAdjustedDamage, info.bitsDamageType);
 				}
 			}
 		}
 	}
 }
 
+void RadiusDamageBatchBegin()
+{
+	g_RadiusDamageBatch.Begin();
+}
+
+void RadiusDamageBatchEnd()
+{
+	g_RadiusDamageBatch.End();
+}
+
+//
+// RadiusDamage - this entity is exploding, or otherwise needs to inflict damage upon entities within a certain range.
+//
+// only damage ents that can clearly be seen by the explosion!
+//
+// If a radius damage batch is open the damage is applied when the batch ends.
+//
+void RadiusDamage(Vector vecSrc, entvars_t* pevInflictor, entvars_t* pevAttacker, float flDamage, float flRadius, int iClassIgnore, int bitsDamageType)
+{
+	g_RadiusDamageBatch.Queue({vecSrc, pevInflictor, pevAttacker, flDamage, flRadius, iClassIgnore, bitsDamageType});
+}
+
 
 void CBaseMonster::RadiusDamage(entvars_t* pevInflictor, entvars_t* pevAttacker, float flDamage, int iClassIgnore, int bitsDamageType)
 {
@@ -1355,6 +1464,27 @@ void CBaseMonster::TraceAttack(entvars_t* pevAttacker, float flDamage, Vector ve
 	}
 }
 
+static bool BulletHitBrush(TraceResult* ptr)
+{
+	entvars_t* pevHit = VARS(ptr->pHit);
+
+	return pevHit->solid == SOLID_BSP || pevHit->movetype == MOVETYPE_PUSHSTEP;
+}
+
+//
+// BulletImpact - plays the impact sound and paints the decal for a pellet. Only the first pellet
+// to hit a surface plays a sound, and pellets landing on top of an earlier one share its decal.
+//
+static void BulletImpact(CBulletImpacts& impacts, TraceResult* ptr, const Vector& vecSrc, const Vector& vecEnd, int iBulletType)
+{
+	if (impacts.AddImpact(ENTINDEX(ptr->pHit), BulletHitBrush(ptr), ptr->vecPlaneNormal, ptr->flPlaneDist))
+		TEXTURETYPE_PlaySound(ptr, vecSrc, vecEnd, iBulletType);
+
+	if (impacts.AddDecal(ptr->vecEndPos))
+		DecalGunshot(ptr, iBulletType);
+}
+
+
 /*
 ================
 FireBullets
@@ -1374,9 +1504,11 @@ void CBaseEntity::FireBullets(unsigned int cShots, Vector vecSrc, Vector vecDirS
 	if (pevAttacker == NULL)
 		pevAttacker = pev; // the default attacker is ourselves
 
-	ClearMultiDamage();
+	ClearMultiDamagePerVictim();
 	gMultiDamage.type = DMG_BULLET | DMG_NEVERGIB;
 
+	CBulletImpacts impacts;
+
 	for (unsigned int iShot = 1; iShot <= cShots; iShot++)
 	{
 		// get circular gaussian spread
@@ -1436,8 +1568,7 @@ void CBaseEntity::FireBullets(unsigned int cShots, Vector vecSrc, Vector vecDirS
 			{
 				pEntity->TraceAttack(pevAttacker, iDamage, vecDir, &tr, DMG_BULLET | ((iDamage > 16) ? DMG_ALWAYSGIB : DMG_NEVERGIB));
 
-				TEXTURETYPE_PlaySound(&tr, vecSrc, vecEnd, iBulletType);
-				DecalGunshot(&tr, iBulletType);
+				BulletImpact(impacts, &tr, vecSrc, vecEnd, iBulletType);
 			}
 			else
 				switch (iBulletType)
@@ -1446,38 +1577,35 @@ void CBaseEntity::FireBullets(unsigned int cShots, Vector vecSrc, Vector vecDirS
 					// make distance based!
 					pEntity->TraceAttack(pevAttacker, gSkillData.plrDmgBuckshot, vecDir, &tr, DMG_BULLET);
 
-					TEXTURETYPE_PlaySound(&tr, vecSrc, vecEnd, iBulletType);
-					DecalGunshot(&tr, iBulletType);
+					BulletImpact(impacts, &tr, vecSrc, vecEnd, iBulletType);
 					break;
 
 				default:
 				case BULLET_MONSTER_9MM:
 					pEntity->TraceAttack(pevAttacker, gSkillData.monDmg9MM, vecDir, &tr, DMG_BULLET);
 
-					TEXTURETYPE_PlaySound(&tr, vecSrc, vecEnd, iBulletType);
-					DecalGunshot(&tr, iBulletType);
+					BulletImpact(impacts, &tr, vecSrc, vecEnd, iBulletType);
 
 					break;
 
 				case BULLET_MONSTER_MP5:
 					pEntity->TraceAttack(pevAttacker, gSkillData.monDmgMP5, vecDir, &tr, DMG_BULLET);
 
-					TEXTURETYPE_PlaySound(&tr, vecSrc, vecEnd, iBulletType);
-					DecalGunshot(&tr, iBulletType);
+					BulletImpact(impacts, &tr, vecSrc, vecEnd, iBulletType);
 
 					break;
 
 				case BULLET_MONSTER_12MM:
 					pEntity->TraceAttack(pevAttacker, gSkillData.monDmg12MM, vecDir, &tr, DMG_BULLET);
-					TEXTURETYPE_PlaySound(&tr, vecSrc, vecEnd, iBulletType);
-					DecalGunshot(&tr, iBulletType);
+					BulletImpact(impacts, &tr, vecSrc, vecEnd, iBulletType);
 					break;
 
 				case BULLET_NONE: // FIX
 					pEntity->TraceAttack(pevAttacker, 50, vecDir, &tr, DMG_CLUB);
-					TEXTURETYPE_PlaySound(&tr, vecSrc, vecEnd, iBulletType);
+					if (impacts.AddImpact(ENTINDEX(tr.pHit), BulletHitBrush(&tr), tr.vecPlaneNormal, tr.flPlaneDist))
+						TEXTURETYPE_PlaySound(&tr, vecSrc, vecEnd, iBulletType);
 					// only decal glass
-					if (!FNullEnt(tr.pHit) && VARS(tr.pHit)->rendermode != 0)
+					if (!FNullEnt(tr.pHit) && VARS(tr.pHit)->rendermode != 0 && impacts.AddDecal(tr.vecEndPos))
 					{
 						UTIL_DecalTrace(&tr, DECAL_GLASSBREAK1 + RANDOM_LONG(0, 2));
 					}
@@ -1512,9 +1640,11 @@ Vector CBaseEntity::FireBulletsPlayer(unsigned int cShots, Vector vecSrc, Vector
 	if (pevAttacker == NULL)
 		pevAttacker = pev; // the default attacker is ourselves
 
-	ClearMultiDamage();
+	ClearMultiDamagePerVictim();
 	gMultiDamage.type = DMG_BULLET | DMG_NEVERGIB;
 
+	CBulletImpacts impacts;
+
 	for (unsigned int iShot = 1; iShot <= cShots; iShot++)
 	{
 		//Use player's random seed.
@@ -1540,8 +1670,7 @@ Vector CBaseEntity::FireBulletsPlayer(unsigned int cShots, Vector vecSrc, Vector
 			{
 				pEntity->TraceAttack(pevAttacker, iDamage, vecDir, &tr, DMG_BULLET | ((iDamage > 16) ? DMG_ALWAYSGIB : DMG_NEVERGIB));
 
-				TEXTURETYPE_PlaySound(&tr, vecSrc, vecEnd, iBulletType);
-				DecalGunshot(&tr, iBulletType);
+				BulletImpact(impacts, &tr, vecSrc, vecEnd, iBulletType);
 			}
 			else
 				switch (iBulletType)
@@ -1566,9 +1695,10 @@ Vector CBaseEntity::FireBulletsPlayer(unsigned int cShots, Vector vecSrc, Vector
 
 				case BULLET_NONE: // FIX
 					pEntity->TraceAttack(pevAttacker, 50, vecDir, &tr, DMG_CLUB);
-					TEXTURETYPE_PlaySound(&tr, vecSrc, vecEnd, iBulletType);
+					if (impacts.AddImpact(ENTINDEX(tr.pHit), BulletHitBrush(&tr), tr.vecPlaneNormal, tr.flPlaneDist))
+						TEXTURETYPE_PlaySound(&tr, vecSrc, vecEnd, iBulletType);
 					// only decal glass
-					if (!FNullEnt(tr.pHit) && VARS(tr.pHit)->rendermode != 0)
+					if (!FNullEnt(tr.pHit) && VARS(tr.pHit)->rendermode != 0 && impacts.AddDecal(tr.vecEndPos))
 					{
 						UTIL_DecalTrace(&tr, DECAL_GLASSBREAK1 + RANDOM_LONG(0, 2));
 					}
@@ -21,6 +21,7 @@
 #include "player.h"
 #include "gamerules.h"
 #include "UserMessages.h"
+#include "entitypool.h"
 
 #ifndef CLIENT_DLL
 #define BOLT_AIR_VELOCITY 2000
@@ -46,11 +47,12 @@ public:
 	static CCrossbowBolt* BoltCreate();
 };
 LINK_ENTITY_TO_CLASS(crossbow_bolt, CCrossbowBolt);
+LINK_ENTITY_TO_POOL(crossbow_bolt, CCrossbowBolt);
 
 CCrossbowBolt* CCrossbowBolt::BoltCreate()
 {
 	// Create a new entity with CCrossbowBolt private data
-	CCrossbowBolt* pBolt = GetClassPtr((CCrossbowBolt*)NULL);
+	CCrossbowBolt* pBolt = GetPooledClassPtr<CCrossbowBolt>("crossbow_bolt");
 	pBolt->pev->classname = MAKE_STRING("bolt");
 	pBolt->Spawn();
 
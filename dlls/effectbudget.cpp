@@ -0,0 +1,355 @@
+/***
+*
+*	Copyright (c) 1996-2001, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+#include "monsters.h"
+#include "game.h"
+#include "effectbudget.h"
+
+// Blood decals are rate limited per plane and per cell of this size, so one large floor doesn't share a single budget
+constexpr float DECAL_CELL_SIZE = 128;
+constexpr int MAX_DECAL_SURFACES = 64;
+
+struct BudgetEntry
+{
+	EHANDLE hEntity;
+	float time;
+};
+
+struct BudgetStats
+{
+	unsigned int added;
+	unsigned int recycledArea;
+	unsigned int recycledGlobal;
+	unsigned int recycledVisible;
+	int peak;
+};
+
+struct DecalSurface
+{
+	int entity;
+	Vector normal;
+	float dist;
+	int cell[3];
+	float tokens;
+	float lastTime;
+};
+
+// Ordered oldest first
+static std::vector<BudgetEntry> g_Gibs;
+static std::vector<BudgetEntry> g_Corpses;
+
+static BudgetStats g_GibStats;
+static BudgetStats g_CorpseStats;
+
+static DecalSurface g_DecalSurfaces[MAX_DECAL_SURFACES];
+static int g_DecalSurfaceCount = 0;
+static unsigned int g_DecalsPlaced = 0;
+static unsigned int g_DecalsSuppressed = 0;
+
+static bool IsLiveGib(CBaseEntity* pEntity)
+{
+	return pEntity && (pEntity->pev->flags & FL_KILLME) == 0;
+}
+
+static bool IsLiveCorpse(CBaseEntity* pEntity)
+{
+	return pEntity && pEntity->pev->modelindex != 0;
+}
+
+static bool IsInArea(CBaseEntity* pEntity, const Vector& origin, float radius)
+{
+	return (pEntity->pev->origin - origin).Length() < radius;
+}
+
+//
+// Picks the instance to recycle among the candidates (indices into entries, oldest first):
+// the oldest one that isn't in any player's PVS, or the oldest one if they can all be seen.
+//
+static int SelectVictim(std::vector<BudgetEntry>& entries, const std::vector<int>& candidates, BudgetStats& stats)
+{
+	std::vector<bool> visible(candidates.size(), false);
+
+	for (int i = 1; i <= gpGlobals->maxClients; i++)
+	{
+		CBaseEntity* pPlayer = UTIL_PlayerByIndex(i);
+
+		if (!pPlayer)
+			continue;
+
+		Vector vecEyes = pPlayer->pev->origin + pPlayer->pev->view_ofs;
+		unsigned char* pvs = ENGINE_SET_PVS(vecEyes);
+
+		for (std::size_t j = 0; j < candidates.size(); j++)
+		{
+			if (!visible[j] && 0 != ENGINE_CHECK_VISIBILITY(entries[candidates[j]].hEntity.Get(), pvs))
+				visible[j] = true;
+		}
+	}
+
+	for (std::size_t j = 0; j < candidates.size(); j++)
+	{
+		if (!visible[j])
+			return candidates[j];
+	}
+
+	++stats.recycledVisible;
+
+	return candidates.front();
+}
+
+//
+// Returns the index of the entry that has to make room for a new instance at origin, or -1 if there is room left.
+//
+template <typename IsLive>
+static int FindVictim(std::vector<BudgetEntry>& entries, BudgetStats& stats, const Vector& origin, int maxGlobal, int maxArea, IsLive isLive)
+{
+	const float radius = sv_effectbudget_area.value;
+
+	std::vector<int> live;
+	std::vector<int> area;
+
+	for (std::size_t i = 0; i < entries.size(); i++)
+	{
+		CBaseEntity* pEntity = entries[i].hEntity;
+
+		if (!isLive(pEntity))
+			continue;
+
+		live.push_back(i);
+
+		if (radius > 0 && IsInArea(pEntity, origin, radius))
+			area.push_back(i);
+	}
+
+	if (maxArea > 0 && radius > 0 && static_cast<int>(area.size()) >= maxArea)
+	{
+		++stats.recycledArea;
+		return SelectVictim(entries, area, stats);
+	}
+
+	if (maxGlobal > 0 && static_cast<int>(live.size()) >= maxGlobal)
+	{
+		++stats.recycledGlobal;
+		return SelectVictim(entries, live, stats);
+	}
+
+	return -1;
+}
+
+void EffectBudget_AddGib(CGib* pGib)
+{
+	// Forget gibs that have faded out or were removed
+	g_Gibs.erase(std::remove_if(g_Gibs.begin(), g_Gibs.end(), [](BudgetEntry& entry)
+					 { return !IsLiveGib(entry.hEntity); }),
+		g_Gibs.end());
+
+	const int victim = FindVictim(g_Gibs, g_GibStats, pGib->pev->origin,
+		static_cast<int>(sv_gib_max.value), static_cast<int>(sv_gib_max_area.value), &IsLiveGib);
+
+	if (victim != -1)
+	{
+		UTIL_Remove(g_Gibs[victim].hEntity);
+		g_Gibs.erase(g_Gibs.begin() + victim);
+	}
+
+	BudgetEntry entry;
+	entry.hEntity = pGib;
+	entry.time = gpGlobals->time;
+	g_Gibs.push_back(entry);
+
+	++g_GibStats.added;
+	g_GibStats.peak = std::max(g_GibStats.peak, static_cast<int>(g_Gibs.size()));
+}
+
+void EffectBudget_InitCorpses(edict_t* pBodyQueueHead)
+{
+	g_Corpses.clear();
+
+	edict_t* pent = pBodyQueueHead;
+
+	do
+	{
+		BudgetEntry entry;
+		entry.hEntity = CBaseEntity::Instance(pent);
+		entry.time = 0;
+		g_Corpses.push_back(entry);
+
+		pent = VARS(pent)->owner;
+	} while (pent && pent != pBodyQueueHead);
+}
+
+edict_t* EffectBudget_ClaimCorpse(const Vector& origin)
+{
+	int slot = FindVictim(g_Corpses, g_CorpseStats, origin,
+		static_cast<int>(sv_corpse_max.value), static_cast<int>(sv_corpse_max_area.value), &IsLiveCorpse);
+
+	if (slot == -1)
+	{
+		for (std::size_t i = 0; i < g_Corpses.size(); i++)
+		{
+			if (!IsLiveCorpse(g_Corpses[i].hEntity))
+			{
+				slot = i;
+				break;
+			}
+		}
+
+		// All body queue entries are in use, reuse the oldest like the body queue always did
+		if (slot == -1)
+		{
+			++g_CorpseStats.recycledGlobal;
+			slot = 0;
+		}
+	}
+
+	BudgetEntry entry = g_Corpses[slot];
+	entry.time = gpGlobals->time;
+
+	g_Corpses.erase(g_Corpses.begin() + slot);
+	g_Corpses.push_back(entry);
+
+	++g_CorpseStats.added;
+
+	int live = 0;
+
+	for (auto& corpse : g_Corpses)
+	{
+		if (IsLiveCorpse(corpse.hEntity))
+			++live;
+	}
+
+	// The claimed entry isn't live until the corpse has been copied to it
+	g_CorpseStats.peak = std::max(g_CorpseStats.peak, IsLiveCorpse(entry.hEntity) ? live : live + 1);
+
+	return entry.hEntity.Get();
+}
+
+bool EffectBudget_AllowDecal(const TraceResult* pTrace)
+{
+	const float rate = sv_decal_rate.value;
+
+	if (rate <= 0 || pTrace->flFraction == 1.0)
+		return true;
+
+	const int entity = pTrace->pHit ? ENTINDEX(pTrace->pHit) : 0;
+	const float dist = DotProduct(pTrace->vecPlaneNormal, pTrace->vecEndPos);
+
+	int cell[3];
+
+	for (int i = 0; i < 3; i++)
+	{
+		cell[i] = static_cast<int>(std::floor(pTrace->vecEndPos[i] / DECAL_CELL_SIZE));
+	}
+
+	DecalSurface* pSurface = nullptr;
+
+	for (int i = 0; i < g_DecalSurfaceCount; i++)
+	{
+		DecalSurface& surface = g_DecalSurfaces[i];
+
+		if (surface.entity == entity && 0 == memcmp(surface.cell, cell, sizeof(cell)) && DotProduct(surface.normal, pTrace->vecPlaneNormal) > 0.999f && fabs(surface.dist - dist) < 1)
+		{
+			pSurface = &surface;
+			break;
+		}
+	}
+
+	const float burst = std::max(sv_decal_burst.value, 1.0f);
+
+	if (!pSurface)
+	{
+		// Take a free entry, or the one that was used least recently
+		if (g_DecalSurfaceCount < MAX_DECAL_SURFACES)
+		{
+			pSurface = &g_DecalSurfaces[g_DecalSurfaceCount++];
+		}
+		else
+		{
+			pSurface = std::min_element(std::begin(g_DecalSurfaces), std::end(g_DecalSurfaces), [](const DecalSurface& lhs, const DecalSurface& rhs)
+				{ return lhs.lastTime < rhs.lastTime; });
+		}
+
+		pSurface->entity = entity;
+		pSurface->normal = pTrace->vecPlaneNormal;
+		pSurface->dist = dist;
+		memcpy(pSurface->cell, cell, sizeof(cell));
+		pSurface->tokens = burst;
+		pSurface->lastTime = gpGlobals->time;
+	}
+
+	pSurface->tokens = std::min(burst, pSurface->tokens + (gpGlobals->time - pSurface->lastTime) * rate);
+	pSurface->lastTime = gpGlobals->time;
+
+	if (pSurface->tokens < 1)
+	{
+		++g_DecalsSuppressed;
+		return false;
+	}
+
+	pSurface->tokens -= 1;
+	++g_DecalsPlaced;
+
+	return true;
+}
+
+void EffectBudget_Clear()
+{
+	g_Gibs.clear();
+	g_Corpses.clear();
+	g_DecalSurfaceCount = 0;
+}
+
+static void PrintBudgetStats(const char* name, const std::vector<BudgetEntry>& entries, const BudgetStats& stats, bool (*isLive)(CBaseEntity*), const cvar_t& max, const cvar_t& maxArea)
+{
+	int live = 0;
+
+	for (auto entry : entries)
+	{
+		if (isLive(entry.hEntity))
+			++live;
+	}
+
+	g_engfuncs.pfnServerPrint(UTIL_VarArgs("%-8s %4d %4d %4d %4d %7u %6u %6u %7u\n",
+		name, live, static_cast<int>(max.value), static_cast<int>(maxArea.value), stats.peak,
+		stats.added, stats.recycledArea, stats.recycledGlobal, stats.recycledVisible));
+}
+
+void EffectBudget_PrintStats()
+{
+	if (CMD_ARGC() > 1 && 0 == strcmp(CMD_ARGV(1), "reset"))
+	{
+		g_GibStats = {};
+		g_CorpseStats = {};
+		g_DecalsPlaced = g_DecalsSuppressed = 0;
+		return;
+	}
+
+	g_engfuncs.pfnServerPrint(UTIL_VarArgs("Effect budgets (area radius %d):\n", static_cast<int>(sv_effectbudget_area.value)));
+	g_engfuncs.pfnServerPrint("type     live  max area peak   added   area global visible\n");
+
+	PrintBudgetStats("gibs", g_Gibs, g_GibStats, &IsLiveGib, sv_gib_max, sv_gib_max_area);
+	PrintBudgetStats("corpses", g_Corpses, g_CorpseStats, &IsLiveCorpse, sv_corpse_max, sv_corpse_max_area);
+
+	g_engfuncs.pfnServerPrint(UTIL_VarArgs("blood decals: %u placed, %u suppressed (%g per second per surface, burst %d, %d surfaces tracked)\n",
+		g_DecalsPlaced, g_DecalsSuppressed, sv_decal_rate.value, static_cast<int>(sv_decal_burst.value), g_DecalSurfaceCount));
+}
@@ -0,0 +1,59 @@
+/***
+*
+*	Copyright (c) 1996-2001, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#pragma once
+
+/**
+*	@file
+*
+*	Budgets for the effects that pile up during mass-casualty events: gibs, multiplayer corpses and blood decals.
+*	Gibs and corpses are capped globally and per area. When a budget is exceeded the oldest instance nobody can see is recycled,
+*	or the oldest one if they are all visible. Blood decals are rate limited per surface.
+*	All limits are cvars. 0 disables a limit, except for sv_corpse_max which is the size of the body queue. Statistics are printed by sv_effectbudget_stats.
+*/
+
+class CGib;
+
+/**
+*	@brief Adds a gib thrown by a dying monster or player to the gib budget, removing older gibs if needed.
+*	Must be called after the gib's origin has been set.
+*/
+void EffectBudget_AddGib(CGib* pGib);
+
+/**
+*	@brief Sets up the corpse budget with the body queue entities. Called when the body queue is created.
+*/
+void EffectBudget_InitCorpses(edict_t* pBodyQueueHead);
+
+/**
+*	@brief Returns the body queue entity a new corpse at the given origin should be copied to.
+*	This is a free entry if one is left and the area isn't full, otherwise the corpse to recycle.
+*/
+edict_t* EffectBudget_ClaimCorpse(const Vector& origin);
+
+/**
+*	@brief Returns whether a blood decal may be placed for this trace, based on the decal rate of the surface that was hit.
+*/
+bool EffectBudget_AllowDecal(const TraceResult* pTrace);
+
+/**
+*	@brief Forgets all tracked instances. Called when the server shuts down the current map.
+*/
+void EffectBudget_Clear();
+
+/**
+*	@brief Prints the budget counters to the server console. Used by sv_effectbudget_stats.
+*/
+void EffectBudget_PrintStats();
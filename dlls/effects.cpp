@@ -22,6 +22,8 @@
 #include "decals.h"
 #include "func_break.h"
 #include "shake.h"
+#include "entitypool.h"
+#include "stringpool.h"
 
 #define SF_GIBSHOOTER_REPEATABLE 1 // allows a gibshooter to be refired
 
@@ -163,6 +165,7 @@ void CBubbling::FizzThink()
 // --------------------------------------------------
 
 LINK_ENTITY_TO_CLASS(beam, CBeam);
+LINK_ENTITY_TO_POOL(beam, CBeam);
 
 void CBeam::Spawn()
 {
@@ -221,7 +224,7 @@ const Vector& CBeam::GetEndPos()
 CBeam* CBeam::BeamCreate(const char* pSpriteName, int width)
 {
 	// Create a new entity with CBeam private data
-	CBeam* pBeam = GetClassPtr((CBeam*)NULL);
+	CBeam* pBeam = GetPooledClassPtr<CBeam>("beam");
 	pBeam->pev->classname = MAKE_STRING("beam");
 
 	pBeam->BeamInit(pSpriteName, width);
@@ -522,12 +525,12 @@ bool CLightning::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "LightningStart"))
 	{
-		m_iszStartEntity = ALLOC_STRING(pkvd->szValue);
+		m_iszStartEntity = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "LightningEnd"))
 	{
-		m_iszEndEntity = ALLOC_STRING(pkvd->szValue);
+		m_iszEndEntity = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "life"))
@@ -557,7 +560,7 @@ bool CLightning::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "texture"))
 	{
-		m_iszSpriteName = ALLOC_STRING(pkvd->szValue);
+		m_iszSpriteName = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "framestart"))
@@ -997,7 +1000,7 @@ bool CLaser::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "LaserTarget"))
 	{
-		pev->message = ALLOC_STRING(pkvd->szValue);
+		pev->message = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "width"))
@@ -1017,12 +1020,12 @@ bool CLaser::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "texture"))
 	{
-		pev->model = ALLOC_STRING(pkvd->szValue);
+		pev->model = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "EndSprite"))
 	{
-		m_iszSpriteName = ALLOC_STRING(pkvd->szValue);
+		m_iszSpriteName = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "framestart"))
@@ -1454,7 +1457,7 @@ CGib* CGibShooter::CreateGib()
 	if (CVAR_GET_FLOAT("violence_hgibs") == 0)
 		return NULL;
 
-	CGib* pGib = GetClassPtr((CGib*)NULL);
+	CGib* pGib = GetPooledClassPtr<CGib>("gib");
 	pGib->Spawn("models/hgibs.mdl");
 	pGib->m_bloodColor = BLOOD_COLOR_RED;
 
@@ -1533,7 +1536,7 @@ bool CEnvShooter::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "shootmodel"))
 	{
-		pev->model = ALLOC_STRING(pkvd->szValue);
+		pev->model = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "shootsounds"))
@@ -1580,7 +1583,7 @@ void CEnvShooter::Precache()
 
 CGib* CEnvShooter::CreateGib()
 {
-	CGib* pGib = GetClassPtr((CGib*)NULL);
+	CGib* pGib = GetPooledClassPtr<CGib>("gib");
 
 	pGib->Spawn(STRING(pev->model));
 
@@ -2040,7 +2043,7 @@ bool CMessage::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "messagesound"))
 	{
-		pev->noise = ALLOC_STRING(pkvd->szValue);
+		pev->noise = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "messagevolume"))
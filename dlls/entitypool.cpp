@@ -0,0 +1,245 @@
+/***
+*
+*	Copyright (c) 1996-2001, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+#include "game.h"
+#include "entitypool.h"
+
+// The engine doesn't hand out an edict that was freed less than this long ago so clients don't confuse the old and new entity.
+// Dormant entities follow the same rule.
+constexpr float ENTITYPOOL_REUSE_DELAY = 0.5;
+
+static CEntityPool* g_pFirstEntityPool = nullptr;
+
+struct PooledEdict
+{
+	CEntityPool* pool;
+	bool dormant;
+	float releaseTime;
+};
+
+// Indexed by entity index
+static std::vector<PooledEdict> g_PooledEdicts;
+
+static float g_flEntityPoolStatsStart = 0;
+
+static PooledEdict* GetPooledEdict(CBaseEntity* pEntity)
+{
+	const int index = pEntity->entindex();
+
+	if (index <= 0 || index >= static_cast<int>(g_PooledEdicts.size()))
+		return nullptr;
+
+	PooledEdict* pooled = &g_PooledEdicts[index];
+
+	if (!pooled->pool)
+		return nullptr;
+
+	return pooled;
+}
+
+CEntityPool::CEntityPool(const char* className, std::size_t size, ConstructFunction construct)
+	: m_ClassName(className), m_Size(size), m_Construct(construct), m_pNext(g_pFirstEntityPool)
+{
+	g_pFirstEntityPool = this;
+}
+
+CEntityPool* CEntityPool::Find(const char* className)
+{
+	for (CEntityPool* pool = g_pFirstEntityPool; pool; pool = pool->m_pNext)
+	{
+		if (0 == strcmp(pool->m_ClassName, className))
+			return pool;
+	}
+
+	return nullptr;
+}
+
+CBaseEntity* CEntityPool::Acquire()
+{
+	if (m_Dormant.empty())
+		return nullptr;
+
+	// Oldest first
+	CBaseEntity* pEntity = m_Dormant.front();
+	PooledEdict* pooled = GetPooledEdict(pEntity);
+
+	if (gpGlobals->time - pooled->releaseTime < ENTITYPOOL_REUSE_DELAY)
+		return nullptr;
+
+	m_Dormant.erase(m_Dormant.begin());
+	pooled->dormant = false;
+
+	edict_t* pent = pEntity->edict();
+	entvars_t* pev = pEntity->pev;
+
+	// Reinitialize the private data and entvars the same way a new entity is set up
+	pEntity->~CBaseEntity();
+	std::memset(static_cast<void*>(pEntity), 0, m_Size);
+
+	std::memset(pev, 0, sizeof(*pev));
+	pev->pContainingEntity = pent;
+
+	pEntity = m_Construct(pEntity);
+	pEntity->pev = pev;
+
+	++m_Reused;
+
+	return pEntity;
+}
+
+void CEntityPool::Track(CBaseEntity* pEntity)
+{
+	++m_Created;
+
+	const int index = pEntity->entindex();
+
+	if (index <= 0)
+		return;
+
+	if (index >= static_cast<int>(g_PooledEdicts.size()))
+		g_PooledEdicts.resize(std::max(index + 1, gpGlobals->maxEntities));
+
+	g_PooledEdicts[index] = {this, false, 0};
+}
+
+bool CEntityPool::Release(CBaseEntity* pEntity)
+{
+	PooledEdict* pooled = GetPooledEdict(pEntity);
+
+	if (static_cast<float>(m_Dormant.size()) >= sv_entitypool_max.value)
+	{
+		++m_Discarded;
+		*pooled = {};
+		return false;
+	}
+
+	entvars_t* pev = pEntity->pev;
+
+	pEntity->SetThink(NULL);
+	pEntity->SetTouch(NULL);
+	pEntity->SetUse(NULL);
+	pEntity->SetBlocked(NULL);
+
+	// Hide it and take it out of the world
+	pev->classname = 0;
+	pev->targetname = 0;
+	pev->flags = 0;
+	pev->solid = SOLID_NOT;
+	pev->movetype = MOVETYPE_NONE;
+	pev->takedamage = DAMAGE_NO;
+	pev->effects = EF_NODRAW;
+	pev->model = 0;
+	pev->modelindex = 0;
+	pev->nextthink = 0;
+	pev->owner = NULL;
+	pev->aiment = NULL;
+	pev->velocity = g_vecZero;
+	pev->avelocity = g_vecZero;
+
+	UTIL_SetSize(pev, g_vecZero, g_vecZero);
+	UTIL_SetOrigin(pev, pev->origin);
+
+	// Handles to the removed entity must not resolve to whatever this edict becomes next
+	pEntity->edict()->serialnumber++;
+
+	pooled->dormant = true;
+	pooled->releaseTime = gpGlobals->time;
+
+	m_Dormant.push_back(pEntity);
+	m_PeakDormant = std::max(m_PeakDormant, m_Dormant.size());
+
+	++m_Recycled;
+
+	return true;
+}
+
+void CEntityPool::Forget(CBaseEntity* pEntity)
+{
+	if (auto it = std::find(m_Dormant.begin(), m_Dormant.end(), pEntity); it != m_Dormant.end())
+		m_Dormant.erase(it);
+}
+
+bool EntityPool_Release(CBaseEntity* pEntity)
+{
+	PooledEdict* pooled = GetPooledEdict(pEntity);
+
+	if (!pooled || pooled->dormant)
+		return false;
+
+	return pooled->pool->Release(pEntity);
+}
+
+bool EntityPool_IsDormant(CBaseEntity* pEntity)
+{
+	PooledEdict* pooled = GetPooledEdict(pEntity);
+
+	return pooled && pooled->dormant;
+}
+
+void EntityPool_OnFree(CBaseEntity* pEntity)
+{
+	PooledEdict* pooled = GetPooledEdict(pEntity);
+
+	if (!pooled)
+		return;
+
+	pooled->pool->Forget(pEntity);
+	*pooled = {};
+}
+
+void EntityPool_Clear()
+{
+	for (CEntityPool* pool = g_pFirstEntityPool; pool; pool = pool->m_pNext)
+	{
+		pool->m_Dormant.clear();
+	}
+
+	g_PooledEdicts.clear();
+}
+
+void EntityPool_PrintStats()
+{
+	if (CMD_ARGC() > 1 && 0 == strcmp(CMD_ARGV(1), "reset"))
+	{
+		for (CEntityPool* pool = g_pFirstEntityPool; pool; pool = pool->m_pNext)
+		{
+			pool->m_Created = pool->m_Reused = pool->m_Recycled = pool->m_Discarded = 0;
+			pool->m_PeakDormant = pool->m_Dormant.size();
+		}
+
+		g_flEntityPoolStatsStart = gpGlobals->time;
+		return;
+	}
+
+	const float elapsed = std::max(gpGlobals->time - g_flEntityPoolStatsStart, 1.0f);
+
+	g_engfuncs.pfnServerPrint(UTIL_VarArgs("Entity pools (max %d dormant per class, %.1f seconds):\n", static_cast<int>(sv_entitypool_max.value), elapsed));
+	g_engfuncs.pfnServerPrint("class               created  reused recycled discarded dormant peak  allocs/s\n");
+
+	for (CEntityPool* pool = g_pFirstEntityPool; pool; pool = pool->m_pNext)
+	{
+		g_engfuncs.pfnServerPrint(UTIL_VarArgs("%-18s %8u %7u %8u %9u %7d %4d %9.2f\n",
+			pool->m_ClassName, pool->m_Created, pool->m_Reused, pool->m_Recycled, pool->m_Discarded,
+			static_cast<int>(pool->m_Dormant.size()), static_cast<int>(pool->m_PeakDormant),
+			(pool->m_Created + pool->m_Reused) / elapsed));
+	}
+}
@@ -0,0 +1,143 @@
+/***
+*
+*	Copyright (c) 1996-2001, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#pragma once
+
+/**
+*	@file
+*
+*	Edict recycling for short-lived entities (projectiles, gibs, beams).
+*	Instead of being freed, a removed entity of a pooled class is kept around dormant: hidden, non-solid and never saved.
+*	The next creation of the same class reinitializes its entvars and private data in place instead of allocating a new edict.
+*	The number of dormant entities per class is capped by the sv_entitypool_max cvar.
+*/
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+class CBaseEntity;
+
+class CEntityPool
+{
+public:
+	using ConstructFunction = CBaseEntity* (*)(void* memory);
+
+	CEntityPool(const char* className, std::size_t size, ConstructFunction construct);
+
+	CEntityPool(const CEntityPool&) = delete;
+	CEntityPool& operator=(const CEntityPool&) = delete;
+
+	/**
+	*	@brief Returns the pool for the given entity class name, if that class is pooled.
+	*/
+	static CEntityPool* Find(const char* className);
+
+	/**
+	*	@brief Returns a reinitialized dormant entity, or nullptr if none can be reused yet.
+	*	The entity has just been constructed and has zeroed entvars, like a freshly created entity.
+	*/
+	CBaseEntity* Acquire();
+
+	/**
+	*	@brief Marks a freshly created entity as belonging to this pool so it can be recycled when it is removed.
+	*/
+	void Track(CBaseEntity* pEntity);
+
+	const char* GetClassName() const { return m_ClassName; }
+
+private:
+	friend bool EntityPool_Release(CBaseEntity* pEntity);
+	friend void EntityPool_OnFree(CBaseEntity* pEntity);
+	friend void EntityPool_Clear();
+	friend void EntityPool_PrintStats();
+
+	bool Release(CBaseEntity* pEntity);
+	void Forget(CBaseEntity* pEntity);
+
+	const char* const m_ClassName;
+	const std::size_t m_Size;
+	const ConstructFunction m_Construct;
+
+	std::vector<CBaseEntity*> m_Dormant;
+
+	// Counters, used to size the pools
+	unsigned int m_Created = 0;
+	unsigned int m_Reused = 0;
+	unsigned int m_Recycled = 0;
+	unsigned int m_Discarded = 0;
+	std::size_t m_PeakDormant = 0;
+
+	CEntityPool* m_pNext;
+};
+
+template <class T>
+CBaseEntity* EntityPool_Construct(void* memory)
+{
+	return ::new (memory) T;
+}
+
+/**
+*	@brief Makes the entity class linked to mapClassName recycle its edicts.
+*	Entities of that class have to be created with CBaseEntity::Create or GetPooledClassPtr to be recycled.
+*/
+#define LINK_ENTITY_TO_POOL(mapClassName, DLLClassName) \
+	static CEntityPool g_EntityPool_##mapClassName(#mapClassName, sizeof(DLLClassName), &EntityPool_Construct<DLLClassName>)
+
+/**
+*	@brief Pooled version of GetClassPtr((T*)NULL).
+*	@param className Name the pool was linked with in LINK_ENTITY_TO_POOL.
+*/
+template <class T>
+T* GetPooledClassPtr(const char* className)
+{
+	CEntityPool* pool = CEntityPool::Find(className);
+
+	if (!pool)
+		return GetClassPtr((T*)NULL);
+
+	if (CBaseEntity* pEntity = pool->Acquire(); pEntity)
+		return static_cast<T*>(pEntity);
+
+	T* pEntity = GetClassPtr((T*)NULL);
+	pool->Track(pEntity);
+	return pEntity;
+}
+
+/**
+*	@brief Called when an entity is removed. If it belongs to a pool with room left it is made dormant.
+*	@return Whether the entity was recycled. If not, it has to be removed as usual.
+*/
+bool EntityPool_Release(CBaseEntity* pEntity);
+
+/**
+*	@brief Returns whether the entity is a dormant pooled entity. These must not be saved or moved across transitions.
+*/
+bool EntityPool_IsDormant(CBaseEntity* pEntity);
+
+/**
+*	@brief Called when the engine frees an entity's private data.
+*/
+void EntityPool_OnFree(CBaseEntity* pEntity);
+
+/**
+*	@brief Forgets all dormant entities. Called when the server shuts down the current map, which frees all edicts.
+*/
+void EntityPool_Clear();
+
+/**
+*	@brief Prints the per-class allocation counters to the server console. Used by sv_entitypool_stats.
+*/
+void EntityPool_PrintStats();
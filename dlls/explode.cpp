@@ -215,7 +215,9 @@ void CEnvExplosion::Use(CBaseEntity* pActivator, CBaseEntity* pCaller, USE_TYPE
 	// do damage
 	if ((pev->spawnflags & SF_ENVEXPLOSION_NODAMAGE) == 0)
 	{
+		RadiusDamageBatchBegin();
 		RadiusDamage(pev, pev, m_iMagnitude, CLASS_NONE, DMG_BLAST);
+		RadiusDamageBatchEnd();
 	}
 
 	SetThink(&CEnvExplosion::Smoke);
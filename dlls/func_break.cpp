@@ -27,6 +27,7 @@
 #include "func_break.h"
 #include "decals.h"
 #include "explode.h"
+#include "stringpool.h"
 
 // =================== FUNC_Breakable ==============================================
 
@@ -106,7 +107,7 @@ bool CBreakable::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "gibmodel"))
 	{
-		m_iszGibModel = ALLOC_STRING(pkvd->szValue);
+		m_iszGibModel = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "spawnobject"))
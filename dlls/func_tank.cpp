@@ -20,6 +20,7 @@
 #include "explode.h"
 
 #include "player.h"
+#include "stringpool.h"
 
 
 #define SF_TANK_ACTIVE 0x0001
@@ -280,17 +281,17 @@ bool CFuncTank::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "spritesmoke"))
 	{
-		m_iszSpriteSmoke = ALLOC_STRING(pkvd->szValue);
+		m_iszSpriteSmoke = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "spriteflash"))
 	{
-		m_iszSpriteFlash = ALLOC_STRING(pkvd->szValue);
+		m_iszSpriteFlash = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "rotatesound"))
 	{
-		pev->noise = ALLOC_STRING(pkvd->szValue);
+		pev->noise = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "persistence"))
@@ -325,7 +326,7 @@ bool CFuncTank::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "master"))
 	{
-		m_iszMaster = ALLOC_STRING(pkvd->szValue);
+		m_iszMaster = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
@@ -820,7 +821,7 @@ bool CFuncTankLaser::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "laserentity"))
 	{
-		pev->message = ALLOC_STRING(pkvd->szValue);
+		pev->message = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
@@ -18,6 +18,9 @@
 #include "client.h"
 #include "game.h"
 #include "filesystem_utils.h"
+#include "entitypool.h"
+#include "effectbudget.h"
+#include "stringpool.h"
 
 cvar_t displaysoundlist = {"displaysoundlist", "0"};
 
@@ -47,6 +50,18 @@ cvar_t mp_chattime = {"mp_chattime", "10", FCVAR_SERVER};
 
 cvar_t sv_allowbunnyhopping = {"sv_allowbunnyhopping", "0", FCVAR_SERVER};
 
+cvar_t sv_entitypool_max = {"sv_entitypool_max", "32"}; // max dormant entities kept per pooled class, 0 disables pooling
+
+cvar_t sv_gib_max = {"sv_gib_max", "64"}; // max live gibs, 0 for no limit
+cvar_t sv_gib_max_area = {"sv_gib_max_area", "16"}; // max live gibs within sv_effectbudget_area units, 0 for no limit
+cvar_t sv_corpse_max = {"sv_corpse_max", "4"}; // size of the multiplayer body queue, takes effect on map change
+cvar_t sv_corpse_max_area = {"sv_corpse_max_area", "2"}; // max corpses within sv_effectbudget_area units, 0 for no limit
+cvar_t sv_effectbudget_area = {"sv_effectbudget_area", "256"}; // radius of the per area gib and corpse budgets
+cvar_t sv_decal_rate = {"sv_decal_rate", "4"}; // blood decals per second per surface, 0 for no limit
+cvar_t sv_decal_burst = {"sv_decal_burst", "8"}; // blood decals a surface can take at once
+
+cvar_t sv_prediction_debug = {"sv_prediction_debug", "0"}; // send hashes of every player's state after each usercmd to check client prediction against
+
 //CVARS FOR SKILL LEVEL SETTINGS
 // Agrunt
 cvar_t sk_agrunt_health1 = {"sk_agrunt_health1", "0"};
@@ -523,6 +538,24 @@ void GameDLLInit()
 
 	CVAR_REGISTER(&sv_allowbunnyhopping);
 
+	CVAR_REGISTER(&sv_entitypool_max);
+	g_engfuncs.pfnAddServerCommand("sv_entitypool_stats", &EntityPool_PrintStats);
+
+	CVAR_REGISTER(&sv_gib_max);
+	CVAR_REGISTER(&sv_gib_max_area);
+	CVAR_REGISTER(&sv_corpse_max);
+	CVAR_REGISTER(&sv_corpse_max_area);
+	CVAR_REGISTER(&sv_effectbudget_area);
+	CVAR_REGISTER(&sv_decal_rate);
+	CVAR_REGISTER(&sv_decal_burst);
+	g_engfuncs.pfnAddServerCommand("sv_effectbudget_stats", &EffectBudget_PrintStats);
+
+	g_engfuncs.pfnAddServerCommand("sv_stringpool_stats", &StringPool_PrintStats);
+
+	CVAR_REGISTER(&sv_prediction_debug);
+	g_engfuncs.pfnAddServerCommand("sv_pmrecord", &PMRecordCommand);
+	g_engfuncs.pfnAddServerCommand("sv_pmtrace_stats", &PMTraceStatsCommand);
+
 	// REGISTER CVARS FOR SKILL LEVEL STUFF
 	// Agrunt
 	CVAR_REGISTER(&sk_agrunt_health1); // {"sk_agrunt_health1","0"};
@@ -43,6 +43,18 @@ extern cvar_t mp_chattime;
 
 extern cvar_t sv_allowbunnyhopping;
 
+extern cvar_t sv_entitypool_max;
+
+extern cvar_t sv_gib_max;
+extern cvar_t sv_gib_max_area;
+extern cvar_t sv_corpse_max;
+extern cvar_t sv_corpse_max_area;
+extern cvar_t sv_effectbudget_area;
+extern cvar_t sv_decal_rate;
+extern cvar_t sv_decal_burst;
+
+extern cvar_t sv_prediction_debug;
+
 extern cvar_t sv_busters;
 
 // Engine Cvars
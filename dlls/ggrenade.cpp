@@ -25,12 +25,14 @@
 #include "weapons.h"
 #include "soundent.h"
 #include "decals.h"
+#include "entitypool.h"
 
 
 //===================grenade
 
 
 LINK_ENTITY_TO_CLASS(grenade, CGrenade);
+LINK_ENTITY_TO_POOL(grenade, CGrenade);
 
 // Grenades flagged with this will be triggered when the owner calls detonateSatchelCharges
 #define SF_DETONATE 0x0001
@@ -95,7 +97,10 @@ void CGrenade::Explode(TraceResult* pTrace, int bitsDamageType)
 	Vector origin = pev->origin;
 	origin.z -= 1;
 
+	// Grenades, tripmines and satchels set off by this one are damaged in a fixed order
+	RadiusDamageBatchBegin();
 	RadiusDamage(origin, pev, pevOwner, pev->dmg, CLASS_NONE, bitsDamageType);
+	RadiusDamageBatchEnd();
 
 	if (RANDOM_FLOAT(0, 1) < 0.5)
 	{
@@ -376,7 +381,7 @@ void CGrenade::Spawn()
 
 CGrenade* CGrenade::ShootContact(entvars_t* pevOwner, Vector vecStart, Vector vecVelocity)
 {
-	CGrenade* pGrenade = GetClassPtr((CGrenade*)NULL);
+	CGrenade* pGrenade = GetPooledClassPtr<CGrenade>("grenade");
 	pGrenade->Spawn();
 	// contact grenades arc lower
 	pGrenade->pev->gravity = 0.5; // lower gravity since grenade is aerodynamic and engine doesn't know it.
@@ -403,7 +408,7 @@ CGrenade* CGrenade::ShootContact(entvars_t* pevOwner, Vector vecStart, Vector ve
 
 CGrenade* CGrenade::ShootTimed(entvars_t* pevOwner, Vector vecStart, Vector vecVelocity, float time)
 {
-	CGrenade* pGrenade = GetClassPtr((CGrenade*)NULL);
+	CGrenade* pGrenade = GetPooledClassPtr<CGrenade>("grenade");
 	pGrenade->Spawn();
 	UTIL_SetOrigin(pGrenade->pev, vecStart);
 	pGrenade->pev->velocity = vecVelocity;
@@ -444,7 +449,7 @@ CGrenade* CGrenade::ShootTimed(entvars_t* pevOwner, Vector vecStart, Vector vecV
 
 CGrenade* CGrenade::ShootSatchelCharge(entvars_t* pevOwner, Vector vecStart, Vector vecVelocity)
 {
-	CGrenade* pGrenade = GetClassPtr((CGrenade*)NULL);
+	CGrenade* pGrenade = GetPooledClassPtr<CGrenade>("grenade");
 	pGrenade->pev->movetype = MOVETYPE_BOUNCE;
 	pGrenade->pev->classname = MAKE_STRING("grenade");
 
@@ -24,12 +24,14 @@
 #include "soundent.h"
 #include "hornet.h"
 #include "gamerules.h"
+#include "entitypool.h"
 
 
 int iHornetTrail;
 int iHornetPuff;
 
 LINK_ENTITY_TO_CLASS(hornet, CHornet);
+LINK_ENTITY_TO_POOL(hornet, CHornet);
 
 //=========================================================
 // Save/Restore
@@ -23,6 +23,7 @@
 #include "extdll.h"
 #include "util.h"
 #include "cbase.h"
+#include "stringpool.h"
 
 
 
@@ -70,7 +71,7 @@ bool CLight::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "pattern"))
 	{
-		m_iszPattern = ALLOC_STRING(pkvd->szValue);
+		m_iszPattern = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
@@ -29,6 +29,7 @@
 #include "maprules.h"
 #include "cbase.h"
 #include "player.h"
+#include "stringpool.h"
 
 class CRuleEntity : public CBaseEntity
 {
@@ -68,7 +69,7 @@ bool CRuleEntity::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "master"))
 	{
-		SetMaster(ALLOC_STRING(pkvd->szValue));
+		SetMaster(StringPool_Alloc(pkvd->szValue));
 		return true;
 	}
 
@@ -528,22 +529,22 @@ bool CGamePlayerZone::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "intarget"))
 	{
-		m_iszInTarget = ALLOC_STRING(pkvd->szValue);
+		m_iszInTarget = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "outtarget"))
 	{
-		m_iszOutTarget = ALLOC_STRING(pkvd->szValue);
+		m_iszOutTarget = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "incount"))
 	{
-		m_iszInCount = ALLOC_STRING(pkvd->szValue);
+		m_iszInCount = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "outcount"))
 	{
-		m_iszOutCount = ALLOC_STRING(pkvd->szValue);
+		m_iszOutCount = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
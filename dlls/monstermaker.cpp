@@ -22,6 +22,7 @@
 #include "cbase.h"
 #include "monsters.h"
 #include "saverestore.h"
+#include "stringpool.h"
 
 // Monstermaker spawnflags
 #define SF_MONSTERMAKER_START_ON 1	  // start active ( if has targetname )
@@ -93,7 +94,7 @@ bool CMonsterMaker::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "monstertype"))
 	{
-		m_iszMonsterClassname = ALLOC_STRING(pkvd->szValue);
+		m_iszMonsterClassname = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
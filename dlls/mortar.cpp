@@ -27,6 +27,7 @@
 #include "weapons.h"
 #include "decals.h"
 #include "soundent.h"
+#include "stringpool.h"
 
 class CFuncMortarField : public CBaseToggle
 {
@@ -72,12 +73,12 @@ bool CFuncMortarField::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "m_iszXController"))
 	{
-		m_iszXController = ALLOC_STRING(pkvd->szValue);
+		m_iszXController = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "m_iszYController"))
 	{
-		m_iszYController = ALLOC_STRING(pkvd->szValue);
+		m_iszYController = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "m_flSpread"))
@@ -21,6 +21,7 @@
 #include "cbase.h"
 #include "trains.h"
 #include "saverestore.h"
+#include "stringpool.h"
 
 class CPathCorner : public CPointEntity
 {
@@ -137,7 +138,7 @@ bool CPathTrack::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "altpath"))
 	{
-		m_altName = ALLOC_STRING(pkvd->szValue);
+		m_altName = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
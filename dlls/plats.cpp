@@ -25,6 +25,7 @@
 #include "cbase.h"
 #include "trains.h"
 #include "saverestore.h"
+#include "stringpool.h"
 
 static void PlatSpawnInsideTrigger(entvars_t* pevPlatform);
 
@@ -1760,17 +1761,17 @@ bool CFuncTrackChange::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "train"))
 	{
-		m_trainName = ALLOC_STRING(pkvd->szValue);
+		m_trainName = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "toptrack"))
 	{
-		m_trackTopName = ALLOC_STRING(pkvd->szValue);
+		m_trackTopName = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "bottomtrack"))
 	{
-		m_trackBottomName = ALLOC_STRING(pkvd->szValue);
+		m_trackBottomName = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
@@ -28,6 +28,7 @@
 #include "schedule.h"
 #include "scripted.h"
 #include "defaultai.h"
+#include "stringpool.h"
 
 
 
@@ -52,17 +53,17 @@ bool CCineMonster::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "m_iszIdle"))
 	{
-		m_iszIdle = ALLOC_STRING(pkvd->szValue);
+		m_iszIdle = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "m_iszPlay"))
 	{
-		m_iszPlay = ALLOC_STRING(pkvd->szValue);
+		m_iszPlay = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "m_iszEntity"))
 	{
-		m_iszEntity = ALLOC_STRING(pkvd->szValue);
+		m_iszEntity = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "m_fMoveTo"))
@@ -967,12 +968,12 @@ bool CScriptedSentence::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "sentence"))
 	{
-		m_iszSentence = ALLOC_STRING(pkvd->szValue);
+		m_iszSentence = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "entity"))
 	{
-		m_iszEntity = ALLOC_STRING(pkvd->szValue);
+		m_iszEntity = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "duration"))
@@ -1002,7 +1003,7 @@ bool CScriptedSentence::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "listener"))
 	{
-		m_iszListener = ALLOC_STRING(pkvd->szValue);
+		m_iszListener = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
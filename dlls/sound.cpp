@@ -1488,17 +1488,8 @@ void EMIT_GROUPNAME_SUIT(edict_t* entity, const char* groupname)
 //
 // Used to detect the texture the player is standing on, map the
 // texture name to a material type.  Play footstep sound based
-// on material type.
-
-bool fTextureTypeInit = false;
-
-int gcTextures = 0;
-char grgszTextureName[CTEXTURESMAX][CBTEXTURENAMEMAX]; // texture names
-char grgchTextureType[CTEXTURESMAX];				   // parallel array of texture types
-
-// open materials.txt,  get size, alloc space,
-// save in array.  Only works first time called,
-// ignored on subsequent calls.
+// on material type. The material table itself is loaded from
+// materials.txt by PM_InitTextureTypes in pm_shared.
 
 static char* memfgets(byte* pMemFile, int fileSize, int& filePos, char* pBuffer, int bufferSize)
 {
@@ -1548,90 +1539,6 @@ static char* memfgets(byte* pMemFile, int fileSize, int& filePos, char* pBuffer,
 	return NULL;
 }
 
-
-void TEXTURETYPE_Init()
-{
-	char buffer[512];
-	int i, j;
-	byte* pMemFile;
-	int fileSize, filePos = 0;
-
-	if (fTextureTypeInit)
-		return;
-
-	memset(&(grgszTextureName[0][0]), 0, CTEXTURESMAX * CBTEXTURENAMEMAX);
-	memset(grgchTextureType, 0, CTEXTURESMAX);
-
-	gcTextures = 0;
-	memset(buffer, 0, 512);
-
-	pMemFile = g_engfuncs.pfnLoadFileForMe("sound/materials.txt", &fileSize);
-	if (!pMemFile)
-		return;
-
-	// for each line in the file...
-	while (memfgets(pMemFile, fileSize, filePos, buffer, 511) != NULL && (gcTextures < CTEXTURESMAX))
-	{
-		// skip whitespace
-		i = 0;
-		while ('\0' != buffer[i] && 0 != isspace(buffer[i]))
-			i++;
-
-		if ('\0' == buffer[i])
-			continue;
-
-		// skip comment lines
-		if (buffer[i] == '/' || 0 == isalpha(buffer[i]))
-			continue;
-
-		// get texture type
-		grgchTextureType[gcTextures] = toupper(buffer[i++]);
-
-		// skip whitespace
-		while ('\0' != buffer[i] && 0 != isspace(buffer[i]))
-			i++;
-
-		if ('\0' == buffer[i])
-			continue;
-
-		// get sentence name
-		j = i;
-		while ('\0' != buffer[j] && 0 == isspace(buffer[j]))
-			j++;
-
-		if ('\0' == buffer[j])
-			continue;
-
-		// null-terminate name and save in sentences array
-		j = V_min(j, CBTEXTURENAMEMAX - 1 + i);
-		buffer[j] = 0;
-		strcpy(&(grgszTextureName[gcTextures++][0]), &(buffer[i]));
-	}
-
-	g_engfuncs.pfnFreeFile(pMemFile);
-
-	fTextureTypeInit = true;
-}
-
-// given texture name, find texture type
-// if not found, return type 'concrete'
-
-// NOTE: this routine should ONLY be called if the
-// current texture under the player changes!
-
-char TEXTURETYPE_Find(char* name)
-{
-	// CONSIDER: pre-sort texture names and perform faster binary search here
-
-	for (int i = 0; i < gcTextures; i++)
-	{
-		if (!strnicmp(name, &(grgszTextureName[i][0]), CBTEXTURENAMEMAX - 1))
-			return (grgchTextureType[i]);
-	}
-
-	return CHAR_TEX_CONCRETE;
-}
-
 // play a strike sound based on the texture that was hit by the attack traceline.  VecSrc/VecEnd are the
 // original traceline endpoints used by the attacker, iBulletType is the type of bullet that hit the texture.
 // returns volume of strike instrument (crowbar) to play
@@ -1643,7 +1550,6 @@ float TEXTURETYPE_PlaySound(TraceResult* ptr, Vector vecSrc, Vector vecEnd, int
 	char chTextureType;
 	float fvol;
 	float fvolbar;
-	char szbuffer[64];
 	const char* pTextureName;
 	float rgfl1[3];
 	float rgfl2[3];
@@ -1680,20 +1586,10 @@ float TEXTURETYPE_PlaySound(TraceResult* ptr, Vector vecSrc, Vector vecEnd, int
 
 		if (pTextureName)
 		{
-			// strip leading '-0' or '+0~' or '{' or '!'
-			if (*pTextureName == '-' || *pTextureName == '+')
-				pTextureName += 2;
-
-			if (*pTextureName == '{' || *pTextureName == '!' || *pTextureName == '~' || *pTextureName == ' ')
-				pTextureName++;
-			// '}}'
-			strcpy(szbuffer, pTextureName);
-			szbuffer[CBTEXTURENAMEMAX - 1] = 0;
-
-			// ALERT ( at_console, "texture hit: %s\n", szbuffer);
+			// ALERT ( at_console, "texture hit: %s\n", pTextureName);
 
 			// get texture type
-			chTextureType = TEXTURETYPE_Find(szbuffer);
+			chTextureType = PM_FindTextureTypeCached(pTextureName);
 		}
 	}
 
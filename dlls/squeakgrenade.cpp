@@ -21,6 +21,7 @@
 #include "player.h"
 #include "soundent.h"
 #include "gamerules.h"
+#include "entitypool.h"
 
 enum w_squeak_e
 {
@@ -63,6 +64,7 @@ class CSqueakGrenade : public CGrenade
 float CSqueakGrenade::m_flNextBounceSoundTime = 0;
 
 LINK_ENTITY_TO_CLASS(monster_snark, CSqueakGrenade);
+LINK_ENTITY_TO_POOL(monster_snark, CSqueakGrenade);
 TYPEDESCRIPTION CSqueakGrenade::m_SaveData[] =
 	{
 		DEFINE_FIELD(CSqueakGrenade, m_flDie, FIELD_TIME),
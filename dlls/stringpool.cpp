@@ -0,0 +1,160 @@
+/***
+*
+*	Copyright (c) 1996-2001, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "extdll.h"
+#include "util.h"
+#include "stringpool.h"
+
+// Strings are stored back to back in blocks of this size. Longer strings get a block of their own.
+constexpr std::size_t STRINGPOOL_BLOCK_SIZE = 64 * 1024;
+
+class CStringPool
+{
+public:
+	string_t Alloc(const char* str);
+	void PrintStats();
+
+private:
+	const char* Store(std::string_view str);
+
+	// Views into the blocks
+	std::unordered_set<std::string_view> m_Strings;
+
+	std::vector<std::unique_ptr<char[]>> m_Blocks;
+	std::size_t m_BlockUsed = STRINGPOOL_BLOCK_SIZE;
+	std::vector<std::unique_ptr<char[]>> m_LargeStrings;
+
+	// Scratch buffer for the unescaped string
+	std::string m_Unescaped;
+
+	unsigned int m_Hits = 0;
+	unsigned int m_Misses = 0;
+	unsigned int m_Fallbacks = 0;
+	std::size_t m_Bytes = 0;
+	std::size_t m_BytesSaved = 0;
+};
+
+static CStringPool g_StringPool;
+
+const char* CStringPool::Store(std::string_view str)
+{
+	const std::size_t size = str.size() + 1;
+
+	char* dest;
+
+	if (size > STRINGPOOL_BLOCK_SIZE / 4)
+	{
+		// Don't waste the rest of the current block on a long string
+		m_LargeStrings.push_back(std::make_unique<char[]>(size));
+		dest = m_LargeStrings.back().get();
+	}
+	else
+	{
+		if (m_BlockUsed + size > STRINGPOOL_BLOCK_SIZE)
+		{
+			m_Blocks.push_back(std::make_unique<char[]>(STRINGPOOL_BLOCK_SIZE));
+			m_BlockUsed = 0;
+		}
+
+		dest = m_Blocks.back().get() + m_BlockUsed;
+		m_BlockUsed += size;
+	}
+
+	memcpy(dest, str.data(), str.size());
+	dest[str.size()] = '\0';
+
+	m_Bytes += size;
+
+	return dest;
+}
+
+string_t CStringPool::Alloc(const char* str)
+{
+	// Same conversion as the engine: \n becomes a newline, a backslash followed by anything else becomes a backslash
+	m_Unescaped.clear();
+
+	for (const char* p = str; '\0' != *p; ++p)
+	{
+		if (*p == '\\' && '\0' != p[1])
+		{
+			++p;
+			m_Unescaped += *p == 'n' ? '\n' : '\\';
+		}
+		else
+		{
+			m_Unescaped += *p;
+		}
+	}
+
+	const char* pooled;
+
+	if (auto it = m_Strings.find(m_Unescaped); it != m_Strings.end())
+	{
+		++m_Hits;
+		m_BytesSaved += it->size() + 1;
+		pooled = it->data();
+	}
+	else
+	{
+		++m_Misses;
+		pooled = Store(m_Unescaped);
+		m_Strings.emplace(pooled, m_Unescaped.size());
+	}
+
+	const uint64 offset = (uint64)pooled - (uint64)STRING(0);
+
+	// string_t is a 32 bit offset from the engine's string base, 32 bit builds can reach anything through wraparound
+	if constexpr (sizeof(void*) > 4)
+	{
+		if (offset > UINT_MAX)
+		{
+			++m_Fallbacks;
+			return ALLOC_STRING(str);
+		}
+	}
+
+	return static_cast<string_t>(offset);
+}
+
+void CStringPool::PrintStats()
+{
+	const unsigned int total = m_Hits + m_Misses;
+
+	g_engfuncs.pfnServerPrint(UTIL_VarArgs("String pool: %d strings, %d bytes in %d blocks and %d long strings\n",
+		static_cast<int>(m_Strings.size()), static_cast<int>(m_Bytes), static_cast<int>(m_Blocks.size()), static_cast<int>(m_LargeStrings.size())));
+	g_engfuncs.pfnServerPrint(UTIL_VarArgs("%u lookups, %u hits (%.1f%%), %d bytes not allocated again\n",
+		total, m_Hits, total > 0 ? 100.0 * m_Hits / total : 0.0, static_cast<int>(m_BytesSaved)));
+
+	if (0 != m_Fallbacks)
+		g_engfuncs.pfnServerPrint(UTIL_VarArgs("%u strings out of range of the engine string base, passed to ALLOC_STRING\n", m_Fallbacks));
+}
+
+string_t StringPool_Alloc(const char* str)
+{
+	return g_StringPool.Alloc(str);
+}
+
+void StringPool_PrintStats()
+{
+	g_StringPool.PrintStats();
+}
@@ -0,0 +1,37 @@
+/***
+*
+*	Copyright (c) 1996-2001, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#pragma once
+
+/**
+*	@file
+*
+*	Game DLL string interner used instead of ALLOC_STRING for strings that are allocated over and over,
+*	like keyvalues, restored string fields and entity class names.
+*	ALLOC_STRING copies every string into the engine's string table, so identical strings are stored again on every spawn and restore.
+*	The pool stores each distinct string once, in memory owned by the game DLL, and hands out the same string_t for it every time.
+*/
+
+/**
+*	@brief Returns a string_t for str, allocating a copy the first time the string is seen.
+*	Escape sequences are converted the same way ALLOC_STRING does, so this can replace it as is.
+*	The returned string stays valid until the game DLL is unloaded.
+*/
+string_t StringPool_Alloc(const char* str);
+
+/**
+*	@brief Prints the pool size and hit rate to the server console. Used by sv_stringpool_stats.
+*/
+void StringPool_PrintStats();
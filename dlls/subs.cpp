@@ -26,6 +26,8 @@
 #include "saverestore.h"
 #include "nodes.h"
 #include "doors.h"
+#include "entitypool.h"
+#include "stringpool.h"
 
 extern bool FEntIsVisible(entvars_t* pev, entvars_t* pevTarget);
 
@@ -69,7 +71,7 @@ bool CBaseDMStart::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "master"))
 	{
-		pev->netname = ALLOC_STRING(pkvd->szValue);
+		pev->netname = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
@@ -116,6 +118,9 @@ void CBaseEntity::SUB_Remove()
 		ALERT(at_aiconsole, "SUB_Remove called on entity with health > 0\n");
 	}
 
+	if (EntityPool_Release(this))
+		return;
+
 	REMOVE_ENTITY(ENT(pev));
 }
 
@@ -144,7 +149,7 @@ bool CBaseDelay::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "killtarget"))
 	{
-		m_iszKillTarget = ALLOC_STRING(pkvd->szValue);
+		m_iszKillTarget = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
@@ -364,7 +369,7 @@ bool CBaseToggle::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "master"))
 	{
-		m_sMaster = ALLOC_STRING(pkvd->szValue);
+		m_sMaster = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "distance"))
@@ -22,6 +22,7 @@
 #include "scripted.h"
 #include "soundent.h"
 #include "animation.h"
+#include "stringpool.h"
 
 //=========================================================
 // Talking monster base class
@@ -1431,12 +1432,12 @@ bool CTalkMonster::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "UseSentence"))
 	{
-		m_iszUse = ALLOC_STRING(pkvd->szValue);
+		m_iszUse = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "UnUseSentence"))
 	{
-		m_iszUnUse = ALLOC_STRING(pkvd->szValue);
+		m_iszUnUse = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
@@ -27,6 +27,8 @@
 #include "saverestore.h"
 #include "trains.h" // trigger_camera has train functionality
 #include "gamerules.h"
+#include "entitypool.h"
+#include "stringpool.h"
 
 #define SF_TRIGGER_PUSH_START_OFF 2		   //spawnflag that makes trigger_push spawn turned OFF
 #define SF_TRIGGER_HURT_TARGETONCE 1	   // Only fire hurt target once
@@ -134,7 +136,7 @@ bool CAutoTrigger::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "globalstate"))
 	{
-		m_globalstate = ALLOC_STRING(pkvd->szValue);
+		m_globalstate = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "triggerstate"))
@@ -1399,7 +1401,7 @@ bool CChangeLevel::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "changetarget"))
 	{
-		m_changeTarget = ALLOC_STRING(pkvd->szValue);
+		m_changeTarget = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "changedelay"))
@@ -1681,7 +1683,7 @@ int CChangeLevel::ChangeList(LEVELLIST* pLevelList, int maxList)
 				{
 					//					ALERT( at_console, "Trying %s\n", STRING(pEntity->pev->classname) );
 					int caps = pEntity->ObjectCaps();
-					if ((caps & FCAP_DONT_SAVE) == 0)
+					if ((caps & FCAP_DONT_SAVE) == 0 && !EntityPool_IsDormant(pEntity))
 					{
 						int flags = 0;
 
@@ -2046,7 +2048,7 @@ bool CTriggerEndSection::KeyValue(KeyValueData* pkvd)
 	{
 		//		m_iszSectionName = ALLOC_STRING( pkvd->szValue );
 		// Store this in message so we don't have to write save/restore for this ent
-		pev->message = ALLOC_STRING(pkvd->szValue);
+		pev->message = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
@@ -2113,7 +2115,7 @@ bool CTriggerChangeTarget::KeyValue(KeyValueData* pkvd)
 {
 	if (FStrEq(pkvd->szKeyName, "m_iszNewTarget"))
 	{
-		m_iszNewTarget = ALLOC_STRING(pkvd->szValue);
+		m_iszNewTarget = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 
@@ -2221,7 +2223,7 @@ bool CTriggerCamera::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "moveto"))
 	{
-		m_sPath = ALLOC_STRING(pkvd->szValue);
+		m_sPath = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "acceleration"))
@@ -31,6 +31,9 @@
 #include "weapons.h"
 #include "gamerules.h"
 #include "UserMessages.h"
+#include "entitypool.h"
+#include "effectbudget.h"
+#include "stringpool.h"
 
 float UTIL_WeaponTimeBase()
 {
@@ -1230,6 +1233,9 @@ void UTIL_BloodDecalTrace(TraceResult* pTrace, int bloodColor)
 {
 	if (UTIL_ShouldShowBlood(bloodColor))
 	{
+		if (!EffectBudget_AllowDecal(pTrace))
+			return;
+
 		if (bloodColor == BLOOD_COLOR_RED)
 			UTIL_DecalTrace(pTrace, DECAL_BLOOD1 + RANDOM_LONG(0, 5));
 		else
@@ -1579,6 +1585,10 @@ void UTIL_Remove(CBaseEntity* pEntity)
 		return;
 
 	pEntity->UpdateOnRemove();
+
+	if (EntityPool_Release(pEntity))
+		return;
+
 	pEntity->pev->flags |= FL_KILLME;
 	pEntity->pev->targetname = 0;
 }
@@ -2010,7 +2020,7 @@ void EntvarsKeyvalue(entvars_t* pev, KeyValueData* pkvd)
 			case FIELD_MODELNAME:
 			case FIELD_SOUNDNAME:
 			case FIELD_STRING:
-				(*(int*)((char*)pev + pField->fieldOffset)) = ALLOC_STRING(pkvd->szValue);
+				(*(int*)((char*)pev + pField->fieldOffset)) = StringPool_Alloc(pkvd->szValue);
 				break;
 
 			case FIELD_TIME:
@@ -2293,7 +2303,7 @@ int CRestore::ReadField(void* pBaseData, TYPEDESCRIPTION* pFields, int fieldCoun
 						{
 							int string;
 
-							string = ALLOC_STRING((char*)pInputData);
+							string = StringPool_Alloc((char*)pInputData);
 
 							*((int*)pOutputData) = string;
 
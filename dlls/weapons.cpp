@@ -30,6 +30,7 @@
 #include "decals.h"
 #include "gamerules.h"
 #include "UserMessages.h"
+#include "stringpool.h"
 
 #define NOT_USED 255
 
@@ -68,6 +69,17 @@ Collects multiple small damages into a single damage
 ==============================================================================
 */
 
+#define MAX_MULTIDAMAGE_VICTIMS 32
+
+// Per-victim totals, only used after ClearMultiDamagePerVictim
+static struct
+{
+	bool active;
+	int count;
+	EHANDLE hEntity[MAX_MULTIDAMAGE_VICTIMS];
+	float amount[MAX_MULTIDAMAGE_VICTIMS];
+} gMultiDamageVictims;
+
 //
 // ClearMultiDamage - resets the global multi damage accumulator
 //
@@ -76,6 +88,22 @@ void ClearMultiDamage()
 	gMultiDamage.pEntity = NULL;
 	gMultiDamage.amount = 0;
 	gMultiDamage.type = 0;
+
+	gMultiDamageVictims.active = false;
+	gMultiDamageVictims.count = 0;
+}
+
+
+//
+// ClearMultiDamagePerVictim - resets the global multi damage accumulator and keeps a separate
+// total for every damaged entity until ApplyMultiDamage, instead of applying the damage
+// every time the damaged entity changes.
+//
+void ClearMultiDamagePerVictim()
+{
+	ClearMultiDamage();
+
+	gMultiDamageVictims.active = true;
 }
 
 
@@ -91,6 +119,35 @@ void ApplyMultiDamage(entvars_t* pevInflictor, entvars_t* pevAttacker)
 	Vector vecDir;	 //direction blood should go
 	TraceResult tr;
 
+	if (gMultiDamageVictims.active)
+	{
+		// A victim dying can start other damage (exploding breakables, barrels) that clears the accumulator,
+		// so take a copy and clear it before anything is damaged.
+		const int count = gMultiDamageVictims.count;
+		const int bitsDamageType = gMultiDamage.type;
+		EHANDLE hEntity[MAX_MULTIDAMAGE_VICTIMS];
+		float amount[MAX_MULTIDAMAGE_VICTIMS];
+
+		for (int i = 0; i < count; i++)
+		{
+			hEntity[i] = gMultiDamageVictims.hEntity[i];
+			amount[i] = gMultiDamageVictims.amount[i];
+		}
+
+		ClearMultiDamage();
+
+		// in the order the entities were first hit
+		for (int i = 0; i < count; i++)
+		{
+			CBaseEntity* pEntity = hEntity[i];
+
+			if (pEntity)
+				pEntity->TakeDamage(pevInflictor, pevAttacker, amount[i], bitsDamageType);
+		}
+
+		return;
+	}
+
 	if (!gMultiDamage.pEntity)
 		return;
 
@@ -108,6 +165,34 @@ void AddMultiDamage(entvars_t* pevInflictor, CBaseEntity* pEntity, float flDamag
 
 	gMultiDamage.type |= bitsDamageType;
 
+	if (gMultiDamageVictims.active)
+	{
+		int i;
+
+		for (i = 0; i < gMultiDamageVictims.count; i++)
+		{
+			if (gMultiDamageVictims.hEntity[i] == pEntity)
+				break;
+		}
+
+		if (i == gMultiDamageVictims.count)
+		{
+			if (gMultiDamageVictims.count == MAX_MULTIDAMAGE_VICTIMS)
+			{
+				// out of slots, fall back to applying it right away
+				pEntity->TakeDamage(pevInflictor, pevInflictor, flDamage, gMultiDamage.type); // UNDONE: wrong attacker!
+				return;
+			}
+
+			gMultiDamageVictims.hEntity[i] = pEntity;
+			gMultiDamageVictims.amount[i] = 0;
+			gMultiDamageVictims.count++;
+		}
+
+		gMultiDamageVictims.amount[i] += flDamage;
+		return;
+	}
+
 	if (pEntity != gMultiDamage.pEntity)
 	{
 		ApplyMultiDamage(pevInflictor, pevInflictor); // UNDONE: wrong attacker!
@@ -1088,7 +1173,7 @@ bool CWeaponBox::KeyValue(KeyValueData* pkvd)
 {
 	if (m_cAmmoTypes < MAX_AMMO_SLOTS)
 	{
-		PackAmmo(ALLOC_STRING(pkvd->szKeyName), atoi(pkvd->szValue));
+		PackAmmo(StringPool_Alloc(pkvd->szKeyName), atoi(pkvd->szValue));
 		m_cAmmoTypes++; // count this new ammo type.
 
 		return true;
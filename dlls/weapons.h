@@ -394,6 +394,7 @@ inline DLL_GLOBAL short g_sModelIndexBloodDrop;	 // holds the sprite index for b
 inline DLL_GLOBAL short g_sModelIndexBloodSpray; // holds the sprite index for blood spray (bigger)
 
 extern void ClearMultiDamage();
+extern void ClearMultiDamagePerVictim();
 extern void ApplyMultiDamage(entvars_t* pevInflictor, entvars_t* pevAttacker);
 extern void AddMultiDamage(entvars_t* pevInflictor, CBaseEntity* pEntity, float flDamage, int bitsDamageType);
 
@@ -402,6 +403,11 @@ extern void SpawnBlood(Vector vecSpot, int bloodColor, float flDamage);
 extern int DamageDecal(CBaseEntity* pEntity, int bitsDamageType);
 extern void RadiusDamage(Vector vecSrc, entvars_t* pevInflictor, entvars_t* pevAttacker, float flDamage, float flRadius, int iClassIgnore, int bitsDamageType);
 
+// Radius damage issued between these calls is applied in issue order by RadiusDamageBatchEnd.
+// Batches can be nested.
+extern void RadiusDamageBatchBegin();
+extern void RadiusDamageBatchEnd();
+
 typedef struct
 {
 	CBaseEntity* pEntity;
@@ -20,6 +20,8 @@
 
 */
 
+#include <algorithm>
+
 #include "extdll.h"
 #include "util.h"
 #include "cbase.h"
@@ -33,6 +35,9 @@
 #include "weapons.h"
 #include "gamerules.h"
 #include "teamplay_gamerules.h"
+#include "game.h"
+#include "effectbudget.h"
+#include "stringpool.h"
 
 CGlobalState gGlobalState;
 
@@ -201,6 +206,8 @@ class CCorpse : public CBaseEntity
 
 LINK_ENTITY_TO_CLASS(bodyque, CCorpse);
 
+constexpr int MAX_BODYQUE = 32;
+
 static void InitBodyQue()
 {
 	string_t istrClassname = MAKE_STRING("bodyque");
@@ -208,14 +215,18 @@ static void InitBodyQue()
 	g_pBodyQueueHead = CREATE_NAMED_ENTITY(istrClassname);
 	entvars_t* pev = VARS(g_pBodyQueueHead);
 
-	// Reserve 3 more slots for dead bodies
-	for (int i = 0; i < 3; i++)
+	// Reserve more slots for dead bodies, sv_corpse_max in total
+	const int count = std::clamp(static_cast<int>(sv_corpse_max.value), 1, MAX_BODYQUE);
+
+	for (int i = 1; i < count; i++)
 	{
 		pev->owner = CREATE_NAMED_ENTITY(istrClassname);
 		pev = VARS(pev->owner);
 	}
 
 	pev->owner = g_pBodyQueueHead;
+
+	EffectBudget_InitCorpses(g_pBodyQueueHead);
 }
 
 
@@ -229,7 +240,8 @@ void CopyToBodyQue(entvars_t* pev)
 	if ((pev->effects & EF_NODRAW) != 0 || pev->modelindex == 0)
 		return;
 
-	entvars_t* pevHead = VARS(g_pBodyQueueHead);
+	// The corpse budget picks a free entry, or the corpse to recycle
+	entvars_t* pevHead = VARS(EffectBudget_ClaimCorpse(pev->origin));
 
 	pevHead->angles = pev->angles;
 	pevHead->model = pev->model;
@@ -253,7 +265,6 @@ void CopyToBodyQue(entvars_t* pev)
 
 	UTIL_SetOrigin(pevHead, pev->origin);
 	UTIL_SetSize(pevHead, pev->mins, pev->maxs);
-	g_pBodyQueueHead = pevHead->owner;
 }
 
 
@@ -544,11 +555,6 @@ void CWorld::Precache()
 
 	SENTENCEG_Init();
 
-	// init texture type array from materials.txt
-
-	TEXTURETYPE_Init();
-
-
 	// the area based ambient sounds MUST be the first precache_sounds
 
 	// player precaches
@@ -722,7 +728,7 @@ bool CWorld::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "chaptertitle"))
 	{
-		pev->netname = ALLOC_STRING(pkvd->szValue);
+		pev->netname = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "startdark"))
@@ -750,7 +756,7 @@ bool CWorld::KeyValue(KeyValueData* pkvd)
 	}
 	else if (FStrEq(pkvd->szKeyName, "mapteams"))
 	{
-		pev->team = ALLOC_STRING(pkvd->szValue);
+		pev->team = StringPool_Alloc(pkvd->szValue);
 		return true;
 	}
 	else if (FStrEq(pkvd->szKeyName, "defaultteam"))
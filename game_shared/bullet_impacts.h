@@ -0,0 +1,168 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#pragma once
+
+/**
+*	@file
+*
+*	Impact bookkeeping for multi-pellet shots, shared by the server's FireBullets and the client's EV_HLDM_FireBullets.
+*/
+
+#include <cmath>
+
+/**
+*	@brief Tracks the surfaces hit by the pellets of a single shot.
+*	Used to play at most one impact sound per surface and to avoid stacking decals on top of each other.
+*	A surface is a plane of a brush entity, or the whole entity for anything else.
+*/
+class CBulletImpacts
+{
+public:
+	static constexpr int MaxSurfaces = 32;
+	static constexpr int MaxDecals = 32;
+
+	/**
+	*	@brief Pellets landing closer than this to an earlier pellet on the same surface share its decal.
+	*/
+	static constexpr float DecalOverlapDistance = 4;
+
+	/**
+	*	@brief Records an impact and returns whether it is the first one on its surface this shot.
+	*	@param entity Index of the entity that was hit.
+	*	@param isBrush Whether the entity is a brush entity. Other entities are treated as a single surface.
+	*/
+	bool AddImpact(int entity, bool isBrush, const float* planeNormal, float planeDist)
+	{
+		m_LastSurface = FindSurface(entity, isBrush, planeNormal, planeDist);
+
+		if (m_LastSurface != -1)
+		{
+			return false;
+		}
+
+		if (m_SurfaceCount < MaxSurfaces)
+		{
+			auto& surface = m_Surfaces[m_SurfaceCount];
+
+			surface.Entity = entity;
+
+			for (int i = 0; i < 3; ++i)
+			{
+				surface.Normal[i] = planeNormal[i];
+			}
+
+			surface.Dist = planeDist;
+
+			m_LastSurface = m_SurfaceCount++;
+		}
+
+		return true;
+	}
+
+	/**
+	*	@brief Returns whether a decal should be placed at the given position for the impact last passed to AddImpact.
+	*	Pellets that land on top of an earlier decal on the same surface are collapsed into it.
+	*/
+	bool AddDecal(const float* endPos)
+	{
+		for (int i = 0; i < m_DecalCount; ++i)
+		{
+			const auto& decal = m_Decals[i];
+
+			if (decal.SurfaceIndex != m_LastSurface || m_LastSurface == -1)
+			{
+				continue;
+			}
+
+			float distanceSquared = 0;
+
+			for (int j = 0; j < 3; ++j)
+			{
+				const float delta = decal.Origin[j] - endPos[j];
+				distanceSquared += delta * delta;
+			}
+
+			if (distanceSquared < DecalOverlapDistance * DecalOverlapDistance)
+			{
+				return false;
+			}
+		}
+
+		if (m_DecalCount < MaxDecals)
+		{
+			auto& decal = m_Decals[m_DecalCount++];
+
+			decal.SurfaceIndex = m_LastSurface;
+
+			for (int i = 0; i < 3; ++i)
+			{
+				decal.Origin[i] = endPos[i];
+			}
+		}
+
+		return true;
+	}
+
+private:
+	int FindSurface(int entity, bool isBrush, const float* planeNormal, float planeDist) const
+	{
+		for (int i = 0; i < m_SurfaceCount; ++i)
+		{
+			const auto& surface = m_Surfaces[i];
+
+			if (surface.Entity != entity)
+			{
+				continue;
+			}
+
+			if (!isBrush)
+			{
+				return i;
+			}
+
+			// Pellets hitting the same brush face get the same plane back from the trace, allow for rounding.
+			const float dot = surface.Normal[0] * planeNormal[0] + surface.Normal[1] * planeNormal[1] + surface.Normal[2] * planeNormal[2];
+
+			if (dot > 0.999f && std::fabs(surface.Dist - planeDist) < 1)
+			{
+				return i;
+			}
+		}
+
+		return -1;
+	}
+
+	struct Surface
+	{
+		int Entity;
+		float Normal[3];
+		float Dist;
+	};
+
+	struct Decal
+	{
+		int SurfaceIndex;
+		float Origin[3];
+	};
+
+	Surface m_Surfaces[MaxSurfaces];
+	int m_SurfaceCount = 0;
+
+	Decal m_Decals[MaxDecals];
+	int m_DecalCount = 0;
+
+	int m_LastSurface = -1;
+};
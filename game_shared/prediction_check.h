@@ -0,0 +1,153 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#pragma once
+
+/**
+*	@file
+*
+*	Prediction divergence detection, shared by the server's CmdEnd and the client's HUD_PostRunCmd.
+*	With sv_prediction_debug enabled the server sends a hash of every field below after running each usercmd,
+*	identified by the command's random seed. The client compares them with the state it predicted for the same command.
+*/
+
+#include <cmath>
+
+enum PredictionField
+{
+	PRED_ORIGIN = 0,
+	PRED_VELOCITY,
+	PRED_FLAGS,
+	PRED_NEXTATTACK,
+	PRED_WEAPONID,
+	PRED_CLIP,
+	PRED_INRELOAD,
+	PRED_NEXTPRIMARYATTACK,
+	PRED_NEXTSECONDARYATTACK,
+	PRED_WEAPONIDLE,
+
+	PRED_FIELD_COUNT
+};
+
+/**
+*	@brief Player flags set by movement code, the only ones compared. Needs const.h.
+*/
+#define PREDICTION_FLAGS (FL_ONGROUND | FL_DUCKING | FL_WATERJUMP)
+
+/**
+*	@brief Fields of the player and its active weapon that prediction is expected to get right.
+*	Timers are relative, the way they are stored when weapons are predicted.
+*/
+struct PredictionState
+{
+	float Origin[3];
+	float Velocity[3];
+	int Flags;
+	float NextAttack;
+	int WeaponId;
+	int Clip;
+	int InReload;
+	float NextPrimaryAttack;
+	float NextSecondaryAttack;
+	float WeaponIdle;
+};
+
+/**
+*	@brief Positions are networked in 1/128 units and timers in milliseconds, so values are rounded to coarser steps
+*	before hashing to keep network precision from showing up as divergence.
+*/
+constexpr float PREDICTION_ORIGIN_STEP = 1 / 8.0f;
+constexpr float PREDICTION_VELOCITY_STEP = 1 / 2.0f;
+constexpr float PREDICTION_TIMER_STEP = 1 / 100.0f;
+
+inline const char* PredictionField_Name(int field)
+{
+	static const char* const names[PRED_FIELD_COUNT] =
+		{
+			"origin",
+			"velocity",
+			"flags",
+			"next attack",
+			"weapon id",
+			"clip",
+			"in reload",
+			"next primary attack",
+			"next secondary attack",
+			"weapon idle"};
+
+	return field >= 0 && field < PRED_FIELD_COUNT ? names[field] : "unknown";
+}
+
+inline unsigned int PredictionHash_Add(unsigned int hash, int value)
+{
+	// FNV-1a over the bytes of the value
+	for (int i = 0; i < 4; ++i)
+	{
+		hash ^= (static_cast<unsigned int>(value) >> (i * 8)) & 0xFF;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+inline unsigned int PredictionHash_Add(unsigned int hash, float value, float step)
+{
+	return PredictionHash_Add(hash, static_cast<int>(std::floor(value / step + 0.5f)));
+}
+
+/**
+*	@brief Timers are clamped the same way as when they are sent to the client.
+*/
+inline unsigned int PredictionHash_AddTimer(unsigned int hash, float value)
+{
+	return PredictionHash_Add(hash, value < -0.001f ? -0.001f : value, PREDICTION_TIMER_STEP);
+}
+
+/**
+*	@brief Computes a 16 bit hash for each field.
+*/
+inline void PredictionState_Hash(const PredictionState& state, unsigned short* hashes)
+{
+	const unsigned int basis = 2166136261u;
+	unsigned int hash;
+
+	hash = basis;
+	for (int i = 0; i < 3; ++i)
+		hash = PredictionHash_Add(hash, state.Origin[i], PREDICTION_ORIGIN_STEP);
+	hashes[PRED_ORIGIN] = hash ^ (hash >> 16);
+
+	hash = basis;
+	for (int i = 0; i < 3; ++i)
+		hash = PredictionHash_Add(hash, state.Velocity[i], PREDICTION_VELOCITY_STEP);
+	hashes[PRED_VELOCITY] = hash ^ (hash >> 16);
+
+	const int ints[] = {state.Flags, state.WeaponId, state.Clip, state.InReload};
+	const int intFields[] = {PRED_FLAGS, PRED_WEAPONID, PRED_CLIP, PRED_INRELOAD};
+
+	for (int i = 0; i < 4; ++i)
+	{
+		hash = PredictionHash_Add(basis, ints[i]);
+		hashes[intFields[i]] = hash ^ (hash >> 16);
+	}
+
+	const float timers[] = {state.NextAttack, state.NextPrimaryAttack, state.NextSecondaryAttack, state.WeaponIdle};
+	const int timerFields[] = {PRED_NEXTATTACK, PRED_NEXTPRIMARYATTACK, PRED_NEXTSECONDARYATTACK, PRED_WEAPONIDLE};
+
+	for (int i = 0; i < 4; ++i)
+	{
+		hash = PredictionHash_AddTimer(basis, timers[i]);
+		hashes[timerFields[i]] = hash ^ (hash >> 16);
+	}
+}
@@ -0,0 +1,212 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#include <cstring>
+
+#include "Platform.h"
+#include "mathlib.h"
+#include "studio_animcache.h"
+
+bool StudioAnim_DecodeChannel(const mstudioanimvalue_t* panimvalue, int numframes, std::vector<studio_animkey_t>& keys)
+{
+	keys.clear();
+
+	if (numframes <= 0)
+		return false;
+
+	keys.resize(numframes);
+
+	// Same walk as StudioCalcBoneQuaterion, but continuing from the previous frame instead of starting over
+	int k = 0;
+
+	for (int frame = 0; frame < numframes; ++frame, ++k)
+	{
+		while (panimvalue->num.total <= k)
+		{
+			// Corrupt spans reset the walk, and empty ones never end it; leave those to the original code
+			if (panimvalue->num.total < panimvalue->num.valid || 0 == panimvalue->num.total)
+			{
+				keys.clear();
+				return false;
+			}
+
+			k -= panimvalue->num.total;
+			panimvalue += panimvalue->num.valid + 1;
+		}
+
+		if (panimvalue->num.total < panimvalue->num.valid)
+		{
+			keys.clear();
+			return false;
+		}
+
+		const int valid = panimvalue->num.valid;
+		const int total = panimvalue->num.total;
+
+		auto& key = keys[frame];
+
+		if (valid > k)
+		{
+			key.value = panimvalue[k + 1].value;
+
+			if (valid > k + 1)
+				key.next = panimvalue[k + 2].value;
+			else if (total > k + 1)
+				key.next = key.value;
+			else
+				key.next = panimvalue[valid + 2].value;
+
+			key.blendPosition = valid > k + 1;
+		}
+		else
+		{
+			key.value = panimvalue[valid].value;
+
+			if (total > k + 1)
+				key.next = key.value;
+			else
+				key.next = panimvalue[valid + 2].value;
+
+			key.blendPosition = total <= k + 1;
+		}
+	}
+
+	return true;
+}
+
+CStudioAnimCache::Entry* CStudioAnimCache::Find(const mstudioanim_t* panim, int numbones, int numframes)
+{
+	if (0 == m_MaxBytes || !panim || numbones <= 0 || numframes <= 0)
+		return nullptr;
+
+	if (auto it = m_Lookup.find(panim); it != m_Lookup.end())
+	{
+		auto entry = it->second;
+
+		if (entry->numframes == numframes && entry->offsets.size() == static_cast<std::size_t>(numbones) && 0 == memcmp(entry->offsets.data(), panim, numbones * sizeof(mstudioanim_t)))
+		{
+			++m_Stats.hits;
+			m_Entries.splice(m_Entries.begin(), m_Entries, entry);
+			return &*entry;
+		}
+
+		// Another model was loaded where this one used to be
+		m_Bytes -= entry->bytes;
+		m_Entries.erase(entry);
+		m_Lookup.erase(it);
+	}
+
+	++m_Stats.misses;
+
+	m_Entries.emplace_front();
+
+	auto& entry = m_Entries.front();
+
+	entry.anim = panim;
+	entry.numframes = numframes;
+	entry.offsets.assign(panim, panim + numbones);
+	entry.bones.resize(numbones);
+	entry.bytes = sizeof(Entry) + numbones * (sizeof(mstudioanim_t) + sizeof(studio_bonekeys_t));
+
+	m_Lookup.emplace(panim, m_Entries.begin());
+	m_Bytes += entry.bytes;
+
+	EvictTo(m_MaxBytes, &entry);
+
+	return &entry;
+}
+
+const studio_bonekeys_t& CStudioAnimCache::GetBone(Entry* entry, int bone)
+{
+	auto& keys = entry->bones[bone];
+
+	if (!keys.decoded)
+	{
+		keys.decoded = true;
+		++m_Stats.bonesDecoded;
+
+		const auto& offsets = entry->offsets[bone];
+		const auto panim = entry->anim + bone;
+
+		std::size_t bytes = 0;
+
+		for (int j = 0; j < STUDIO_ANIM_CHANNELS; ++j)
+		{
+			if (0 == offsets.offset[j])
+				continue;
+
+			StudioAnim_DecodeChannel(reinterpret_cast<const mstudioanimvalue_t*>(reinterpret_cast<const byte*>(panim) + offsets.offset[j]),
+				entry->numframes, keys.channels[j]);
+
+			bytes += keys.channels[j].capacity() * sizeof(studio_animkey_t);
+		}
+
+		entry->bytes += bytes;
+		m_Bytes += bytes;
+
+		EvictTo(m_MaxBytes, entry);
+	}
+
+	return keys;
+}
+
+void CStudioAnimCache::SetMaxBytes(std::size_t maxBytes)
+{
+	m_MaxBytes = maxBytes;
+
+	if (0 == m_MaxBytes)
+		Clear();
+	else
+		EvictTo(m_MaxBytes, nullptr);
+}
+
+void CStudioAnimCache::Clear()
+{
+	m_Entries.clear();
+	m_Lookup.clear();
+	m_Bytes = 0;
+}
+
+void CStudioAnimCache::SetEvictionPaused(bool paused)
+{
+	m_EvictionPaused = paused;
+
+	if (!m_EvictionPaused)
+		EvictTo(m_MaxBytes, nullptr);
+}
+
+void CStudioAnimCache::ResetStats()
+{
+	m_Stats = {};
+}
+
+void CStudioAnimCache::EvictTo(std::size_t maxBytes, const Entry* keep)
+{
+	if (m_EvictionPaused)
+		return;
+
+	while (m_Bytes > maxBytes && !m_Entries.empty())
+	{
+		auto& oldest = m_Entries.back();
+
+		if (&oldest == keep)
+			break;
+
+		++m_Stats.evictions;
+		m_Bytes -= oldest.bytes;
+		m_Lookup.erase(oldest.anim);
+		m_Entries.pop_back();
+	}
+}
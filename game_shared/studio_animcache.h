@@ -0,0 +1,147 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#pragma once
+
+/**
+*	@file
+*
+*	Decoded studio model animations.
+*	Animation channels are stored run length encoded, so finding the value of a frame means walking the channel from the start.
+*	The cache decodes every frame of a bone's channels the first time the bone is set up for a sequence,
+*	after which looking up a frame is an array index.
+*/
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "studio.h"
+
+#define STUDIO_ANIM_CHANNELS 6
+
+/**
+*	@brief Values of one channel at one frame.
+*	Rotations interpolate from value to next. Positions only do when blendPosition is set, otherwise they use value.
+*/
+struct studio_animkey_t
+{
+	short value;
+	short next;
+	bool blendPosition;
+};
+
+struct studio_bonekeys_t
+{
+	bool decoded = false;
+
+	// Every frame of each channel. Empty for channels that aren't animated, or whose data is malformed and must be read directly.
+	std::vector<studio_animkey_t> channels[STUDIO_ANIM_CHANNELS];
+
+	/**
+	*	@brief Returns the decoded values of a channel for a frame, or nullptr if it has to be read from the animation data.
+	*/
+	const studio_animkey_t* GetKey(int channel, int frame) const
+	{
+		const auto& keys = channels[channel];
+
+		if (frame < 0 || static_cast<std::size_t>(frame) >= keys.size())
+			return nullptr;
+
+		return &keys[frame];
+	}
+};
+
+struct studio_animcache_stats_t
+{
+	unsigned int hits;
+	unsigned int misses;
+	unsigned int bonesDecoded;
+	unsigned int evictions;
+};
+
+/**
+*	@brief Least recently used cache of decoded animations, limited to a number of bytes.
+*	Entries are one blend of one sequence, keyed by the address of its animation data.
+*/
+class CStudioAnimCache
+{
+public:
+	struct Entry;
+
+	/**
+	*	@brief Finds or adds the entry for the animation data of a sequence blend. Returns nullptr if the cache is disabled.
+	*	@param panim Animation data of the first bone.
+	*/
+	Entry* Find(const mstudioanim_t* panim, int numbones, int numframes);
+
+	/**
+	*	@brief Returns the keys of a bone of an entry, decoding them first if needed.
+	*	May evict other entries, but not this one.
+	*/
+	const studio_bonekeys_t& GetBone(Entry* entry, int bone);
+
+	/**
+	*	@brief Sets the memory limit. 0 disables the cache.
+	*/
+	void SetMaxBytes(std::size_t maxBytes);
+	std::size_t GetMaxBytes() const { return m_MaxBytes; }
+	std::size_t GetBytes() const { return m_Bytes; }
+	int GetEntryCount() const { return static_cast<int>(m_Entries.size()); }
+
+	void Clear();
+
+	/**
+	*	@brief While paused entries are only evicted once eviction is resumed,
+	*	so keys returned by GetBone stay valid while several threads use the cache.
+	*/
+	void SetEvictionPaused(bool paused);
+
+	const studio_animcache_stats_t& GetStats() const { return m_Stats; }
+	void ResetStats();
+
+	struct Entry
+	{
+		const mstudioanim_t* anim;
+		int numframes;
+
+		// Copy of the channel offsets of all bones, to recognize different data loaded at the same address
+		std::vector<mstudioanim_t> offsets;
+
+		std::vector<studio_bonekeys_t> bones;
+		std::size_t bytes = 0;
+	};
+
+private:
+	void EvictTo(std::size_t maxBytes, const Entry* keep);
+
+	// Most recently used first
+	std::list<Entry> m_Entries;
+	std::unordered_map<const mstudioanim_t*, std::list<Entry>::iterator> m_Lookup;
+
+	std::size_t m_MaxBytes = 0;
+	std::size_t m_Bytes = 0;
+	bool m_EvictionPaused = false;
+
+	studio_animcache_stats_t m_Stats{};
+};
+
+/**
+*	@brief Decodes every frame of a channel into keys.
+*	Returns false if the data is malformed in a way StudioCalcBoneQuaterion and StudioCalcBonePosition handle specially,
+*	in which case the channel has to be read directly.
+*/
+bool StudioAnim_DecodeChannel(const mstudioanimvalue_t* panimvalue, int numframes, std::vector<studio_animkey_t>& keys);
@@ -0,0 +1,379 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#include <cmath>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include <emmintrin.h>
+
+#include "studio_simd.h"
+
+// The Linux build disables SSE for the library, so the kernels ask for it themselves
+#ifdef __GNUC__
+#define STUDIO_SIMD_TARGET __attribute__((target("sse2")))
+#else
+#define STUDIO_SIMD_TARGET
+#endif
+
+#define STUDIO_SIMD_PI 3.14159265358979323846f
+
+bool StudioSIMD_IsSupported()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	return 0 != (info[3] & (1 << 26));
+#else
+	return 0 != __builtin_cpu_supports("sse2");
+#endif
+}
+
+namespace
+{
+STUDIO_SIMD_TARGET inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/**
+*	@brief Sine and cosine of 4 angles, from the Cephes library's sinf and cosf.
+*/
+STUDIO_SIMD_TARGET inline void SinCos(__m128 x, __m128& s, __m128& c)
+{
+	const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+
+	__m128 sinSign = _mm_and_ps(x, signMask);
+	x = _mm_andnot_ps(signMask, x);
+
+	// Octant, rounded up to an even number
+	__m128i octant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(4.0f / STUDIO_SIMD_PI)));
+	octant = _mm_and_si128(_mm_add_epi32(octant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+
+	const __m128 y = _mm_cvtepi32_ps(octant);
+
+	sinSign = _mm_xor_ps(sinSign, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, _mm_set1_epi32(4)), 29)));
+	const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(octant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+
+	// Whether the sine uses the cosine polynomial and the other way around
+	const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+
+	// Extended precision modular arithmetic
+	x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625f)));
+	x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+	x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+
+	const __m128 z = _mm_mul_ps(x, x);
+
+	__m128 cosPoly = _mm_set1_ps(2.443315711809948e-5f);
+	cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(-1.388731625493765e-3f));
+	cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(4.166664568298827e-2f));
+	cosPoly = _mm_mul_ps(_mm_mul_ps(cosPoly, z), z);
+	cosPoly = _mm_sub_ps(cosPoly, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+	cosPoly = _mm_add_ps(cosPoly, _mm_set1_ps(1.0f));
+
+	__m128 sinPoly = _mm_set1_ps(-1.9515295891e-4f);
+	sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(8.3321608736e-3f));
+	sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(-1.6666654611e-1f));
+	sinPoly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinPoly, z), x), x);
+
+	s = _mm_xor_ps(Select(swap, cosPoly, sinPoly), sinSign);
+	c = _mm_xor_ps(Select(swap, sinPoly, cosPoly), cosSign);
+}
+
+STUDIO_SIMD_TARGET inline __m128 Sin(__m128 x)
+{
+	__m128 s, c;
+	SinCos(x, s, c);
+	return s;
+}
+
+/**
+*	@brief Arc cosine of 4 values in [-1, 1], from the Cephes library's asinf.
+*/
+STUDIO_SIMD_TARGET inline __m128 ACos(__m128 x)
+{
+	const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	const __m128 ax = _mm_min_ps(_mm_andnot_ps(signMask, x), one);
+	const __m128 negative = _mm_cmplt_ps(x, _mm_setzero_ps());
+
+	// Above 0.5, asin(x) = pi / 2 - 2 * asin(sqrt((1 - x) / 2))
+	const __m128 large = _mm_cmpgt_ps(ax, _mm_set1_ps(0.5f));
+	const __m128 zLarge = _mm_mul_ps(_mm_sub_ps(one, ax), _mm_set1_ps(0.5f));
+
+	const __m128 z = Select(large, zLarge, _mm_mul_ps(ax, ax));
+	const __m128 v = Select(large, _mm_sqrt_ps(zLarge), ax);
+
+	__m128 p = _mm_set1_ps(4.2163199048e-2f);
+	p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(2.4181311049e-2f));
+	p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(4.5470025998e-2f));
+	p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(7.4953002686e-2f));
+	p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.6666752422e-1f));
+	p = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, z), v), v);
+
+	// acos(|x|) = 2 * asin(sqrt((1 - |x|) / 2)) when large, pi / 2 - asin(|x|) otherwise
+	const __m128 acosAbs = Select(large, _mm_add_ps(p, p), _mm_sub_ps(_mm_set1_ps(STUDIO_SIMD_PI * 0.5f), p));
+
+	return Select(negative, _mm_sub_ps(_mm_set1_ps(STUDIO_SIMD_PI), acosAbs), acosAbs);
+}
+
+/**
+*	@brief Loads @p count (at most 4) vectors of @p N floats as N registers of one component each. Missing vectors are 0.
+*/
+template <int N>
+STUDIO_SIMD_TARGET inline void LoadComponents(const float* vectors, int count, __m128 (&components)[N])
+{
+	alignas(16) float values[N][4] = {};
+
+	for (int i = 0; i < count; ++i)
+	{
+		for (int j = 0; j < N; ++j)
+			values[j][i] = vectors[i * N + j];
+	}
+
+	for (int j = 0; j < N; ++j)
+		components[j] = _mm_load_ps(values[j]);
+}
+
+STUDIO_SIMD_TARGET inline void LoadComponents(const float* vectors, int count, __m128 (&components)[4])
+{
+	if (count < 4)
+	{
+		LoadComponents<4>(vectors, count, components);
+		return;
+	}
+
+	components[0] = _mm_loadu_ps(vectors);
+	components[1] = _mm_loadu_ps(vectors + 4);
+	components[2] = _mm_loadu_ps(vectors + 8);
+	components[3] = _mm_loadu_ps(vectors + 12);
+
+	_MM_TRANSPOSE4_PS(components[0], components[1], components[2], components[3]);
+}
+
+/**
+*	@brief Stores 4 registers of one component each as @p count (at most 4) vectors of 4 floats.
+*/
+STUDIO_SIMD_TARGET inline void StoreVectors(__m128 x, __m128 y, __m128 z, __m128 w, float* vectors, int count)
+{
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+
+	const __m128 rows[4] = {x, y, z, w};
+
+	for (int i = 0; i < count; ++i)
+		_mm_storeu_ps(vectors + i * 4, rows[i]);
+}
+}
+
+STUDIO_SIMD_TARGET void StudioSIMD_AngleQuaternions(const float (*angles)[3], vec4_t* quaternions, int count)
+{
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	for (int i = 0; i < count; i += 4)
+	{
+		const int batch = count - i < 4 ? count - i : 4;
+
+		__m128 angle[3];
+		LoadComponents(angles[i], batch, angle);
+
+		__m128 sr, cr, sp, cp, sy, cy;
+		SinCos(_mm_mul_ps(angle[0], half), sr, cr);
+		SinCos(_mm_mul_ps(angle[1], half), sp, cp);
+		SinCos(_mm_mul_ps(angle[2], half), sy, cy);
+
+		const __m128 crcp = _mm_mul_ps(cr, cp);
+		const __m128 srsp = _mm_mul_ps(sr, sp);
+		const __m128 srcp = _mm_mul_ps(sr, cp);
+		const __m128 crsp = _mm_mul_ps(cr, sp);
+
+		StoreVectors(
+			_mm_sub_ps(_mm_mul_ps(srcp, cy), _mm_mul_ps(crsp, sy)),
+			_mm_add_ps(_mm_mul_ps(crsp, cy), _mm_mul_ps(srcp, sy)),
+			_mm_sub_ps(_mm_mul_ps(crcp, sy), _mm_mul_ps(srsp, cy)),
+			_mm_add_ps(_mm_mul_ps(crcp, cy), _mm_mul_ps(srsp, sy)),
+			quaternions[i], batch);
+	}
+}
+
+STUDIO_SIMD_TARGET void StudioSIMD_QuaternionSlerps(const vec4_t* p, const vec4_t* q, float t, vec4_t* qt, int count)
+{
+	const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 epsilon = _mm_set1_ps(0.000001f);
+	const __m128 vt = _mm_set1_ps(t);
+	const __m128 vt1 = _mm_set1_ps(1.0f - t);
+
+	// Used when the quaternions are opposite
+	const __m128 oppositeP = _mm_set1_ps(std::sin((1.0f - t) * (0.5f * STUDIO_SIMD_PI)));
+	const __m128 oppositeQ = _mm_set1_ps(std::sin(t * (0.5f * STUDIO_SIMD_PI)));
+
+	for (int i = 0; i < count; i += 4)
+	{
+		const int batch = count - i < 4 ? count - i : 4;
+
+		__m128 vp[4], vq[4];
+		LoadComponents(p[i], batch, vp);
+		LoadComponents(q[i], batch, vq);
+
+		// decide if one of the quaternions is backwards
+		__m128 a = _mm_setzero_ps();
+		__m128 b = _mm_setzero_ps();
+
+		for (int j = 0; j < 4; ++j)
+		{
+			const __m128 difference = _mm_sub_ps(vp[j], vq[j]);
+			const __m128 sum = _mm_add_ps(vp[j], vq[j]);
+			a = _mm_add_ps(a, _mm_mul_ps(difference, difference));
+			b = _mm_add_ps(b, _mm_mul_ps(sum, sum));
+		}
+
+		const __m128 flip = _mm_and_ps(_mm_cmpgt_ps(a, b), signMask);
+
+		__m128 cosom = _mm_setzero_ps();
+
+		for (int j = 0; j < 4; ++j)
+		{
+			vq[j] = _mm_xor_ps(vq[j], flip);
+			cosom = _mm_add_ps(cosom, _mm_mul_ps(vp[j], vq[j]));
+		}
+
+		const __m128 notOpposite = _mm_cmpgt_ps(_mm_add_ps(one, cosom), epsilon);
+		const __m128 notClose = _mm_cmpgt_ps(_mm_sub_ps(one, cosom), epsilon);
+
+		const __m128 omega = ACos(cosom);
+
+		__m128 sinom, unused;
+		SinCos(omega, sinom, unused);
+
+		// Close quaternions blend linearly, avoid dividing by a tiny sine for them
+		const __m128 divisor = Select(notClose, sinom, one);
+
+		const __m128 sclp = Select(notClose, _mm_div_ps(Sin(_mm_mul_ps(vt1, omega)), divisor), vt1);
+		const __m128 sclq = Select(notClose, _mm_div_ps(Sin(_mm_mul_ps(vt, omega)), divisor), vt);
+
+		__m128 result[4];
+
+		for (int j = 0; j < 4; ++j)
+			result[j] = _mm_add_ps(_mm_mul_ps(sclp, vp[j]), _mm_mul_ps(sclq, vq[j]));
+
+		// Rotate q by 90 degrees when they are opposite
+		const __m128 perpendicular[4] = {_mm_xor_ps(vq[1], signMask), vq[0], _mm_xor_ps(vq[3], signMask), vq[2]};
+
+		for (int j = 0; j < 3; ++j)
+		{
+			const __m128 opposite = _mm_add_ps(_mm_mul_ps(oppositeP, vp[j]), _mm_mul_ps(oppositeQ, perpendicular[j]));
+			result[j] = Select(notOpposite, result[j], opposite);
+		}
+
+		result[3] = Select(notOpposite, result[3], perpendicular[3]);
+
+		StoreVectors(result[0], result[1], result[2], result[3], qt[i], batch);
+	}
+}
+
+STUDIO_SIMD_TARGET void StudioSIMD_BoneMatrices(const vec4_t* quaternions, const float (*pos)[3], float (*matrices)[3][4], int count)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	for (int i = 0; i < count; i += 4)
+	{
+		const int batch = count - i < 4 ? count - i : 4;
+
+		__m128 q[4];
+		LoadComponents(quaternions[i], batch, q);
+
+		const __m128 x2 = _mm_add_ps(q[0], q[0]);
+		const __m128 y2 = _mm_add_ps(q[1], q[1]);
+		const __m128 z2 = _mm_add_ps(q[2], q[2]);
+
+		const __m128 xx = _mm_mul_ps(q[0], x2);
+		const __m128 yy = _mm_mul_ps(q[1], y2);
+		const __m128 zz = _mm_mul_ps(q[2], z2);
+		const __m128 xy = _mm_mul_ps(q[0], y2);
+		const __m128 xz = _mm_mul_ps(q[0], z2);
+		const __m128 yz = _mm_mul_ps(q[1], z2);
+		const __m128 wx = _mm_mul_ps(q[3], x2);
+		const __m128 wy = _mm_mul_ps(q[3], y2);
+		const __m128 wz = _mm_mul_ps(q[3], z2);
+
+		// Each row of every matrix, then the rows are transposed into the matrices. Positions are copied afterwards.
+		const __m128 zero = _mm_setzero_ps();
+
+		__m128 row0[4] = {_mm_sub_ps(_mm_sub_ps(one, yy), zz), _mm_sub_ps(xy, wz), _mm_add_ps(xz, wy), zero};
+		__m128 row1[4] = {_mm_add_ps(xy, wz), _mm_sub_ps(_mm_sub_ps(one, xx), zz), _mm_sub_ps(yz, wx), zero};
+		__m128 row2[4] = {_mm_sub_ps(xz, wy), _mm_add_ps(yz, wx), _mm_sub_ps(_mm_sub_ps(one, xx), yy), zero};
+
+		_MM_TRANSPOSE4_PS(row0[0], row0[1], row0[2], row0[3]);
+		_MM_TRANSPOSE4_PS(row1[0], row1[1], row1[2], row1[3]);
+		_MM_TRANSPOSE4_PS(row2[0], row2[1], row2[2], row2[3]);
+
+		for (int j = 0; j < batch; ++j)
+		{
+			_mm_storeu_ps(matrices[i + j][0], row0[j]);
+			_mm_storeu_ps(matrices[i + j][1], row1[j]);
+			_mm_storeu_ps(matrices[i + j][2], row2[j]);
+
+			matrices[i + j][0][3] = pos[i + j][0];
+			matrices[i + j][1][3] = pos[i + j][1];
+			matrices[i + j][2][3] = pos[i + j][2];
+		}
+	}
+}
+
+STUDIO_SIMD_TARGET void StudioSIMD_ConcatTransforms(const float in1[3][4], const float in2[3][4], float out[3][4])
+{
+	const __m128 columns[4] = {
+		_mm_loadu_ps(in2[0]),
+		_mm_loadu_ps(in2[1]),
+		_mm_loadu_ps(in2[2]),
+		_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f)};
+
+	__m128 rows[3];
+
+	for (int i = 0; i < 3; ++i)
+	{
+		rows[i] = _mm_mul_ps(_mm_set1_ps(in1[i][0]), columns[0]);
+		rows[i] = _mm_add_ps(rows[i], _mm_mul_ps(_mm_set1_ps(in1[i][1]), columns[1]));
+		rows[i] = _mm_add_ps(rows[i], _mm_mul_ps(_mm_set1_ps(in1[i][2]), columns[2]));
+		rows[i] = _mm_add_ps(rows[i], _mm_mul_ps(_mm_set1_ps(in1[i][3]), columns[3]));
+	}
+
+	// out may be one of the inputs
+	for (int i = 0; i < 3; ++i)
+		_mm_storeu_ps(out[i], rows[i]);
+}
+
+float StudioSIMD_MaxError(const float* values, const float* reference, int count)
+{
+	float maxError = 0;
+
+	for (int i = 0; i < count; ++i)
+	{
+		const float scale = std::fabs(reference[i]) > 1.0f ? std::fabs(reference[i]) : 1.0f;
+		const float error = std::fabs(values[i] - reference[i]) / scale;
+
+		if (std::isnan(error))
+			return HUGE_VALF;
+
+		if (error > maxError)
+			maxError = error;
+	}
+
+	return maxError;
+}
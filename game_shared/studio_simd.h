@@ -0,0 +1,62 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#pragma once
+
+/**
+*	@file
+*
+*	SSE2 versions of the quaternion and matrix functions used to set up studio model bones,
+*	working on 4 bones at a time.
+*	Sines, cosines and arc cosines are polynomial approximations, so results differ from
+*	AngleQuaternion, QuaternionSlerp, QuaternionMatrix and ConcatTransforms by a few units in the last place.
+*	Only call these if StudioSIMD_IsSupported returns true.
+*/
+
+#include "mathlib.h"
+
+// Largest difference from the scalar functions, relative to the size of the values, that validation accepts
+#define STUDIO_SIMD_TOLERANCE 1e-4f
+
+/**
+*	@brief Whether the CPU supports SSE2. The kernels are compiled for it even if the rest of the library isn't.
+*/
+bool StudioSIMD_IsSupported();
+
+/**
+*	@brief AngleQuaternion for @p count angles.
+*/
+void StudioSIMD_AngleQuaternions(const float (*angles)[3], vec4_t* quaternions, int count);
+
+/**
+*	@brief QuaternionSlerp for @p count pairs. Unlike QuaternionSlerp, @p q is left unchanged.
+*/
+void StudioSIMD_QuaternionSlerps(const vec4_t* p, const vec4_t* q, float t, vec4_t* qt, int count);
+
+/**
+*	@brief QuaternionMatrix for @p count bones, with the bone positions in the last column.
+*/
+void StudioSIMD_BoneMatrices(const vec4_t* quaternions, const float (*pos)[3], float (*matrices)[3][4], int count);
+
+/**
+*	@brief ConcatTransforms for one pair of matrices, a row per instruction.
+*	Bones depend on their parent, so these can't be batched.
+*/
+void StudioSIMD_ConcatTransforms(const float in1[3][4], const float in2[3][4], float out[3][4]);
+
+/**
+*	@brief Returns the largest difference between two arrays, relative to the size of the values when those are larger than 1.
+*/
+float StudioSIMD_MaxError(const float* values, const float* reference, int count);
@@ -0,0 +1,446 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Platform.h"
+#include "mathlib.h"
+#include "const.h"
+#include "usercmd.h"
+#include "pm_defs.h"
+#include "pm_movevars.h"
+#include "pm_replay.h"
+
+enum pmreplay_fieldtype_t
+{
+	PMREPLAY_FLOAT,
+	PMREPLAY_INT,
+	PMREPLAY_VECTOR,
+	PMREPLAY_BYTE,
+	PMREPLAY_SHORT,
+	PMREPLAY_USHORT
+};
+
+struct pmreplay_field_t
+{
+	pmreplay_fieldtype_t type;
+	size_t offset;
+};
+
+#define PMREPLAY_FIELD(type, name) {type, offsetof(pmreplay_move_t, name)}
+
+// Order of the fields on a move line, append new fields at the end and bump PMREPLAY_VERSION
+static const pmreplay_field_t g_MoveFields[] =
+	{
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, time),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, frametime),
+		PMREPLAY_FIELD(PMREPLAY_VECTOR, angles),
+		PMREPLAY_FIELD(PMREPLAY_VECTOR, oldangles),
+		PMREPLAY_FIELD(PMREPLAY_VECTOR, basevelocity),
+		PMREPLAY_FIELD(PMREPLAY_VECTOR, punchangle),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, gravity),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, friction),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, maxspeed),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, clientmaxspeed),
+		PMREPLAY_FIELD(PMREPLAY_INT, dead),
+		PMREPLAY_FIELD(PMREPLAY_INT, deadflag),
+		PMREPLAY_FIELD(PMREPLAY_INT, spectator),
+		PMREPLAY_FIELD(PMREPLAY_INT, movetype),
+		PMREPLAY_FIELD(PMREPLAY_INT, iuser1),
+		PMREPLAY_FIELD(PMREPLAY_INT, iuser2),
+		PMREPLAY_FIELD(PMREPLAY_INT, iuser3),
+		PMREPLAY_FIELD(PMREPLAY_INT, iuser4),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, fuser1),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, fuser2),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, fuser3),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, fuser4),
+
+		PMREPLAY_FIELD(PMREPLAY_VECTOR, origin),
+		PMREPLAY_FIELD(PMREPLAY_VECTOR, velocity),
+		PMREPLAY_FIELD(PMREPLAY_VECTOR, view_ofs),
+		PMREPLAY_FIELD(PMREPLAY_VECTOR, movedir),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, flDuckTime),
+		PMREPLAY_FIELD(PMREPLAY_INT, bInDuck),
+		PMREPLAY_FIELD(PMREPLAY_INT, flTimeStepSound),
+		PMREPLAY_FIELD(PMREPLAY_INT, iStepLeft),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, flFallVelocity),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, flSwimTime),
+		PMREPLAY_FIELD(PMREPLAY_INT, flags),
+		PMREPLAY_FIELD(PMREPLAY_INT, usehull),
+		PMREPLAY_FIELD(PMREPLAY_INT, oldbuttons),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, waterjumptime),
+		PMREPLAY_FIELD(PMREPLAY_INT, onground),
+		PMREPLAY_FIELD(PMREPLAY_INT, waterlevel),
+		PMREPLAY_FIELD(PMREPLAY_INT, watertype),
+
+		PMREPLAY_FIELD(PMREPLAY_SHORT, cmd.lerp_msec),
+		PMREPLAY_FIELD(PMREPLAY_BYTE, cmd.msec),
+		PMREPLAY_FIELD(PMREPLAY_VECTOR, cmd.viewangles),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, cmd.forwardmove),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, cmd.sidemove),
+		PMREPLAY_FIELD(PMREPLAY_FLOAT, cmd.upmove),
+		PMREPLAY_FIELD(PMREPLAY_BYTE, cmd.lightlevel),
+		PMREPLAY_FIELD(PMREPLAY_USHORT, cmd.buttons),
+		PMREPLAY_FIELD(PMREPLAY_BYTE, cmd.impulse),
+		PMREPLAY_FIELD(PMREPLAY_BYTE, cmd.weaponselect),
+
+		PMREPLAY_FIELD(PMREPLAY_VECTOR, resultOrigin),
+		PMREPLAY_FIELD(PMREPLAY_VECTOR, resultVelocity),
+};
+
+#define PMREPLAY_MAX_LINE 4096
+
+static FILE* g_pRecordFile = NULL;
+static char g_szRecordMapName[64];
+static int g_iRecordPlayer = -1;
+static bool g_bRecordHeaderWritten = false;
+static pmreplay_move_t g_RecordMove;
+
+void PMReplay_Capture(const playermove_s* pmove, pmreplay_move_t& move)
+{
+	move.time = pmove->time;
+	move.frametime = pmove->frametime;
+	move.angles = pmove->angles;
+	move.oldangles = pmove->oldangles;
+	move.basevelocity = pmove->basevelocity;
+	move.punchangle = pmove->punchangle;
+	move.gravity = pmove->gravity;
+	move.friction = pmove->friction;
+	move.maxspeed = pmove->maxspeed;
+	move.clientmaxspeed = pmove->clientmaxspeed;
+	move.dead = pmove->dead;
+	move.deadflag = pmove->deadflag;
+	move.spectator = pmove->spectator;
+	move.movetype = pmove->movetype;
+	move.iuser1 = pmove->iuser1;
+	move.iuser2 = pmove->iuser2;
+	move.iuser3 = pmove->iuser3;
+	move.iuser4 = pmove->iuser4;
+	move.fuser1 = pmove->fuser1;
+	move.fuser2 = pmove->fuser2;
+	move.fuser3 = pmove->fuser3;
+	move.fuser4 = pmove->fuser4;
+
+	move.origin = pmove->origin;
+	move.velocity = pmove->velocity;
+	move.view_ofs = pmove->view_ofs;
+	move.movedir = pmove->movedir;
+	move.flDuckTime = pmove->flDuckTime;
+	move.bInDuck = pmove->bInDuck;
+	move.flTimeStepSound = pmove->flTimeStepSound;
+	move.iStepLeft = pmove->iStepLeft;
+	move.flFallVelocity = pmove->flFallVelocity;
+	move.flSwimTime = pmove->flSwimTime;
+	move.flags = pmove->flags;
+	move.usehull = pmove->usehull;
+	move.oldbuttons = pmove->oldbuttons;
+	move.waterjumptime = pmove->waterjumptime;
+	move.onground = pmove->onground;
+	move.waterlevel = pmove->waterlevel;
+	move.watertype = pmove->watertype;
+
+	move.cmd = pmove->cmd;
+
+	move.resultOrigin = g_vecZero;
+	move.resultVelocity = g_vecZero;
+}
+
+void PMReplay_Apply(const pmreplay_move_t& move, playermove_s* pmove, bool carryOver)
+{
+	pmove->time = move.time;
+	pmove->frametime = move.frametime;
+	pmove->angles = move.angles;
+	pmove->oldangles = move.oldangles;
+	pmove->basevelocity = move.basevelocity;
+	pmove->punchangle = move.punchangle;
+	pmove->gravity = move.gravity;
+	pmove->friction = move.friction;
+	pmove->maxspeed = move.maxspeed;
+	pmove->clientmaxspeed = move.clientmaxspeed;
+	pmove->dead = move.dead;
+	pmove->deadflag = move.deadflag;
+	pmove->spectator = move.spectator;
+	pmove->movetype = move.movetype;
+	pmove->iuser1 = move.iuser1;
+	pmove->iuser2 = move.iuser2;
+	pmove->iuser3 = move.iuser3;
+	pmove->iuser4 = move.iuser4;
+	pmove->fuser1 = move.fuser1;
+	pmove->fuser2 = move.fuser2;
+	pmove->fuser3 = move.fuser3;
+	pmove->fuser4 = move.fuser4;
+
+	pmove->cmd = move.cmd;
+
+	if (!carryOver)
+		return;
+
+	pmove->origin = move.origin;
+	pmove->velocity = move.velocity;
+	pmove->view_ofs = move.view_ofs;
+	pmove->movedir = move.movedir;
+	pmove->flDuckTime = move.flDuckTime;
+	pmove->bInDuck = move.bInDuck;
+	pmove->flTimeStepSound = move.flTimeStepSound;
+	pmove->iStepLeft = move.iStepLeft;
+	pmove->flFallVelocity = move.flFallVelocity;
+	pmove->flSwimTime = move.flSwimTime;
+	pmove->flags = move.flags;
+	pmove->usehull = move.usehull;
+	pmove->oldbuttons = move.oldbuttons;
+	pmove->waterjumptime = move.waterjumptime;
+	pmove->onground = move.onground;
+	pmove->waterlevel = move.waterlevel;
+	pmove->watertype = move.watertype;
+}
+
+void PMReplay_WriteHeader(FILE* file, const char* mapname, const playermove_s* pmove)
+{
+	const movevars_t* mv = pmove->movevars;
+
+	fprintf(file, "pmreplay %d\n", PMREPLAY_VERSION);
+	fprintf(file, "map %s\n", mapname);
+	fprintf(file, "physinfo %s\n", pmove->physinfo);
+	fprintf(file, "movevars %a %a %a %a %a %a %a %a %a %a %a %a %a %a %a %a %d %a %a\n",
+		mv->gravity, mv->stopspeed, mv->maxspeed, mv->spectatormaxspeed,
+		mv->accelerate, mv->airaccelerate, mv->wateraccelerate,
+		mv->friction, mv->edgefriction, mv->waterfriction, mv->entgravity,
+		mv->bounce, mv->stepsize, mv->maxvelocity, mv->zmax, mv->waveHeight,
+		mv->footsteps, mv->rollangle, mv->rollspeed);
+}
+
+// Reads a line and returns its contents after the expected keyword, or NULL
+static char* PMReplay_ReadLine(FILE* file, const char* keyword, char* buffer, int size)
+{
+	if (!fgets(buffer, size, file))
+		return NULL;
+
+	buffer[strcspn(buffer, "\r\n")] = '\0';
+
+	const size_t length = strlen(keyword);
+
+	if (0 != strncmp(buffer, keyword, length) || (buffer[length] != ' ' && buffer[length] != '\0'))
+		return NULL;
+
+	return buffer[length] == ' ' ? buffer + length + 1 : buffer + length;
+}
+
+bool PMReplay_ReadHeader(FILE* file, pmreplay_header_t& header)
+{
+	char buffer[PMREPLAY_MAX_LINE];
+	char* value;
+
+	memset(&header, 0, sizeof(header));
+
+	if ((value = PMReplay_ReadLine(file, "pmreplay", buffer, sizeof(buffer))) == NULL || atoi(value) != PMREPLAY_VERSION)
+		return false;
+
+	if ((value = PMReplay_ReadLine(file, "map", buffer, sizeof(buffer))) == NULL)
+		return false;
+
+	strncpy(header.mapname, value, sizeof(header.mapname) - 1);
+
+	if ((value = PMReplay_ReadLine(file, "physinfo", buffer, sizeof(buffer))) == NULL)
+		return false;
+
+	strncpy(header.physinfo, value, sizeof(header.physinfo) - 1);
+
+	if ((value = PMReplay_ReadLine(file, "movevars", buffer, sizeof(buffer))) == NULL)
+		return false;
+
+	movevars_t* mv = &header.movevars;
+
+	float* const floats[] =
+		{
+			&mv->gravity, &mv->stopspeed, &mv->maxspeed, &mv->spectatormaxspeed,
+			&mv->accelerate, &mv->airaccelerate, &mv->wateraccelerate,
+			&mv->friction, &mv->edgefriction, &mv->waterfriction, &mv->entgravity,
+			&mv->bounce, &mv->stepsize, &mv->maxvelocity, &mv->zmax, &mv->waveHeight};
+
+	char* p = value;
+
+	for (float* f : floats)
+	{
+		*f = strtof(p, &p);
+	}
+
+	mv->footsteps = strtol(p, &p, 10);
+	mv->rollangle = strtof(p, &p);
+	mv->rollspeed = strtof(p, &p);
+
+	return true;
+}
+
+void PMReplay_WriteMove(FILE* file, const pmreplay_move_t& move)
+{
+	fputs("move", file);
+
+	for (const auto& field : g_MoveFields)
+	{
+		const byte* data = reinterpret_cast<const byte*>(&move) + field.offset;
+
+		switch (field.type)
+		{
+		case PMREPLAY_FLOAT:
+			fprintf(file, " %a", *reinterpret_cast<const float*>(data));
+			break;
+
+		case PMREPLAY_INT:
+			fprintf(file, " %d", *reinterpret_cast<const int*>(data));
+			break;
+
+		case PMREPLAY_VECTOR:
+		{
+			const float* v = reinterpret_cast<const float*>(data);
+			fprintf(file, " %a %a %a", v[0], v[1], v[2]);
+			break;
+		}
+
+		case PMREPLAY_BYTE:
+			fprintf(file, " %d", *data);
+			break;
+
+		case PMREPLAY_SHORT:
+			fprintf(file, " %d", *reinterpret_cast<const short*>(data));
+			break;
+
+		case PMREPLAY_USHORT:
+			fprintf(file, " %d", *reinterpret_cast<const unsigned short*>(data));
+			break;
+		}
+	}
+
+	fputc('\n', file);
+}
+
+bool PMReplay_ReadMove(FILE* file, pmreplay_move_t& move)
+{
+	char buffer[PMREPLAY_MAX_LINE];
+	char* p = PMReplay_ReadLine(file, "move", buffer, sizeof(buffer));
+
+	if (!p)
+		return false;
+
+	memset(&move, 0, sizeof(move));
+
+	for (const auto& field : g_MoveFields)
+	{
+		byte* data = reinterpret_cast<byte*>(&move) + field.offset;
+		char* end;
+
+		switch (field.type)
+		{
+		case PMREPLAY_FLOAT:
+			*reinterpret_cast<float*>(data) = strtof(p, &end);
+			break;
+
+		case PMREPLAY_INT:
+			*reinterpret_cast<int*>(data) = strtol(p, &end, 10);
+			break;
+
+		case PMREPLAY_VECTOR:
+		{
+			float* v = reinterpret_cast<float*>(data);
+			v[0] = strtof(p, &end);
+			v[1] = strtof(end, &end);
+			v[2] = strtof(end, &end);
+			break;
+		}
+
+		case PMREPLAY_BYTE:
+			*data = static_cast<byte>(strtol(p, &end, 10));
+			break;
+
+		case PMREPLAY_SHORT:
+			*reinterpret_cast<short*>(data) = static_cast<short>(strtol(p, &end, 10));
+			break;
+
+		case PMREPLAY_USHORT:
+			*reinterpret_cast<unsigned short*>(data) = static_cast<unsigned short>(strtol(p, &end, 10));
+			break;
+		}
+
+		// Truncated line
+		if (end == p)
+			return false;
+
+		p = end;
+	}
+
+	return true;
+}
+
+bool PMReplay_StartRecording(const char* filename, const char* mapname, int playerIndex)
+{
+	PMReplay_StopRecording();
+
+	g_pRecordFile = fopen(filename, "w");
+
+	if (!g_pRecordFile)
+		return false;
+
+	strncpy(g_szRecordMapName, mapname, sizeof(g_szRecordMapName) - 1);
+	g_szRecordMapName[sizeof(g_szRecordMapName) - 1] = '\0';
+
+	// pmove uses 0 based player indices
+	g_iRecordPlayer = playerIndex - 1;
+	g_bRecordHeaderWritten = false;
+
+	return true;
+}
+
+void PMReplay_StopRecording()
+{
+	if (g_pRecordFile)
+	{
+		fclose(g_pRecordFile);
+		g_pRecordFile = NULL;
+	}
+
+	g_iRecordPlayer = -1;
+}
+
+bool PMReplay_IsRecording()
+{
+	return g_pRecordFile != NULL;
+}
+
+void PMReplay_BeginMove(const playermove_s* pmove)
+{
+	if (!g_pRecordFile || pmove->player_index != g_iRecordPlayer)
+		return;
+
+	// The header needs the physics settings, which are only available from here
+	if (!g_bRecordHeaderWritten)
+	{
+		PMReplay_WriteHeader(g_pRecordFile, g_szRecordMapName, pmove);
+		g_bRecordHeaderWritten = true;
+	}
+
+	PMReplay_Capture(pmove, g_RecordMove);
+}
+
+void PMReplay_EndMove(const playermove_s* pmove)
+{
+	if (!g_pRecordFile || pmove->player_index != g_iRecordPlayer)
+		return;
+
+	g_RecordMove.resultOrigin = pmove->origin;
+	g_RecordMove.resultVelocity = pmove->velocity;
+
+	PMReplay_WriteMove(g_pRecordFile, g_RecordMove);
+}
@@ -0,0 +1,133 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+//
+// pm_replay.h
+//
+
+#pragma once
+
+/**
+*	@file
+*
+*	Recorded player movement, written by the server (sv_pmrecord) and replayed by the pmreplay tool.
+*	A recording is a text file:
+*	@code
+*	pmreplay 1
+*	map <map name>
+*	physinfo <physics info string>
+*	movevars <gravity> <stopspeed> ... <rollspeed> <footsteps>
+*	move <player state before the move> <usercmd> <origin and velocity after the move>
+*	...
+*	@endcode
+*	Floats are written in hexadecimal so they are read back exactly.
+*/
+
+#include <stdio.h>
+
+#include "Platform.h"
+#include "usercmd.h"
+#include "pm_movevars.h"
+
+struct playermove_s;
+
+#define PMREPLAY_VERSION 1
+
+struct pmreplay_header_t
+{
+	char mapname[64];
+	char physinfo[256];
+	movevars_t movevars;
+};
+
+/**
+*	@brief Player state going into one PM_Move call, the usercmd it ran and its result.
+*/
+struct pmreplay_move_t
+{
+	// Set by the engine and the game between moves
+	float time;
+	float frametime;
+	Vector angles;
+	Vector oldangles;
+	Vector basevelocity;
+	Vector punchangle;
+	float gravity;
+	float friction;
+	float maxspeed;
+	float clientmaxspeed;
+	int dead;
+	int deadflag;
+	int spectator;
+	int movetype;
+	int iuser1, iuser2, iuser3, iuser4;
+	float fuser1, fuser2, fuser3, fuser4;
+
+	// Carried over from the previous move
+	Vector origin;
+	Vector velocity;
+	Vector view_ofs;
+	Vector movedir;
+	float flDuckTime;
+	int bInDuck;
+	int flTimeStepSound;
+	int iStepLeft;
+	float flFallVelocity;
+	float flSwimTime;
+	int flags;
+	int usehull;
+	int oldbuttons;
+	float waterjumptime;
+	int onground;
+	int waterlevel;
+	int watertype;
+
+	usercmd_t cmd;
+
+	Vector resultOrigin;
+	Vector resultVelocity;
+};
+
+/**
+*	@brief Copies the state of pmove going into a move.
+*/
+void PMReplay_Capture(const playermove_s* pmove, pmreplay_move_t& move);
+
+/**
+*	@brief Sets up pmove for a recorded move.
+*	@param carryOver Whether to also restore the state that PM_Move carries over from the previous move.
+*		If false, that state is left as the previous replayed move left it.
+*/
+void PMReplay_Apply(const pmreplay_move_t& move, playermove_s* pmove, bool carryOver);
+
+void PMReplay_WriteHeader(FILE* file, const char* mapname, const playermove_s* pmove);
+bool PMReplay_ReadHeader(FILE* file, pmreplay_header_t& header);
+
+void PMReplay_WriteMove(FILE* file, const pmreplay_move_t& move);
+bool PMReplay_ReadMove(FILE* file, pmreplay_move_t& move);
+
+/**
+*	@brief Starts recording the moves of the given player to a file.
+*	@param playerIndex Entity index of the player.
+*/
+bool PMReplay_StartRecording(const char* filename, const char* mapname, int playerIndex);
+void PMReplay_StopRecording();
+bool PMReplay_IsRecording();
+
+/**
+*	@brief Called around PM_Move on the server to record the move if it belongs to the recorded player.
+*/
+void PMReplay_BeginMove(const playermove_s* pmove);
+void PMReplay_EndMove(const playermove_s* pmove);
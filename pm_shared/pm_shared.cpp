@@ -29,6 +29,9 @@
 #include <string.h> // strcpy
 #include <stdlib.h> // atoi
 #include <ctype.h>	// isspace
+#include <stddef.h> // offsetof
+
+#include <vector>
 
 #ifdef CLIENT_DLL
 // Spectator Mode
@@ -145,6 +148,206 @@ static void PM_TraceModel(physent_t* pEnt, const Vector& start, const Vector& en
 	pmove->PM_TraceModel(pEnt, start, end, trace);
 }
 
+/*
+Per-move memo of the engine's trace, point contents and position test results.
+Physents, hulls and the world don't change during a PM_Move call, so a query with the same inputs
+returns the same result. Keys are compared bit for bit so the results are exactly the ones the engine would return.
+The memo is emptied at the start of every PM_Move call.
+*/
+#define PM_MEMO_TRACES 8
+#define PM_MEMO_CONTENTS 8
+#define PM_MEMO_TESTS 4
+
+struct pm_tracememo_t
+{
+	Vector start;
+	Vector end;
+	int hull;
+	int flags;
+	int ignore_pe;
+	pmtrace_t result;
+};
+
+struct pm_contentsmemo_t
+{
+	Vector point;
+	int contents;
+	int truecontents;
+};
+
+struct pm_testmemo_t
+{
+	Vector point;
+	int hull;
+	int hitent;
+	pmtrace_t trace;
+};
+
+static pm_tracememo_t g_TraceMemo[PM_MEMO_TRACES];
+static pm_contentsmemo_t g_ContentsMemo[PM_MEMO_CONTENTS];
+static pm_testmemo_t g_TestMemo[PM_MEMO_TESTS];
+static int g_iTraceMemoCount, g_iContentsMemoCount, g_iTestMemoCount;
+
+static bool g_bTraceMemoEnabled = true;
+static pm_tracestats_t g_TraceStats;
+
+static inline bool PM_SameVector(const Vector& a, const Vector& b)
+{
+	return 0 == memcmp(&a, &b, sizeof(Vector));
+}
+
+static void PM_ClearTraceMemo()
+{
+	g_iTraceMemoCount = 0;
+	g_iContentsMemoCount = 0;
+	g_iTestMemoCount = 0;
+}
+
+/**
+*	@brief pmove->PM_PlayerTrace, but returns the earlier result if the same trace was already done during this move.
+*/
+static pmtrace_t PM_CachedPlayerTrace(const Vector& start, const Vector& end, int traceFlags, int ignore_pe)
+{
+	++g_TraceStats.traces;
+
+	const int count = V_min(g_iTraceMemoCount, PM_MEMO_TRACES);
+
+	for (int i = 0; i < count; ++i)
+	{
+		const pm_tracememo_t& memo = g_TraceMemo[i];
+
+		if (memo.hull == pmove->usehull && memo.flags == traceFlags && memo.ignore_pe == ignore_pe && PM_SameVector(memo.start, start) && PM_SameVector(memo.end, end))
+		{
+			++g_TraceStats.traceHits;
+			return memo.result;
+		}
+	}
+
+	// Copies, the engine takes non-const pointers
+	Vector traceStart = start;
+	Vector traceEnd = end;
+
+	const pmtrace_t result = pmove->PM_PlayerTrace(traceStart, traceEnd, traceFlags, ignore_pe);
+
+	if (g_bTraceMemoEnabled)
+	{
+		// Once full, overwrite the oldest entry
+		pm_tracememo_t& memo = g_TraceMemo[g_iTraceMemoCount++ % PM_MEMO_TRACES];
+		memo.start = start;
+		memo.end = end;
+		memo.hull = pmove->usehull;
+		memo.flags = traceFlags;
+		memo.ignore_pe = ignore_pe;
+		memo.result = result;
+	}
+
+	return result;
+}
+
+/**
+*	@brief pmove->PM_PointContents with the same memo as PM_CachedPlayerTrace.
+*/
+static int PM_CachedPointContents(const Vector& point, int* truecontents)
+{
+	++g_TraceStats.contents;
+
+	const int count = V_min(g_iContentsMemoCount, PM_MEMO_CONTENTS);
+
+	for (int i = 0; i < count; ++i)
+	{
+		const pm_contentsmemo_t& memo = g_ContentsMemo[i];
+
+		if (PM_SameVector(memo.point, point))
+		{
+			++g_TraceStats.contentsHits;
+
+			if (truecontents)
+				*truecontents = memo.truecontents;
+
+			return memo.contents;
+		}
+	}
+
+	Vector contentsPoint = point;
+	int truecont;
+
+	// Always ask for the true contents so the entry can answer both kinds of queries
+	const int contents = pmove->PM_PointContents(contentsPoint, &truecont);
+
+	if (truecontents)
+		*truecontents = truecont;
+
+	if (g_bTraceMemoEnabled)
+	{
+		pm_contentsmemo_t& memo = g_ContentsMemo[g_iContentsMemoCount++ % PM_MEMO_CONTENTS];
+		memo.point = point;
+		memo.contents = contents;
+		memo.truecontents = truecont;
+	}
+
+	return contents;
+}
+
+/**
+*	@brief pmove->PM_TestPlayerPosition with the same memo as PM_CachedPlayerTrace.
+*/
+static int PM_CachedTestPlayerPosition(const Vector& point, pmtrace_t* trace)
+{
+	++g_TraceStats.tests;
+
+	const int count = V_min(g_iTestMemoCount, PM_MEMO_TESTS);
+
+	for (int i = 0; i < count; ++i)
+	{
+		const pm_testmemo_t& memo = g_TestMemo[i];
+
+		if (memo.hull == pmove->usehull && PM_SameVector(memo.point, point))
+		{
+			++g_TraceStats.testHits;
+
+			if (trace)
+				*trace = memo.trace;
+
+			return memo.hitent;
+		}
+	}
+
+	Vector testPoint = point;
+	pmtrace_t testTrace;
+
+	const int hitent = pmove->PM_TestPlayerPosition(testPoint, &testTrace);
+
+	if (trace)
+		*trace = testTrace;
+
+	if (g_bTraceMemoEnabled)
+	{
+		pm_testmemo_t& memo = g_TestMemo[g_iTestMemoCount++ % PM_MEMO_TESTS];
+		memo.point = point;
+		memo.hull = pmove->usehull;
+		memo.hitent = hitent;
+		memo.trace = testTrace;
+	}
+
+	return hitent;
+}
+
+void PM_SetTraceMemoEnabled(bool enabled)
+{
+	g_bTraceMemoEnabled = enabled;
+	PM_ClearTraceMemo();
+}
+
+const pm_tracestats_t& PM_GetTraceStats()
+{
+	return g_TraceStats;
+}
+
+void PM_ResetTraceStats()
+{
+	g_TraceStats = {};
+}
+
 void PM_SwapTextures(int i, int j)
 {
 	char chTemp;
@@ -282,6 +485,81 @@ char PM_FindTextureType(const char* name)
 	return CHAR_TEX_CONCRETE;
 }
 
+/*
+Texture type cache
+
+Engine texture name lookups return a pointer to the name stored with the texture, which stays the same while the map is loaded.
+Types are cached by that pointer, so a footstep or impact on a known texture is a hash table probe instead of a search through
+the materials.txt names. Each entry also keeps a copy of the name to catch a pointer being reused for another texture after a map change.
+*/
+#define PM_TEXTURECACHE_SIZE 2048 // power of 2, 4 times the number of textures a map can have
+#define PM_TEXTURECACHE_NAMELEN 16 // length of texture names in BSP files
+
+struct pm_texturecache_t
+{
+	const char* key;
+	char name[PM_TEXTURECACHE_NAMELEN];
+	char type;
+};
+
+static pm_texturecache_t g_TextureCache[PM_TEXTURECACHE_SIZE];
+static int g_iTextureCacheCount = 0;
+
+const char* PM_StripTextureName(const char* textureName)
+{
+	// strip leading '-0' or '+0~' or '{' or '!'
+	if (*textureName == '-' || *textureName == '+')
+		textureName += 2;
+
+	if (*textureName == '{' || *textureName == '!' || *textureName == '~' || *textureName == ' ')
+		textureName++;
+	// '}}'
+
+	return textureName;
+}
+
+char PM_FindTextureTypeCached(const char* textureName)
+{
+	const uintptr_t hash = reinterpret_cast<uintptr_t>(textureName) * 2654435761u;
+
+	for (uintptr_t i = 0; i < PM_TEXTURECACHE_SIZE; i++)
+	{
+		pm_texturecache_t& entry = g_TextureCache[((hash >> 4) + i) & (PM_TEXTURECACHE_SIZE - 1)];
+
+		if (entry.key == textureName)
+		{
+			if (0 == strncmp(entry.name, textureName, PM_TEXTURECACHE_NAMELEN))
+				return entry.type;
+
+			// Same address, different texture
+			strncpy(entry.name, textureName, PM_TEXTURECACHE_NAMELEN);
+			entry.type = PM_FindTextureType(PM_StripTextureName(textureName));
+			return entry.type;
+		}
+
+		if (!entry.key)
+		{
+			// Leave room so lookups for textures that aren't cached stay short
+			if (g_iTextureCacheCount >= PM_TEXTURECACHE_SIZE / 2)
+				break;
+
+			++g_iTextureCacheCount;
+			entry.key = textureName;
+			strncpy(entry.name, textureName, PM_TEXTURECACHE_NAMELEN);
+			entry.type = PM_FindTextureType(PM_StripTextureName(textureName));
+			return entry.type;
+		}
+	}
+
+	return PM_FindTextureType(PM_StripTextureName(textureName));
+}
+
+void PM_ClearTextureTypeCache()
+{
+	memset(g_TextureCache, 0, sizeof(g_TextureCache));
+	g_iTextureCacheCount = 0;
+}
+
 void PM_PlayStepSound(int step, float fvol)
 {
 	static int iSkipStep = 0;
@@ -552,19 +830,11 @@ void PM_CatagorizeTextureType()
 	if (!pTextureName)
 		return;
 
-	// strip leading '-0' or '+0~' or '{' or '!'
-	if (*pTextureName == '-' || *pTextureName == '+')
-		pTextureName += 2;
-
-	if (*pTextureName == '{' || *pTextureName == '!' || *pTextureName == '~' || *pTextureName == ' ')
-		pTextureName++;
-	// '}}'
-
-	strcpy(pmove->sztexturename, pTextureName);
+	strncpy(pmove->sztexturename, PM_StripTextureName(pTextureName), CBTEXTURENAMEMAX - 1);
 	pmove->sztexturename[CBTEXTURENAMEMAX - 1] = 0;
 
 	// get texture type
-	pmove->chtexturetype = PM_FindTextureType(pmove->sztexturename);
+	pmove->chtexturetype = PM_FindTextureTypeCached(pTextureName);
 }
 
 void PM_UpdateStepSound()
@@ -632,13 +902,13 @@ void PM_UpdateStepSound()
 			fvol = 0.35;
 			pmove->flTimeStepSound = 350;
 		}
-		else if (pmove->PM_PointContents(knee, NULL) == CONTENTS_WATER)
+		else if (PM_CachedPointContents(knee, NULL) == CONTENTS_WATER)
 		{
 			step = STEP_WADE;
 			fvol = 0.65;
 			pmove->flTimeStepSound = 600;
 		}
-		else if (pmove->PM_PointContents(feet, NULL) == CONTENTS_WATER)
+		else if (PM_CachedPointContents(feet, NULL) == CONTENTS_WATER)
 		{
 			step = STEP_SLOSH;
 			fvol = fWalking ? 0.2 : 0.5;
@@ -898,7 +1168,7 @@ int PM_FlyMove()
 			end[i] = pmove->origin[i] + time_left * pmove->velocity[i];
 
 		// See if we can make it from origin to end point.
-		trace = pmove->PM_PlayerTrace(pmove->origin, end, PM_NORMAL, -1);
+		trace = PM_CachedPlayerTrace(pmove->origin, end, PM_NORMAL, -1);
 
 		allFraction += trace.fraction;
 		// If we started in a solid object, or we were in solid space
@@ -1100,10 +1370,10 @@ PM_WalkMove
 Only used by players.  Moves along the ground when player is a MOVETYPE_WALK.
 ======================
 */
+static void PM_WalkMoveTrace();
+
 void PM_WalkMove()
 {
-	int clip;
-	int oldonground;
 	int i;
 
 	Vector wishvel;
@@ -1112,13 +1382,6 @@ void PM_WalkMove()
 	Vector wishdir;
 	float wishspeed;
 
-	Vector dest, start;
-	Vector original, originalvel;
-	Vector down, downvel;
-	float downdist, updist;
-
-	pmtrace_t trace;
-
 	// Copy movement amounts
 	fmove = pmove->cmd.forwardmove;
 	smove = pmove->cmd.sidemove;
@@ -1167,6 +1430,28 @@ void PM_WalkMove()
 	//if (!pmove->velocity[0] && !pmove->velocity[1] && !pmove->velocity[2])
 	//	return;
 
+	PM_WalkMoveTrace();
+}
+
+/*
+=====================
+PM_WalkMoveTrace
+
+Second half of PM_WalkMove: moves the player along the ground using the velocity set up by the first half.
+======================
+*/
+static void PM_WalkMoveTrace()
+{
+	int clip;
+	int oldonground;
+
+	Vector dest, start;
+	Vector original, originalvel;
+	Vector down, downvel;
+	float downdist, updist;
+
+	pmtrace_t trace;
+
 	oldonground = pmove->onground;
 
 	// first try just moving to the destination
@@ -1176,7 +1461,7 @@ void PM_WalkMove()
 
 	// first try moving directly to the next spot
 	VectorCopy(dest, start);
-	trace = pmove->PM_PlayerTrace(pmove->origin, dest, PM_NORMAL, -1);
+	trace = PM_CachedPlayerTrace(pmove->origin, dest, PM_NORMAL, -1);
 	// If we made it all the way, then copy trace end
 	//  as new player position.
 	if (trace.fraction == 1)
@@ -1213,7 +1498,7 @@ void PM_WalkMove()
 	VectorCopy(pmove->origin, dest);
 	dest[2] += pmove->movevars->stepsize;
 
-	trace = pmove->PM_PlayerTrace(pmove->origin, dest, PM_NORMAL, -1);
+	trace = PM_CachedPlayerTrace(pmove->origin, dest, PM_NORMAL, -1);
 	// If we started okay and made it part of the way at least,
 	//  copy the results to the movement start position and then
 	//  run another move try.
@@ -1230,7 +1515,7 @@ void PM_WalkMove()
 	VectorCopy(pmove->origin, dest);
 	dest[2] -= pmove->movevars->stepsize;
 
-	trace = pmove->PM_PlayerTrace(pmove->origin, dest, PM_NORMAL, -1);
+	trace = PM_CachedPlayerTrace(pmove->origin, dest, PM_NORMAL, -1);
 
 	// If we are not on the ground any more then
 	//  use the original movement attempt
@@ -1259,6 +1544,40 @@ void PM_WalkMove()
 		pmove->velocity[2] = downvel[2];
 }
 
+/*
+==================
+PM_GroundFriction
+
+Friction of the ground the player is moving over at the given speed. Edges are more slippery.
+==================
+*/
+static float PM_GroundFriction(float speed)
+{
+	const float* vel = pmove->velocity;
+	float friction;
+	Vector start, stop;
+	pmtrace_t trace;
+
+	start[0] = stop[0] = pmove->origin[0] + vel[0] / speed * 16;
+	start[1] = stop[1] = pmove->origin[1] + vel[1] / speed * 16;
+	start[2] = pmove->origin[2] + pmove->player_mins[pmove->usehull][2];
+	stop[2] = start[2] - 34;
+
+	trace = PM_CachedPlayerTrace(start, stop, PM_NORMAL, -1);
+
+	if (trace.fraction == 1.0)
+		friction = pmove->movevars->friction * pmove->movevars->edgefriction;
+	else
+		friction = pmove->movevars->friction;
+
+	// Grab friction value.
+	//friction = pmove->movevars->friction;
+
+	friction *= pmove->friction; // player friction?
+
+	return friction;
+}
+
 /*
 ==================
 PM_Friction
@@ -1295,25 +1614,7 @@ void PM_Friction()
 	// apply ground friction
 	if (pmove->onground != -1) // On an entity that is the ground
 	{
-		Vector start, stop;
-		pmtrace_t trace;
-
-		start[0] = stop[0] = pmove->origin[0] + vel[0] / speed * 16;
-		start[1] = stop[1] = pmove->origin[1] + vel[1] / speed * 16;
-		start[2] = pmove->origin[2] + pmove->player_mins[pmove->usehull][2];
-		stop[2] = start[2] - 34;
-
-		trace = pmove->PM_PlayerTrace(start, stop, PM_NORMAL, -1);
-
-		if (trace.fraction == 1.0)
-			friction = pmove->movevars->friction * pmove->movevars->edgefriction;
-		else
-			friction = pmove->movevars->friction;
-
-		// Grab friction value.
-		//friction = pmove->movevars->friction;
-
-		friction *= pmove->friction; // player friction?
+		friction = PM_GroundFriction(speed);
 
 		// Bleed off some speed, but if we have less than the bleed
 		//  threshhold, bleed the theshold amount.
@@ -1462,7 +1763,7 @@ void PM_WaterMove()
 	VectorMA(pmove->origin, pmove->frametime, pmove->velocity, dest);
 	VectorCopy(dest, start);
 	start[2] += pmove->movevars->stepsize + 1;
-	trace = pmove->PM_PlayerTrace(start, dest, PM_NORMAL, -1);
+	trace = PM_CachedPlayerTrace(start, dest, PM_NORMAL, -1);
 	if (0 == trace.startsolid && 0 == trace.allsolid) // FIXME: check steep slope?
 	{												  // walked up the step, so just keep result and exit
 		VectorCopy(trace.endpos, pmove->origin);
@@ -1556,7 +1857,7 @@ bool PM_CheckWater()
 	pmove->watertype = CONTENTS_EMPTY;
 
 	// Grab point contents.
-	cont = pmove->PM_PointContents(point, &truecont);
+	cont = PM_CachedPointContents(point, &truecont);
 	// Are we under water? (not solid and not empty?)
 	if (cont <= CONTENTS_WATER && cont > CONTENTS_TRANSLUCENT)
 	{
@@ -1571,7 +1872,7 @@ bool PM_CheckWater()
 
 		// Now check a point that is at the player hull midpoint.
 		point[2] = pmove->origin[2] + heightover2;
-		cont = pmove->PM_PointContents(point, NULL);
+		cont = PM_CachedPointContents(point, NULL);
 		// If that point is also under water...
 		if (cont <= CONTENTS_WATER && cont > CONTENTS_TRANSLUCENT)
 		{
@@ -1581,7 +1882,7 @@ bool PM_CheckWater()
 			// Now check the eye position.  (view_ofs is relative to the origin)
 			point[2] = pmove->origin[2] + pmove->view_ofs[2];
 
-			cont = pmove->PM_PointContents(point, NULL);
+			cont = PM_CachedPointContents(point, NULL);
 			if (cont <= CONTENTS_WATER && cont > CONTENTS_TRANSLUCENT)
 				pmove->waterlevel = 3; // In over our eyes
 		}
@@ -1636,7 +1937,7 @@ void PM_CatagorizePosition()
 	else
 	{
 		// Try and move down.
-		tr = pmove->PM_PlayerTrace(pmove->origin, point, PM_NORMAL, -1);
+		tr = PM_CachedPlayerTrace(pmove->origin, point, PM_NORMAL, -1);
 		// If we hit a steep plane, we are not on ground
 		if (tr.plane.normal[2] < 0.7)
 			pmove->onground = -1; // too steep
@@ -1716,7 +2017,7 @@ bool PM_TryToUnstuck(Vector base)
 				test[1] += y;
 				test[2] += z;
 
-				if (pmove->PM_TestPlayerPosition(test, NULL) == -1)
+				if (PM_CachedTestPlayerPosition(test, NULL) == -1)
 				{
 					VectorCopy(test, pmove->origin);
 					return false;
@@ -1740,7 +2041,7 @@ bool PM_CheckStuck()
 	static float rgStuckCheckTime[MAX_PLAYERS][2]; // Last time we did a full
 
 	// If position is okay, exit
-	hitent = pmove->PM_TestPlayerPosition(pmove->origin, &traceresult);
+	hitent = PM_CachedTestPlayerPosition(pmove->origin, &traceresult);
 	if (hitent == -1)
 	{
 		PM_ResetStuckOffsets(pmove->player_index, pmove->server);
@@ -1765,7 +2066,7 @@ bool PM_CheckStuck()
 				i = PM_GetRandomStuckOffsets(pmove->player_index, pmove->server, offset);
 
 				VectorAdd(base, offset, test);
-				if (pmove->PM_TestPlayerPosition(test, &traceresult) == -1)
+				if (PM_CachedTestPlayerPosition(test, &traceresult) == -1)
 				{
 					PM_ResetStuckOffsets(pmove->player_index, pmove->server);
 
@@ -1798,7 +2099,7 @@ bool PM_CheckStuck()
 	i = PM_GetRandomStuckOffsets(pmove->player_index, pmove->server, offset);
 
 	VectorAdd(base, offset, test);
-	if ((hitent = pmove->PM_TestPlayerPosition(test, NULL)) == -1)
+	if ((hitent = PM_CachedTestPlayerPosition(test, NULL)) == -1)
 	{
 		//Con_DPrintf("Nudged\n");
 
@@ -1993,7 +2294,7 @@ void PM_FixPlayerCrouchStuck(int direction)
 	int i;
 	Vector test;
 
-	hitent = pmove->PM_TestPlayerPosition(pmove->origin, NULL);
+	hitent = PM_CachedTestPlayerPosition(pmove->origin, NULL);
 	if (hitent == -1)
 		return;
 
@@ -2001,7 +2302,7 @@ void PM_FixPlayerCrouchStuck(int direction)
 	for (i = 0; i < 36; i++)
 	{
 		pmove->origin[2] += direction;
-		hitent = pmove->PM_TestPlayerPosition(pmove->origin, NULL);
+		hitent = PM_CachedTestPlayerPosition(pmove->origin, NULL);
 		if (hitent == -1)
 			return;
 	}
@@ -2025,14 +2326,14 @@ void PM_UnDuck()
 		}
 	}
 
-	trace = pmove->PM_PlayerTrace(newOrigin, newOrigin, PM_NORMAL, -1);
+	trace = PM_CachedPlayerTrace(newOrigin, newOrigin, PM_NORMAL, -1);
 
 	if (0 == trace.startsolid)
 	{
 		pmove->usehull = 0;
 
 		// Oh, no, changing hulls stuck us into something, try unsticking downward first.
-		trace = pmove->PM_PlayerTrace(newOrigin, newOrigin, PM_NORMAL, -1);
+		trace = PM_CachedPlayerTrace(newOrigin, newOrigin, PM_NORMAL, -1);
 		if (0 != trace.startsolid)
 		{
 			// See if we are stuck?  If so, stay ducked with the duck hull until we have a clear spot
@@ -2171,7 +2472,7 @@ void PM_LadderMove(physent_t* pLadder)
 	VectorCopy(pmove->origin, floor);
 	floor[2] += pmove->player_mins[pmove->usehull][2] - 1;
 
-	const bool onFloor = pmove->PM_PointContents(floor, NULL) == CONTENTS_SOLID;
+	const bool onFloor = PM_CachedPointContents(floor, NULL) == CONTENTS_SOLID;
 
 	pmove->gravity = 0;
 	PM_TraceModel(pLadder, pmove->origin, ladderCenter, &trace);
@@ -2361,7 +2662,7 @@ pmtrace_t PM_PushEntity(Vector push)
 
 	VectorAdd(pmove->origin, push, end);
 
-	trace = pmove->PM_PlayerTrace(pmove->origin, end, PM_NORMAL, -1);
+	trace = PM_CachedPlayerTrace(pmove->origin, end, PM_NORMAL, -1);
 
 	VectorCopy(trace.endpos, pmove->origin);
 
@@ -2747,14 +3048,14 @@ void PM_CheckWaterJump()
 	// Trace, this trace should use the point sized collision hull
 	savehull = pmove->usehull;
 	pmove->usehull = 2;
-	tr = pmove->PM_PlayerTrace(vecStart, vecEnd, PM_NORMAL, -1);
+	tr = PM_CachedPlayerTrace(vecStart, vecEnd, PM_NORMAL, -1);
 	if (tr.fraction < 1.0 && fabs(tr.plane.normal[2]) < 0.1f) // Facing a near vertical wall?
 	{
 		vecStart[2] += pmove->player_maxs[savehull][2] - WJ_HEIGHT;
 		VectorMA(vecStart, 24, flatforward, vecEnd);
 		VectorMA(vec3_origin, -50, tr.plane.normal, pmove->movedir);
 
-		tr = pmove->PM_PlayerTrace(vecStart, vecEnd, PM_NORMAL, -1);
+		tr = PM_CachedPlayerTrace(vecStart, vecEnd, PM_NORMAL, -1);
 		if (tr.fraction == 1.0)
 		{
 			pmove->waterjumptime = 2000;
@@ -3037,9 +3338,19 @@ Numtouch and touchindex[] will be set if any of the physents
 were contacted during the move.
 =============
 */
-void PM_PlayerMove(qboolean server)
+/*
+=============
+PM_PlayerMoveBegin
+
+Everything PM_PlayerMove does before the movetype specific movement.
+Returns false if the move is already over.
+=============
+*/
+static void PM_WalkMoveFinish();
+
+static bool PM_PlayerMoveBegin(qboolean server, physent_t*& pLadder)
 {
-	physent_t* pLadder = NULL;
+	pLadder = NULL;
 
 	// Are we running server code?
 	pmove->server = server;
@@ -3065,7 +3376,7 @@ void PM_PlayerMove(qboolean server)
 	{
 		PM_SpectatorMove();
 		PM_CatagorizePosition();
-		return;
+		return false;
 	}
 
 	// Always try and unstick us unless we are in NOCLIP mode
@@ -3078,7 +3389,7 @@ void PM_PlayerMove(qboolean server)
 
 			if (PM_CheckStuck())
 			{
-				return; // Can't move, we're stuck
+				return false; // Can't move, we're stuck
 			}
 		}
 	}
@@ -3126,6 +3437,18 @@ void PM_PlayerMove(qboolean server)
 		}
 	}
 
+	return true;
+}
+
+/*
+=============
+PM_PlayerMoveByType
+
+The movetype specific part of PM_PlayerMove.
+=============
+*/
+static void PM_PlayerMoveByType(physent_t* pLadder)
+{
 	// Handle movement
 	switch (pmove->movetype)
 	{
@@ -3258,37 +3581,59 @@ void PM_PlayerMove(qboolean server)
 				PM_AirMove(); // Take into account movement when in air.
 			}
 
-			// Set final flags.
-			PM_CatagorizePosition();
+			PM_WalkMoveFinish();
+		}
 
-			// Now pull the base velocity back out.
-			// Base velocity is set if you are on a moving object, like
-			//  a conveyor (or maybe another monster?)
-			VectorSubtract(pmove->velocity, pmove->basevelocity, pmove->velocity);
+		// Did we enter or leave the water?
+		PM_PlayWaterSounds();
+		break;
+	}
+}
 
-			// Make sure velocity is valid.
-			PM_CheckVelocity();
+/*
+=============
+PM_WalkMoveFinish
 
-			// Add any remaining gravitational component.
-			if (!PM_InWater())
-			{
-				PM_FixupGravityVelocity();
-			}
+End of a walking or falling move outside of water.
+=============
+*/
+static void PM_WalkMoveFinish()
+{
+	// Set final flags.
+	PM_CatagorizePosition();
 
-			// If we are on ground, no downward velocity.
-			if (pmove->onground != -1)
-			{
-				pmove->velocity[2] = 0;
-			}
+	// Now pull the base velocity back out.
+	// Base velocity is set if you are on a moving object, like
+	//  a conveyor (or maybe another monster?)
+	VectorSubtract(pmove->velocity, pmove->basevelocity, pmove->velocity);
 
-			// See if we landed on the ground with enough force to play
-			//  a landing sound.
-			PM_CheckFalling();
-		}
+	// Make sure velocity is valid.
+	PM_CheckVelocity();
 
-		// Did we enter or leave the water?
-		PM_PlayWaterSounds();
-		break;
+	// Add any remaining gravitational component.
+	if (!PM_InWater())
+	{
+		PM_FixupGravityVelocity();
+	}
+
+	// If we are on ground, no downward velocity.
+	if (pmove->onground != -1)
+	{
+		pmove->velocity[2] = 0;
+	}
+
+	// See if we landed on the ground with enough force to play
+	//  a landing sound.
+	PM_CheckFalling();
+}
+
+void PM_PlayerMove(qboolean server)
+{
+	physent_t* pLadder;
+
+	if (PM_PlayerMoveBegin(server, pLadder))
+	{
+		PM_PlayerMoveByType(pLadder);
 	}
 }
 
@@ -3409,14 +3754,30 @@ invoked by each side as appropriate.  There should be no distinction, internally
 and client.  This will ensure that prediction behaves appropriately.
 */
 
+static void PM_MoveFinish();
+
 void PM_Move(struct playermove_s* ppmove, qboolean server)
 {
 	assert(pm_shared_initialized);
 
 	pmove = ppmove;
 
+	PM_ClearTraceMemo();
+
 	PM_PlayerMove(server);
 
+	PM_MoveFinish();
+}
+
+/*
+=============
+PM_MoveFinish
+
+Updates the flags and resets friction after a move.
+=============
+*/
+static void PM_MoveFinish()
+{
 	if (pmove->onground != -1)
 	{
 		pmove->flags |= FL_ONGROUND;
@@ -3493,3 +3854,510 @@ bool PM_GetHullBounds(int hullnumber, float* mins, float* maxs)
 
 	return false;
 }
+
+/*
+Batched movement
+
+PM_MoveBatch runs the moves of several players that share the same world (physents, movevars and callbacks).
+Players walking or falling outside of water take a split path: the math that doesn't trace (gravity, friction,
+acceleration and velocity checks) runs as loops over arrays of all those players at once, and each player is swapped
+into pmove only for the parts that trace. Every other player runs the regular PM_PlayerMove.
+The loops use the same expressions in the same order as the scalar functions, so results match PM_Move exactly.
+*/
+
+// Size of the part of playermove_t that holds the state of one player
+#define PM_BATCH_STATE_SIZE offsetof(playermove_t, numphysent)
+
+struct pm_batchplayer_t
+{
+	byte state[PM_BATCH_STATE_SIZE];
+	usercmd_t cmd;
+	char physinfo[MAX_PHYSINFO_STRING];
+	std::vector<pmtrace_t> touches;
+
+	// Index into the lane arrays if this player is on the batched path, -1 otherwise
+	int lane;
+};
+
+struct pm_batch_s
+{
+	int count;
+	int numBatched;
+	pm_batchplayer_t players[PM_BATCH_MAX_PLAYERS];
+
+	// Players on the batched path, one lane each
+	int numLanes;
+	int player[PM_BATCH_MAX_PLAYERS];
+
+	// Kept here while the player is swapped out, written back to pmove when swapped in
+	float velocity[3][PM_BATCH_MAX_PLAYERS];
+	float basevelocity[3][PM_BATCH_MAX_PLAYERS];
+	float origin[3][PM_BATCH_MAX_PLAYERS];
+	float forward[3][PM_BATCH_MAX_PLAYERS];
+	float right[3][PM_BATCH_MAX_PLAYERS];
+
+	// Copied out when the player is swapped out, not changed by the batched code
+	float frametime[PM_BATCH_MAX_PLAYERS];
+	float gravity[PM_BATCH_MAX_PLAYERS];
+	float friction[PM_BATCH_MAX_PLAYERS];
+	float maxspeed[PM_BATCH_MAX_PLAYERS];
+	float waterjumptime[PM_BATCH_MAX_PLAYERS];
+	float forwardmove[PM_BATCH_MAX_PLAYERS];
+	float sidemove[PM_BATCH_MAX_PLAYERS];
+	int dead[PM_BATCH_MAX_PLAYERS];
+	int onground[PM_BATCH_MAX_PLAYERS];
+
+	// Ground friction
+	bool applyFriction[PM_BATCH_MAX_PLAYERS];
+	float speed[PM_BATCH_MAX_PLAYERS];
+	float groundFriction[PM_BATCH_MAX_PLAYERS];
+
+	// Whether the player still has to be moved through the world after accelerating
+	bool moving[PM_BATCH_MAX_PLAYERS];
+};
+
+pm_batch_s* PM_AllocBatch()
+{
+	pm_batch_s* batch = new pm_batch_s;
+	batch->count = 0;
+	batch->numBatched = 0;
+	batch->numLanes = 0;
+	return batch;
+}
+
+void PM_FreeBatch(pm_batch_s* batch)
+{
+	delete batch;
+}
+
+void PM_BatchSetCount(pm_batch_s* batch, int count)
+{
+	batch->count = V_max(0, V_min(count, PM_BATCH_MAX_PLAYERS));
+}
+
+int PM_BatchGetCount(const pm_batch_s* batch)
+{
+	return batch->count;
+}
+
+int PM_BatchNumBatched(const pm_batch_s* batch)
+{
+	return batch->numBatched;
+}
+
+void PM_BatchSetPlayer(pm_batch_s* batch, int index, const playermove_s* state)
+{
+	pm_batchplayer_t& player = batch->players[index];
+
+	memcpy(player.state, state, PM_BATCH_STATE_SIZE);
+	player.cmd = state->cmd;
+	memcpy(player.physinfo, state->physinfo, sizeof(player.physinfo));
+	player.touches.clear();
+	player.lane = -1;
+}
+
+void PM_BatchGetPlayer(const pm_batch_s* batch, int index, playermove_s* state)
+{
+	const pm_batchplayer_t& player = batch->players[index];
+
+	memcpy(state, player.state, PM_BATCH_STATE_SIZE);
+	state->cmd = player.cmd;
+	memcpy(state->physinfo, player.physinfo, sizeof(player.physinfo));
+	state->numtouch = static_cast<int>(player.touches.size());
+
+	if (!player.touches.empty())
+		memcpy(state->touchindex, player.touches.data(), player.touches.size() * sizeof(pmtrace_t));
+}
+
+/**
+*	@brief Swaps a player into pmove.
+*/
+static void PM_BatchLoad(pm_batch_s* batch, int index)
+{
+	PM_BatchGetPlayer(batch, index, pmove);
+
+	// Entries from other players are rarely hit again, so don't make this player's lookups go through them
+	PM_ClearTraceMemo();
+
+	const int lane = batch->players[index].lane;
+
+	if (lane != -1)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			pmove->velocity[i] = batch->velocity[i][lane];
+			pmove->basevelocity[i] = batch->basevelocity[i][lane];
+			pmove->origin[i] = batch->origin[i][lane];
+			pmove->forward[i] = batch->forward[i][lane];
+			pmove->right[i] = batch->right[i][lane];
+		}
+
+		// Batched players aren't on a ladder
+		g_onladder = false;
+	}
+}
+
+/**
+*	@brief Swaps the player in pmove back out.
+*/
+static void PM_BatchStore(pm_batch_s* batch, int index)
+{
+	pm_batchplayer_t& player = batch->players[index];
+
+	// The movement code doesn't change physinfo
+	memcpy(player.state, pmove, PM_BATCH_STATE_SIZE);
+	player.cmd = pmove->cmd;
+	player.touches.assign(pmove->touchindex, pmove->touchindex + pmove->numtouch);
+
+	const int lane = player.lane;
+
+	if (lane != -1)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			batch->velocity[i][lane] = pmove->velocity[i];
+			batch->basevelocity[i][lane] = pmove->basevelocity[i];
+			batch->origin[i][lane] = pmove->origin[i];
+			batch->forward[i][lane] = pmove->forward[i];
+			batch->right[i][lane] = pmove->right[i];
+		}
+
+		batch->frametime[lane] = pmove->frametime;
+		batch->gravity[lane] = pmove->gravity;
+		batch->friction[lane] = pmove->friction;
+		batch->maxspeed[lane] = pmove->maxspeed;
+		batch->waterjumptime[lane] = pmove->waterjumptime;
+		batch->forwardmove[lane] = pmove->cmd.forwardmove;
+		batch->sidemove[lane] = pmove->cmd.sidemove;
+		batch->dead[lane] = pmove->dead;
+		batch->onground[lane] = pmove->onground;
+	}
+}
+
+/**
+*	@brief PM_CheckVelocity for all lanes.
+*	Values in range are left alone, lanes with anything out of range or invalid go through PM_CheckVelocity itself.
+*/
+static void PM_BatchCheckVelocity(pm_batch_s* batch)
+{
+	const float maxvelocity = pmove->movevars->maxvelocity;
+
+	for (int lane = 0; lane < batch->numLanes; lane++)
+	{
+		bool valid = true;
+
+		for (int i = 0; i < 3; i++)
+		{
+			const float vel = batch->velocity[i][lane];
+			const float org = batch->origin[i][lane];
+
+			// Fails for NaN as well as out of range values, x - x is only 0 for finite values
+			valid = valid && vel >= -maxvelocity && vel <= maxvelocity && org - org == 0;
+		}
+
+		if (valid)
+			continue;
+
+		const Vector savedVelocity = pmove->velocity;
+		const Vector savedOrigin = pmove->origin;
+
+		for (int i = 0; i < 3; i++)
+		{
+			pmove->velocity[i] = batch->velocity[i][lane];
+			pmove->origin[i] = batch->origin[i][lane];
+		}
+
+		PM_CheckVelocity();
+
+		for (int i = 0; i < 3; i++)
+		{
+			batch->velocity[i][lane] = pmove->velocity[i];
+			batch->origin[i][lane] = pmove->origin[i];
+		}
+
+		pmove->velocity = savedVelocity;
+		pmove->origin = savedOrigin;
+	}
+}
+
+/**
+*	@brief PM_AddCorrectGravity for all lanes. Batched players are never in a water jump.
+*/
+static void PM_BatchAddCorrectGravity(pm_batch_s* batch)
+{
+	const float gravity = pmove->movevars->gravity;
+
+	float* velz = batch->velocity[2];
+	float* basevelz = batch->basevelocity[2];
+
+	for (int lane = 0; lane < batch->numLanes; lane++)
+	{
+		float ent_gravity;
+
+		if (0 != batch->gravity[lane])
+			ent_gravity = batch->gravity[lane];
+		else
+			ent_gravity = 1.0;
+
+		velz[lane] -= (ent_gravity * gravity * 0.5 * batch->frametime[lane]);
+		velz[lane] += basevelz[lane] * batch->frametime[lane];
+		basevelz[lane] = 0;
+	}
+
+	PM_BatchCheckVelocity(batch);
+}
+
+/**
+*	@brief The part of PM_Friction after the ground friction trace.
+*/
+static void PM_BatchFriction(pm_batch_s* batch)
+{
+	const float stopspeed = pmove->movevars->stopspeed;
+
+	for (int lane = 0; lane < batch->numLanes; lane++)
+	{
+		if (!batch->applyFriction[lane])
+			continue;
+
+		const float speed = batch->speed[lane];
+		float control, drop, newspeed;
+
+		drop = 0;
+
+		control = (speed < stopspeed) ? stopspeed : speed;
+		drop += control * batch->groundFriction[lane] * batch->frametime[lane];
+
+		newspeed = speed - drop;
+		if (newspeed < 0)
+			newspeed = 0;
+
+		newspeed /= speed;
+
+		for (int i = 0; i < 3; i++)
+			batch->velocity[i][lane] = batch->velocity[i][lane] * newspeed;
+	}
+}
+
+/**
+*	@brief The parts of PM_WalkMove and PM_AirMove before the player is moved through the world.
+*/
+static void PM_BatchAccelerate(pm_batch_s* batch)
+{
+	const float accelerate = pmove->movevars->accelerate;
+	const float airaccelerate = pmove->movevars->airaccelerate;
+
+	for (int lane = 0; lane < batch->numLanes; lane++)
+	{
+		Vector forward{batch->forward[0][lane], batch->forward[1][lane], batch->forward[2][lane]};
+		Vector right{batch->right[0][lane], batch->right[1][lane], batch->right[2][lane]};
+		Vector velocity{batch->velocity[0][lane], batch->velocity[1][lane], batch->velocity[2][lane]};
+
+		const float fmove = batch->forwardmove[lane];
+		const float smove = batch->sidemove[lane];
+		const bool walking = batch->onground[lane] != -1;
+
+		// Zero out z components of movement vectors
+		forward[2] = 0;
+		right[2] = 0;
+
+		VectorNormalize(forward);
+		VectorNormalize(right);
+
+		Vector wishvel;
+
+		for (int i = 0; i < 2; i++)
+			wishvel[i] = forward[i] * fmove + right[i] * smove;
+
+		wishvel[2] = 0;
+
+		Vector wishdir;
+		VectorCopy(wishvel, wishdir);
+		float wishspeed = VectorNormalize(wishdir);
+
+		// Clamp to server defined max speed
+		if (wishspeed > batch->maxspeed[lane])
+		{
+			VectorScale(wishvel, batch->maxspeed[lane] / wishspeed, wishvel);
+			wishspeed = batch->maxspeed[lane];
+		}
+
+		const bool canAccelerate = 0 == batch->dead[lane] && 0 == batch->waterjumptime[lane];
+
+		if (walking)
+		{
+			// PM_Accelerate
+			velocity[2] = 0;
+
+			if (canAccelerate)
+			{
+				const float currentspeed = DotProduct(velocity, wishdir);
+				const float addspeed = wishspeed - currentspeed;
+
+				if (addspeed > 0)
+				{
+					float accelspeed = accelerate * batch->frametime[lane] * wishspeed * batch->friction[lane];
+
+					if (accelspeed > addspeed)
+						accelspeed = addspeed;
+
+					for (int i = 0; i < 3; i++)
+						velocity[i] += accelspeed * wishdir[i];
+				}
+			}
+
+			velocity[2] = 0;
+		}
+		else if (canAccelerate)
+		{
+			// PM_AirAccelerate
+			float wishspd = wishspeed;
+
+			if (wishspd > 30)
+				wishspd = 30;
+
+			const float currentspeed = DotProduct(velocity, wishdir);
+			const float addspeed = wishspd - currentspeed;
+
+			if (addspeed > 0)
+			{
+				float accelspeed = airaccelerate * wishspeed * batch->frametime[lane] * batch->friction[lane];
+
+				if (accelspeed > addspeed)
+					accelspeed = addspeed;
+
+				for (int i = 0; i < 3; i++)
+					velocity[i] += accelspeed * wishdir[i];
+			}
+		}
+
+		// Add in any base velocity to the current velocity.
+		for (int i = 0; i < 3; i++)
+			velocity[i] = velocity[i] + batch->basevelocity[i][lane];
+
+		batch->moving[lane] = true;
+
+		if (walking && Length(velocity) < 1.0f)
+		{
+			VectorClear(velocity);
+			batch->moving[lane] = false;
+		}
+
+		for (int i = 0; i < 3; i++)
+		{
+			batch->forward[i][lane] = forward[i];
+			batch->right[i][lane] = right[i];
+			batch->velocity[i][lane] = velocity[i];
+		}
+	}
+}
+
+void PM_MoveBatch(playermove_s* ppmove, pm_batch_s* batch, qboolean server)
+{
+	assert(pm_shared_initialized);
+
+	pmove = ppmove;
+
+	batch->numLanes = 0;
+
+	// Everything up to the movement itself, and the whole move for players that don't take the batched path
+	for (int i = 0; i < batch->count; i++)
+	{
+		batch->players[i].lane = -1;
+
+		PM_BatchLoad(batch, i);
+
+		physent_t* pLadder;
+
+		if (PM_PlayerMoveBegin(server, pLadder))
+		{
+			if (pmove->movetype == MOVETYPE_WALK && !pLadder && !PM_InWater() && 0 == pmove->waterjumptime)
+			{
+				batch->players[i].lane = batch->numLanes;
+				batch->player[batch->numLanes++] = i;
+				PM_BatchStore(batch, i);
+				continue;
+			}
+
+			PM_PlayerMoveByType(pLadder);
+		}
+
+		PM_MoveFinish();
+		PM_BatchStore(batch, i);
+	}
+
+	batch->numBatched = batch->numLanes;
+
+	PM_BatchAddCorrectGravity(batch);
+
+	// Jumping and the ground friction trace
+	for (int lane = 0; lane < batch->numLanes; lane++)
+	{
+		const int i = batch->player[lane];
+
+		PM_BatchLoad(batch, i);
+
+		// Was jump button pressed?
+		if ((pmove->cmd.buttons & IN_JUMP) != 0)
+		{
+			PM_Jump();
+		}
+		else
+		{
+			pmove->oldbuttons &= ~IN_JUMP;
+		}
+
+		batch->applyFriction[lane] = false;
+
+		// Fricion is handled before we add in any base velocity.
+		if (pmove->onground != -1)
+		{
+			pmove->velocity[2] = 0.0;
+
+			// PM_Friction up to the friction value
+			if (0 == pmove->waterjumptime)
+			{
+				const float* vel = pmove->velocity;
+				const float speed = sqrt(vel[0] * vel[0] + vel[1] * vel[1] + vel[2] * vel[2]);
+
+				if (speed >= 0.1f)
+				{
+					batch->applyFriction[lane] = true;
+					batch->speed[lane] = speed;
+					batch->groundFriction[lane] = PM_GroundFriction(speed);
+				}
+			}
+		}
+
+		PM_BatchStore(batch, i);
+	}
+
+	PM_BatchFriction(batch);
+	PM_BatchCheckVelocity(batch);
+	PM_BatchAccelerate(batch);
+
+	// Move through the world and finish the move
+	for (int lane = 0; lane < batch->numLanes; lane++)
+	{
+		const int i = batch->player[lane];
+
+		PM_BatchLoad(batch, i);
+
+		if (batch->moving[lane])
+		{
+			if (pmove->onground != -1)
+				PM_WalkMoveTrace();
+			else
+				PM_FlyMove();
+		}
+
+		PM_WalkMoveFinish();
+
+		// Did we enter or leave the water?
+		PM_PlayWaterSounds();
+
+		PM_MoveFinish();
+
+		batch->players[i].lane = -1;
+		PM_BatchStore(batch, i);
+	}
+}
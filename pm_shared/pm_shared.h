@@ -27,11 +27,85 @@ void PM_Init(playermove_s* ppmove);
 void PM_Move(playermove_s* ppmove, qboolean server);
 char PM_FindTextureType(const char* name);
 
+/**
+*	@brief Skips the prefixes of random tiling, animated, transparent and water textures.
+*/
+const char* PM_StripTextureName(const char* textureName);
+
+/**
+*	@brief Texture type of a texture name as returned by the engine's trace texture functions, prefixes included.
+*	Results are cached by the address of the name.
+*/
+char PM_FindTextureTypeCached(const char* textureName);
+
+/**
+*	@brief Empties the texture type cache. Call on map change.
+*/
+void PM_ClearTextureTypeCache();
+
 /**
 *	@brief Engine calls this to enumerate player collision hulls, for prediction. Return false if the hullnumber doesn't exist.
 */
 bool PM_GetHullBounds(int hullnumber, float* mins, float* maxs);
 
+/**
+*	@brief Number of engine trace, point contents and position test calls made by PM_Move,
+*	and how many of them were answered from the per-move memo instead.
+*/
+struct pm_tracestats_t
+{
+	unsigned int traces;
+	unsigned int traceHits;
+	unsigned int contents;
+	unsigned int contentsHits;
+	unsigned int tests;
+	unsigned int testHits;
+};
+
+/**
+*	@brief Enables or disables the per-move trace memo. Enabled by default. Results are the same either way.
+*/
+void PM_SetTraceMemoEnabled(bool enabled);
+
+const pm_tracestats_t& PM_GetTraceStats();
+void PM_ResetTraceStats();
+
+#define PM_BATCH_MAX_PLAYERS 64
+
+/**
+*	@brief Player states for PM_MoveBatch.
+*	Each player has the part of playermove_s that belongs to one player: everything before the physents,
+*	the usercmd, the physics info string and the touched entities.
+*/
+struct pm_batch_s;
+
+pm_batch_s* PM_AllocBatch();
+void PM_FreeBatch(pm_batch_s* batch);
+
+void PM_BatchSetCount(pm_batch_s* batch, int count);
+int PM_BatchGetCount(const pm_batch_s* batch);
+
+/**
+*	@brief Copies the state of a player into the batch. Clears its touched entities.
+*/
+void PM_BatchSetPlayer(pm_batch_s* batch, int index, const playermove_s* state);
+
+/**
+*	@brief Copies the state of a player, including the entities it touched during the last move, out of the batch.
+*/
+void PM_BatchGetPlayer(const pm_batch_s* batch, int index, playermove_s* state);
+
+/**
+*	@brief Number of players that took the batched path during the last PM_MoveBatch.
+*/
+int PM_BatchNumBatched(const pm_batch_s* batch);
+
+/**
+*	@brief Runs one move for every player in the batch. Gives the same results as calling PM_Move for each player.
+*	@param ppmove Shared by all players: physents, movevars and callbacks. Its player state is overwritten.
+*/
+void PM_MoveBatch(playermove_s* ppmove, pm_batch_s* batch, qboolean server);
+
 // Spectator Movement modes (stored in pev->iuser1, so the physics code can get at them)
 #define OBS_NONE 0
 #define OBS_CHASE_LOCKED 1
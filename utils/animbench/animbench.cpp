@@ -0,0 +1,752 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+****/
+
+// animbench.cpp: decodes every frame of every sequence of studio models through both the run length encoded animation data
+// and the animation cache (see studio_animcache.h), checks that they agree and times them.
+// With -kernels it also times the SSE2 bone kernels (see studio_simd.h) against the scalar functions on the decoded poses.
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "Platform.h"
+#include "mathlib.h"
+#include "studio_animcache.h"
+#include "studio_simd.h"
+
+// From studiomdl.h
+#define STUDIO_VERSION 10
+#define IDSTUDIOHEADER (('T' << 24) + ('S' << 16) + ('D' << 8) + 'I')
+
+struct modelfile_t
+{
+	std::string name;
+	std::vector<byte> header;
+
+	// Sequence groups, the first is the model itself
+	std::vector<std::vector<byte>> groups;
+};
+
+struct benchresult_t
+{
+	unsigned int bones;
+	unsigned int mismatches;
+	long long referenceTime;
+	long long coldTime;
+	long long cachedTime;
+};
+
+static int g_Steps = 4;
+static int g_Repeat = 10;
+
+// Most bone evaluations of a model the kernel benchmark uses
+#define KERNEL_MAX_BONES 65536
+
+// Fraction the kernel benchmark interpolates the two frames of a pose at
+#define KERNEL_SLERP_FRACTION 0.25f
+
+static bool LoadFile(const std::string& filename, std::vector<byte>& data)
+{
+	FILE* file = fopen(filename.c_str(), "rb");
+
+	if (!file)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	const long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	data.resize(length);
+
+	const bool success = length > 0 && fread(data.data(), length, 1, file) == 1;
+
+	fclose(file);
+
+	return success;
+}
+
+static bool LoadModel(const char* filename, modelfile_t& model)
+{
+	model.name = filename;
+
+	if (!LoadFile(filename, model.header) || model.header.size() < sizeof(studiohdr_t))
+	{
+		printf("can't load %s\n", filename);
+		return false;
+	}
+
+	const auto phdr = reinterpret_cast<studiohdr_t*>(model.header.data());
+
+	if (phdr->id != IDSTUDIOHEADER || phdr->version != STUDIO_VERSION)
+	{
+		printf("%s is not a studio model\n", filename);
+		return false;
+	}
+
+	model.groups.resize(V_max(phdr->numseqgroups, 1));
+
+	// Sequence groups are stored next to the model as <name>01.mdl, <name>02.mdl...
+	std::string base = filename;
+
+	if (base.size() > 4 && 0 == strcmp(base.c_str() + base.size() - 4, ".mdl"))
+		base.resize(base.size() - 4);
+
+	for (int i = 1; i < phdr->numseqgroups; i++)
+	{
+		char groupname[16];
+		snprintf(groupname, sizeof(groupname), "%02d.mdl", i);
+
+		if (!LoadFile(base + groupname, model.groups[i]))
+		{
+			printf("can't load %s%s\n", base.c_str(), groupname);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static const mstudioanim_t* GetAnim(const modelfile_t& model, const mstudioseqdesc_t* pseqdesc)
+{
+	if (pseqdesc->seqgroup == 0)
+		return reinterpret_cast<const mstudioanim_t*>(model.header.data() + pseqdesc->animindex);
+
+	return reinterpret_cast<const mstudioanim_t*>(model.groups[pseqdesc->seqgroup].data() + pseqdesc->animindex);
+}
+
+/**
+*	@brief Rotation and position inputs of one bone, before controllers and conversion to a quaternion.
+*/
+struct bonevalues_t
+{
+	float angle1[3];
+	float angle2[3];
+	float pos[3];
+};
+
+// Same as CStudioModelRenderer::StudioCalcBoneQuaterion and StudioCalcBonePosition
+static void ReferenceBone(int frame, float s, const mstudiobone_t* pbone, const mstudioanim_t* panim, bonevalues_t& values)
+{
+	int j, k;
+	const mstudioanimvalue_t* panimvalue;
+
+	for (j = 0; j < 3; j++)
+	{
+		if (panim->offset[j + 3] == 0)
+		{
+			values.angle2[j] = values.angle1[j] = pbone->value[j + 3];
+		}
+		else
+		{
+			panimvalue = (const mstudioanimvalue_t*)((const byte*)panim + panim->offset[j + 3]);
+			k = frame;
+			if (panimvalue->num.total < panimvalue->num.valid)
+				k = 0;
+			while (panimvalue->num.total <= k)
+			{
+				k -= panimvalue->num.total;
+				panimvalue += panimvalue->num.valid + 1;
+				if (panimvalue->num.total < panimvalue->num.valid)
+					k = 0;
+			}
+			if (panimvalue->num.valid > k)
+			{
+				values.angle1[j] = panimvalue[k + 1].value;
+
+				if (panimvalue->num.valid > k + 1)
+					values.angle2[j] = panimvalue[k + 2].value;
+				else if (panimvalue->num.total > k + 1)
+					values.angle2[j] = values.angle1[j];
+				else
+					values.angle2[j] = panimvalue[panimvalue->num.valid + 2].value;
+			}
+			else
+			{
+				values.angle1[j] = panimvalue[panimvalue->num.valid].value;
+				if (panimvalue->num.total > k + 1)
+					values.angle2[j] = values.angle1[j];
+				else
+					values.angle2[j] = panimvalue[panimvalue->num.valid + 2].value;
+			}
+			values.angle1[j] = pbone->value[j + 3] + values.angle1[j] * pbone->scale[j + 3];
+			values.angle2[j] = pbone->value[j + 3] + values.angle2[j] * pbone->scale[j + 3];
+		}
+	}
+
+	for (j = 0; j < 3; j++)
+	{
+		values.pos[j] = pbone->value[j];
+		if (panim->offset[j] != 0)
+		{
+			panimvalue = (const mstudioanimvalue_t*)((const byte*)panim + panim->offset[j]);
+			k = frame;
+			if (panimvalue->num.total < panimvalue->num.valid)
+				k = 0;
+			while (panimvalue->num.total <= k)
+			{
+				k -= panimvalue->num.total;
+				panimvalue += panimvalue->num.valid + 1;
+				if (panimvalue->num.total < panimvalue->num.valid)
+					k = 0;
+			}
+			if (panimvalue->num.valid > k)
+			{
+				if (panimvalue->num.valid > k + 1)
+					values.pos[j] += (panimvalue[k + 1].value * (1.0 - s) + s * panimvalue[k + 2].value) * pbone->scale[j];
+				else
+					values.pos[j] += panimvalue[k + 1].value * pbone->scale[j];
+			}
+			else
+			{
+				if (panimvalue->num.total <= k + 1)
+					values.pos[j] += (panimvalue[panimvalue->num.valid].value * (1.0 - s) + s * panimvalue[panimvalue->num.valid + 2].value) * pbone->scale[j];
+				else
+					values.pos[j] += panimvalue[panimvalue->num.valid].value * pbone->scale[j];
+			}
+		}
+	}
+}
+
+// Same as the cached paths of StudioCalcBoneQuaterion and StudioCalcBonePosition, falling back to the reference for channels that aren't decoded
+static void CachedBone(int frame, float s, const mstudiobone_t* pbone, const mstudioanim_t* panim, const studio_bonekeys_t& keys, bonevalues_t& values)
+{
+	bonevalues_t reference;
+	bool haveReference = false;
+
+	for (int j = 0; j < 3; j++)
+	{
+		const studio_animkey_t* key;
+
+		if (panim->offset[j + 3] == 0)
+		{
+			values.angle2[j] = values.angle1[j] = pbone->value[j + 3];
+		}
+		else if ((key = keys.GetKey(j + 3, frame)) != NULL)
+		{
+			values.angle1[j] = pbone->value[j + 3] + key->value * pbone->scale[j + 3];
+			values.angle2[j] = pbone->value[j + 3] + key->next * pbone->scale[j + 3];
+		}
+		else
+		{
+			if (!haveReference)
+			{
+				ReferenceBone(frame, s, pbone, panim, reference);
+				haveReference = true;
+			}
+
+			values.angle1[j] = reference.angle1[j];
+			values.angle2[j] = reference.angle2[j];
+		}
+	}
+
+	for (int j = 0; j < 3; j++)
+	{
+		const studio_animkey_t* key;
+
+		values.pos[j] = pbone->value[j];
+		if (panim->offset[j] != 0 && (key = keys.GetKey(j, frame)) != NULL)
+		{
+			if (key->blendPosition)
+				values.pos[j] += (key->value * (1.0 - s) + s * key->next) * pbone->scale[j];
+			else
+				values.pos[j] += key->value * pbone->scale[j];
+		}
+		else if (panim->offset[j] != 0)
+		{
+			if (!haveReference)
+			{
+				ReferenceBone(frame, s, pbone, panim, reference);
+				haveReference = true;
+			}
+
+			values.pos[j] = reference.pos[j];
+		}
+	}
+}
+
+// Same as AngleQuaternion in cl_dll/studio_util.cpp
+static void ReferenceAngleQuaternion(const float* angles, vec4_t quaternion)
+{
+	float angle;
+	float sr, sp, sy, cr, cp, cy;
+
+	angle = angles[2] * 0.5;
+	sy = sin(angle);
+	cy = cos(angle);
+	angle = angles[1] * 0.5;
+	sp = sin(angle);
+	cp = cos(angle);
+	angle = angles[0] * 0.5;
+	sr = sin(angle);
+	cr = cos(angle);
+
+	quaternion[0] = sr * cp * cy - cr * sp * sy;
+	quaternion[1] = cr * sp * cy + sr * cp * sy;
+	quaternion[2] = cr * cp * sy - sr * sp * cy;
+	quaternion[3] = cr * cp * cy + sr * sp * sy;
+}
+
+// Same as QuaternionSlerp in cl_dll/studio_util.cpp
+static void ReferenceQuaternionSlerp(vec4_t p, vec4_t q, float t, vec4_t qt)
+{
+	int i;
+	float omega, cosom, sinom, sclp, sclq;
+
+	float a = 0;
+	float b = 0;
+
+	for (i = 0; i < 4; i++)
+	{
+		a += (p[i] - q[i]) * (p[i] - q[i]);
+		b += (p[i] + q[i]) * (p[i] + q[i]);
+	}
+	if (a > b)
+	{
+		for (i = 0; i < 4; i++)
+		{
+			q[i] = -q[i];
+		}
+	}
+
+	cosom = p[0] * q[0] + p[1] * q[1] + p[2] * q[2] + p[3] * q[3];
+
+	if ((1.0 + cosom) > 0.000001)
+	{
+		if ((1.0 - cosom) > 0.000001)
+		{
+			omega = acos(cosom);
+			sinom = sin(omega);
+			sclp = sin((1.0 - t) * omega) / sinom;
+			sclq = sin(t * omega) / sinom;
+		}
+		else
+		{
+			sclp = 1.0 - t;
+			sclq = t;
+		}
+		for (i = 0; i < 4; i++)
+		{
+			qt[i] = sclp * p[i] + sclq * q[i];
+		}
+	}
+	else
+	{
+		qt[0] = -q[1];
+		qt[1] = q[0];
+		qt[2] = -q[3];
+		qt[3] = q[2];
+		sclp = sin((1.0 - t) * (0.5 * M_PI));
+		sclq = sin(t * (0.5 * M_PI));
+		for (i = 0; i < 3; i++)
+		{
+			qt[i] = sclp * p[i] + sclq * qt[i];
+		}
+	}
+}
+
+// Same as QuaternionMatrix in cl_dll/studio_util.cpp, with the position in the last column like StudioSetupBones
+static void ReferenceBoneMatrix(const vec4_t quaternion, const float* pos, float (*matrix)[4])
+{
+	matrix[0][0] = 1.0 - 2.0 * quaternion[1] * quaternion[1] - 2.0 * quaternion[2] * quaternion[2];
+	matrix[1][0] = 2.0 * quaternion[0] * quaternion[1] + 2.0 * quaternion[3] * quaternion[2];
+	matrix[2][0] = 2.0 * quaternion[0] * quaternion[2] - 2.0 * quaternion[3] * quaternion[1];
+
+	matrix[0][1] = 2.0 * quaternion[0] * quaternion[1] - 2.0 * quaternion[3] * quaternion[2];
+	matrix[1][1] = 1.0 - 2.0 * quaternion[0] * quaternion[0] - 2.0 * quaternion[2] * quaternion[2];
+	matrix[2][1] = 2.0 * quaternion[1] * quaternion[2] + 2.0 * quaternion[3] * quaternion[0];
+
+	matrix[0][2] = 2.0 * quaternion[0] * quaternion[2] + 2.0 * quaternion[3] * quaternion[1];
+	matrix[1][2] = 2.0 * quaternion[1] * quaternion[2] - 2.0 * quaternion[3] * quaternion[0];
+	matrix[2][2] = 1.0 - 2.0 * quaternion[0] * quaternion[0] - 2.0 * quaternion[1] * quaternion[1];
+
+	matrix[0][3] = pos[0];
+	matrix[1][3] = pos[1];
+	matrix[2][3] = pos[2];
+}
+
+// Same as ConcatTransforms in pm_shared/pm_math.cpp
+static void ReferenceConcatTransforms(const float in1[3][4], const float in2[3][4], float out[3][4])
+{
+	for (int i = 0; i < 3; i++)
+	{
+		out[i][0] = in1[i][0] * in2[0][0] + in1[i][1] * in2[1][0] + in1[i][2] * in2[2][0];
+		out[i][1] = in1[i][0] * in2[0][1] + in1[i][1] * in2[1][1] + in1[i][2] * in2[2][1];
+		out[i][2] = in1[i][0] * in2[0][2] + in1[i][1] * in2[1][2] + in1[i][2] * in2[2][2];
+		out[i][3] = in1[i][0] * in2[0][3] + in1[i][1] * in2[1][3] + in1[i][2] * in2[2][3] + in1[i][3];
+	}
+}
+
+template <typename Function>
+static void ForEachFrame(const modelfile_t& model, Function function)
+{
+	const auto phdr = reinterpret_cast<const studiohdr_t*>(model.header.data());
+	const auto pseqdesc = reinterpret_cast<const mstudioseqdesc_t*>(model.header.data() + phdr->seqindex);
+
+	for (int sequence = 0; sequence < phdr->numseq; sequence++)
+	{
+		const auto& seq = pseqdesc[sequence];
+		const mstudioanim_t* panim = GetAnim(model, &seq);
+
+		for (int blend = 0; blend < seq.numblends; blend++, panim += phdr->numbones)
+		{
+			for (int step = 0; step < seq.numframes * g_Steps; step++)
+			{
+				const float f = static_cast<float>(step) / g_Steps;
+				const int frame = static_cast<int>(f);
+
+				function(panim, seq.numframes, frame, f - frame);
+			}
+		}
+	}
+}
+
+static bool BenchModel(const modelfile_t& model, std::size_t cacheBytes, benchresult_t& result)
+{
+	const auto phdr = reinterpret_cast<const studiohdr_t*>(model.header.data());
+	const auto pbones = reinterpret_cast<const mstudiobone_t*>(model.header.data() + phdr->boneindex);
+
+	result = {};
+
+	std::vector<bonevalues_t> expected;
+	std::vector<bonevalues_t> values(phdr->numbones);
+
+	// Reference values, also the baseline time
+	for (int pass = 0; pass < g_Repeat; pass++)
+	{
+		const bool record = pass == 0;
+		const auto start = std::chrono::steady_clock::now();
+
+		ForEachFrame(model, [&](const mstudioanim_t* panim, int numframes, int frame, float s)
+			{
+				for (int i = 0; i < phdr->numbones; i++)
+					ReferenceBone(frame, s, &pbones[i], &panim[i], values[i]);
+
+				if (record)
+					expected.insert(expected.end(), values.begin(), values.end());
+			});
+
+		if (!record)
+			result.referenceTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	CStudioAnimCache cache;
+	cache.SetMaxBytes(cacheBytes);
+
+	for (int pass = 0; pass < g_Repeat; pass++)
+	{
+		// The first pass decodes everything, the others run from the cache unless it is too small
+		const bool cold = pass == 0;
+		std::size_t index = 0;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		ForEachFrame(model, [&](const mstudioanim_t* panim, int numframes, int frame, float s)
+			{
+				CStudioAnimCache::Entry* entry = cache.Find(panim, phdr->numbones, numframes);
+
+				for (int i = 0; i < phdr->numbones; i++)
+				{
+					if (entry)
+						CachedBone(frame, s, &pbones[i], &panim[i], cache.GetBone(entry, i), values[i]);
+					else
+						ReferenceBone(frame, s, &pbones[i], &panim[i], values[i]);
+				}
+
+				if (cold)
+				{
+					for (int i = 0; i < phdr->numbones; i++, index++)
+					{
+						if (0 != memcmp(&values[i], &expected[index], sizeof(bonevalues_t)))
+							++result.mismatches;
+					}
+				}
+			});
+
+		const long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+		if (cold)
+			result.coldTime = elapsed;
+		else
+			result.cachedTime += elapsed;
+	}
+
+	result.bones = static_cast<unsigned int>(expected.size());
+
+	const auto& stats = cache.GetStats();
+
+	printf("%-32s %6d %6d %9u %10.1f %10.1f %10.1f %8u %8u %s\n", model.name.c_str(), phdr->numseq, phdr->numbones, result.bones,
+		static_cast<double>(result.referenceTime) / V_max(1, g_Repeat - 1) / V_max(1u, result.bones),
+		static_cast<double>(result.coldTime) / V_max(1u, result.bones),
+		static_cast<double>(result.cachedTime) / V_max(1, g_Repeat - 1) / V_max(1u, result.bones),
+		static_cast<unsigned int>(cache.GetBytes() / 1024), stats.evictions,
+		0 == result.mismatches ? "matches" : "MISMATCH");
+
+	return 0 == result.mismatches;
+}
+
+struct kernelresult_t
+{
+	const char* name;
+	unsigned int bones;
+	long long scalarTime;
+	long long simdTime;
+	float maxError;
+};
+
+template <typename Function>
+static long long TimeKernel(Function function)
+{
+	long long total = 0;
+
+	// The first pass warms up the caches
+	for (int pass = 0; pass < g_Repeat; pass++)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		function();
+
+		if (pass > 0)
+			total += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	return total;
+}
+
+static bool BenchKernels(const modelfile_t& model)
+{
+	const auto phdr = reinterpret_cast<const studiohdr_t*>(model.header.data());
+	const auto pbones = reinterpret_cast<const mstudiobone_t*>(model.header.data() + phdr->boneindex);
+	const int numbones = phdr->numbones;
+
+	if (numbones <= 0 || numbones > MAXSTUDIOBONES)
+		return false;
+
+	// Decoded poses, as the renderer would pass them to the kernels
+	std::vector<bonevalues_t> values;
+	bonevalues_t bone;
+
+	ForEachFrame(model, [&](const mstudioanim_t* panim, int numframes, int frame, float s)
+		{
+			if (values.size() + numbones > KERNEL_MAX_BONES)
+				return;
+
+			for (int i = 0; i < numbones; i++)
+			{
+				ReferenceBone(frame, s, &pbones[i], &panim[i], bone);
+				values.push_back(bone);
+			}
+		});
+
+	const int count = static_cast<int>(values.size());
+
+	if (0 == count)
+		return true;
+
+	std::vector<float> angle1(count * 3), angle2(count * 3), pos(count * 3);
+
+	for (int i = 0; i < count; i++)
+	{
+		memcpy(&angle1[i * 3], values[i].angle1, sizeof(values[i].angle1));
+		memcpy(&angle2[i * 3], values[i].angle2, sizeof(values[i].angle2));
+		memcpy(&pos[i * 3], values[i].pos, sizeof(values[i].pos));
+	}
+
+	const auto angles1 = reinterpret_cast<const float(*)[3]>(angle1.data());
+	const auto angles2 = reinterpret_cast<const float(*)[3]>(angle2.data());
+	const auto positions = reinterpret_cast<const float(*)[3]>(pos.data());
+
+	std::vector<vec4_t> q1(count), q2(count), q(count), simdQ(count);
+	std::vector<float[3][4]> matrices(count), simdMatrices(count);
+
+	float root[3][4] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}};
+
+	auto error = [](const auto& values, const auto& reference)
+	{ return StudioSIMD_MaxError(reinterpret_cast<const float*>(values.data()), reinterpret_cast<const float*>(reference.data()),
+		  static_cast<int>(sizeof(values[0]) / sizeof(float) * values.size())); };
+
+	kernelresult_t results[4] = {
+		{"AngleQuaternion", static_cast<unsigned int>(count * 2)},
+		{"QuaternionSlerp", static_cast<unsigned int>(count)},
+		{"QuaternionMatrix", static_cast<unsigned int>(count)},
+		{"ConcatTransforms", static_cast<unsigned int>(count)}};
+
+	// Every kernel gets the scalar results of the previous step, so errors don't add up
+	results[0].scalarTime = TimeKernel([&]()
+		{
+			for (int i = 0; i < count; i++)
+			{
+				ReferenceAngleQuaternion(angles1[i], q1[i]);
+				ReferenceAngleQuaternion(angles2[i], q2[i]);
+			} });
+
+	results[0].simdTime = TimeKernel([&]()
+		{
+			StudioSIMD_AngleQuaternions(angles1, simdQ.data(), count);
+			StudioSIMD_AngleQuaternions(angles2, q.data(), count); });
+
+	results[0].maxError = V_max(error(simdQ, q1), error(q, q2));
+
+	results[1].scalarTime = TimeKernel([&]()
+		{
+			for (int i = 0; i < count; i++)
+			{
+				vec4_t p1, p2;
+				memcpy(p1, q1[i], sizeof(p1));
+				memcpy(p2, q2[i], sizeof(p2));
+				ReferenceQuaternionSlerp(p1, p2, KERNEL_SLERP_FRACTION, q[i]);
+			} });
+
+	results[1].simdTime = TimeKernel([&]()
+		{ StudioSIMD_QuaternionSlerps(q1.data(), q2.data(), KERNEL_SLERP_FRACTION, simdQ.data(), count); });
+
+	results[1].maxError = error(simdQ, q);
+
+	results[2].scalarTime = TimeKernel([&]()
+		{
+			for (int i = 0; i < count; i++)
+				ReferenceBoneMatrix(q[i], positions[i], matrices[i]);
+		});
+
+	results[2].simdTime = TimeKernel([&]()
+		{ StudioSIMD_BoneMatrices(q.data(), positions, simdMatrices.data(), count); });
+
+	results[2].maxError = error(simdMatrices, matrices);
+
+	// Each pose is a hierarchy, like StudioSetupBones
+	std::vector<float[3][4]> transforms(count), simdTransforms(count);
+
+	auto concat = [&](auto function, std::vector<float[3][4]>& out)
+	{
+		for (int pose = 0; pose < count; pose += numbones)
+		{
+			for (int i = 0; i < numbones; i++)
+			{
+				const int parent = pbones[i].parent;
+
+				if (parent >= 0 && parent < numbones)
+					function(out[pose + parent], matrices[pose + i], out[pose + i]);
+				else
+					function(root, matrices[pose + i], out[pose + i]);
+			}
+		}
+	};
+
+	results[3].scalarTime = TimeKernel([&]()
+		{ concat(ReferenceConcatTransforms, transforms); });
+
+	results[3].simdTime = TimeKernel([&]()
+		{ concat(StudioSIMD_ConcatTransforms, simdTransforms); });
+
+	results[3].maxError = error(simdTransforms, transforms);
+
+	bool matches = true;
+
+	for (const auto& result : results)
+	{
+		const double passes = V_max(1, g_Repeat - 1);
+		const double scalarRate = result.bones * passes / V_max(1LL, result.scalarTime) * 1000.0;
+		const double simdRate = result.bones * passes / V_max(1LL, result.simdTime) * 1000.0;
+
+		const bool withinTolerance = result.maxError <= STUDIO_SIMD_TOLERANCE;
+
+		printf("%-32s %-18s %9u %12.1f %12.1f %8.2f %10.2g %s\n", model.name.c_str(), result.name, result.bones,
+			scalarRate, simdRate, simdRate / scalarRate, result.maxError, withinTolerance ? "matches" : "MISMATCH");
+
+		matches = matches && withinTolerance;
+	}
+
+	return matches;
+}
+
+static void Usage()
+{
+	printf("usage: animbench [options] model.mdl [models]\n"
+		   "  -steps <n>     evaluate every frame at n evenly spaced fractions, default 4\n"
+		   "  -repeat <n>    evaluate every model n times, for timing, default 10\n"
+		   "  -cachekb <n>   animation cache memory limit in kilobytes, default 8192\n"
+		   "  -kernels       also time the SSE2 bone kernels against the scalar code, in millions of bones per second\n"
+		   "sequence groups are loaded from <model>01.mdl, <model>02.mdl...\n");
+	exit(1);
+}
+
+int main(int argc, char** argv)
+{
+	std::size_t cacheBytes = 8192 * 1024;
+	bool kernels = false;
+
+	std::vector<const char*> files;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (0 == strcmp(argv[i], "-steps") && i + 1 < argc)
+		{
+			g_Steps = atoi(argv[++i]);
+			g_Steps = V_max(1, g_Steps);
+		}
+		else if (0 == strcmp(argv[i], "-repeat") && i + 1 < argc)
+		{
+			g_Repeat = atoi(argv[++i]);
+			g_Repeat = V_max(2, g_Repeat);
+		}
+		else if (0 == strcmp(argv[i], "-cachekb") && i + 1 < argc)
+		{
+			const int kilobytes = atoi(argv[++i]);
+			cacheBytes = static_cast<std::size_t>(V_max(1, kilobytes)) * 1024;
+		}
+		else if (0 == strcmp(argv[i], "-kernels"))
+		{
+			kernels = true;
+		}
+		else if (argv[i][0] == '-')
+			Usage();
+		else
+			files.push_back(argv[i]);
+	}
+
+	if (files.empty())
+		Usage();
+
+	printf("%-32s %6s %6s %9s %10s %10s %10s %8s %8s %s\n", "model", "seqs", "bones", "evals", "ns/ref", "ns/cold", "ns/cached", "cacheKB", "evicted", "result");
+
+	int failures = 0;
+
+	for (const char* filename : files)
+	{
+		modelfile_t model;
+		benchresult_t result;
+
+		if (!LoadModel(filename, model) || !BenchModel(model, cacheBytes, result))
+			++failures;
+	}
+
+	if (kernels)
+	{
+		if (!StudioSIMD_IsSupported())
+		{
+			printf("SSE2 is not supported by this CPU\n");
+			return 1;
+		}
+
+		printf("\n%-32s %-18s %9s %12s %12s %8s %10s %s\n", "model", "kernel", "bones", "Mbones/s", "SSE2 Mbones/s", "speedup", "max error", "result");
+
+		for (const char* filename : files)
+		{
+			modelfile_t model;
+
+			if (!LoadModel(filename, model) || !BenchKernels(model))
+				++failures;
+		}
+	}
+
+	return 0 == failures ? 0 : 1;
+}
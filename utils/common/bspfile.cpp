@@ -91,7 +91,7 @@ int FastChecksum(void* buffer, int bytes)
 	int checksum = 0;
 
 	while (bytes--)
-		checksum = _rotl(checksum, 4) ^ *byteBuffer++;
+		checksum = static_cast<int>((static_cast<unsigned int>(checksum) << 4) | (static_cast<unsigned int>(checksum) >> 28)) ^ *byteBuffer++;
 
 	return checksum;
 }
@@ -18,6 +18,10 @@
 #include <direct.h>
 #endif
 
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
 #ifdef NeXT
 #include <libc.h>
 #endif
@@ -226,7 +230,8 @@ void Q_getwd(char* out)
 	_getcwd(out, 256);
 	strcat(out, "\\");
 #else
-	getwd(out);
+	getcwd(out, 256);
+	strcat(out, "/");
 #endif
 }
 
@@ -0,0 +1,1053 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+****/
+
+// pmreplay.cpp: runs recorded player movement (see pm_replay.h) through PM_Move outside of the engine.
+// Collision is done against the world's clip hulls only, brush entities, players and water brushes are not simulated.
+
+#include <chrono>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "Platform.h"
+#include "mathlib.h"
+#include "const.h"
+#include "usercmd.h"
+#include "pm_defs.h"
+#include "pm_shared.h"
+#include "pm_movevars.h"
+#include "com_model.h"
+#include "pm_replay.h"
+
+#include "pmreplay_bsp.h"
+
+#define DIST_EPSILON (0.03125)
+
+// From bspfile.h, which can't be included here
+#define CONTENTS_CURRENT_0 -9
+#define CONTENTS_CURRENT_DOWN -14
+
+struct replaycounters_t
+{
+	unsigned int moves;
+	unsigned int playerTraces;
+	unsigned int traceLines;
+	unsigned int pointContents;
+	unsigned int testPosition;
+	unsigned int hullPointContents;
+};
+
+static playermove_t g_PlayerMove;
+static movevars_t g_MoveVars;
+
+static bspworld_t g_World;
+static std::string g_WorldName;
+static std::vector<mplane_t> g_Planes;
+static hull_t g_Hulls[MAX_MAP_HULLS];
+
+static replaycounters_t g_Counters;
+static float g_flReplayTime;
+static unsigned int g_RandomSeed;
+static bool g_Verbose = false;
+
+//=============================================================================
+// World collision, same as the engine's hull tracing
+
+static int HullPointContents(hull_t* hull, int num, const Vector& p)
+{
+	while (num >= 0)
+	{
+		const dclipnode_t* node = &hull->clipnodes[num];
+		const mplane_t* plane = &hull->planes[node->planenum];
+
+		float d;
+
+		if (plane->type < 3)
+			d = p[plane->type] - plane->dist;
+		else
+			d = DotProduct(plane->normal, p) - plane->dist;
+
+		num = node->children[d < 0 ? 1 : 0];
+	}
+
+	return num;
+}
+
+static bool RecursiveHullCheck(hull_t* hull, int num, float p1f, float p2f, const Vector& p1, const Vector& p2, pmtrace_t* trace)
+{
+	// check for empty
+	if (num < 0)
+	{
+		if (num != CONTENTS_SOLID)
+		{
+			trace->allsolid = 0;
+
+			if (num == CONTENTS_EMPTY)
+				trace->inopen = 1;
+			else
+				trace->inwater = 1;
+		}
+		else
+		{
+			trace->startsolid = 1;
+		}
+
+		return true; // empty
+	}
+
+	const dclipnode_t* node = &hull->clipnodes[num];
+	const mplane_t* plane = &hull->planes[node->planenum];
+
+	float t1, t2;
+
+	if (plane->type < 3)
+	{
+		t1 = p1[plane->type] - plane->dist;
+		t2 = p2[plane->type] - plane->dist;
+	}
+	else
+	{
+		t1 = DotProduct(plane->normal, p1) - plane->dist;
+		t2 = DotProduct(plane->normal, p2) - plane->dist;
+	}
+
+	if (t1 >= 0 && t2 >= 0)
+		return RecursiveHullCheck(hull, node->children[0], p1f, p2f, p1, p2, trace);
+
+	if (t1 < 0 && t2 < 0)
+		return RecursiveHullCheck(hull, node->children[1], p1f, p2f, p1, p2, trace);
+
+	// put the crosspoint DIST_EPSILON pixels on the near side
+	float frac;
+
+	if (t1 < 0)
+		frac = (t1 + DIST_EPSILON) / (t1 - t2);
+	else
+		frac = (t1 - DIST_EPSILON) / (t1 - t2);
+
+	if (frac < 0)
+		frac = 0;
+
+	if (frac > 1)
+		frac = 1;
+
+	float midf = p1f + (p2f - p1f) * frac;
+	Vector mid = p1 + (p2 - p1) * frac;
+
+	const int side = t1 < 0 ? 1 : 0;
+
+	// move up to the node
+	if (!RecursiveHullCheck(hull, node->children[side], p1f, midf, p1, mid, trace))
+		return false;
+
+	// go past the node
+	if (HullPointContents(hull, node->children[side ^ 1], mid) != CONTENTS_SOLID)
+		return RecursiveHullCheck(hull, node->children[side ^ 1], midf, p2f, mid, p2, trace);
+
+	if (0 != trace->allsolid)
+		return false; // never got out of the solid area
+
+	// the other side of the node is solid, this is the impact point
+	if (0 == side)
+	{
+		trace->plane.normal = plane->normal;
+		trace->plane.dist = plane->dist;
+	}
+	else
+	{
+		trace->plane.normal = -plane->normal;
+		trace->plane.dist = -plane->dist;
+	}
+
+	while (HullPointContents(hull, hull->firstclipnode, mid) == CONTENTS_SOLID)
+	{
+		// shouldn't really happen, but does occasionally
+		frac -= 0.1;
+
+		if (frac < 0)
+		{
+			trace->fraction = midf;
+			trace->endpos = mid;
+			return false;
+		}
+
+		midf = p1f + (p2f - p1f) * frac;
+		mid = p1 + (p2 - p1) * frac;
+	}
+
+	trace->fraction = midf;
+	trace->endpos = mid;
+
+	return false;
+}
+
+// Maps pmove's hull numbers to the bsp's hulls
+static hull_t* HullForUseHull(int usehull)
+{
+	switch (usehull)
+	{
+	case 1:
+		return &g_Hulls[3];
+	case 2:
+		return &g_Hulls[0];
+	case 3:
+		return &g_Hulls[2];
+	default:
+		return &g_Hulls[1];
+	}
+}
+
+static pmtrace_t TraceWorld(const Vector& start, const Vector& end, int usehull, int ignore_pe)
+{
+	pmtrace_t trace;
+	memset(&trace, 0, sizeof(trace));
+
+	trace.fraction = 1;
+	trace.ent = -1;
+	trace.endpos = end;
+
+	if (ignore_pe == 0)
+		return trace;
+
+	hull_t* hull = HullForUseHull(usehull);
+	const Vector offset = hull->clip_mins - g_PlayerMove.player_mins[usehull];
+
+	trace.allsolid = 1;
+
+	RecursiveHullCheck(hull, hull->firstclipnode, 0, 1, start - offset, end - offset, &trace);
+
+	if (0 != trace.allsolid)
+		trace.startsolid = 1;
+
+	if (0 != trace.startsolid)
+	{
+		trace.fraction = 0;
+		trace.endpos = start;
+	}
+	else
+	{
+		trace.endpos = trace.endpos + offset;
+	}
+
+	if (trace.fraction < 1 || 0 != trace.startsolid)
+		trace.ent = 0;
+
+	return trace;
+}
+
+//=============================================================================
+// playermove callbacks
+
+static const char* Stub_Info_ValueForKey(const char* s, const char* key)
+{
+	static char value[2][128];
+	static int valueIndex = 0;
+
+	char pkey[128];
+
+	if (*s == '\\')
+		s++;
+
+	while (true)
+	{
+		char* o = pkey;
+
+		while (*s != '\\')
+		{
+			if ('\0' == *s)
+				return "";
+			*o++ = *s++;
+		}
+
+		*o = '\0';
+		s++;
+
+		valueIndex ^= 1;
+		o = value[valueIndex];
+
+		while (*s != '\\' && '\0' != *s)
+			*o++ = *s++;
+
+		*o = '\0';
+
+		if (0 == strcmp(key, pkey))
+			return value[valueIndex];
+
+		if ('\0' == *s)
+			return "";
+
+		s++;
+	}
+}
+
+static void Stub_Particle(float* origin, int color, float life, int zpos, int zvel)
+{
+}
+
+static int Stub_TestPlayerPosition(float* pos, pmtrace_t* ptrace)
+{
+	++g_Counters.testPosition;
+
+	if (ptrace)
+		*ptrace = TraceWorld(pos, pos, g_PlayerMove.usehull, -1);
+
+	hull_t* hull = HullForUseHull(g_PlayerMove.usehull);
+	const Vector offset = hull->clip_mins - g_PlayerMove.player_mins[g_PlayerMove.usehull];
+
+	if (HullPointContents(hull, hull->firstclipnode, Vector(pos) - offset) == CONTENTS_SOLID)
+		return 0;
+
+	return -1;
+}
+
+static int Stub_TestPlayerPositionEx(float* pos, pmtrace_t* ptrace, int (*pfnIgnore)(physent_t* pe))
+{
+	if (pfnIgnore && 0 != pfnIgnore(&g_PlayerMove.physents[0]))
+		return -1;
+
+	return Stub_TestPlayerPosition(pos, ptrace);
+}
+
+static void Stub_Con_NPrintf(int idx, const char* fmt, ...)
+{
+}
+
+static void Stub_Con_DPrintf(const char* fmt, ...)
+{
+	if (!g_Verbose)
+		return;
+
+	va_list args;
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+}
+
+static void Stub_Con_Printf(const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+}
+
+static double Stub_Sys_FloatTime()
+{
+	return g_flReplayTime;
+}
+
+static void Stub_StuckTouch(int hitent, pmtrace_t* ptraceresult)
+{
+}
+
+static int Stub_PointContents(float* p, int* truecontents)
+{
+	++g_Counters.pointContents;
+
+	int contents = HullPointContents(&g_Hulls[0], g_Hulls[0].firstclipnode, p);
+
+	if (truecontents)
+		*truecontents = contents;
+
+	if (contents <= CONTENTS_CURRENT_0 && contents >= CONTENTS_CURRENT_DOWN)
+		contents = CONTENTS_WATER;
+
+	return contents;
+}
+
+static int Stub_TruePointContents(float* p)
+{
+	++g_Counters.pointContents;
+
+	return HullPointContents(&g_Hulls[0], g_Hulls[0].firstclipnode, p);
+}
+
+static int Stub_HullPointContents(struct hull_s* hull, int num, float* p)
+{
+	++g_Counters.hullPointContents;
+
+	return HullPointContents(hull, num, p);
+}
+
+static pmtrace_t Stub_PlayerTrace(float* start, float* end, int traceFlags, int ignore_pe)
+{
+	++g_Counters.playerTraces;
+
+	return TraceWorld(start, end, g_PlayerMove.usehull, ignore_pe);
+}
+
+static pmtrace_t Stub_PlayerTraceEx(float* start, float* end, int traceFlags, int (*pfnIgnore)(physent_t* pe))
+{
+	++g_Counters.playerTraces;
+
+	const int ignore_pe = pfnIgnore && 0 != pfnIgnore(&g_PlayerMove.physents[0]) ? 0 : -1;
+
+	return TraceWorld(start, end, g_PlayerMove.usehull, ignore_pe);
+}
+
+static pmtrace_t* Stub_TraceLine(float* start, float* end, int flags, int usehull, int ignore_pe)
+{
+	static pmtrace_t trace;
+
+	++g_Counters.traceLines;
+
+	trace = TraceWorld(start, end, usehull, ignore_pe);
+
+	return &trace;
+}
+
+static pmtrace_t* Stub_TraceLineEx(float* start, float* end, int flags, int usehull, int (*pfnIgnore)(physent_t* pe))
+{
+	const int ignore_pe = pfnIgnore && 0 != pfnIgnore(&g_PlayerMove.physents[0]) ? 0 : -1;
+
+	return Stub_TraceLine(start, end, flags, usehull, ignore_pe);
+}
+
+// Deterministic so replays are repeatable
+static int32 Stub_RandomLong(int32 lLow, int32 lHigh)
+{
+	g_RandomSeed = g_RandomSeed * 1103515245 + 12345;
+
+	const unsigned int range = static_cast<unsigned int>(lHigh - lLow) + 1;
+
+	if (range == 0)
+		return lLow;
+
+	return lLow + static_cast<int32>((g_RandomSeed >> 8) % range);
+}
+
+static float Stub_RandomFloat(float flLow, float flHigh)
+{
+	g_RandomSeed = g_RandomSeed * 1103515245 + 12345;
+
+	return flLow + (flHigh - flLow) * ((g_RandomSeed >> 8) / static_cast<float>(1 << 24));
+}
+
+static int Stub_GetModelType(model_t* mod)
+{
+	return mod_brush;
+}
+
+static void Stub_GetModelBounds(model_t* mod, float* mins, float* maxs)
+{
+	VectorCopy(g_World.mins, mins);
+	VectorCopy(g_World.maxs, maxs);
+}
+
+static void* Stub_HullForBsp(physent_t* pe, float* offset)
+{
+	VectorClear(offset);
+
+	return HullForUseHull(g_PlayerMove.usehull);
+}
+
+static float Stub_TraceModel(physent_t* pEnt, const float* start, const float* end, trace_t* trace)
+{
+	memset(trace, 0, sizeof(*trace));
+	trace->fraction = 1;
+	VectorCopy(end, trace->endpos);
+
+	return 1;
+}
+
+static int Stub_COM_FileSize(const char* filename)
+{
+	return -1;
+}
+
+static byte* Stub_COM_LoadFile(const char* path, int usehunk, int* pLength)
+{
+	return NULL;
+}
+
+static void Stub_COM_FreeFile(void* buffer)
+{
+}
+
+static char* Stub_memfgets(byte* pMemFile, int fileSize, int* pFilePos, char* pBuffer, int bufferSize)
+{
+	return NULL;
+}
+
+static void Stub_PlaySound(int channel, const char* sample, float volume, float attenuation, int fFlags, int pitch)
+{
+}
+
+static const char* Stub_TraceTexture(int ground, float* vstart, float* vend)
+{
+	// No texture names in the clip hulls, footsteps default to concrete
+	return NULL;
+}
+
+static void Stub_PlaybackEventFull(int flags, int clientindex, unsigned short eventindex, float delay, float* origin, float* angles, float fparam1, float fparam2, int iparam1, int iparam2, int bparam1, int bparam2)
+{
+}
+
+//=============================================================================
+
+static void LoadWorld(const char* filename)
+{
+	if (g_WorldName == filename)
+		return;
+
+	BSP_LoadWorld(filename, g_World);
+	g_WorldName = filename;
+
+	g_Planes.resize(g_World.planes.size());
+
+	for (size_t i = 0; i < g_World.planes.size(); i++)
+	{
+		g_Planes[i].normal = g_World.planes[i].normal;
+		g_Planes[i].dist = g_World.planes[i].dist;
+		g_Planes[i].type = static_cast<byte>(g_World.planes[i].type);
+	}
+
+	// Hull sizes the bsp compiler expanded the clip hulls by
+	const Vector hullSizes[MAX_MAP_HULLS][2] =
+		{
+			{Vector(0, 0, 0), Vector(0, 0, 0)},
+			{Vector(-16, -16, -36), Vector(16, 16, 36)},
+			{Vector(-32, -32, -32), Vector(32, 32, 32)},
+			{Vector(-16, -16, -18), Vector(16, 16, 18)}};
+
+	for (int i = 0; i < MAX_MAP_HULLS; i++)
+	{
+		hull_t* hull = &g_Hulls[i];
+
+		if (i == 0)
+		{
+			hull->clipnodes = reinterpret_cast<dclipnode_t*>(g_World.hull0.data());
+			hull->lastclipnode = static_cast<int>(g_World.hull0.size()) - 1;
+		}
+		else
+		{
+			hull->clipnodes = reinterpret_cast<dclipnode_t*>(g_World.clipnodes.data());
+			hull->lastclipnode = static_cast<int>(g_World.clipnodes.size()) - 1;
+		}
+
+		hull->planes = g_Planes.data();
+		hull->firstclipnode = g_World.headnode[i];
+		hull->clip_mins = hullSizes[i][0];
+		hull->clip_maxs = hullSizes[i][1];
+	}
+}
+
+static void InitPlayerMove(bool multiplayer)
+{
+	playermove_t* pm = &g_PlayerMove;
+
+	memset(pm, 0, sizeof(*pm));
+
+	pm->server = 1;
+	pm->multiplayer = multiplayer ? 1 : 0;
+	pm->movevars = &g_MoveVars;
+
+	pm->numphysent = 1;
+	strcpy(pm->physents[0].name, "world");
+	pm->physents[0].solid = SOLID_BSP;
+	pm->physents[0].movetype = MOVETYPE_NONE;
+
+	pm->PM_Info_ValueForKey = Stub_Info_ValueForKey;
+	pm->PM_Particle = Stub_Particle;
+	pm->PM_TestPlayerPosition = Stub_TestPlayerPosition;
+	pm->Con_NPrintf = Stub_Con_NPrintf;
+	pm->Con_DPrintf = Stub_Con_DPrintf;
+	pm->Con_Printf = Stub_Con_Printf;
+	pm->Sys_FloatTime = Stub_Sys_FloatTime;
+	pm->PM_StuckTouch = Stub_StuckTouch;
+	pm->PM_PointContents = Stub_PointContents;
+	pm->PM_TruePointContents = Stub_TruePointContents;
+	pm->PM_HullPointContents = Stub_HullPointContents;
+	pm->PM_PlayerTrace = Stub_PlayerTrace;
+	pm->PM_TraceLine = Stub_TraceLine;
+	pm->RandomLong = Stub_RandomLong;
+	pm->RandomFloat = Stub_RandomFloat;
+	pm->PM_GetModelType = Stub_GetModelType;
+	pm->PM_GetModelBounds = Stub_GetModelBounds;
+	pm->PM_HullForBsp = Stub_HullForBsp;
+	pm->PM_TraceModel = Stub_TraceModel;
+	pm->COM_FileSize = Stub_COM_FileSize;
+	pm->COM_LoadFile = Stub_COM_LoadFile;
+	pm->COM_FreeFile = Stub_COM_FreeFile;
+	pm->memfgets = Stub_memfgets;
+	pm->runfuncs = 0;
+	pm->PM_PlaySound = Stub_PlaySound;
+	pm->PM_TraceTexture = Stub_TraceTexture;
+	pm->PM_PlaybackEventFull = Stub_PlaybackEventFull;
+	pm->PM_PlayerTraceEx = Stub_PlayerTraceEx;
+	pm->PM_TestPlayerPositionEx = Stub_TestPlayerPositionEx;
+	pm->PM_TraceLineEx = Stub_TraceLineEx;
+
+	PM_Init(pm);
+}
+
+//=============================================================================
+
+struct replayresult_t
+{
+	std::string name;
+	Vector origin;
+	Vector velocity;
+};
+
+struct recording_t
+{
+	std::string name;
+	pmreplay_header_t header;
+	std::vector<pmreplay_move_t> moves;
+};
+
+static bool LoadRecording(const char* filename, recording_t& recording)
+{
+	FILE* file = fopen(filename, "r");
+
+	if (!file)
+	{
+		printf("%s: can't open file\n", filename);
+		return false;
+	}
+
+	recording.name = filename;
+
+	if (!PMReplay_ReadHeader(file, recording.header))
+	{
+		printf("%s: not a pmreplay version %d recording\n", filename, PMREPLAY_VERSION);
+		fclose(file);
+		return false;
+	}
+
+	pmreplay_move_t move;
+
+	while (PMReplay_ReadMove(file, move))
+		recording.moves.push_back(move);
+
+	fclose(file);
+
+	return true;
+}
+
+// Runs all moves of the recording and returns the number of nanoseconds spent in PM_Move
+static long long Replay(const recording_t& recording, bool resync, replayresult_t& result, int& firstMismatch)
+{
+	playermove_t* pm = &g_PlayerMove;
+
+	g_MoveVars = recording.header.movevars;
+	strcpy(pm->physinfo, recording.header.physinfo);
+	g_RandomSeed = 0;
+	firstMismatch = -1;
+
+	long long elapsed = 0;
+
+	for (size_t i = 0; i < recording.moves.size(); i++)
+	{
+		const pmreplay_move_t& move = recording.moves[i];
+
+		PMReplay_Apply(move, pm, resync || i == 0);
+		g_flReplayTime = move.time;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		PM_Move(pm, 1);
+
+		elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+		++g_Counters.moves;
+
+		if (firstMismatch == -1 && (pm->origin != move.resultOrigin || pm->velocity != move.resultVelocity))
+			firstMismatch = static_cast<int>(i);
+	}
+
+	result.name = recording.name;
+	result.origin = pm->origin;
+	result.velocity = pm->velocity;
+
+	return elapsed;
+}
+
+// Runs the recordings side by side through PM_MoveBatch, as if they were different players on the same server.
+// The recordings have to be made with the same physics settings. Returns the number of nanoseconds spent in PM_MoveBatch.
+static long long ReplayBatch(const std::vector<recording_t>& recordings, bool resync, std::vector<replayresult_t>& results,
+	std::vector<int>& firstMismatch, unsigned int& batchedMoves)
+{
+	playermove_t* pm = &g_PlayerMove;
+
+	g_MoveVars = recordings[0].header.movevars;
+	strcpy(pm->physinfo, recordings[0].header.physinfo);
+	g_RandomSeed = 0;
+
+	pm_batch_s* batch = PM_AllocBatch();
+
+	// Recording played by each player in the batch, players are dropped as their recordings end
+	std::vector<int> playerRecording;
+
+	for (size_t r = 0; r < recordings.size(); r++)
+	{
+		PM_BatchSetPlayer(batch, static_cast<int>(r), pm);
+		playerRecording.push_back(static_cast<int>(r));
+	}
+
+	PM_BatchSetCount(batch, static_cast<int>(recordings.size()));
+
+	results.resize(recordings.size());
+	firstMismatch.assign(recordings.size(), -1);
+
+	long long elapsed = 0;
+
+	for (size_t i = 0; !playerRecording.empty(); i++)
+	{
+		for (size_t p = 0; p < playerRecording.size(); p++)
+		{
+			const pmreplay_move_t& move = recordings[playerRecording[p]].moves[i];
+
+			PM_BatchGetPlayer(batch, static_cast<int>(p), pm);
+			PMReplay_Apply(move, pm, resync || i == 0);
+			PM_BatchSetPlayer(batch, static_cast<int>(p), pm);
+		}
+
+		g_flReplayTime = recordings[playerRecording[0]].moves[i].time;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		PM_MoveBatch(pm, batch, 1);
+
+		elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+		g_Counters.moves += playerRecording.size();
+		batchedMoves += PM_BatchNumBatched(batch);
+
+		for (size_t p = 0; p < playerRecording.size();)
+		{
+			const int r = playerRecording[p];
+			const pmreplay_move_t& move = recordings[r].moves[i];
+
+			PM_BatchGetPlayer(batch, static_cast<int>(p), pm);
+
+			if (firstMismatch[r] == -1 && (pm->origin != move.resultOrigin || pm->velocity != move.resultVelocity))
+				firstMismatch[r] = static_cast<int>(i);
+
+			if (i + 1 < recordings[r].moves.size())
+			{
+				p++;
+				continue;
+			}
+
+			results[r].name = recordings[r].name;
+			results[r].origin = pm->origin;
+			results[r].velocity = pm->velocity;
+
+			// Move the last player into this slot
+			const int last = static_cast<int>(playerRecording.size()) - 1;
+
+			PM_BatchGetPlayer(batch, last, pm);
+			PM_BatchSetPlayer(batch, static_cast<int>(p), pm);
+			playerRecording[p] = playerRecording[last];
+			playerRecording.pop_back();
+			PM_BatchSetCount(batch, last);
+		}
+	}
+
+	PM_FreeBatch(batch);
+
+	return elapsed;
+}
+
+static void WriteResult(FILE* file, const replayresult_t& result)
+{
+	fprintf(file, "%s origin %a %a %a velocity %a %a %a\n", result.name.c_str(),
+		result.origin.x, result.origin.y, result.origin.z,
+		result.velocity.x, result.velocity.y, result.velocity.z);
+}
+
+static bool FindGoldenResult(const char* goldenFile, const std::string& name, replayresult_t& golden)
+{
+	FILE* file = fopen(goldenFile, "r");
+
+	if (!file)
+		return false;
+
+	char line[2048];
+	bool found = false;
+
+	while (!found && fgets(line, sizeof(line), file))
+	{
+		char* p = strstr(line, " origin ");
+
+		if (!p || static_cast<size_t>(p - line) != name.size() || 0 != strncmp(line, name.c_str(), name.size()))
+			continue;
+
+		p += strlen(" origin ");
+
+		for (int i = 0; i < 3; i++)
+			golden.origin[i] = strtof(p, &p);
+
+		p = strstr(p, "velocity");
+
+		if (!p)
+			continue;
+
+		p += strlen("velocity");
+
+		for (int i = 0; i < 3; i++)
+			golden.velocity[i] = strtof(p, &p);
+
+		found = true;
+	}
+
+	fclose(file);
+
+	return found;
+}
+
+static void Usage()
+{
+	printf("usage: pmreplay [options] recording [recordings]\n"
+		   "  -map <bsp>           world to collide with, default <basedir>/maps/<map in the recording>.bsp\n"
+		   "  -basedir <dir>       game directory to look for maps in, default .\n"
+		   "  -repeat <n>          run every recording n times, for timing\n"
+		   "  -resync              restore the recorded player state before every move instead of carrying it over\n"
+		   "  -singleplayer        run as a singleplayer server\n"
+		   "  -batch               run all recordings at once through PM_MoveBatch, as players on the same server\n"
+		   "  -nomemo              disable the per-move trace memo in the movement code\n"
+		   "  -golden <file>       compare the final origin and velocity against a golden file\n"
+		   "  -writegolden <file>  write the final origin and velocity of every recording to a golden file\n"
+		   "  -v                   print developer messages from the movement code\n");
+	exit(1);
+}
+
+int main(int argc, char** argv)
+{
+	const char* mapOverride = NULL;
+	const char* basedir = ".";
+	const char* goldenFile = NULL;
+	const char* writeGoldenFile = NULL;
+	int repeat = 1;
+	bool resync = false;
+	bool multiplayer = true;
+	bool batch = false;
+
+	std::vector<const char*> files;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (0 == strcmp(argv[i], "-map") && i + 1 < argc)
+			mapOverride = argv[++i];
+		else if (0 == strcmp(argv[i], "-basedir") && i + 1 < argc)
+			basedir = argv[++i];
+		else if (0 == strcmp(argv[i], "-repeat") && i + 1 < argc)
+		{
+			repeat = atoi(argv[++i]);
+			repeat = V_max(1, repeat);
+		}
+		else if (0 == strcmp(argv[i], "-resync"))
+			resync = true;
+		else if (0 == strcmp(argv[i], "-singleplayer"))
+			multiplayer = false;
+		else if (0 == strcmp(argv[i], "-batch"))
+			batch = true;
+		else if (0 == strcmp(argv[i], "-nomemo"))
+			PM_SetTraceMemoEnabled(false);
+		else if (0 == strcmp(argv[i], "-golden") && i + 1 < argc)
+			goldenFile = argv[++i];
+		else if (0 == strcmp(argv[i], "-writegolden") && i + 1 < argc)
+			writeGoldenFile = argv[++i];
+		else if (0 == strcmp(argv[i], "-v"))
+			g_Verbose = true;
+		else if (argv[i][0] == '-')
+			Usage();
+		else
+			files.push_back(argv[i]);
+	}
+
+	if (files.empty())
+		Usage();
+
+	InitPlayerMove(multiplayer);
+
+	FILE* writeGolden = NULL;
+
+	if (writeGoldenFile)
+	{
+		writeGolden = fopen(writeGoldenFile, "w");
+
+		if (!writeGolden)
+		{
+			printf("can't write %s\n", writeGoldenFile);
+			return 1;
+		}
+	}
+
+	int failures = 0;
+	long long totalElapsed = 0;
+	unsigned int totalMoves = 0;
+
+	printf("%-32s %8s %10s %8s %8s %8s %8s %8s %s\n", "recording", "moves", "ns/move", "traces", "contents", "testpos", "hullcont", "memohits", "server");
+
+	// Prints the results of one recording and checks them against the golden file
+	const auto report = [&](const recording_t& recording, const replayresult_t& result, int firstMismatch, long long elapsed, unsigned int moves)
+	{
+		moves = V_max(moves, 1u);
+
+		char server[64];
+
+		if (firstMismatch == -1)
+			snprintf(server, sizeof(server), "matches");
+		else
+			snprintf(server, sizeof(server), "differs from move %d", firstMismatch);
+
+		const pm_tracestats_t& memoStats = PM_GetTraceStats();
+
+		printf("%-32s %8u %10.1f %8.2f %8.2f %8.2f %8.2f %8.2f %s\n", recording.name.c_str(), static_cast<unsigned int>(recording.moves.size()),
+			static_cast<double>(elapsed) / moves,
+			static_cast<double>(g_Counters.playerTraces + g_Counters.traceLines) / moves,
+			static_cast<double>(g_Counters.pointContents) / moves,
+			static_cast<double>(g_Counters.testPosition) / moves,
+			static_cast<double>(g_Counters.hullPointContents) / moves,
+			static_cast<double>(memoStats.traceHits + memoStats.contentsHits + memoStats.testHits) / moves,
+			server);
+
+		if (writeGolden)
+			WriteResult(writeGolden, result);
+
+		if (goldenFile)
+		{
+			replayresult_t golden;
+
+			if (!FindGoldenResult(goldenFile, result.name, golden))
+			{
+				printf("  no golden result for %s\n", recording.name.c_str());
+				++failures;
+			}
+			else if (golden.origin != result.origin || golden.velocity != result.velocity)
+			{
+				printf("  MISMATCH origin %.6f %.6f %.6f velocity %.6f %.6f %.6f, golden origin %.6f %.6f %.6f velocity %.6f %.6f %.6f\n",
+					result.origin.x, result.origin.y, result.origin.z, result.velocity.x, result.velocity.y, result.velocity.z,
+					golden.origin.x, golden.origin.y, golden.origin.z, golden.velocity.x, golden.velocity.y, golden.velocity.z);
+				++failures;
+			}
+		}
+	};
+
+	std::vector<recording_t> recordings;
+
+	for (const char* filename : files)
+	{
+		recording_t recording;
+
+		if (!LoadRecording(filename, recording))
+		{
+			++failures;
+			continue;
+		}
+
+		if (recording.moves.empty())
+		{
+			printf("%s: no moves\n", filename);
+			++failures;
+			continue;
+		}
+
+		if (batch)
+		{
+			recordings.push_back(std::move(recording));
+			continue;
+		}
+
+		if (mapOverride)
+		{
+			LoadWorld(mapOverride);
+		}
+		else
+		{
+			const std::string mapPath = std::string(basedir) + "/maps/" + recording.header.mapname + ".bsp";
+			LoadWorld(mapPath.c_str());
+		}
+
+		memset(&g_Counters, 0, sizeof(g_Counters));
+		PM_ResetTraceStats();
+
+		replayresult_t result;
+		int firstMismatch = -1;
+		long long elapsed = 0;
+
+		for (int r = 0; r < repeat; r++)
+			elapsed += Replay(recording, resync, result, firstMismatch);
+
+		report(recording, result, firstMismatch, elapsed, g_Counters.moves);
+
+		totalElapsed += elapsed;
+		totalMoves += g_Counters.moves;
+	}
+
+	if (batch && !recordings.empty())
+	{
+		if (recordings.size() > PM_BATCH_MAX_PLAYERS)
+		{
+			printf("at most %d recordings can be run as a batch\n", PM_BATCH_MAX_PLAYERS);
+			return 1;
+		}
+
+		for (const recording_t& recording : recordings)
+		{
+			if (0 != strcmp(recording.header.mapname, recordings[0].header.mapname) ||
+				0 != memcmp(&recording.header.movevars, &recordings[0].header.movevars, sizeof(movevars_t)))
+			{
+				printf("%s: recordings run as a batch need the same map and physics settings\n", recording.name.c_str());
+				return 1;
+			}
+		}
+
+		if (mapOverride)
+		{
+			LoadWorld(mapOverride);
+		}
+		else
+		{
+			const std::string mapPath = std::string(basedir) + "/maps/" + recordings[0].header.mapname + ".bsp";
+			LoadWorld(mapPath.c_str());
+		}
+
+		memset(&g_Counters, 0, sizeof(g_Counters));
+		PM_ResetTraceStats();
+
+		std::vector<replayresult_t> results;
+		std::vector<int> firstMismatch;
+		unsigned int batchedMoves = 0;
+		long long elapsed = 0;
+
+		for (int r = 0; r < repeat; r++)
+			elapsed += ReplayBatch(recordings, resync, results, firstMismatch, batchedMoves);
+
+		// Timings and counts are for the batch as a whole
+		for (size_t r = 0; r < recordings.size(); r++)
+			report(recordings[r], results[r], firstMismatch[r], elapsed, g_Counters.moves);
+
+		printf("%u of %u moves took the batched path\n", batchedMoves, g_Counters.moves);
+
+		totalElapsed += elapsed;
+		totalMoves += g_Counters.moves;
+	}
+
+	if (writeGolden)
+		fclose(writeGolden);
+
+	if (totalMoves > 0)
+		printf("%u moves, %.1f ns/move\n", totalMoves, static_cast<double>(totalElapsed) / totalMoves);
+
+	if (failures > 0)
+	{
+		printf("%d recording(s) failed\n", failures);
+		return 1;
+	}
+
+	return 0;
+}
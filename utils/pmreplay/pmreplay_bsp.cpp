@@ -0,0 +1,78 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*	
+*	This product contains software technology licensed from Id 
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc. 
+*	All Rights Reserved.
+*
+****/
+
+// pmreplay_bsp.cpp: bsp loading, kept separate from the movement code because
+// the tools' headers can't be mixed with the game's
+
+#include "cmdlib.h"
+#include "mathlib.h"
+#include "bspfile.h"
+
+#include "pmreplay_bsp.h"
+
+void BSP_LoadWorld(const char* filename, bspworld_t& world)
+{
+	char path[1024];
+
+	strncpy(path, filename, sizeof(path) - 1);
+	path[sizeof(path) - 1] = '\0';
+
+	LoadBSPFile(path);
+
+	if (nummodels < 1)
+		Error("%s has no world model", filename);
+
+	world.planes.resize(numplanes);
+
+	for (int i = 0; i < numplanes; i++)
+	{
+		for (int j = 0; j < 3; j++)
+			world.planes[i].normal[j] = dplanes[i].normal[j];
+
+		world.planes[i].dist = dplanes[i].dist;
+		world.planes[i].type = dplanes[i].type;
+	}
+
+	// Same as Mod_MakeHull0 in the engine
+	world.hull0.resize(numnodes);
+
+	for (int i = 0; i < numnodes; i++)
+	{
+		world.hull0[i].planenum = dnodes[i].planenum;
+
+		for (int j = 0; j < 2; j++)
+		{
+			const int child = dnodes[i].children[j];
+
+			if (child < 0)
+				world.hull0[i].children[j] = dleafs[-1 - child].contents;
+			else
+				world.hull0[i].children[j] = child;
+		}
+	}
+
+	world.clipnodes.resize(numclipnodes);
+
+	for (int i = 0; i < numclipnodes; i++)
+	{
+		world.clipnodes[i].planenum = dclipnodes[i].planenum;
+		world.clipnodes[i].children[0] = dclipnodes[i].children[0];
+		world.clipnodes[i].children[1] = dclipnodes[i].children[1];
+	}
+
+	for (int i = 0; i < MAX_MAP_HULLS; i++)
+		world.headnode[i] = dmodels[0].headnode[i];
+
+	for (int i = 0; i < 3; i++)
+	{
+		world.mins[i] = dmodels[0].mins[i];
+		world.maxs[i] = dmodels[0].maxs[i];
+	}
+}
@@ -0,0 +1,47 @@
+/***
+*
+*	Copyright (c) 1996-2002, Valve LLC. All rights reserved.
+*	
+*	This product contains software technology licensed from Id 
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc. 
+*	All Rights Reserved.
+*
+****/
+
+// pmreplay_bsp.h
+
+#pragma once
+
+#include <vector>
+
+// Collision data of the world model, copied out of the bsp file.
+// The layouts match the engine's mplane_t and dclipnode_t closely enough to build hull_t from them,
+// but this header can't include either because the tools' headers clash with the game's.
+
+struct bspplane_t
+{
+	float normal[3];
+	float dist;
+	int type;
+};
+
+struct bspclipnode_t
+{
+	int planenum;
+	short children[2]; // negative numbers are contents
+};
+
+struct bspworld_t
+{
+	std::vector<bspplane_t> planes;
+
+	// Hull 0 is built from the drawing nodes and leafs, like the engine does
+	std::vector<bspclipnode_t> hull0;
+	std::vector<bspclipnode_t> clipnodes;
+
+	int headnode[4];
+	float mins[3], maxs[3];
+};
+
+// Loads the world model's hulls. Exits with an error if the file can't be loaded.
+void BSP_LoadWorld(const char* filename, bspworld_t& world);